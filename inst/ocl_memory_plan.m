@@ -0,0 +1,117 @@
+## Copyright (C) 2019-2023 Matthias W. Klein
+##
+## This file is part of OCL - a GNU Octave package providing OpenCL support.
+##
+## OCL is free software: you can redistribute it and/or modify
+## it under the terms of the GNU General Public License as published by
+## the Free Software Foundation, either version 3 of the License, or
+## (at your option) any later version.
+##
+## OCL is distributed in the hope that it will be useful,
+## but WITHOUT ANY WARRANTY; without even the implied warranty of
+## MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+## GNU General Public License for more details.
+##
+## You should have received a copy of the GNU General Public License
+## along with OCL.  If not, see <http://www.gnu.org/licenses/>.
+
+## -*- texinfo -*-
+##
+## @deftypefn{Function File} {@var{stats} =} ocl_memory_plan (@var{plan})
+##
+## Reserve OpenCL device memory for OCL matrices of given sizes and classes.
+##
+## @code{ocl_memory_plan} pre-allocates OpenCL buffers for the OCL matrices
+## listed in @var{plan}, a cell array with one row per matrix and the columns
+## @{@var{dims}, @var{class}@} or @{@var{dims}, @var{class}, @var{count}@}.
+## @var{dims} is the size vector of the matrix, @var{class} its class
+## (e.g., @qcode{"single"} or @qcode{"int32"}, with a trailing
+## @qcode{" complex"} for complex matrices), and @var{count} the number of
+## such matrices (default: 1).  The buffers are retained in OCL's pool of
+## OpenCL memory buffers and kept there, so that subsequently created OCL
+## matrices of these sizes need no OpenCL memory allocation, e.g., within a
+## time-critical loop.
+##
+## The returned struct @var{stats} contains the requested and the achieved
+## number of reserved bytes (fields @code{requested_bytes} and
+## @code{reserved_bytes}), the number of buffers which could not be allocated
+## (field @code{failed}), and the fragmentation of the pool of retained
+## buffers (field @code{fragmentation}).  As retained buffers are only reused
+## for matrices of their exact size in bytes, the fragmentation is the
+## fraction of retained bytes in buffers of none of the reserved sizes,
+## i.e., zero if the pool only holds buffers for the planned matrices.
+##
+## The pool statistics of @code{__ocl_memmgr__ ("poolstats")} count pool hits
+## and misses (i.e., OpenCL memory allocations), which allows to confirm
+## that a loop runs without allocations:
+##
+## @example
+## @group
+## ocl_memory_plan (@{[1000 1000], "single", 2@});
+## s0 = __ocl_memmgr__ ("poolstats");
+## for k = 1:100
+##   a = ocl_single (rand (1000, 1000));
+##   b = a .* a;
+##   clear a b
+## endfor
+## s = __ocl_memmgr__ ("poolstats");
+## assert (s.misses, s0.misses)
+## @end group
+## @end example
+##
+## Reservations are cancelled by @code{__ocl_memmgr__ ("reserve", [])}, and
+## when the OpenCL context is destroyed.
+##
+## @seealso{oclArray, ocl_double, ocl_single, ocl_context}
+## @end deftypefn
+
+function stats = ocl_memory_plan (plan)
+
+  if ((nargin != 1) || ! iscell (plan) || ! any (columns (plan) == [2 3]))
+    error ("ocl_memory_plan: argument must be a cell array with rows {dims, class[, count]}");
+  endif
+
+  sizes = [];
+  for i = 1:rows (plan)
+    n = prod (plan{i,1});
+    count = 1;
+    if (columns (plan) == 3)
+      count = plan{i,3};
+    endif
+    sizes = [sizes, repmat(n * element_bytes (plan{i,2}), 1, count)];
+  endfor
+
+  stats = __ocl_memmgr__ ("reserve", sizes);
+
+endfunction
+
+
+function nbytes = element_bytes (class_str)
+
+  [cls, rest] = strtok (class_str);
+  is_complex = strcmp (strtrim (rest), "complex");
+  if (! (is_complex || isempty (strtrim (rest))))
+    error ("ocl_memory_plan: invalid class '%s'", class_str);
+  endif
+
+  switch cls
+    case {"double", "int64", "uint64"}
+      nbytes = 8;
+    case {"single", "int32", "uint32"}
+      nbytes = 4;
+    case {"int16", "uint16"}
+      nbytes = 2;
+    case {"int8", "uint8"}
+      nbytes = 1;
+    otherwise
+      error ("ocl_memory_plan: invalid class '%s'", class_str);
+  endswitch
+
+  if (is_complex)
+    if (! any (strcmp (cls, {"double", "single"})))
+      error ("ocl_memory_plan: invalid class '%s'", class_str);
+    endif
+    nbytes *= 2;
+  endif
+
+endfunction
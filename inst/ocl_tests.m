@@ -194,6 +194,23 @@ assert (islogical (a < 18))
 assert (to_octave_type (ocl_cat (1, a, a, a)), repmat (to_octave_type (a), [3 1 1]))
 assert (to_octave_type (ocl_cat (2, a, a, a)), repmat (to_octave_type (a), [1 3 1]))
 assert (to_octave_type (ocl_cat (3, a, a, a)), repmat (to_octave_type (a), [1 1 3]))
+parts = cell (1, 40); parts2 = cell (1, 40);
+for k = 1:40
+  parts{k} = a(:,mod (k, columns (a)) + 1); parts2{k} = to_octave_type (parts{k});
+endfor
+assert (to_octave_type (cat (1, parts{:})), cat (1, parts2{:}))
+assert (to_octave_type (horzcat (parts{:})), horzcat (parts2{:}))
+assert (to_octave_type (vertcat (a, a(1,:), a)), vertcat (to_octave_type (a), to_octave_type (a(1,:)), to_octave_type (a)))
+assert (to_octave_type (horzcat ([], a, a)), [to_octave_type(a), to_octave_type(a)])
+s1 = a(:); s2 = to_octave_type (s1);
+assert (to_octave_type (cat (1, s1(1:5), s1(6:9), s1(10:end))), s2)
+parts = cell (1, 11); parts2 = cell (1, 11);
+for k = 1:11 # inputs of unequal sizes, the last launch of the gather kernel partial
+  parts2{k} = to_octave_type (to_ocl_type (reshape (1:3*k, k, 3))); parts{k} = to_ocl_type (parts2{k});
+endfor
+parts2{6} = to_octave_type (to_ocl_type (ones (30000, 3))); parts{6} = to_ocl_type (parts2{6}); # a large input
+assert (to_octave_type (cat (1, parts{:})), cat (1, parts2{:}))
+assert (to_octave_type (cat (2, parts{1}.', parts{2}.', parts{3}.')), cat (2, parts2{1}.', parts2{2}.', parts2{3}.'))
 
 endfor # complex_iter
 
@@ -205,10 +222,31 @@ assert (to_octave_type (ocl_zeros (4, 5, 6, typestr(5:end))), zeros (4, 5, 6, ty
 assert (to_octave_type (ocl_zeros ([4 5 6], typestr(5:end))), zeros ([4 5 6], typestr(5:end)))
 assert (to_octave_type (ocl_eye ([4 5], typestr(5:end))), eye ([4 5], typestr(5:end)))
 assert (to_octave_type (ocl_eye (4, typestr(5:end))), eye (4, typestr(5:end)))
+assert (to_octave_type (ocl_zeros (100, 3, typestr(5:end)) + ocl_eye (100, 3, typestr(5:end))), eye (100, 3, typestr(5:end)))
+z = ocl_ones (4, 5, typestr(5:end)); z(2,3) = 7;
+o = ones (4, 5, typestr(5:end)); o(2,3) = 7;
+assert (to_octave_type (z), o)
 if ocltype == 1 # ocl double
 assert (to_octave_type (ocl_linspace (0, 1, 6)), linspace (0, 1, 6), 1e-14)
 assert (to_octave_type (ocl_logspace (0, 1, 6)), logspace (0, 1, 6), 1e-14)
 endif
+r = to_octave_type (ocl_randi ([2 9], 1000, 3, typestr(5:end)));
+assert (size (r), [1000 3])
+assert (all (r(:) >= 2) && all (r(:) <= 9))
+assert (all (r(:) == round (r(:))))
+if typefloat
+ocl_rand ("seed", 42);
+r1 = to_octave_type (ocl_rand (300, 7, typestr(5:end)));
+r2 = to_octave_type (ocl_randn ([300 7], typestr(5:end)));
+ocl_rand ("seed", 42);
+assert (to_octave_type (ocl_rand (300, 7, typestr(5:end))), r1)
+assert (to_octave_type (ocl_randn (300, 7, typestr(5:end))), r2)
+assert (ocl_rand ("seed"), uint64 (42))
+assert (all (r1(:) > 0) && all (r1(:) < 1))
+assert (abs (mean (r1(:)) - 0.5) < 0.05)
+assert (abs (mean (r2(:))) < 0.1)
+assert (abs (std (r2(:)) - 1) < 0.1)
+endif
 
 if typefloat
 a = to_ocl_type (zeros ([4 5]));
@@ -225,6 +263,10 @@ assert (class (help ("ocl_zeros")), "char") # test for help string
 assert (class (help ("ocl_eye")), "char") # test for help string
 assert (class (help ("ocl_linspace")), "char") # test for help string
 assert (class (help ("ocl_logspace")), "char") # test for help string
+assert (class (help ("ocl_rand")), "char") # test for help string
+assert (class (help ("ocl_randn")), "char") # test for help string
+assert (class (help ("ocl_randi")), "char") # test for help string
+assert (class (help ("ocl_sparse")), "char") # test for help string
 
 ## --------- utility function tests ---------
 
@@ -490,9 +532,28 @@ assert (to_octave_type (c), c2)
 
 a = a0; a2 = a20;
 
-a(a < 15) = 0; a2(a2 < 15) = 0;  # only logically indexed assignment with scalar allowed, no other logical indexing
+assert (to_octave_type (a(a < 15)), a2(a2 < 15))
+ar = a(:)'; ar2 = a2(:)';
+assert (to_octave_type (ar(ar < 15)), ar2(ar2 < 15))
+assert (to_octave_type (a(a > 1e3)), a2(a2 > 1e3))
+assert (size (ar(ar != ar)), size (ar2(ar2 != ar2)))
+
+a(a < 15) = 0; a2(a2 < 15) = 0;  # logically indexed assignment only with scalar
 assert (to_octave_type (a), a2)
 
+## assignment beyond the end resizes along the last dimension
+g = c(:); g2 = c2(:); h = c(1:3); h2 = c2(1:3);
+for k = 1:5
+  g(end+1:end+3) = h; g2(end+1:end+3) = h2;
+endfor
+g(end+1) = to_octave_type (j); g2(end+1) = j;
+assert (to_octave_type (g), g2)
+g = a; g2 = a2;
+g(:,end+1) = a(:,1); g2(:,end+1) = a2(:,1);
+assert (to_octave_type (g), g2)
+assert (to_octave_type (resize (c(:), [numel(c)+2, 1])), resize (c2(:), [numel(c2)+2, 1]))
+assert (to_octave_type (resize (g(:,1:2), [3 4])), resize (g2(:,1:2), [3 4]))
+
 endfor # complex_iter
 
 ## --------- operator tests ---------
@@ -516,6 +577,45 @@ assert (to_octave_type (-d), -to_octave_type (d))
 endif
 assert (to_octave_type (d.'), to_octave_type (d).')
 assert (to_octave_type (d'), to_octave_type (d)')
+e0 = to_octave_type (reshape (rem (0:(45*70*3-1), 11), 45, 70, 3) + j);
+e = to_ocl_type (e0);
+assert (to_octave_type (e(:,:,2).'), e0(:,:,2).')
+assert (to_octave_type (e(:,:,2)'), e0(:,:,2)')
+assert (to_octave_type (pagetranspose (e)), permute (e0, [2 1 3]))
+assert (to_octave_type (pagectranspose (e)), conj (permute (e0, [2 1 3])))
+assert (to_octave_type (permute (e, [3 1 2])), permute (e0, [3 1 2]))
+assert (to_octave_type (permute (e, [2 1 4 3])), permute (e0, [2 1 4 3]))
+assert (to_octave_type (ipermute (permute (e, [2 3 1]), [2 3 1])), e0)
+assert (to_octave_type (circshift (e, 7)), circshift (e0, 7))
+assert (to_octave_type (circshift (e, [-2 5 1])), circshift (e0, [-2 5 1]))
+assert (to_octave_type (circshift (e, 4, 2)), circshift (e0, 4, 2))
+assert (to_octave_type (flip (e)), flip (e0))
+assert (to_octave_type (flip (e, 3)), flip (e0, 3))
+assert (to_octave_type (fliplr (e(:,:,1))), fliplr (e0(:,:,1)))
+assert (to_octave_type (rot90 (e)), rot90 (e0))
+assert (to_octave_type (rot90 (e, 2)), rot90 (e0, 2))
+assert (to_octave_type (rot90 (e, -1)), rot90 (e0, -1))
+if ! typeuint
+assert (to_octave_type (diff (e)), diff (e0))
+assert (to_octave_type (diff (e, 2, 2)), diff (e0, 2, 2))
+assert (to_octave_type (diff (e, [], 3)), diff (e0, [], 3))
+endif
+subs0 = rem (0:299, 17).' + 1;
+subs2 = [rem(0:299, 5).' + 1, rem(0:299, 4).' + 1];
+v0 = to_octave_type (rem (0:299, 7).' + 2 * j);
+v = to_ocl_type (v0);
+assert (double (to_octave_type (accumarray (to_ocl_type (subs0), v))), accumarray (subs0, double (v0)))
+assert (double (to_octave_type (accumarray (subs0 * 300, v))), accumarray (subs0 * 300, double (v0)))
+assert (double (to_octave_type (accumarray (subs2, v))), accumarray (subs2, double (v0)))
+assert (double (to_octave_type (accumarray (as_index (to_ocl_type (subs0)), v, [20 1]))), accumarray (subs0, double (v0), [20 1]))
+assert (double (to_octave_type (accumarray (to_ocl_type (subs0), 1))), accumarray (subs0, 1))
+if j == 0
+assert (double (to_octave_type (accumarray (subs0, v, [20 1], @max, 3))), accumarray (subs0, double (v0), [20 1], @max, 3))
+assert (double (to_octave_type (accumarray (subs0, v, [], @min))), accumarray (subs0, double (v0), [], @min))
+assert (double (histc (e, [0 2 5 10])), histc (double (e0), [0 2 5 10]))
+assert (double (histc (e, [1 3 4], 3)), histc (double (e0), [1 3 4], 3))
+assert (double (histc (to_ocl_type (ones (1, 300)), [0 2])), [300 0]) # exact counts for all classes
+endif
 d++;
 assert (to_octave_type (d), to_octave_type (d0)+1)
 d--;
@@ -579,6 +679,129 @@ assert (to_octave_type ((d.*s0) ./ s0), to_octave_type (d.*s0) ./ s0)
 endif
 if typefloat
 assert (to_octave_type (d * e), to_octave_type (d) * to_octave_type (e))
+assert (double (to_octave_type (d' * e)), double (to_octave_type (d)' * to_octave_type (e)), tol)
+assert (double (to_octave_type (d * e')), double (to_octave_type (d) * to_octave_type (e)'), tol)
+assert (double (to_octave_type (d.' * e)), double (to_octave_type (d).' * to_octave_type (e)), tol)
+assert (double (to_octave_type (d' * d)), double (to_octave_type (d)' * to_octave_type (d)), tol)
+assert (double (to_octave_type (d * d')), double (to_octave_type (d) * to_octave_type (d)'), tol)
+p0 = to_octave_type (reshape (rem (0:(4*5*6-1), 7), 4, 5, 6) + j);
+q0 = to_octave_type (reshape (rem (0:(5*3-1), 5), 5, 3) - j);
+r0 = zeros (4, 3, 6, class (p0));
+for k = 1:6
+  r0(:,:,k) = p0(:,:,k) * q0;
+endfor
+assert (double (to_octave_type (pagemtimes (to_ocl_type (p0), to_ocl_type (q0)))), double (r0), tol)
+assert (double (to_octave_type (pagemtimes (to_ocl_type (q0), "ctranspose", to_ocl_type (p0), "ctranspose"))), double (conj (permute (r0, [2 1 3]))), tol)
+f0 = to_octave_type (reshape (rem (0:(12*11*2-1), 9), 12, 11, 2) + j);
+f = to_ocl_type (f0);
+ftol = 100 * eps (typestr(5:end)) * numel (f0) * max (abs (f0(:))); # absolute, the spectrum has zeros
+assert (double (to_octave_type (fft (f))), double (fft (f0)), ftol)
+assert (double (to_octave_type (fft (f, [], 2))), double (fft (f0, [], 2)), ftol)
+assert (double (to_octave_type (fft (f, 14, 3))), double (fft (f0, 14, 3)), ftol)
+assert (double (to_octave_type (ifft (f, 7))), double (ifft (f0, 7)), ftol)
+assert (double (to_octave_type (fft2 (f))), double (fft2 (f0)), ftol)
+assert (double (to_octave_type (ifft2 (fft2 (f)))), double (f0), ftol)
+S0 = sparse ([1 2 4 4 3 1], [1 3 2 5 5 4], [2 -1 3 4 5 1] + j, 4, 5);
+S = ocl_sparse (S0, typestr(5:end));
+x0 = to_octave_type (reshape (rem (0:14, 4), 5, 3) - j);
+y0 = to_octave_type (reshape (rem (0:11, 5), 4, 3) + j);
+assert (size (S), [4 5])
+assert (nnz (S), 6)
+assert (sparse (S), sparse (double (to_octave_type (full (S0)))))
+assert (double (to_octave_type (S * to_ocl_type (x0))), double (S0 * double (x0)), tol)
+assert (double (to_octave_type (S.' * to_ocl_type (y0))), double (S0.' * double (y0)), tol)
+assert (double (to_octave_type (S' * to_ocl_type (y0))), double (S0' * double (y0)), tol)
+assert (double (to_octave_type (to_ocl_type (y0') * S)), double (double (y0') * S0), tol)
+Sr = ocl_sparse (real (S0), typestr(5:end)); # real sparse with complex dense
+xc0 = to_octave_type (reshape (rem (0:14, 4), 5, 3) - sqrt (-1));
+yc0 = to_octave_type (reshape (rem (0:11, 5), 4, 3) + sqrt (-1));
+assert (double (to_octave_type (Sr * to_ocl_type (xc0))), double (real (S0) * double (xc0)), tol)
+assert (double (to_octave_type (to_ocl_type (yc0') * Sr)), double (double (yc0') * real (S0)), tol)
+v0 = to_octave_type (rem (0:199, 9).' - 4 + j);
+w0 = to_octave_type (rem (0:299, 7) - 3 - j);
+k0 = to_octave_type ([1 -2 3 j]);
+v = to_ocl_type (v0);
+ctol = 100 * eps (typestr(5:end)) * 300 * 9 * 7; # absolute
+assert (double (to_octave_type (conv (v, to_ocl_type (k0)))), double (conv (v0, k0)), ctol)
+assert (double (to_octave_type (conv (to_ocl_type (k0), v, "same"))), double (conv (k0, v0, "same")), ctol)
+assert (double (to_octave_type (conv (v, to_ocl_type (k0), "valid"))), double (conv (v0, k0, "valid")), ctol)
+assert (double (to_octave_type (conv (v, to_ocl_type (w0)))), double (conv (v0, w0)), ctol)
+A0 = to_octave_type (reshape (rem (0:(20*17-1), 6), 20, 17) - j);
+A = to_ocl_type (A0);
+K0 = to_octave_type ([1 2 0; -1 j 3; 0 1 1]);
+K1 = to_octave_type ([1; 2; 1] * [1 0 -1]);
+K2 = to_octave_type (reshape (rem (0:143, 5), 12, 12) - 2 + j * eye (12));
+assert (double (to_octave_type (conv2 (A, to_ocl_type (K0)))), double (conv2 (A0, K0)), ctol)
+assert (double (to_octave_type (conv2 (A, to_ocl_type (K0), "same"))), double (conv2 (A0, K0, "same")), ctol)
+assert (double (to_octave_type (conv2 (A, to_ocl_type (K1), "valid"))), double (conv2 (A0, K1, "valid")), ctol)
+assert (double (to_octave_type (conv2 (to_ocl_type (k0), to_ocl_type (k0(1:3)), A))), double (conv2 (k0, k0(1:3), A0)), ctol)
+assert (double (to_octave_type (conv2 (A, to_ocl_type (K2), "same"))), double (conv2 (A0, K2, "same")), ctol)
+b0 = to_octave_type ([1 0.5 j]);
+a0 = to_octave_type ([2 -1 0.5]);
+x0 = to_octave_type (reshape (rem (0:1499, 13), 300, 5).' - 6 + j);
+assert (double (to_octave_type (filter (b0, a0, v))), double (filter (b0, a0, v0)), ctol)
+assert (double (to_octave_type (filter (b0, a0, to_ocl_type (x0), [], 2))), double (filter (b0, a0, x0, [], 2)), ctol)
+x = to_ocl_type (x0);
+t0 = to_octave_type (cumsum (rem (0:299, 7) + 1) / 8);
+assert (double (to_octave_type (trapz (x))), double (trapz (x0)), ctol)
+assert (double (to_octave_type (trapz (x, 2))), double (trapz (x0, 2)), ctol)
+assert (double (to_octave_type (trapz (t0, x, 2))), double (trapz (t0, x0, 2)), ctol)
+assert (double (to_octave_type (cumtrapz (v))), double (cumtrapz (v0)), ctol)
+assert (double (to_octave_type (cumtrapz (t0, x, 2))), double (cumtrapz (t0, x0, 2)), ctol)
+assert (double (to_octave_type (gradient (v, 0.5))), double (gradient (v0, 0.5)), ctol)
+[gx, gy] = gradient (x, 2, 0.25);
+[gx0, gy0] = gradient (x0, 2, 0.25);
+assert (double (to_octave_type (gx)), double (gx0), ctol)
+assert (double (to_octave_type (gy)), double (gy0), ctol)
+M0 = to_octave_type (reshape (rem (0:4899, 11), 70, 70) - 5 + 70 * eye (70) + j);
+r0 = to_octave_type (reshape (rem (0:209, 9), 70, 3) - 4 - j);
+M = to_ocl_type (M0);
+r = to_ocl_type (r0);
+ltol = 1000 * eps (typestr(5:end)) * 70; # absolute
+assert (double (to_octave_type (M \ r)), double (M0 \ r0), ltol)
+[L, U, P] = lu (M);
+assert (double (to_octave_type (P' * L * U)), double (M0), 70 * ltol)
+[L, U] = lu (M);
+assert (double (to_octave_type (L * U)), double (M0), 70 * ltol)
+[L, U, p] = lu (M, "vector");
+assert (double (to_octave_type (L * U)), double (M0(p,:)), 70 * ltol)
+N0 = M0(70:-1:1,:); # every column needs a row interchange
+N = to_ocl_type (N0);
+[L, U, p] = lu (N, "vector");
+[L0, U0, p0] = lu (N0, "vector");
+assert (p, p0)
+assert (double (to_octave_type (L)), double (L0), 70 * ltol)
+assert (double (to_octave_type (U)), double (U0), 70 * ltol)
+[L, U, P] = lu (N);
+P0 = eye (70)(p0,:);
+assert (real (double (to_octave_type (P))), P0)
+[L, U] = lu (N);
+assert (double (to_octave_type (L)), double (P0' * L0), 70 * ltol)
+assert (double (to_octave_type (L * U)), double (N0), 70 * ltol)
+[L, U, p] = lu (to_ocl_type (N0(:,1:40)), "vector"); # tall
+assert (size (L), [70 40])
+assert (size (U), [40 40])
+assert (double (to_octave_type (L * U)), double (N0(p,1:40)), 70 * ltol)
+[L, U] = lu (to_ocl_type (N0(31:70,:))); # wide
+assert (size (L), [40 40])
+assert (size (U), [40 70])
+assert (double (to_octave_type (L * U)), double (N0(31:70,:)), 70 * ltol)
+assert (double (to_octave_type (chol (M' * M))), double (chol (M0' * M0)), 70 * ltol)
+[R, p] = chol (to_ocl_type (to_octave_type (-eye (5))));
+assert (p, 1)
+assert (size (R), [0 0])
+[R, p] = chol (to_ocl_type (to_octave_type (diag ([4 9 -1 1 1]))));
+assert (p, 3)
+assert (double (to_octave_type (R)), [2 0; 0 3], ltol)
+opts = struct ("UT", true);
+assert (double (to_octave_type (linsolve (to_ocl_type (triu (M0)), r, opts))), double (triu (M0) \ r0), ltol)
+opts.TRANSA = true;
+assert (double (to_octave_type (linsolve (to_ocl_type (triu (M0)), r, opts))), double (triu (M0)' \ r0), ltol)
+assert (double (histc (to_ocl_type (abs (x0)), (0:4999) / 4, 2)), histc (double (abs (x0)), (0:4999) / 4, 2))
+assert (double (ocl_chunked (x0, "sum", 333)), double (sum (x0(:))), ctol)
+assert (double (ocl_chunked (x0, "exp", 333)), double (exp (x0)), -50 * eps (typestr(5:end)))
+assert (double (ocl_chunked (x0, "times", exp (x0), 333)), double (x0 .* exp (x0)), -50 * eps (typestr(5:end)))
+assert (ocl_chunked (x0, "minus", x0 / 2, numel (x0) / 3 + 1), x0 - x0 / 2) # both staging buffers, short last chunk
 else # binary operator '*' not implemented for octave '[u]int* matrix' by '[u]int* matrix' operations
 assert (to_octave_type (d * e), to_octave_type (double (to_octave_type (d)) * double (to_octave_type (e))))
 endif
@@ -702,6 +925,17 @@ d = d0 * (s0*s0);
 d /= s0;
 assert (to_octave_type (d), to_octave_type (d0) * s0, tol)
 
+## longer arrays and slices (vectorized elements plus remaining elements)
+d = to_ocl_type (rem ((0:100)', 7) + j);
+e = d(3:end);
+e0 = to_octave_type (d)(3:end);
+assert (to_octave_type (e + e), e0 + e0)
+assert (to_octave_type (e .* s), e0 .* s)
+assert (real (to_octave_type (e < s0)), to_octave_type (e0 < s0))
+d(5:60) = s;
+e0 = to_octave_type (rem ((0:100)', 7) + j); e0(5:60) = s;
+assert (to_octave_type (d), e0)
+
 endfor # complex_iter
 
 ## --------- dimension-wise (math) tests ---------
@@ -769,6 +1003,18 @@ assert (to_octave_type (std (d, 0, 1)), to_octave_type (std (to_octave_type (d),
 assert (to_octave_type (std (d, 0, 2)), to_octave_type (std (to_octave_type (d), 0, 2)), tol * eps (typestr(5:end)))
 assert (to_octave_type (std (d, 1, 1)), to_octave_type (std (to_octave_type (d), 1, 1)), tol * eps (typestr(5:end)))
 assert (to_octave_type (std (d, 1, 2)), to_octave_type (std (to_octave_type (d), 1, 2)), tol * eps (typestr(5:end)))
+
+assert (to_octave_type (var (d)), to_octave_type (var (to_octave_type (d))), tol * eps (typestr(5:end)))
+assert (to_octave_type (var (d, 1, 2)), to_octave_type (var (to_octave_type (d), 1, 2)), tol * eps (typestr(5:end)))
+[v, m] = var (d, 0, 2);
+assert (to_octave_type (v), to_octave_type (var (to_octave_type (d), 0, 2)), tol * eps (typestr(5:end)))
+assert (to_octave_type (m), to_octave_type (mean (to_octave_type (d), 2)), tol * eps (typestr(5:end)))
+
+## large offset relative to the spread (cancellation in sum-of-squares formulas)
+e0 = 1000 + rem ((1:1000)', 9) + j;
+e = to_ocl_type (e0);
+assert (to_octave_type (var (e)), to_octave_type (var (to_octave_type (e))), -100 * eps (typestr(5:end)))
+assert (to_octave_type (std (e)), to_octave_type (std (to_octave_type (e))), -100 * eps (typestr(5:end)))
 endif
 
 assert (to_octave_type (cumsum (r)), to_octave_type (cumsum (to_octave_type (r))))
@@ -814,6 +1060,23 @@ assert (to_octave_type (int64 (findlast (d, 1))), to_octave_type ([4 4 4 4]))
 assert (to_octave_type (int64 (findlast (d, 2))), to_octave_type ([4 4 4 4]'))
 endif
 
+assert (int64 (find (r)), int64 (find (to_octave_type (r))))
+assert (int64 (find (c)), int64 (find (to_octave_type (c))))
+assert (int64 (find (d)), int64 (find (to_octave_type (d))))
+assert (int64 (find (d, 3)), int64 (find (to_octave_type (d), 3)))
+assert (int64 (find (d, 3, 'last')), int64 (find (to_octave_type (d), 3, 'last')))
+assert (nnz (d), nnz (to_octave_type (d)))
+e0 = to_octave_type (rem ((0:9999)', 7) == 3);
+e = to_ocl_type (e0);
+assert (int64 (find (e)), int64 (find (e0)))
+assert (int64 (find (e, 20, 'last')), int64 (find (e0, 20, 'last')))
+assert (nnz (e), nnz (e0))
+assert (size (find (ocl_zeros (1, 5, typestr(5:end)))), [1 0])
+assert (size (find (ocl_zeros (5, 1, typestr(5:end)))), [0 1])
+assert (size (find (ocl_zeros (4, 5, typestr(5:end)))), [0 1])
+assert (size (find (to_ocl_type ([]))), [0 0])
+assert (nnz (ocl_zeros (1, 5, typestr(5:end))), 0)
+
 assert (to_octave_type (max (r)), max (to_octave_type (r)))
 assert (to_octave_type (max (c)), max (to_octave_type (c)))
 assert (to_octave_type (max (d)), max (to_octave_type (d)))
@@ -862,6 +1125,26 @@ assert (to_octave_type (min (d, e)), min (to_octave_type (d), to_octave_type (e)
 assert (to_octave_type (min (d, s)), min (to_octave_type (d), s))
 assert (to_octave_type (min (s, d)), min (s, to_octave_type (d)))
 
+## long slices (several work-groups per slice), ties go to the first occurrence
+e0 = to_octave_type (rem ((0:9999)', 97) + j);
+e = to_ocl_type (e0);
+[v, i] = max (e); [vo, io] = max (e0);
+assert (to_octave_type (v), vo)
+assert (int64 (i), int64 (io))
+[v, i] = min (e); [vo, io] = min (e0);
+assert (to_octave_type (v), vo)
+assert (int64 (i), int64 (io))
+[v, i] = max (reshape (e, 100, 100), [], 2); [vo, io] = max (reshape (e0, 100, 100), [], 2);
+assert (to_octave_type (v), vo)
+assert (int64 (i), int64 (io))
+if typefloat
+e0(5000) = NaN;
+e = to_ocl_type (e0);
+[v, i] = max (e); [vo, io] = max (e0);
+assert (to_octave_type (v), vo)
+assert (int64 (i), int64 (io))
+endif
+
 assert (to_octave_type (cummax (r)), cummax (to_octave_type (r)))
 assert (to_octave_type (cummax (c)), cummax (to_octave_type (c)))
 assert (to_octave_type (cummax (d)), cummax (to_octave_type (d)))
@@ -1124,24 +1407,177 @@ b = prog (0, 4, { [4 1]; "single" }, a(:,3), uint64 (0), a(:,4), uint64 (0));
 assert (single (b), single (a(:,3)) + single (a(:,4)))
 
 
-# dummy saving and loading tests
-# The OCL saving and loading dummy functionality is there ONLY in order not break
-# when saving / loading workspaces which also contain OCL variables (including core dumps).
-# Contained OCL data is not saved, however, since it is always context dependent.
-# OCL matrix data should be transfered to octave by 'ocl_to_octave' before saving.
+# spilling of least recently used OCL arrays to host memory
+old_budget = __ocl_memmgr__ ("budget");
+st0 = __ocl_memmgr__ ("spillstats");
+n = 10000;
+__ocl_memmgr__ ("budget", 3 * 4 * n, 0);
+x = cell (1, 6);
+for k = 1:6
+  x{k} = ocl_single (k * ones (n, 1));
+endfor
+st = __ocl_memmgr__ ("spillstats");
+assert (st.spills > st0.spills)
+assert (st.spilled_bytes > 0)
+for k = 1:6
+  assert (single (x{k} + 1), single ((k + 1) * ones (n, 1)))
+endfor
+st = __ocl_memmgr__ ("spillstats");
+assert (st.page_ins > st0.page_ins)
+## arguments already bound stay on the device while make_unique copies the next ones
+y = x{2};
+b = prog (0, n, { [n 1]; "single" }, x{1}, uint64 (0), y, uint64 (0));
+assert (single (b), single (3 * ones (n, 1)))
+b = prog (0, n, { [n 1]; "single" }, y, uint64 (0), x{3}, uint64 (0));
+assert (single (b), single (5 * ones (n, 1)))
+clear x y b
+__ocl_memmgr__ ("budget", old_budget(1), old_budget(2));
+for sz = {-1, NaN, Inf}
+  failed = false;
+  try; __ocl_memmgr__ ("budget", sz{1}); catch; failed = true; end
+  assert (failed)
+endfor
+assert (__ocl_memmgr__ ("budget"), old_budget)
+
+
+# retention of pooled buffers when OCL arrays are freed
+test_pool_retention ();
+
+
+# reservation of retained buffers
+ocl_context ("clear");
+r = ocl_memory_plan ({[100 10], "single", 2; [50 1], "double complex"});
+assert (r.requested_bytes, 2 * 4000 + 800)
+assert (r.reserved_bytes, r.requested_bytes)
+assert (r.fragmentation, 0) # the pool only holds the planned buffers
+st0 = __ocl_memmgr__ ("poolstats");
+assert (st0.reserved_bytes >= r.reserved_bytes)
+for k = 1:3
+  y = ocl_single (k * ones (100, 10));
+  z = y .* y;
+  clear y z
+endfor
+st = __ocl_memmgr__ ("poolstats");
+assert (st.misses, st0.misses)
+__ocl_memmgr__ ("trim");
+st = __ocl_memmgr__ ("poolstats");
+assert (st.pooled_bytes >= r.reserved_bytes)
+__ocl_memmgr__ ("reserve", []);
+assert (__ocl_memmgr__ ("trim"), 0)
+for sz = {-1, NaN, Inf, 0.5}
+  failed = false;
+  try; __ocl_memmgr__ ("reserve", sz{1}); catch; failed = true; end
+  assert (failed)
+endfor
+
+
+# memory usage accounting
+u0 = ocl_context ("memory_usage");
+y = ocl_int16 (ones (300, 1));
+z = ocl_single (ones (10, 10) * i);
+u = ocl_context ("memory_usage");
+assert (u.live_objects - u0.live_objects, 2)
+assert (u.live_bytes - u0.live_bytes, 600 + 800)
+assert (any (strcmp ({u.by_type.type}, "int16")))
+assert (any (strcmp ({u.by_type.type}, "single complex")))
+assert (any (u.by_size(:,1) == 512))
+assert (u.peak_bytes >= u.device_bytes + u.pooled_bytes)
+assert (u.global_mem_size > 0)
+clear y z
+ocl_context ("memory_usage", "reset");
+u = ocl_context ("memory_usage");
+assert (u.live_bytes, u0.live_bytes)
+assert (u.peak_bytes, u.device_bytes + u.pooled_bytes)
+
+# constant arrays are virtual until used on the device
+y = ocl_zeros (1000, 100) + 2;
+z = ocl_eye (500, "single");
+w = ocl_linspace (0, 1, 1000);
+u = ocl_context ("memory_usage");
+assert (u.live_bytes, u0.live_bytes)
+assert (double (y), 2 * ones (1000, 100))
+assert (single (z), eye (500, "single"))
+assert (double (w(end-1:end)), [998/999 1], 1e-15)
+u = ocl_context ("memory_usage");
+assert (u.live_bytes, u0.live_bytes)
+assert (single (sum (z)), ones (1, 500, "single"))
+u = ocl_context ("memory_usage");
+assert (u.live_bytes, u0.live_bytes + 500 * 500 * 4)
+clear y z w
+# single precision ramps are read back as generated by the device
+w = ocl_linspace (single (0), single (1), 999);
+w1 = single (w); # virtual
+w2 = single (w + single (0)); # materialized by the addition
+assert (w1, w2)
+assert (single (w(500)), w2(500))
+clear w
+
+# the cache of fft plans (chirp filters for lengths with large prime factors)
+old_fftcache = __ocl_memmgr__ ("fftcache");
+y = fft (ocl_single (complex (ones (13, 1))));
+c = __ocl_memmgr__ ("fftcache");
+assert (c(1) > 0)
+__ocl_memmgr__ ("fftcache", 0); # drops all plans
+c = __ocl_memmgr__ ("fftcache");
+assert (c, [0 0])
+__ocl_memmgr__ ("fftcache", old_fftcache(2));
+y = fft (ocl_single (complex (ones (13, 1))));
+ocl_context ("clear");
+c = __ocl_memmgr__ ("fftcache");
+assert (c(1), 0)
+assert (single (y), fft (complex (ones (13, 1, "single"))), 1e-5)
+clear y
+
+
+# saving and loading tests
+# OCL matrices are saved with their data, and uploaded into the current context on loading.
 # Before loading, the OCL package must be loaded (by 'pkg load ocl') nevertheless.
 
-warning ("off", "Ocl:matrix_save", "local"); # for testing here, switch off the warnings
+sv_a = ocl_single (reshape (1:24, 2, 3, 4));
+sv_b = ocl_int16 ([-3 7; 11 0]);
+sv_c = ocl_single (complex (1:3, -(1:3)));
+sv_e = ocl_single (zeros (0, 3));
+sv_s = ocl_uint8 (200);
 tmpfile = tempname ();
-save ("-text", tmpfile);
-load ("-text", tmpfile);
-save ("-binary", tmpfile);
-load ("-binary", tmpfile);
+formats = {"-text", "-binary"};
 hdf = 1; try; save ("-hdf5", tmpfile, "hdf"); catch; hdf = 0; end
 if hdf
-save ("-hdf5", tmpfile);
-load ("-hdf5", tmpfile);
+formats{end+1} = "-hdf5";
 endif # if hdf
+for lazy = [false, true]
+__ocl_memmgr__ ("lazyload", lazy);
+for f = 1:numel (formats)
+save (formats{f}, tmpfile, "sv_a", "sv_b", "sv_c", "sv_e", "sv_s");
+sv = load (formats{f}, tmpfile);
+assert (class (sv.sv_a), "ocl_single")
+assert (class (sv.sv_b), "ocl_int16")
+assert (class (sv.sv_s), "ocl_uint8")
+assert (single (sv.sv_a), single (sv_a))
+assert (int16 (sv.sv_b), int16 (sv_b))
+assert (single (sv.sv_c), single (sv_c))
+assert (size (sv.sv_e), [0 3])
+assert (uint8 (sv.sv_s), uint8 (200))
+assert (single (sv.sv_a + 1), single (sv_a) + 1)
+endfor
+endfor
+__ocl_memmgr__ ("lazyload", false);
+try; unlink (tmpfile); catch; end
+clear sv sv_a sv_b sv_c sv_e sv_s
+
+# raw binary file transfer
+tmpfile = tempname ();
+r0 = single (reshape (1:600, 20, 30));
+assert (ocl_fwrite (tmpfile, ocl_single (r0)), 600)
+assert (single (ocl_fread (tmpfile, [20 Inf], "single")), r0)
+assert (single (ocl_fread (tmpfile, 10, "single", 4 * 7)), r0(8:17)')
+ocl_fwrite (tmpfile, ocl_int16 ([1 -2 3]), "append");
+assert (int16 (ocl_fread (tmpfile, Inf, "int16", 2400)), int16 ([1 -2 3])')
+fid = fopen (tmpfile); r1 = fread (fid, [20 30], "single=>single"); fclose (fid);
+assert (r1, r0)
+failed = false;
+try; ocl_fwrite (tmpfile, 5); catch; failed = true; end
+assert (failed)
+assert (single (ocl_fread (tmpfile, [20 30], "single")), r0) # file left intact
 try; unlink (tmpfile); catch; end
 
 
@@ -1153,4 +1589,65 @@ ret = 1;
 
 endfunction
 
+
+## Pool retention: the buffer of the OCL array of each iteration is reused,
+## whether or not it was the last live one, and trimmed by the idle hook
+## and by ocl_context ("clear").
+
+function test_pool_retention ()
+
+## only counts buffers of the size used here, whatever other OCL arrays
+## (or cached data) are live
+n = 1000;
+nbytes = 4 * n;
+old_retain = __ocl_memmgr__ ("retain");
+__ocl_memmgr__ ("retain", 2^20, 0);
+st0 = __ocl_memmgr__ ("poolstats");
+for k = 1:5
+  y = ocl_single (k * ones (n, 1));
+  assert (single (y), single (k * ones (n, 1)))
+  clear y
+  assert (pooled_buffers (nbytes) >= 1)
+endfor
+st = __ocl_memmgr__ ("poolstats");
+assert (st.hits - st0.hits >= 4)
+__ocl_memmgr__ ("trim");
+assert (pooled_buffers (nbytes), 0)
+
+## buffers not reused for the idle time are released by the idle hook
+__ocl_memmgr__ ("retain", 2^20, 1);
+y = ocl_single (ones (n, 1));
+clear y
+assert (pooled_buffers (nbytes) >= 1)
+pause (1.5);
+__ocl_memmgr__ ("idle"); # as called by octave while waiting for input
+assert (pooled_buffers (nbytes), 0)
+
+## ocl_context ("clear") releases them at once
+y = ocl_single (ones (n, 1));
+clear y
+assert (pooled_buffers (nbytes) >= 1)
+ocl_context ("clear");
+assert (pooled_buffers (nbytes), 0)
+
+for v = {-1, NaN, Inf}
+  failed = false;
+  try; __ocl_memmgr__ ("retain", v{1}); catch; failed = true; end
+  assert (failed)
+  failed = false;
+  try; __ocl_memmgr__ ("trim", v{1}); catch; failed = true; end
+  assert (failed)
+endfor
+__ocl_memmgr__ ("retain", old_retain(1), old_retain(2));
+
+endfunction
+
+
+function count = pooled_buffers (nbytes)
+
+m = __ocl_memmgr__ ("numobjs");
+count = sum (m(m(:,1) == nbytes, 2));
+
+endfunction
+
 %!assert (ocl_tests ())
@@ -34,13 +34,16 @@
 ##
 ## For an explanation of OCL matrices, see @code{ocl_double}.
 ##
+## An OCL sparse matrix (see @code{ocl_sparse}) is transferred into an
+## octave sparse matrix.
+##
 ## For compatibility with MATLAB, the @code{gather} function is an alias
 ## to @code{ocl_to_octave}.
 ##
 ## @seealso{oclArray, ocl_double, ocl_single,
 ## ocl_int8, ocl_int16, ocl_int32, ocl_int64,
 ## ocl_uint8, ocl_uint16, ocl_uint32, ocl_uint64,
-## gpuArray, gather}
+## ocl_sparse, gpuArray, gather}
 ## @end deftypefn
 
 function ret = ocl_to_octave (ocl_array)
@@ -70,6 +73,9 @@ function ret = ocl_to_octave (ocl_array)
       ret = uint32 (ocl_array);
     case {"ocl uint64 matrix"}
       ret = uint64 (ocl_array);
+    case {"ocl sparse matrix", "ocl complex sparse matrix", ...
+          "ocl float sparse matrix", "ocl float complex sparse matrix"}
+      ret = sparse (ocl_array);
     otherwise
       error ("invalid argument type");
   endswitch
@@ -88,3 +94,5 @@ endfunction
 %!assert (typeinfo (ocl_to_octave (ocl_uint16 ([0 0]))), "uint16 matrix");
 %!assert (typeinfo (ocl_to_octave (ocl_uint32 ([0 0]))), "uint32 matrix");
 %!assert (typeinfo (ocl_to_octave (ocl_uint64 ([0 0]))), "uint64 matrix");
+%!assert (typeinfo (ocl_to_octave (ocl_sparse (speye (2)))), "sparse matrix");
+%!assert (typeinfo (ocl_to_octave (ocl_sparse (speye (2) * i))), "sparse complex matrix");
@@ -35,6 +35,12 @@
 #include "ocl_array_prog.h"
 #include "ocl_memobj.h"
 #include <Array-util.h>
+#include <sstream>
+#include <algorithm>
+#include <limits>
+#include <map>
+#include <ctime>
+#include <byte-swap.h>
 
 
 
@@ -46,6 +52,7 @@
   template <> std::string OclArray<T>::type_str_oclc = #OCLC_STR; \
   template <> OclProgram OclArray<T>::array_prog = OclProgram (); \
   template <> std::vector<int> OclArray<T>::kernel_indices  = std::vector<int> (); \
+  template <> int OclArray<T>::array_prog_vector_width = 1; \
   template <> bool OclArray<T>::is_integer_type (void) { return IS_INTEGER; } \
   template <> bool OclArray<T>::is_uint_type (void) { return IS_UINT; } \
   template <> bool OclArray<T>::is_complex_type (void) { return IS_COMPLEX; }
@@ -67,6 +74,126 @@ SPECIALIZE_OCLARRAY (Complex,        double,  double2,  false,  false,  true  );
 
 
 
+// ---------- static helper functions
+
+
+// Vector width for the elementwise kernels of the array program: at least
+// 16 bytes per vector load/store, or the device's preferred vector width if
+// that is larger (e.g., on CPU runtimes with 256-bit or 512-bit SIMD units).
+static
+int
+elementwise_vector_width (const std::string& oclc_type, size_t type_size)
+{
+  std::string t = oclc_type;
+  if ((t.length () > 1) && (t [0] == 'u'))
+    t = t.substr (1); // unsigned types share the preference of their signed type
+
+  cl_device_info prop;
+  if      (t == "char")   prop = CL_DEVICE_PREFERRED_VECTOR_WIDTH_CHAR;
+  else if (t == "short")  prop = CL_DEVICE_PREFERRED_VECTOR_WIDTH_SHORT;
+  else if (t == "int")    prop = CL_DEVICE_PREFERRED_VECTOR_WIDTH_INT;
+  else if (t == "long")   prop = CL_DEVICE_PREFERRED_VECTOR_WIDTH_LONG;
+  else if (t == "float")  prop = CL_DEVICE_PREFERRED_VECTOR_WIDTH_FLOAT;
+  else if (t == "double") prop = CL_DEVICE_PREFERRED_VECTOR_WIDTH_DOUBLE;
+  else
+    return 1;
+
+  cl_uint preferred = 0;
+  if (clGetDeviceInfo (get_device_id (), prop, sizeof (cl_uint), & preferred, 0) != CL_SUCCESS)
+    preferred = 0;
+
+  int vw = 16 / type_size;
+  while ((vw < (int) preferred) && (vw < 16))
+    vw *= 2;
+
+  return std::max (std::min (vw, 16), 2);
+}
+
+
+// Whether the device of the current context supports an OpenCL extension.
+static
+bool
+device_has_extension (const std::string& name)
+{
+  size_t len = 0;
+  if ((clGetDeviceInfo (get_device_id (), CL_DEVICE_EXTENSIONS, 0, 0, & len) != CL_SUCCESS) || (len == 0))
+    return false;
+
+  std::string ext (len, ' ');
+  if (clGetDeviceInfo (get_device_id (), CL_DEVICE_EXTENSIONS, len, & ext [0], 0) != CL_SUCCESS)
+    return false;
+
+  return ((" " + ext.substr (0, ext.find ('\0')) + " ").find (" " + name + " ") != std::string::npos);
+}
+
+
+// Tile size of the transpose kernels (TILE_DIM in the array program), and
+// the number of tile rows handled at once by a work-group.
+static const size_t transpose_tile_dim = 32;
+static const size_t transpose_block_rows = 8;
+
+// Local memory budget of the pagewise matrix multiply for staging the
+// operand pages; larger pages are read from global memory.
+static const size_t pagemtimes_local_bytes = 16384;
+
+// Upper limit of the work-items sharing one row of a sparse matrix in
+// the sparse times dense product.
+static const size_t csr_max_lanes = 32;
+
+// Convolution: kernels of up to conv_direct_max_taps elements are applied
+// directly, with the kernel and a source window (or, in 2 dims, a source
+// tile of up to conv2_tile_dim^2 outputs) staged in local memory.
+static const size_t conv_direct_max_taps = 128;
+static const size_t conv2_tile_dim = 16;
+static const size_t conv_local_bytes = 16384;
+
+// Recursive filters run in chunks of at least iir_min_chunk elements, for
+// about iir_target_items work-items over all slices.
+static const size_t iir_min_chunk = 64;
+static const size_t iir_target_items = 8192;
+
+// Dense linear algebra: width of the panels / diagonal blocks of the blocked
+// factorizations and triangular solves; the updates of the rest of the
+// matrix are products of blocks of this width.
+static const size_t linalg_block_size = 64;
+
+// Histograms and accumarray: bins (counts, or values) of up to
+// scatter_local_bytes are privatised in local memory per work-group;
+// beyond that, histc sorts the bin keys, and accumarray updates the
+// output in global memory.
+static const size_t scatter_local_bytes = 16384;
+
+// Concatenation: inputs of up to cat_gather_max_len elements are copied by
+// the gather kernel, cat_gather_inputs of them per launch (the number of
+// its source buffer arguments); larger inputs by a copy command each.
+static const size_t cat_gather_inputs = 8;
+static const size_t cat_gather_max_len = 65536;
+
+// Out-of-core streaming of host arrays: chunks of up to stream_chunk_bytes,
+// but at most half of the largest buffer, or an eighth of the global memory,
+// of the device (two chunks of each array are staged at a time).
+static const size_t stream_chunk_bytes = 64 << 20;
+
+
+// Default chunk length of the out-of-core streaming of host arrays.
+static
+octave_idx_type
+stream_chunk_length (size_t type_size)
+{
+  size_t bytes = stream_chunk_bytes;
+
+  cl_ulong max_alloc = 0, global_mem = 0;
+  if ((clGetDeviceInfo (get_device_id (), CL_DEVICE_MAX_MEM_ALLOC_SIZE, sizeof (cl_ulong), & max_alloc, 0) == CL_SUCCESS) &&
+      (max_alloc > 0))
+    bytes = std::min (bytes, static_cast<size_t> (max_alloc / 2));
+  if ((clGetDeviceInfo (get_device_id (), CL_DEVICE_GLOBAL_MEM_SIZE, sizeof (cl_ulong), & global_mem, 0) == CL_SUCCESS) &&
+      (global_mem > 0))
+    bytes = std::min (bytes, static_cast<size_t> (global_mem / 8));
+
+  return std::max (static_cast<octave_idx_type> (bytes / type_size), (octave_idx_type) 1);
+}
+
+
 // when expanding the OclArray members:
 // assure "rep->assure_valid ();" and "assure_valid_array_prog ();" with all modifying operations
 // assure all calculations include slice_ofs
@@ -88,6 +215,193 @@ ocl_array_inop_error (void)
 }
 
 
+// Random number streams (shared by all array types): the Philox key is the
+// seed, and the counter advances by the number of blocks every array takes.
+// Without an explicit seed, the key is taken from the clock on first use.
+
+static uint64_t rand_key = 0;
+static uint64_t rand_counter = 0;
+static bool rand_seeded = false;
+
+
+void
+ocl_rand_set_seed (uint64_t seed)
+{
+  rand_key = seed;
+  rand_counter = 0;
+  rand_seeded = true;
+}
+
+
+uint64_t
+ocl_rand_get_seed (void)
+{
+  if (! rand_seeded)
+    ocl_rand_set_seed (static_cast<uint64_t> (std::time (0)));
+  return rand_key;
+}
+
+
+// FFT plans: the Stockham radices of a transform length and, for lengths
+// with prime factors other than 2, 3, 5, 7 (Bluestein's algorithm), the
+// padded length m with its radices and the spectra of the chirp filters.
+// There is one cache per array type; it is cleared whenever the array
+// program is rebuilt (new OpenCL context / device), and by
+// ocl_array_clear_caches.  The filters (device memory) of each cache are
+// limited to fft_plan_cache_max_bytes, dropping least recently used plans.
+
+static size_t fft_plan_cache_max_bytes = 64 << 20;
+
+template <typename T>
+struct OclFftPlan
+{
+  std::vector<octave_idx_type> radices;
+  octave_idx_type m;
+  std::vector<octave_idx_type> m_radices;
+  OclArray<T> filter [2]; // forward, inverse
+  uint64_t last_use;
+};
+
+
+template <typename T>
+struct OclFftPlanCache
+{
+  OclFftPlanCache (void) : plans (), filter_bytes (0), num_filters (0), clock (0) { }
+
+  void clear (void) { plans.clear (); filter_bytes = 0; num_filters = 0; }
+
+  std::map<octave_idx_type, OclFftPlan<T> > plans;
+  size_t filter_bytes;
+  size_t num_filters;
+  uint64_t clock;
+};
+
+
+template <typename T>
+static
+OclFftPlanCache<T>&
+fft_plan_cache (void)
+{
+  static OclFftPlanCache<T> cache;
+  return cache;
+}
+
+
+// drop least recently used plans (but not that of length keep_n) while
+// the filters exceed fft_plan_cache_max_bytes
+template <typename T>
+static
+void
+fft_plan_cache_trim (octave_idx_type keep_n)
+{
+  OclFftPlanCache<T>& cache = fft_plan_cache<T> ();
+  typedef typename std::map<octave_idx_type, OclFftPlan<T> >::iterator plan_iterator;
+
+  while (cache.filter_bytes > fft_plan_cache_max_bytes) {
+    plan_iterator lru = cache.plans.end ();
+    for (plan_iterator it = cache.plans.begin (); it != cache.plans.end (); it++)
+      if ((it->first != keep_n) && ((it->second.filter [0].numel () > 0) || (it->second.filter [1].numel () > 0)) &&
+          ((lru == cache.plans.end ()) || (it->second.last_use < lru->second.last_use)))
+        lru = it;
+    if (lru == cache.plans.end ())
+      break;
+    for (int k = 0; k < 2; k++)
+      if (lru->second.filter [k].numel () > 0) {
+        cache.filter_bytes -= lru->second.filter [k].byte_size ();
+        cache.num_filters--;
+      }
+    cache.plans.erase (lru);
+  }
+}
+
+
+void
+ocl_array_clear_caches (void)
+{
+  fft_plan_cache<float> ().clear ();
+  fft_plan_cache<double> ().clear ();
+  fft_plan_cache<FloatComplex> ().clear ();
+  fft_plan_cache<Complex> ().clear ();
+}
+
+
+size_t
+ocl_array_cached_memobjs (void)
+{
+  return fft_plan_cache<float> ().num_filters + fft_plan_cache<double> ().num_filters +
+         fft_plan_cache<FloatComplex> ().num_filters + fft_plan_cache<Complex> ().num_filters;
+}
+
+
+size_t
+ocl_array_cached_bytes (void)
+{
+  return fft_plan_cache<float> ().filter_bytes + fft_plan_cache<double> ().filter_bytes +
+         fft_plan_cache<FloatComplex> ().filter_bytes + fft_plan_cache<Complex> ().filter_bytes;
+}
+
+
+void
+ocl_array_set_cache_limit (size_t max_bytes)
+{
+  fft_plan_cache_max_bytes = max_bytes;
+  fft_plan_cache_trim<float> (-1);
+  fft_plan_cache_trim<double> (-1);
+  fft_plan_cache_trim<FloatComplex> (-1);
+  fft_plan_cache_trim<Complex> (-1);
+}
+
+
+size_t
+ocl_array_cache_limit (void)
+{
+  return fft_plan_cache_max_bytes;
+}
+
+
+static
+bool
+fft_factorize (octave_idx_type n, std::vector<octave_idx_type>& radices)
+{
+  static const octave_idx_type fft_radices [] = { 4, 2, 3, 5, 7 };
+
+  radices.clear ();
+  for (int i = 0; i < 5; i++)
+    while ((n % fft_radices [i]) == 0) {
+      radices.push_back (fft_radices [i]);
+      n /= fft_radices [i];
+    }
+
+  return (n == 1);
+}
+
+
+template <typename T>
+static
+OclFftPlan<T>&
+fft_plan (octave_idx_type n)
+{
+  OclFftPlanCache<T>& cache = fft_plan_cache<T> ();
+  typename std::map<octave_idx_type, OclFftPlan<T> >::iterator it = cache.plans.find (n);
+  if (it != cache.plans.end ()) {
+    it->second.last_use = ++cache.clock;
+    return it->second;
+  }
+
+  OclFftPlan<T>& plan = cache.plans [n];
+  plan.last_use = ++cache.clock;
+  plan.m = 0;
+  if (! fft_factorize (n, plan.radices)) {
+    // smallest 7-smooth length for the linear convolution
+    plan.m = 2 * n - 1;
+    while (! fft_factorize (plan.m, plan.m_radices))
+      plan.m++;
+  }
+
+  return plan;
+}
+
+
 // ---------- OclArray<T>::OclArrayRep members
 
 
@@ -95,7 +409,11 @@ template <typename T>
 void *
 OclArray<T>::OclArrayRep::get_ocl_buffer (void) const
 {
-  return is_valid () ? memobj->get_ocl_buffer () : 0;
+  if (! is_valid ())
+    return 0;
+  if (virt != virt_none)
+    materialize ();
+  return memobj->get_ocl_buffer ();
 }
 
 
@@ -103,6 +421,8 @@ template <typename T>
 bool
 OclArray<T>::OclArrayRep::is_valid (void) const
 {
+  if (virt != virt_none)
+    return opencl_context_id_active (virt_ctx_id);
   return (memobj != 0) && (memobj->object_context_still_valid ());
 }
 
@@ -132,7 +452,156 @@ OclArray<T>::OclArrayRep::allocate (void)
   // only called from a constructor
   // we know: len > 0
   size_t size = len * sizeof (T);
-  memobj = new OclMemoryObject (size);
+  memobj = new OclMemoryObject (size, memobj_type_str ());
+}
+
+
+template <typename T>
+void
+OclArray<T>::OclArrayRep::allocate_lazy (const T *d)
+{
+  // only called from a constructor
+  // we know: len > 0
+  size_t size = len * sizeof (T);
+  memobj = new OclMemoryObject (size, d, memobj_type_str ());
+}
+
+
+template <typename T>
+void
+OclArray<T>::OclArrayRep::allocate_virtual (VirtualKind kind,
+                                            const T& v0,
+                                            const T& v1,
+                                            octave_idx_type nr)
+{
+  // only called from a constructor
+  // we know: len > 0
+  virt_ctx_id = assure_opencl_context ();
+  virt_val [0] = v0;
+  virt_val [1] = v1;
+  virt_nr = nr;
+  virt = kind;
+}
+
+
+template <typename T>
+bool
+OclArray<T>::OclArrayRep::copy_virtual (const OclArrayRep& a,
+                                        octave_idx_type slice_ofs_src)
+{
+  // only called from a constructor
+  // a constant stays virtual in any slice; the other formulas only as a whole
+  if ((a.virt == virt_none) ||
+      ((a.virt != virt_const) && ((slice_ofs_src != 0) || (len != a.len))))
+    return false;
+
+  virt_ctx_id = a.virt_ctx_id;
+  virt_val [0] = a.virt_val [0];
+  virt_val [1] = a.virt_val [1];
+  virt_nr = a.virt_nr;
+  virt = a.virt;
+  return true;
+}
+
+
+template <typename T>
+void
+OclArray<T>::OclArrayRep::materialize (void) const
+{
+  // allocate the OpenCL buffer of a virtual array and generate its contents;
+  // the array is an ordinary one from here on.
+  // This may happen while the caller is setting kernel arguments: holding
+  // the pins meanwhile keeps the arguments bound so far from being spilled,
+  // also by the allocation of a further virtual argument.
+  ocl_memobj_hold_pins (this);
+  memobj = new OclMemoryObject (len * sizeof (T), memobj_type_str ());
+  VirtualKind kind = virt;
+  virt = virt_none;
+
+  assure_valid_array_prog ();
+
+  const void *ocl_buffer = memobj->get_ocl_buffer ();
+  int kernel_index;
+
+  switch (kind) {
+    case virt_linspace:
+      kernel_index = kernel_indices [OclArrayKernels::linspace];
+      array_prog.set_kernel_arg (kernel_index, 0, ocl_buffer);
+      array_prog.set_kernel_arg (kernel_index, 1, virt_val [0]);
+      array_prog.set_kernel_arg (kernel_index, 2, virt_val [1]);
+      array_prog.set_kernel_arg (kernel_index, 3, octave_uint64 (len));
+      array_prog.enqueue_kernel (kernel_index, len);
+      break;
+    case virt_eye:
+      kernel_index = kernel_indices [OclArrayKernels::eye];
+      array_prog.set_kernel_arg (kernel_index, 0, ocl_buffer);
+      array_prog.set_kernel_arg (kernel_index, 1, octave_uint64 (virt_nr+1));
+      array_prog.set_kernel_arg (kernel_index, 2, octave_uint64 (virt_nr * virt_nr));
+      array_prog.enqueue_kernel (kernel_index, len);
+      break;
+    default: // virt_const
+      kernel_index = kernel_indices [OclArrayKernels::fill];
+      array_prog.set_kernel_arg (kernel_index, 0, ocl_buffer);
+      array_prog.set_kernel_arg (kernel_index, 1, octave_uint64 (0));
+      array_prog.set_kernel_arg (kernel_index, 2, virt_val [0]);
+      array_prog.set_kernel_arg (kernel_index, 3, octave_uint64 (len));
+      enqueue_elementwise_kernel (kernel_index, len);
+  }
+
+  ocl_memobj_release_pins (this, false);
+}
+
+
+template <typename T>
+bool
+OclArray<T>::OclArrayRep::is_host_evaluable (void) const
+{
+  // linear ramps only in double precision: the integer and complex
+  // arithmetic differs from the kernel's, and single precision division
+  // is not correctly rounded on all devices
+  return (virt != virt_linspace) ||
+         ! (is_integer_type () || is_complex_type () || (sizeof (T) == sizeof (float)));
+}
+
+
+template <typename T>
+T
+OclArray<T>::OclArrayRep::virtual_element (octave_idx_type i) const
+{
+  if (! is_host_evaluable ()) {
+    // generate the array on the device (by get_ocl_buffer) and read back the element
+    T val;
+    last_error = clEnqueueReadBuffer (get_command_queue (),
+                                      (cl_mem) get_ocl_buffer (),
+                                      CL_TRUE,
+                                      static_cast<size_t> (i) * sizeof (T),
+                                      sizeof (T),
+                                      &val,
+                                      0, 0, 0);
+    ocl_check_error ("clEnqueueReadBuffer");
+    ocl_memobj_release_pins ();
+    return val;
+  }
+
+  // the same formulas as the kernels in materialize
+  switch (virt) {
+    case virt_linspace:
+      return virt_val [0] + ((virt_val [1] - virt_val [0]) * T (i)) / T (len - 1);
+    case virt_eye:
+      return (((i % (virt_nr+1)) == 0) && (i < virt_nr * virt_nr)) ? T (1) : T (0);
+    default: // virt_const
+      return virt_val [0];
+  }
+}
+
+
+template <typename T>
+const char *
+OclArray<T>::OclArrayRep::memobj_type_str (void)
+{
+  // the element type name for the memory usage accounting
+  static const std::string type_str = type_str_oct + (is_complex_type () ? " complex" : "");
+  return type_str.c_str ();
 }
 
 
@@ -169,6 +638,7 @@ OclArray<T>::OclArrayRep::copy_from_oclbuffer (const OclArrayRep& a,
                                     size,
                                     0, 0, 0);
   ocl_check_error ("clEnqueueCopyBuffer");
+  ocl_memobj_release_pins ();
 }
 
 
@@ -176,7 +646,8 @@ template <typename T>
 void
 OclArray<T>::OclArrayRep::copy_from_host (const T *d_src,
                                           octave_idx_type slice_ofs,
-                                          octave_idx_type slice_len)
+                                          octave_idx_type slice_len,
+                                          bool blocking)
 {
   assure_valid ();
 
@@ -185,12 +656,13 @@ OclArray<T>::OclArrayRep::copy_from_host (const T *d_src,
 
   last_error = clEnqueueWriteBuffer (get_command_queue (),
                                      (cl_mem) get_ocl_buffer (),
-                                     CL_TRUE,
+                                     blocking ? CL_TRUE : CL_FALSE,
                                      offset,
                                      size,
                                      d_src,
                                      0, 0, 0);
   ocl_check_error ("clEnqueueWriteBuffer");
+  ocl_memobj_release_pins ();
 }
 
 
@@ -202,6 +674,14 @@ OclArray<T>::OclArrayRep::copy_to_host (T *d_dst,
 {
   assure_valid ();
 
+  // a virtual array is evaluated on the host, except for linear ramps
+  // other than double precision ones (see is_host_evaluable)
+  if ((virt != virt_none) && is_host_evaluable ()) {
+    for (octave_idx_type i = 0; i < slice_len; i++)
+      d_dst [i] = virtual_element (slice_ofs + i);
+    return;
+  }
+
   size_t offset = static_cast<size_t> (slice_ofs) * sizeof (T);
   size_t size = static_cast<size_t> (slice_len) * sizeof (T);
 
@@ -213,6 +693,7 @@ OclArray<T>::OclArrayRep::copy_to_host (T *d_dst,
                                     d_dst,
                                     0, 0, 0);
   ocl_check_error ("clEnqueueReadBuffer");
+  ocl_memobj_release_pins ();
 }
 
 
@@ -363,9 +844,11 @@ OclArray<T>::fill (octave_idx_type fill_ofs,
   int kernel_index = kernel_indices [OclArrayKernels::fill];
 
   array_prog.set_kernel_arg (kernel_index, 0, *this);
-  array_prog.set_kernel_arg (kernel_index, 1, val); // val already has correct type
+  array_prog.set_kernel_arg (kernel_index, 1, octave_uint64 (fill_ofs));
+  array_prog.set_kernel_arg (kernel_index, 2, val); // val already has correct type
+  array_prog.set_kernel_arg (kernel_index, 3, octave_uint64 (fill_len));
 
-  array_prog.enqueue_kernel (kernel_index, fill_len, fill_ofs);
+  enqueue_elementwise_kernel (kernel_index, fill_len);
 }
 
 
@@ -382,10 +865,12 @@ OclArray<T>::fill0 (octave_idx_type fill_ofs,
   int kernel_index = kernel_indices [OclArrayKernels::fill0];
 
   array_prog.set_kernel_arg (kernel_index, 0, *this);
-  array_prog.set_kernel_arg (kernel_index, 1, a);
-  array_prog.set_kernel_arg (kernel_index, 2, octave_uint64 (a.slice_ofs));
+  array_prog.set_kernel_arg (kernel_index, 1, octave_uint64 (fill_ofs));
+  array_prog.set_kernel_arg (kernel_index, 2, a);
+  array_prog.set_kernel_arg (kernel_index, 3, octave_uint64 (a.slice_ofs));
+  array_prog.set_kernel_arg (kernel_index, 4, octave_uint64 (fill_len));
 
-  array_prog.enqueue_kernel (kernel_index, fill_len, fill_ofs);
+  enqueue_elementwise_kernel (kernel_index, fill_len);
 }
 
 
@@ -508,65 +993,133 @@ template <typename T>
 OclArray<T>
 OclArray<T>::transpose (void) const
 {
-  rep->assure_valid ();
-  assure_valid_array_prog ();
-
   if (ndims () != 2)
     ocl_error ("OclArray::transpose: array has > 2 dimensions");
 
-  octave_idx_type nr = dim1 ();
-  octave_idx_type nc = dim2 ();
+  return map_transpose (OclArrayKernels::transpose);
+}
 
-  if ((nr > 1) && (nc > 1)) {
-    OclArray<T> result (dim_vector (nc, nr));
 
-    int kernel_index = kernel_indices [OclArrayKernels::transpose];
+template <typename T>
+OclArray<T>
+OclArray<T>::hermitian (void) const
+{
+  if (ndims () != 2)
+    ocl_error ("OclArray::hermitian: array has > 2 dimensions");
 
-    array_prog.set_kernel_arg (kernel_index, 0, result);
-    array_prog.set_kernel_arg (kernel_index, 1, *this);
-    array_prog.set_kernel_arg (kernel_index, 2, octave_uint64 (slice_ofs));
-    array_prog.set_kernel_arg (kernel_index, 3, octave_uint64 (nr));
-    array_prog.set_kernel_arg (kernel_index, 4, octave_uint64 (nc));
+  return map_transpose (is_complex_type () ? OclArrayKernels::hermitian : OclArrayKernels::transpose);
+}
 
-    array_prog.enqueue_kernel (kernel_index, slice_len);
 
-    return result;
-  } else {
-    // Fast transpose for vectors and empty matrices.
-    return OclArray<T> (*this, dim_vector (nc, nr));
+template <typename T>
+OclArray<T>
+OclArray<T>::pagetranspose (void) const
+{
+  return map_transpose (OclArrayKernels::transpose);
+}
+
+
+template <typename T>
+OclArray<T>
+OclArray<T>::pagectranspose (void) const
+{
+  return map_transpose (is_complex_type () ? OclArrayKernels::hermitian : OclArrayKernels::transpose);
+}
+
+
+template <typename T>
+OclArray<T>
+OclArray<T>::permute (const Array<octave_idx_type>& vec, bool inv) const
+{
+  int nd = ndims ();
+  int perm_len = vec.numel ();
+
+  if (perm_len < nd)
+    ocl_error ("OclArray::permute: permutation vector contains fewer elements than dimensions");
+
+  Array<octave_idx_type> perm (dim_vector (perm_len, 1));
+  std::vector<bool> checked (perm_len, false);
+  for (int i=0; i<perm_len; i++) {
+    octave_idx_type p = vec (i);
+    if ((p < 0) || (p >= perm_len) || checked [p])
+      ocl_error ("OclArray::permute: permutation vector contains an invalid element");
+    checked [p] = true;
+    if (inv)
+      perm (p) = i;
+    else
+      perm (i) = p;
   }
+
+  return remap (perm, Array<bool> (dim_vector (perm_len, 1), false),
+                Array<octave_idx_type> (dim_vector (perm_len, 1), 0));
 }
 
 
 template <typename T>
 OclArray<T>
-OclArray<T>::hermitian (void) const
+OclArray<T>::circshift (const Array<octave_idx_type>& shift) const
 {
-  if (! is_complex_type ())
-    return transpose ();
+  int nd = std::max (ndims (), (int) shift.numel ());
+
+  Array<octave_idx_type> perm (dim_vector (nd, 1));
+  Array<octave_idx_type> source_shift (dim_vector (nd, 1), 0);
+  for (int k=0; k<nd; k++) {
+    perm (k) = k;
+    // result (i) = source (i - shift)
+    if (k < shift.numel ())
+      source_shift (k) = - shift (k);
+  }
 
-  rep->assure_valid ();
-  assure_valid_array_prog ();
+  return remap (perm, Array<bool> (dim_vector (nd, 1), false), source_shift);
+}
 
-  if (ndims () != 2)
-    ocl_error ("OclArray::hermitian: array has > 2 dimensions");
 
-  octave_idx_type nr = dim1 ();
-  octave_idx_type nc = dim2 ();
+template <typename T>
+OclArray<T>
+OclArray<T>::flip (int dim) const
+{
+  if (dim < 0)
+    dim = dimensions.first_non_singleton ();
 
-  OclArray<T> result (dim_vector (nc, nr));
+  int nd = std::max (ndims (), dim + 1);
 
-  int kernel_index = kernel_indices [OclArrayKernels::hermitian];
+  Array<octave_idx_type> perm (dim_vector (nd, 1));
+  Array<bool> flip (dim_vector (nd, 1), false);
+  for (int k=0; k<nd; k++)
+    perm (k) = k;
+  flip (dim) = true;
 
-  array_prog.set_kernel_arg (kernel_index, 0, result);
-  array_prog.set_kernel_arg (kernel_index, 1, *this);
-  array_prog.set_kernel_arg (kernel_index, 2, octave_uint64 (slice_ofs));
-  array_prog.set_kernel_arg (kernel_index, 3, octave_uint64 (nr));
-  array_prog.set_kernel_arg (kernel_index, 4, octave_uint64 (nc));
+  return remap (perm, flip, Array<octave_idx_type> (dim_vector (nd, 1), 0));
+}
 
-  array_prog.enqueue_kernel (kernel_index, slice_len);
 
-  return result;
+template <typename T>
+OclArray<T>
+OclArray<T>::rot90 (int k) const
+{
+  k = ((k % 4) + 4) % 4;
+  if (k == 0)
+    return *this;
+
+  int nd = ndims ();
+
+  Array<octave_idx_type> perm (dim_vector (nd, 1));
+  Array<bool> flip (dim_vector (nd, 1), false);
+  for (int i=0; i<nd; i++)
+    perm (i) = i;
+
+  // k = 1: result (i,j) = source (j,n-1-i), k = 2: source (m-1-i,n-1-j),
+  // k = 3: source (m-1-j,i), for an m x n source matrix
+  if (k != 2) {
+    perm (0) = 1;
+    perm (1) = 0;
+  }
+  if (k != 3)
+    flip (1) = true;
+  if (k != 1)
+    flip (0) = true;
+
+  return remap (perm, flip, Array<octave_idx_type> (dim_vector (nd, 1), 0));
 }
 
 
@@ -574,9 +1127,12 @@ template <typename T>
 Array<T>
 OclArray<T>::as_array (void) const
 {
+  Array<T> result (dimensions);
+  if (numel () == 0) // an empty array has no buffer
+    return result;
+
   rep->assure_valid ();
 
-  Array<T> result (dimensions);
   rep->copy_to_host (result.fortran_vec(), slice_ofs, slice_len);
   return result;
 }
@@ -742,13 +1298,173 @@ OclArray<T>::assign_logical (const OclArray<T>& i,
 
 
 template <typename T>
-OclArray<T>
-OclArray<T>::index (const idx_vector& i) const
+octave_idx_type
+OclArray<T>::compact (const OclArray<T>& flags,
+                      OclArray<ocl_idx_type> *indices,
+                      OclArray<T> *values,
+                      octave_idx_type n,
+                      bool backward) const
 {
-  Array<idx_vector> ia (dim_vector (1,1));
-  ia (0) = i;
-  return index (ia);
-}
+  octave_idx_type len = flags.numel ();
+  octave_idx_type count = 0;
+
+  if (len > 0) {
+    rep->assure_valid ();
+    flags.rep->assure_valid ();
+    assure_valid_array_prog ();
+
+    // count the nonzero flags per chunk, and scan the counts to chunk offsets
+    int kernel_index = kernel_indices [OclArrayKernels::compact_count];
+    size_t local_size = array_prog.reduction_group_size (kernel_index, len);
+    size_t num_groups = array_prog.reduction_groups_per_slice (1, len, local_size);
+    octave_idx_type chunk = (len + num_groups - 1) / num_groups;
+    num_groups = (len + chunk - 1) / chunk;
+
+    OclArray<ocl_idx_type> offsets (dim_vector (num_groups + 1, 1));
+
+    array_prog.set_kernel_arg (kernel_index, 0, offsets);
+    array_prog.set_kernel_arg (kernel_index, 1, flags);
+    array_prog.set_kernel_arg (kernel_index, 2, octave_uint64 (flags.slice_ofs));
+    array_prog.set_kernel_arg (kernel_index, 3, octave_uint64 (len));
+    array_prog.set_kernel_arg (kernel_index, 4, octave_uint64 (chunk));
+    array_prog.set_kernel_arg_local (kernel_index, 5, local_size * sizeof (ocl_idx_type));
+
+    array_prog.enqueue_kernel_groups (kernel_index, 1, local_size, num_groups);
+
+    kernel_index = kernel_indices [OclArrayKernels::compact_scan];
+
+    array_prog.set_kernel_arg (kernel_index, 0, offsets);
+    array_prog.set_kernel_arg (kernel_index, 1, octave_uint64 (num_groups));
+
+    array_prog.enqueue_kernel (kernel_index, 1);
+
+    // the only readback: the total count, to size the result
+    count = offsets.linear_slice (num_groups, num_groups + 1).as_array () (0).value ();
+
+    octave_idx_type pos_lo = 0, pos_hi = count;
+    if ((n >= 0) && (n < count)) {
+      if (backward)
+        pos_lo = count - n;
+      else
+        pos_hi = n;
+    }
+
+    if (indices)
+      *indices = OclArray<ocl_idx_type> (dim_vector (pos_hi - pos_lo, 1));
+    if (values)
+      *values = OclArray<T> (dim_vector (pos_hi - pos_lo, 1));
+
+    if ((pos_hi > pos_lo) && (indices || values)) {
+      // write the selected indices / values in order
+      kernel_index = kernel_indices [OclArrayKernels::compact_scatter];
+      local_size = array_prog.reduction_group_size (kernel_index, chunk);
+
+      if (indices)
+        array_prog.set_kernel_arg (kernel_index, 0, *indices);
+      else
+        array_prog.set_kernel_arg (kernel_index, 0, offsets); // unused
+      if (values)
+        array_prog.set_kernel_arg (kernel_index, 1, *values);
+      else
+        array_prog.set_kernel_arg (kernel_index, 1, flags); // unused
+      array_prog.set_kernel_arg (kernel_index, 2, flags);
+      array_prog.set_kernel_arg (kernel_index, 3, octave_uint64 (flags.slice_ofs));
+      array_prog.set_kernel_arg (kernel_index, 4, *this);
+      array_prog.set_kernel_arg (kernel_index, 5, octave_uint64 (slice_ofs));
+      array_prog.set_kernel_arg (kernel_index, 6, octave_uint64 (len));
+      array_prog.set_kernel_arg (kernel_index, 7, octave_uint64 (chunk));
+      array_prog.set_kernel_arg (kernel_index, 8, offsets);
+      array_prog.set_kernel_arg (kernel_index, 9, octave_uint64 (pos_lo));
+      array_prog.set_kernel_arg (kernel_index, 10, octave_uint64 (pos_hi));
+      array_prog.set_kernel_arg (kernel_index, 11, octave_uint64 ((indices ? 1 : 0) | (values ? 2 : 0)));
+      array_prog.set_kernel_arg_local (kernel_index, 12, local_size * sizeof (ocl_idx_type));
+
+      array_prog.enqueue_kernel_groups (kernel_index, 1, local_size, num_groups);
+    }
+
+  } else {
+    if (indices)
+      *indices = OclArray<ocl_idx_type> (dim_vector (0, 1));
+    if (values)
+      *values = OclArray<T> (dim_vector (0, 1));
+  }
+
+  return count;
+}
+
+
+template <typename T>
+OclArray<ocl_idx_type>
+OclArray<T>::find (octave_idx_type n, bool backward) const
+{
+  OclArray<ocl_idx_type> result;
+  compact (*this, & result, 0, n, backward);
+
+  // orientation as in octave: row vector for a row vector, else column
+  dim_vector rdv = result.dimensions;
+  if (dimensions.all_zero ())
+    rdv = dim_vector (0, 0);
+  else if ((ndims () == 2) && (dimensions (0) == 1))
+    rdv = dim_vector (1, result.numel ());
+
+  // nothing found: an empty result has no buffer to reshape
+  if (result.numel () == 0)
+    return OclArray<ocl_idx_type> (rdv);
+  else
+    return result.reshape (rdv);
+}
+
+
+template <typename T>
+octave_idx_type
+OclArray<T>::nnz (void) const
+{
+  return compact (*this, 0, 0);
+}
+
+
+template <typename T>
+OclArray<T>
+OclArray<T>::index_logical (const OclArray<T>& mask) const
+{
+  if (mask.numel () > numel ())
+#if ! defined (OCL_OCTAVE_VERSION_6_1_0_AND_HIGHER) // for octave versions < 6.1.0
+    octave::err_index_out_of_range (1, 1, mask.numel (), numel ());
+#else // for octave versions >= 6.1.0
+    octave::err_index_out_of_range (1, 1, mask.numel (), numel (), dimensions);
+#endif
+
+  OclArray<T> result;
+  compact (mask, 0, & result);
+
+  // orientation as in octave: that of a vector array, else that of the mask
+  bool row_result;
+#if ! defined (OCL_OCTAVE_VERSION_4_4_0_AND_HIGHER) // for octave versions < 4.4.0
+  if (dimensions.is_vector ())
+#else // for octave versions >= 4.4.0
+  if (dimensions.isvector ())
+#endif
+    row_result = (dimensions (0) == 1);
+  else
+    row_result = (mask.ndims () == 2) && (mask.dims () (0) == 1);
+
+  if (! row_result)
+    return result;
+  else if (result.numel () == 0)
+    return OclArray<T> (dim_vector (1, 0));
+  else
+    return result.reshape (dim_vector (1, result.numel ()));
+}
+
+
+template <typename T>
+OclArray<T>
+OclArray<T>::index (const idx_vector& i) const
+{
+  Array<idx_vector> ia (dim_vector (1,1));
+  ia (0) = i;
+  return index (ia);
+}
 
 
 template <typename T>
@@ -885,6 +1601,97 @@ OclArray<T>::index_helper (const Array<idx_vector>& ia,
 }
 
 
+template <typename T>
+void
+OclArray<T>::resize (const dim_vector& dv, const T& rfv)
+{
+  dim_vector new_dims = dv;
+  new_dims.chop_trailing_singletons ();
+  if (new_dims == dimensions)
+    return;
+
+  octave_idx_type old_len = slice_len;
+  octave_idx_type new_len = new_dims.safe_numel ();
+
+  if (old_len > 0) {
+    rep->assure_valid ();
+
+    // the elements kept must stay at their linear positions: the dimensions
+    // before the last non-singleton one of the old array are unchanged, and
+    // that one only shrinks if no later dimension is added
+    int nd = std::max (new_dims.length (), dimensions.length ());
+    dim_vector odv = dimensions.redim (nd);
+    dim_vector ndv = new_dims.redim (nd);
+    int last = nd-1;
+    while ((last > 0) && (odv (last) == 1))
+      last--;
+    bool keeps_positions = true;
+    for (int k = 0; k < last; k++)
+      if (odv (k) != ndv (k))
+        keeps_positions = false;
+    if (ndv (last) < odv (last))
+      for (int k = last+1; k < nd; k++)
+        if (ndv (k) != 1)
+          keeps_positions = false;
+    if (! keeps_positions)
+      ocl_error ("OclArray: resizing is only possible along the last dimension");
+  }
+
+  if (new_len > old_len) {
+    if (((rep->count) > 1) || (slice_ofs != 0) || (new_len > rep->len)) {
+      // no (unshared) spare capacity: reallocate with geometric growth
+      octave_idx_type cap = std::max (new_len, old_len + old_len / 2);
+      OclArrayRep *new_rep = new OclArrayRep (cap);
+      if (old_len > 0)
+        new_rep->copy_from_oclbuffer (*rep, slice_ofs, 0, old_len);
+      if ((--(rep->count)) == 0)
+        delete rep;
+      rep = new_rep;
+      slice_ofs = 0;
+    }
+    slice_len = new_len;
+    fill (slice_ofs + old_len, new_len - old_len, rfv);
+  } else
+    slice_len = new_len; // shrinking keeps the capacity
+
+  dimensions = new_dims;
+}
+
+
+template <typename T>
+void
+OclArray<T>::resize_for_assign (const Array<idx_vector>& ia)
+{
+  int ial = ia.numel ();
+
+  if (ial == 1) {
+    // A(I) = X for vectors: A(end+1:end+n) = X
+    octave_idx_type ext = ia (0).extent (numel ());
+    if (ext <= numel ())
+      return;
+    if ((ndims () == 2) && (columns () == 1) && (rows () != 1))
+      resize (dim_vector (ext, 1));
+    else if ((ndims () == 2) && ((rows () == 1) || (numel () == 0)))
+      resize (dim_vector (1, ext));
+    // otherwise, index_helper reports the index out of range
+  } else if (ial > 1) {
+    // A(I,J,...) = X beyond the end of the last index: A(:,end+1:end+n) = X;
+    // with fewer indices than dimensions, the trailing ones are folded first
+    dim_vector dv = dimensions.redim (ial);
+    for (int k = 0; k < ial-1; k++)
+      if (ia (k).extent (dv (k)) != dv (k))
+        return;
+    octave_idx_type ext = ia (ial-1).extent (dv (ial-1));
+    if (ext <= dv (ial-1))
+      return;
+    dimensions = dv;
+    dimensions.chop_trailing_singletons ();
+    dv (ial-1) = ext;
+    resize (dv);
+  }
+}
+
+
 template <typename T>
 OclArray<T>
 OclArray<T>::index (const Array<idx_vector>& ia) const
@@ -915,6 +1722,8 @@ void
 OclArray<T>::assign (const Array<idx_vector>& ia,
                      const T& rhs)
 {
+  resize_for_assign (ia);
+
   rep->assure_valid ();
   assure_valid_array_prog ();
 
@@ -943,7 +1752,8 @@ void
 OclArray<T>::assign (const Array<idx_vector>& ia,
                      const OclArray<T>& rhs)
 {
-  // OclArray: No special case when all dimensions are initially zero, since resizing is not allowed.
+  // indexing beyond the end resizes the array along its last dimension first
+  resize_for_assign (ia);
 
   rep->assure_valid ();
   rhs.rep->assure_valid ();
@@ -1047,38 +1857,125 @@ OclArray<T>::cat (int dim, octave_idx_type n, const OclArray<T> *array_list)
   octave_idx_type spdim = 1;
   for (octave_idx_type i = 0; i < dim; i++)
     spdim *= dv (i);
-
+  octave_idx_type nblocks = result.numel () / (spdim * dv (dim));
+
+  // the inputs are split into pieces, i.e., contiguous source ranges of
+  // nblocks blocks in the result; with nblocks == 1, inputs continuing the
+  // same OpenCL buffer range (like consecutive slices of one array) are
+  // merged into a single piece
+  std::vector<octave_idx_type> piece_input;
+  Array<ocl_idx_type> piece_table (dim_vector (4, n)); // per piece: source offset, destination offset, length, block length
+  octave_idx_type num_pieces = 0;
   octave_idx_type offset = 0;
 
-  int kernel_index = kernel_indices [OclArrayKernels::cat];
+  octave_idx_type i = 0;
+  while (i < n) {
+    octave_idx_type len = array_list [i].numel ();
+    if (len == 0) {
+      i++;
+      continue;
+    }
 
-  for (octave_idx_type i = 0; i < n; i++) {
-    octave_quit ();
+    piece_input.push_back (i);
+    octave_idx_type src_ofs = array_list [i].slice_ofs;
+    for (i++; (nblocks == 1) && (i < n); i++) {
+      if (array_list [i].numel () == 0)
+        continue;
+      if ((array_list [i].rep != array_list [piece_input.back ()].rep) || (array_list [i].slice_ofs != src_ofs + len))
+        break;
+      len += array_list [i].numel ();
+    }
 
-#if ! defined (OCL_OCTAVE_VERSION_4_4_0_AND_HIGHER) // for octave versions < 4.4.0
-    if (array_list [i].is_empty ())
-#else // for octave versions >= 4.4.0
-    if (array_list [i].isempty ())
-#endif
+    piece_table (0, num_pieces) = src_ofs;
+    piece_table (1, num_pieces) = offset;
+    piece_table (2, num_pieces) = len;
+    piece_table (3, num_pieces) = len / nblocks;
+    num_pieces++;
+    offset += len / nblocks;
+  }
+
+  size_t dst_stride = static_cast<size_t> (spdim * dv (dim));
+
+  // large pieces (or a single small one) are copied by a copy command each,
+  // the others gathered by one kernel launch per cat_gather_inputs pieces,
+  // with a table of the offsets and extents of all pieces
+  std::vector<octave_idx_type> gathered;
+  for (octave_idx_type p = 0; p < num_pieces; p++)
+    if (static_cast<size_t> (piece_table (2, p).value ()) <= cat_gather_max_len)
+      gathered.push_back (p);
+  if (gathered.size () == 1)
+    gathered.clear ();
+
+  size_t g = 0;
+  for (octave_idx_type p = 0; p < num_pieces; p++) {
+    if ((g < gathered.size ()) && (gathered [g] == p)) {
+      g++;
       continue;
-    dim_vector dvi = array_list [i].dims ();
-    if (ndim >= dvi.length ())
-      dvi = dvi.redim (ndim);
+    }
 
-    octave_idx_type fac1, fac2;
-    fac1 = spdim * dvi (dim);
-    fac2 = spdim * dv (dim);
+    octave_quit ();
 
-    array_prog.set_kernel_arg (kernel_index, 0, result);
-    array_prog.set_kernel_arg (kernel_index, 1, array_list [i]);
-    array_prog.set_kernel_arg (kernel_index, 2, octave_uint64 (array_list [i].slice_ofs));
-    array_prog.set_kernel_arg (kernel_index, 3, octave_uint64 (offset * spdim));
-    array_prog.set_kernel_arg (kernel_index, 4, octave_uint64 (fac1));
-    array_prog.set_kernel_arg (kernel_index, 5, octave_uint64 (fac2));
+    const OclArray<T>& src = array_list [piece_input [p]];
+    octave_idx_type src_ofs = piece_table (0, p).value ();
+    octave_idx_type dst_ofs = piece_table (1, p).value ();
+    octave_idx_type len = piece_table (2, p).value ();
+
+    if (nblocks == 1)
+      result.rep->copy_from_oclbuffer (*(src.rep), src_ofs, dst_ofs, len);
+    else {
+      size_t block_size = static_cast<size_t> (len / nblocks) * sizeof (T);
+      size_t src_origin [3] = { static_cast<size_t> (src_ofs) * sizeof (T), 0, 0 };
+      size_t dst_origin [3] = { static_cast<size_t> (dst_ofs) * sizeof (T), 0, 0 };
+      size_t region [3] = { block_size, static_cast<size_t> (nblocks), 1 };
+
+      last_error = clEnqueueCopyBufferRect (get_command_queue (),
+                                            (cl_mem) src.rep->get_ocl_buffer (),
+                                            (cl_mem) result.rep->get_ocl_buffer (),
+                                            src_origin,
+                                            dst_origin,
+                                            region,
+                                            block_size, 0,
+                                            dst_stride * sizeof (T), 0,
+                                            0, 0, 0);
+      ocl_check_error ("clEnqueueCopyBufferRect");
+      ocl_memobj_release_pins ();
+    }
+  }
+
+  if (gathered.empty ())
+    return result;
+
+  // the table holds the gathered pieces in launch order
+  Array<ocl_idx_type> gather_table (dim_vector (4, gathered.size ()));
+  for (size_t k = 0; k < gathered.size (); k++)
+    for (int r = 0; r < 4; r++)
+      gather_table (r, k) = piece_table (r, gathered [k]);
+  OclArray<ocl_idx_type> table (gather_table);
 
-    array_prog.enqueue_kernel (kernel_index, dvi.numel ());
+  int kernel_index = kernel_indices [OclArrayKernels::cat_gather];
 
-    offset += dvi (dim);
+  for (size_t k0 = 0; k0 < gathered.size (); k0 += cat_gather_inputs) {
+    octave_quit ();
+
+    array_prog.set_kernel_arg (kernel_index, 0, result);
+    array_prog.set_kernel_arg (kernel_index, cat_gather_inputs + 1, table);
+    array_prog.set_kernel_arg (kernel_index, cat_gather_inputs + 4, octave_uint64 (dst_stride));
+
+    size_t num_src = std::min (cat_gather_inputs, gathered.size () - k0);
+    size_t max_len = 0;
+    for (size_t k = 0; k < cat_gather_inputs; k++) {
+      // unused source arguments are bound to the last piece's buffer
+      size_t kp = k0 + std::min (k, num_src - 1);
+      array_prog.set_kernel_arg (kernel_index, 1 + k, array_list [piece_input [gathered [kp]]]);
+      max_len = std::max (max_len, static_cast<size_t> (gather_table (2, kp).value ()));
+    }
+    array_prog.set_kernel_arg (kernel_index, cat_gather_inputs + 2, octave_uint64 (k0));
+    array_prog.set_kernel_arg (kernel_index, cat_gather_inputs + 3, octave_uint64 (num_src));
+
+    Matrix work_size (1, 2);
+    work_size (0, 0) = max_len;
+    work_size (0, 1) = num_src;
+    array_prog.enqueue_kernel (kernel_index, work_size);
   }
 
   return result;
@@ -1096,40 +1993,46 @@ OclArray<T>::eye (octave_idx_type r, octave_idx_type c)
   if (c < 0)
     c = r;
 
-  dim_vector dv (r, c);
-
-  OclArray<T> result (dv);
+  // a virtual array, generated by the eye kernel on first use
+  return OclArray<T> (dim_vector (r, c), OclArrayRep::virt_eye, T (1), T (0), r);
+}
 
-  int kernel_index = kernel_indices [OclArrayKernels::eye];
 
-  array_prog.set_kernel_arg (kernel_index, 0, result);
-  array_prog.set_kernel_arg (kernel_index, 1, octave_uint64 (r+1));
-  array_prog.set_kernel_arg (kernel_index, 2, octave_uint64 (r * r));
+template <typename T>
+OclArray<T>
+OclArray<T>::linspace (T base, T limit, octave_idx_type n)
+{
+  assure_valid_array_prog ();
 
-  array_prog.enqueue_kernel (kernel_index, dv.numel ());
+  if (n < 2)
+    return OclArray<T> (dim_vector (1, 1), limit);
 
-  return result;
+  // a virtual array, generated by the linspace kernel on first use
+  return OclArray<T> (dim_vector (1, n), OclArrayRep::virt_linspace, base, limit);
 }
 
 
 template <typename T>
 OclArray<T>
-OclArray<T>::linspace (T base, T limit, octave_idx_type n)
+OclArray<T>::logspace (T a, T b, octave_idx_type n)
 {
   assure_valid_array_prog ();
 
+  if (is_integer_type () || is_complex_type ())
+    ocl_error ("OclArray::logspace: not possible with this type");
+
   if (n < 2)
-    return OclArray<T> (dim_vector (1, 1), limit);
+    return OclArray<T> (dim_vector (1, 1), b);
 
   dim_vector dv (1, n);
 
   OclArray<T> result (dv);
 
-  int kernel_index = kernel_indices [OclArrayKernels::linspace];
+  int kernel_index = kernel_indices [OclArrayKernels::logspace];
 
   array_prog.set_kernel_arg (kernel_index, 0, result);
-  array_prog.set_kernel_arg (kernel_index, 1, base);
-  array_prog.set_kernel_arg (kernel_index, 2, limit);
+  array_prog.set_kernel_arg (kernel_index, 1, a);
+  array_prog.set_kernel_arg (kernel_index, 2, b);
   array_prog.set_kernel_arg (kernel_index, 3, octave_uint64 (n));
 
   array_prog.enqueue_kernel (kernel_index, dv.numel ());
@@ -1140,28 +2043,37 @@ OclArray<T>::linspace (T base, T limit, octave_idx_type n)
 
 template <typename T>
 OclArray<T>
-OclArray<T>::logspace (T a, T b, octave_idx_type n)
+OclArray<T>::rand_fill (const dim_vector& dv, unsigned long fcn,
+                        int64_t lo, uint64_t range)
 {
   assure_valid_array_prog ();
 
-  if (is_integer_type () || is_complex_type ())
-    ocl_error ("OclArray::logspace: not possible with this type");
-
-  if (n < 2)
-    return OclArray<T> (dim_vector (1, 1), b);
+  int kernel_index = kernel_indices [OclArrayKernels::rand];
 
-  dim_vector dv (1, n);
+  if (kernel_index < 0)
+    ocl_error ("not applicable to type OclArray of this class");
+  if (range == 0)
+    ocl_error ("OclArray::randi: invalid range");
 
   OclArray<T> result (dv);
+  octave_idx_type n = result.numel ();
+  if (n == 0)
+    return result;
 
-  int kernel_index = kernel_indices [OclArrayKernels::logspace];
+  uint64_t key = ocl_rand_get_seed ();
+  uint64_t num_blocks = (n + 1) / 2;
 
   array_prog.set_kernel_arg (kernel_index, 0, result);
-  array_prog.set_kernel_arg (kernel_index, 1, a);
-  array_prog.set_kernel_arg (kernel_index, 2, b);
-  array_prog.set_kernel_arg (kernel_index, 3, octave_uint64 (n));
+  array_prog.set_kernel_arg (kernel_index, 1, octave_uint64 (key));
+  array_prog.set_kernel_arg (kernel_index, 2, octave_uint64 (rand_counter));
+  array_prog.set_kernel_arg (kernel_index, 3, octave_uint64 (static_cast<uint64_t> (lo)));
+  array_prog.set_kernel_arg (kernel_index, 4, octave_uint64 (range));
+  array_prog.set_kernel_arg (kernel_index, 5, octave_uint64 (fcn));
+  array_prog.set_kernel_arg (kernel_index, 6, octave_uint64 (n));
 
-  array_prog.enqueue_kernel (kernel_index, dv.numel ());
+  array_prog.enqueue_kernel_grid (kernel_index, num_blocks);
+
+  rand_counter += num_blocks;
 
   return result;
 }
@@ -1307,7 +2219,7 @@ OclArray<T>::repmat (const dim_vector& dv) const
 
 template <typename T>
 OclArray<T>
-OclArray<T>::std (int opt, int dim) const
+OclArray<T>::var_std (int opt, int dim, bool take_sqrt, OclArray<T> *mean) const
 {
   rep->assure_valid ();
   assure_valid_array_prog ();
@@ -1318,18 +2230,40 @@ OclArray<T>::std (int opt, int dim) const
   dim_wise_op_newdims (dim, new_dimensions, len, fac);
   n = (opt == 0) ? len-1 : len;
 
+  if (len == 0) {
+    T nan_value (std::numeric_limits<double>::quiet_NaN ());
+    if (mean)
+      *mean = OclArray<T> (new_dimensions, nan_value);
+    return OclArray<T> (new_dimensions, nan_value);
+  }
+
   OclArray<T> result (new_dimensions);
+  OclArray<T> result_mean;
+  if (mean)
+    result_mean = OclArray<T> (new_dimensions);
 
-  int kernel_index = kernel_indices [OclArrayKernels::std];
+  int kernel_index = kernel_indices [OclArrayKernels::var];
+  size_t local_size = array_prog.reduction_group_size (kernel_index, len);
 
-  array_prog.set_kernel_arg (kernel_index, 0, result);
-  array_prog.set_kernel_arg (kernel_index, 1, *this);
-  array_prog.set_kernel_arg (kernel_index, 2, octave_uint64 (slice_ofs));
-  array_prog.set_kernel_arg (kernel_index, 3, octave_uint64 (len));
-  array_prog.set_kernel_arg (kernel_index, 4, octave_uint64 (fac));
-  array_prog.set_kernel_arg (kernel_index, 5, octave_uint64 (n));
+  if (mean)
+    array_prog.set_kernel_arg (kernel_index, 0, result_mean);
+  else
+    array_prog.set_kernel_arg (kernel_index, 0, result); // as indicator for unused mean
+  array_prog.set_kernel_arg (kernel_index, 1, result);
+  array_prog.set_kernel_arg (kernel_index, 2, *this);
+  array_prog.set_kernel_arg (kernel_index, 3, octave_uint64 (slice_ofs));
+  array_prog.set_kernel_arg (kernel_index, 4, octave_uint64 (len));
+  array_prog.set_kernel_arg (kernel_index, 5, octave_uint64 (fac));
+  array_prog.set_kernel_arg (kernel_index, 6, octave_uint64 (n));
+  array_prog.set_kernel_arg (kernel_index, 7, octave_uint64 (take_sqrt ? 1 : 0));
+  array_prog.set_kernel_arg_local (kernel_index, 8, local_size * sizeof (octave_uint64));
+  array_prog.set_kernel_arg_local (kernel_index, 9, local_size * sizeof (T));
+  array_prog.set_kernel_arg_local (kernel_index, 10, local_size * sizeof (T));
 
-  array_prog.enqueue_kernel (kernel_index, slice_len / len);
+  array_prog.enqueue_kernel_groups (kernel_index, slice_len / len, local_size);
+
+  if (mean)
+    *mean = result_mean;
 
   return result;
 }
@@ -1489,8 +2423,9 @@ OclArray<Complex>::map_c2r (OclArrayKernels::Kernel kernel) const
   array_prog.set_kernel_arg (kernel_index, 0, result);
   array_prog.set_kernel_arg (kernel_index, 1, *this);
   array_prog.set_kernel_arg (kernel_index, 2, octave_uint64 (slice_ofs));
+  array_prog.set_kernel_arg (kernel_index, 3, octave_uint64 (slice_len));
 
-  array_prog.enqueue_kernel (kernel_index, slice_len);
+  enqueue_elementwise_kernel (kernel_index, slice_len);
 
   return result;
 }
@@ -1513,8 +2448,9 @@ OclArray<FloatComplex>::map_c2r (OclArrayKernels::Kernel kernel) const
   array_prog.set_kernel_arg (kernel_index, 0, result);
   array_prog.set_kernel_arg (kernel_index, 1, *this);
   array_prog.set_kernel_arg (kernel_index, 2, octave_uint64 (slice_ofs));
+  array_prog.set_kernel_arg (kernel_index, 3, octave_uint64 (slice_len));
 
-  array_prog.enqueue_kernel (kernel_index, slice_len);
+  enqueue_elementwise_kernel (kernel_index, slice_len);
 
   return result;
 }
@@ -1613,8 +2549,9 @@ OclArray<T>::map (OclArrayKernels::Kernel kernel) const
   array_prog.set_kernel_arg (kernel_index, 0, result);
   array_prog.set_kernel_arg (kernel_index, 1, *this);
   array_prog.set_kernel_arg (kernel_index, 2, octave_uint64 (slice_ofs));
+  array_prog.set_kernel_arg (kernel_index, 3, octave_uint64 (slice_len));
 
-  array_prog.enqueue_kernel (kernel_index, slice_len);
+  enqueue_elementwise_kernel (kernel_index, slice_len);
 
   return result;
 }
@@ -1625,6 +2562,21 @@ OclArray<T>
 OclArray<T>::map1 (OclArrayKernels::Kernel kernel, const T& par) const
 {
   rep->assure_valid ();
+
+  // a real floating point constant operand gives a constant result, computed
+  // on the host; only for the operations which OpenCL rounds correctly, too
+  // (not for division, which is not correctly rounded in single precision)
+  if (is_virtual_const () && ! (is_integer_type () || is_complex_type ())) {
+    const T& val = rep->virt_val [0];
+    switch (kernel) {
+      case OclArrayKernels::add1:  return OclArray<T> (dimensions, val + par);
+      case OclArrayKernels::sub1s: return OclArray<T> (dimensions, val - par);
+      case OclArrayKernels::sub1m: return OclArray<T> (dimensions, par - val);
+      case OclArrayKernels::mul1:  return OclArray<T> (dimensions, val * par);
+      default: break;
+    }
+  }
+
   assure_valid_array_prog ();
 
   OclArray<T> result (dimensions);
@@ -1635,8 +2587,9 @@ OclArray<T>::map1 (OclArrayKernels::Kernel kernel, const T& par) const
   array_prog.set_kernel_arg (kernel_index, 1, *this);
   array_prog.set_kernel_arg (kernel_index, 2, octave_uint64 (slice_ofs));
   array_prog.set_kernel_arg (kernel_index, 3, par);
+  array_prog.set_kernel_arg (kernel_index, 4, octave_uint64 (slice_len));
 
-  array_prog.enqueue_kernel (kernel_index, slice_len);
+  enqueue_elementwise_kernel (kernel_index, slice_len);
 
   return result;
 }
@@ -1664,8 +2617,9 @@ OclArray<T>::map1_inplace (OclArrayKernels::Kernel kernel, const T& par)
   array_prog.set_kernel_arg (kernel_index, 1, *this);
   array_prog.set_kernel_arg (kernel_index, 2, octave_uint64 (slice_ofs));
   array_prog.set_kernel_arg (kernel_index, 3, par);
+  array_prog.set_kernel_arg (kernel_index, 4, octave_uint64 (slice_len));
 
-  array_prog.enqueue_kernel (kernel_index, slice_len);
+  enqueue_elementwise_kernel (kernel_index, slice_len);
 
   *this = result;
 
@@ -1673,6 +2627,151 @@ OclArray<T>::map1_inplace (OclArrayKernels::Kernel kernel, const T& par)
 }
 
 
+template <typename T>
+OclArray<T>
+OclArray<T>::map_transpose (OclArrayKernels::Kernel kernel) const
+{
+  rep->assure_valid ();
+  assure_valid_array_prog ();
+
+  octave_idx_type nr = dim1 ();
+  octave_idx_type nc = dim2 ();
+  octave_idx_type np = 1;
+  for (int i=2; i<ndims (); i++)
+    np *= dimensions (i);
+
+  dim_vector new_dimensions = dimensions;
+  new_dimensions (0) = nc;
+  new_dimensions (1) = nr;
+
+  if (numel () == 0)
+    return OclArray<T> (new_dimensions);
+
+  // Fast transpose for vectors (pages are vectors: the layout does not change).
+  if (((nr == 1) || (nc == 1)) && (kernel == OclArrayKernels::transpose))
+    return OclArray<T> (*this, new_dimensions);
+
+  OclArray<T> result (new_dimensions);
+
+  int kernel_index = kernel_indices [kernel];
+
+  // local work size: up to transpose_tile_dim x transpose_block_rows
+  size_t wg_size = array_prog.get_kernel_work_group_size (kernel_index);
+  size_t lx = std::min (wg_size, transpose_tile_dim);
+  size_t ly = std::max ((size_t) 1, std::min (wg_size / lx, transpose_block_rows));
+
+  Matrix work_size (3,3);
+  work_size (0,0) = ((nr + transpose_tile_dim - 1) / transpose_tile_dim) * lx;
+  work_size (0,1) = ((nc + transpose_tile_dim - 1) / transpose_tile_dim) * ly;
+  work_size (0,2) = np;
+  work_size (1,0) = 0;
+  work_size (1,1) = 0;
+  work_size (1,2) = 0;
+  work_size (2,0) = lx;
+  work_size (2,1) = ly;
+  work_size (2,2) = 1;
+
+  array_prog.set_kernel_arg (kernel_index, 0, result);
+  array_prog.set_kernel_arg (kernel_index, 1, *this);
+  array_prog.set_kernel_arg (kernel_index, 2, octave_uint64 (slice_ofs));
+  array_prog.set_kernel_arg (kernel_index, 3, octave_uint64 (nr));
+  array_prog.set_kernel_arg (kernel_index, 4, octave_uint64 (nc));
+
+  array_prog.enqueue_kernel (kernel_index, work_size);
+
+  return result;
+}
+
+
+template <typename T>
+OclArray<T>
+OclArray<T>::remap (const Array<octave_idx_type>& perm,
+                    const Array<bool>& flip,
+                    const Array<octave_idx_type>& shift) const
+{
+  rep->assure_valid ();
+  assure_valid_array_prog ();
+
+  int nd = perm.numel ();
+  dim_vector dv = dimensions.redim (nd);
+
+  std::vector<octave_idx_type> src_stride (nd);
+  octave_idx_type s = 1;
+  for (int k=0; k<nd; k++) {
+    src_stride [k] = s;
+    s *= dv (k);
+  }
+
+  dim_vector new_dimensions = dv;
+  for (int k=0; k<nd; k++)
+    new_dimensions (k) = dv (perm (k));
+
+  if (numel () == 0)
+    return OclArray<T> (new_dimensions);
+
+  // per result dimension: extent, (signed) source stride and shift;
+  // singleton dimensions are dropped, and consecutive dimensions merged
+  // where the source layout allows
+  std::vector<octave_idx_type> ext, stride, shft;
+  octave_idx_type base = 0;
+  for (int k=0; k<nd; k++) {
+    int p = perm (k);
+    octave_idx_type n = dv (p);
+    if (n == 1)
+      continue;
+    octave_idx_type st = src_stride [p];
+    octave_idx_type sh = ((shift (p) % n) + n) % n;
+    if (flip (p)) {
+      base += (n - 1) * st;
+      st = -st;
+    }
+    if ((! ext.empty ()) && (sh == 0) && (shft.back () == 0) && (st == stride.back () * ext.back ())) {
+      ext.back () *= n;
+      continue;
+    }
+    ext.push_back (n);
+    stride.push_back (st);
+    shft.push_back (sh);
+  }
+  int m = ext.size ();
+
+  // unchanged layout: shallow copy
+  if ((m == 0) || ((m == 1) && (stride [0] == 1) && (shft [0] == 0)))
+    return OclArray<T> (*this, new_dimensions);
+
+  // transposed (pages of) matrices: the tiled transpose kernel
+  bool plain = (base == 0);
+  for (int k=0; k<m; k++)
+    plain = plain && (shft [k] == 0);
+  if (plain && ((m == 2) || (m == 3)) && (stride [1] == 1) && (stride [0] == ext [1]) &&
+      ((m == 2) || (stride [2] == ext [0] * ext [1])))
+    return reshape (dim_vector (ext [1], ext [0], (m == 3) ? ext [2] : 1)).pagetranspose ().reshape (new_dimensions);
+
+  Array<ocl_idx_type> map (dim_vector (3 * m, 1));
+  for (int k=0; k<m; k++) {
+    map (k) = ocl_idx_type (ext [k]);
+    map (m + k) = ocl_idx_type (stride [k]);
+    map (2 * m + k) = ocl_idx_type (shft [k]);
+  }
+  OclArray<ocl_idx_type> map_ocl (map);
+
+  OclArray<T> result (new_dimensions);
+
+  int kernel_index = kernel_indices [OclArrayKernels::permute];
+
+  array_prog.set_kernel_arg (kernel_index, 0, result);
+  array_prog.set_kernel_arg (kernel_index, 1, *this);
+  array_prog.set_kernel_arg (kernel_index, 2, octave_uint64 (slice_ofs + base));
+  array_prog.set_kernel_arg (kernel_index, 3, map_ocl);
+  array_prog.set_kernel_arg (kernel_index, 4, octave_uint64 (m));
+  array_prog.set_kernel_arg (kernel_index, 5, octave_uint64 (numel ()));
+
+  array_prog.enqueue_kernel_grid (kernel_index, numel ());
+
+  return result;
+}
+
+
 template <typename T>
 OclArray<T>
 OclArray<T>::map1r (OclArrayKernels::Kernel kernel, int dim) const
@@ -1775,18 +2874,62 @@ OclArray<T>::map1ri (OclArrayKernels::Kernel kernel, int dim, OclArray<ocl_idx_t
     result_indices = OclArray<ocl_idx_type> (new_dimensions);
 
   int kernel_index = kernel_indices [kernel];
+  octave_idx_type num_slices = slice_len / len;
+  size_t local_size = array_prog.reduction_group_size (kernel_index, len);
+  size_t groups_per_slice = array_prog.reduction_groups_per_slice (num_slices, len, local_size);
+
+  if (groups_per_slice > 1) {
+    // first stage: (value, index) of each work-group, stored slice-wise
+    OclArray<T> part (dim_vector (groups_per_slice, num_slices));
+    OclArray<ocl_idx_type> part_indices (dim_vector (groups_per_slice, num_slices));
+
+    array_prog.set_kernel_arg (kernel_index, 0, part);
+    array_prog.set_kernel_arg (kernel_index, 1, part_indices);
+    array_prog.set_kernel_arg (kernel_index, 2, *this);
+    array_prog.set_kernel_arg (kernel_index, 3, octave_uint64 (slice_ofs));
+    array_prog.set_kernel_arg (kernel_index, 4, octave_uint64 (len));
+    array_prog.set_kernel_arg (kernel_index, 5, octave_uint64 (fac));
+    array_prog.set_kernel_arg (kernel_index, 6, *this); // as indicator for no input indices
+    array_prog.set_kernel_arg_local (kernel_index, 7, local_size * sizeof (T));
+    array_prog.set_kernel_arg_local (kernel_index, 8, local_size * sizeof (ocl_idx_type));
+
+    array_prog.enqueue_kernel_groups (kernel_index, num_slices, local_size, groups_per_slice);
+
+    // second stage: reduce the partial results of each slice
+    local_size = array_prog.reduction_group_size (kernel_index, groups_per_slice);
 
-  array_prog.set_kernel_arg (kernel_index, 0, result);
-  if (indices)
-    array_prog.set_kernel_arg (kernel_index, 1, result_indices);
-  else
-    array_prog.set_kernel_arg (kernel_index, 1, result); // as indicator for unused indices
-  array_prog.set_kernel_arg (kernel_index, 2, *this);
-  array_prog.set_kernel_arg (kernel_index, 3, octave_uint64 (slice_ofs));
-  array_prog.set_kernel_arg (kernel_index, 4, octave_uint64 (len));
-  array_prog.set_kernel_arg (kernel_index, 5, octave_uint64 (fac));
+    array_prog.set_kernel_arg (kernel_index, 0, result);
+    if (indices)
+      array_prog.set_kernel_arg (kernel_index, 1, result_indices);
+    else
+      array_prog.set_kernel_arg (kernel_index, 1, result); // as indicator for unused indices
+    array_prog.set_kernel_arg (kernel_index, 2, part);
+    array_prog.set_kernel_arg (kernel_index, 3, octave_uint64 (0));
+    array_prog.set_kernel_arg (kernel_index, 4, octave_uint64 (groups_per_slice));
+    array_prog.set_kernel_arg (kernel_index, 5, octave_uint64 (1));
+    array_prog.set_kernel_arg (kernel_index, 6, part_indices);
+    array_prog.set_kernel_arg_local (kernel_index, 7, local_size * sizeof (T));
+    array_prog.set_kernel_arg_local (kernel_index, 8, local_size * sizeof (ocl_idx_type));
 
-  array_prog.enqueue_kernel (kernel_index, slice_len / len);
+    array_prog.enqueue_kernel_groups (kernel_index, num_slices, local_size);
+
+  } else {
+
+    array_prog.set_kernel_arg (kernel_index, 0, result);
+    if (indices)
+      array_prog.set_kernel_arg (kernel_index, 1, result_indices);
+    else
+      array_prog.set_kernel_arg (kernel_index, 1, result); // as indicator for unused indices
+    array_prog.set_kernel_arg (kernel_index, 2, *this);
+    array_prog.set_kernel_arg (kernel_index, 3, octave_uint64 (slice_ofs));
+    array_prog.set_kernel_arg (kernel_index, 4, octave_uint64 (len));
+    array_prog.set_kernel_arg (kernel_index, 5, octave_uint64 (fac));
+    array_prog.set_kernel_arg (kernel_index, 6, *this); // as indicator for no input indices
+    array_prog.set_kernel_arg_local (kernel_index, 7, local_size * sizeof (T));
+    array_prog.set_kernel_arg_local (kernel_index, 8, local_size * sizeof (ocl_idx_type));
+
+    array_prog.enqueue_kernel_groups (kernel_index, num_slices, local_size);
+  }
 
   if (indices)
     *indices = result_indices;
@@ -1845,6 +2988,22 @@ OclArray<T>::map2s (OclArrayKernels::Kernel kernel, const OclArray<T>& s2) const
 
   rep->assure_valid ();
   s2.rep->assure_valid ();
+
+  // with a constant operand, use the kernels with a scalar parameter,
+  // which leave a virtual constant unmaterialized
+  if (s2.is_virtual_const () || is_virtual_const ()) {
+    bool rev = ! s2.is_virtual_const ();
+    const OclArray<T>& a = rev ? s2 : *this;
+    const T& val = (rev ? *this : s2).rep->virt_val [0];
+    switch (kernel) {
+      case OclArrayKernels::add2: return a.map1 (OclArrayKernels::add1, val);
+      case OclArrayKernels::sub2: return a.map1 (rev ? OclArrayKernels::sub1m : OclArrayKernels::sub1s, val);
+      case OclArrayKernels::mul2: return a.map1 (OclArrayKernels::mul1, val);
+      case OclArrayKernels::div2: return a.map1 (rev ? OclArrayKernels::div1n : OclArrayKernels::div1d, val);
+      default: break;
+    }
+  }
+
   assure_valid_array_prog ();
 
   OclArray<T> result (dimensions);
@@ -1856,8 +3015,9 @@ OclArray<T>::map2s (OclArrayKernels::Kernel kernel, const OclArray<T>& s2) const
   array_prog.set_kernel_arg (kernel_index, 2, octave_uint64 (slice_ofs));
   array_prog.set_kernel_arg (kernel_index, 3, s2);
   array_prog.set_kernel_arg (kernel_index, 4, octave_uint64 (s2.slice_ofs));
+  array_prog.set_kernel_arg (kernel_index, 5, octave_uint64 (slice_len));
 
-  array_prog.enqueue_kernel (kernel_index, slice_len);
+  enqueue_elementwise_kernel (kernel_index, slice_len);
 
   return result;
 }
@@ -1890,8 +3050,9 @@ OclArray<T>::map2s_inplace (OclArrayKernels::Kernel kernel, const OclArray<T>& s
   array_prog.set_kernel_arg (kernel_index, 2, octave_uint64 (slice_ofs));
   array_prog.set_kernel_arg (kernel_index, 3, s2);
   array_prog.set_kernel_arg (kernel_index, 4, octave_uint64 (s2.slice_ofs));
+  array_prog.set_kernel_arg (kernel_index, 5, octave_uint64 (slice_len));
 
-  array_prog.enqueue_kernel (kernel_index, slice_len);
+  enqueue_elementwise_kernel (kernel_index, slice_len);
 
   *this = result;
 
@@ -1928,41 +3089,1774 @@ OclArray<T>::map2sf (OclArrayKernels::Kernel kernel,
   array_prog.set_kernel_arg (kernel_index, 4, octave_uint64 (s2.slice_ofs));
   array_prog.set_kernel_arg (kernel_index, 5, par);
   array_prog.set_kernel_arg (kernel_index, 6, octave_uint64 (fcn));
+  array_prog.set_kernel_arg (kernel_index, 7, octave_uint64 (s1.slice_len));
 
-  array_prog.enqueue_kernel (kernel_index, s1.slice_len);
+  enqueue_elementwise_kernel (kernel_index, s1.slice_len);
 
   return result;
 }
 
 
-template <typename T>
+static
+unsigned long
+trans_code (char trans)
+{
+  switch (trans)
+  {
+    case 'N': case 'n': return 0;
+    case 'T': case 't': return 1;
+    case 'C': case 'c': return 2;
+    default:
+      ocl_error ("OclArray: invalid transpose flag for matrix multiplication");
+  }
+  return 0;
+}
+
+
+template <typename T>
+OclArray<T>
+OclArray<T>::mtimes (const OclArray<T>& s2, char trans1, char trans2) const
+{
+  if ((ndims () != 2) || (s2.ndims () != 2))
+    ocl_error ("OclArray: operands must both be 2-dim arrays, or vectors, for matrix multiplication");
+
+  unsigned long t1 = trans_code (trans1);
+  unsigned long t2 = trans_code (trans2);
+
+  octave_idx_type nr1 = (t1 == 0) ? dim1 () : dim2 ();
+  octave_idx_type nc1 = (t1 == 0) ? dim2 () : dim1 ();
+  octave_idx_type nr2 = (t2 == 0) ? s2.dim1 () : s2.dim2 ();
+  octave_idx_type nc2 = (t2 == 0) ? s2.dim2 () : s2.dim1 ();
+
+  if (nc1 != nr2)
+    ocl_error ("OclArray: mismatch in operands' sizes for matrix multiplication");
+
+  // Gram matrix / normal equations, X'*X or X*X': only half of the output
+  if (((t1 == 0) != (t2 == 0)) && (rep == s2.rep) && (slice_ofs == s2.slice_ofs) &&
+      (dimensions == s2.dimensions) && (nr1 > 1))
+    return syrk (t1 != 0, (t1 != 0) ? trans1 : trans2);
+
+  dim_vector new_dimensions (nr1, nc2);
+
+  rep->assure_valid ();
+  s2.rep->assure_valid ();
+  assure_valid_array_prog ();
+
+  OclArray<T> result (new_dimensions);
+  if (result.numel () == 0)
+    return result;
+  if (nc1 == 0) {
+    result.fill (T (0));
+    return result;
+  }
+
+  int kernel_index = kernel_indices [OclArrayKernels::mtimes];
+
+  array_prog.set_kernel_arg (kernel_index, 0, result);
+  array_prog.set_kernel_arg (kernel_index, 1, *this);
+  array_prog.set_kernel_arg (kernel_index, 2, octave_uint64 (slice_ofs));
+  array_prog.set_kernel_arg (kernel_index, 3, s2);
+  array_prog.set_kernel_arg (kernel_index, 4, octave_uint64 (s2.slice_ofs));
+  array_prog.set_kernel_arg (kernel_index, 5, octave_uint64 (nr1));
+  array_prog.set_kernel_arg (kernel_index, 6, octave_uint64 (nc1));
+  array_prog.set_kernel_arg (kernel_index, 7, octave_uint64 (nc2));
+  array_prog.set_kernel_arg (kernel_index, 8, octave_uint64 (t1));
+  array_prog.set_kernel_arg (kernel_index, 9, octave_uint64 (t2));
+
+  array_prog.enqueue_kernel (kernel_index, new_dimensions.numel ());
+
+  return result;
+}
+
+
+template <typename T>
+OclArray<T>
+OclArray<T>::pagemtimes (const OclArray<T>& s2, char trans1, char trans2) const
+{
+  unsigned long t1 = trans_code (trans1);
+  unsigned long t2 = trans_code (trans2);
+
+  const dim_vector& dv1 = dims ();
+  const dim_vector& dv2 = s2.dims ();
+
+  octave_idx_type nr1 = (t1 == 0) ? dv1 (0) : dv1 (1);
+  octave_idx_type nc1 = (t1 == 0) ? dv1 (1) : dv1 (0);
+  octave_idx_type nr2 = (t2 == 0) ? dv2 (0) : dv2 (1);
+  octave_idx_type nc2 = (t2 == 0) ? dv2 (1) : dv2 (0);
+
+  if (nc1 != nr2)
+    ocl_error ("OclArray: mismatch in operands' sizes for pagewise matrix multiplication");
+
+  // page dimensions, broadcast over singletons
+  int nd = std::max (ndims (), s2.ndims ());
+  dim_vector new_dimensions = dim_vector::alloc (nd);
+  new_dimensions (0) = nr1;
+  new_dimensions (1) = nc2;
+  octave_idx_type num_pages = 1;
+  for (int k = 2; k < nd; k++) {
+    octave_idx_type d1 = (k < ndims ()) ? dv1 (k) : 1;
+    octave_idx_type d2 = (k < s2.ndims ()) ? dv2 (k) : 1;
+    if ((d1 != d2) && (d1 != 1) && (d2 != 1))
+      ocl_error ("OclArray: non-conformant page dimensions for pagewise matrix multiplication");
+    new_dimensions (k) = (d1 == 1) ? d2 : d1;
+    num_pages *= new_dimensions (k);
+  }
+
+  rep->assure_valid ();
+  s2.rep->assure_valid ();
+  assure_valid_array_prog ();
+
+  OclArray<T> result (new_dimensions);
+  if (result.numel () == 0)
+    return result;
+  if (nc1 == 0) {
+    result.fill (T (0));
+    return result;
+  }
+
+  // source page of each output page (host side, one upload)
+  Array<ocl_idx_type> page_idx (dim_vector (2 * num_pages, 1));
+  for (octave_idx_type p = 0; p < num_pages; p++) {
+    octave_idx_type q = p, p1 = 0, p2 = 0, f1 = 1, f2 = 1;
+    for (int k = 2; k < nd; k++) {
+      octave_idx_type d1 = (k < ndims ()) ? dv1 (k) : 1;
+      octave_idx_type d2 = (k < s2.ndims ()) ? dv2 (k) : 1;
+      octave_idx_type sub = q % new_dimensions (k);
+      q /= new_dimensions (k);
+      if (d1 != 1)
+        p1 += sub * f1;
+      if (d2 != 1)
+        p2 += sub * f2;
+      f1 *= d1;
+      f2 *= d2;
+    }
+    page_idx (2*p) = p1;
+    page_idx (2*p+1) = p2;
+  }
+  OclArray<ocl_idx_type> page_idx_ocl (page_idx);
+
+  int kernel_index = kernel_indices [OclArrayKernels::pagemtimes];
+
+  // tiny pages: several pages per work-group, operands in local memory
+  size_t page_elems = nr1 * nc2;
+  size_t local_size = array_prog.reduction_group_size (kernel_index, std::numeric_limits<size_t>::max ());
+  size_t items_per_page = array_prog.reduction_group_size (kernel_index, page_elems);
+  size_t pages_per_group = local_size / items_per_page;
+  size_t page_bytes = (nr1 * nc1 + nc1 * nc2) * sizeof (T);
+  while ((pages_per_group > 1) && (pages_per_group * page_bytes > pagemtimes_local_bytes))
+    pages_per_group /= 2;
+  local_size = pages_per_group * items_per_page;
+  bool use_local = (pages_per_group * page_bytes <= pagemtimes_local_bytes);
+  size_t num_groups = (num_pages + pages_per_group - 1) / pages_per_group;
+
+  array_prog.set_kernel_arg (kernel_index, 0, result);
+  array_prog.set_kernel_arg (kernel_index, 1, *this);
+  array_prog.set_kernel_arg (kernel_index, 2, octave_uint64 (slice_ofs));
+  array_prog.set_kernel_arg (kernel_index, 3, s2);
+  array_prog.set_kernel_arg (kernel_index, 4, octave_uint64 (s2.slice_ofs));
+  array_prog.set_kernel_arg (kernel_index, 5, octave_uint64 (nr1));
+  array_prog.set_kernel_arg (kernel_index, 6, octave_uint64 (nc1));
+  array_prog.set_kernel_arg (kernel_index, 7, octave_uint64 (nc2));
+  array_prog.set_kernel_arg (kernel_index, 8, octave_uint64 (t1));
+  array_prog.set_kernel_arg (kernel_index, 9, octave_uint64 (t2));
+  array_prog.set_kernel_arg (kernel_index, 10, page_idx_ocl);
+  array_prog.set_kernel_arg (kernel_index, 11, octave_uint64 (num_pages));
+  array_prog.set_kernel_arg (kernel_index, 12, octave_uint64 (pages_per_group));
+  array_prog.set_kernel_arg (kernel_index, 13, octave_uint64 (use_local ? 1 : 0));
+  array_prog.set_kernel_arg_local (kernel_index, 14, use_local ? pages_per_group * page_bytes : sizeof (T));
+
+  array_prog.enqueue_kernel_groups (kernel_index, num_groups, local_size);
+
+  return result;
+}
+
+
+template <typename T>
+OclArray<T>
+OclArray<T>::syrk (bool trans1, char trans) const
+{
+  if (ndims () != 2)
+    ocl_error ("OclArray: operand must be a 2-dim array, or vector, for matrix multiplication");
+
+  unsigned long t = trans_code (trans);
+  if (t == 0)
+    ocl_error ("OclArray: invalid transpose flag for rank-k product");
+  if (! is_complex_type ())
+    t = 1; // conjugation is void
+
+  octave_idx_type n = trans1 ? dim2 () : dim1 ();
+  octave_idx_type len = trans1 ? dim1 () : dim2 ();
+
+  rep->assure_valid ();
+  assure_valid_array_prog ();
+
+  OclArray<T> result (dim_vector (n, n));
+  if (result.numel () == 0)
+    return result;
+  if (len == 0) {
+    result.fill (T (0));
+    return result;
+  }
+
+  int kernel_index = kernel_indices [OclArrayKernels::syrk];
+
+  array_prog.set_kernel_arg (kernel_index, 0, result);
+  array_prog.set_kernel_arg (kernel_index, 1, *this);
+  array_prog.set_kernel_arg (kernel_index, 2, octave_uint64 (slice_ofs));
+  array_prog.set_kernel_arg (kernel_index, 3, octave_uint64 (n));
+  array_prog.set_kernel_arg (kernel_index, 4, octave_uint64 (len));
+  array_prog.set_kernel_arg (kernel_index, 5, octave_uint64 (trans1 ? 1 : 0));
+  array_prog.set_kernel_arg (kernel_index, 6, octave_uint64 (t));
+
+  Matrix work_size (1,2);
+  work_size (0,0) = n;
+  work_size (0,1) = n;
+
+  array_prog.enqueue_kernel (kernel_index, work_size);
+
+  return result;
+}
+
+
+template <typename T>
+OclArray<T>
+OclArray<T>::csr_mtimes (octave_idx_type nr,
+                         const OclArray<ocl_idx_type>& row_ptr,
+                         const OclArray<ocl_idx_type>& col_idx,
+                         const OclArray<T>& values,
+                         const OclArray<T>& x,
+                         bool conj_values)
+{
+  if (x.ndims () != 2)
+    ocl_error ("OclArray: operand must be a 2-dim array, or vector, for matrix multiplication");
+
+  octave_idx_type nc = x.dim1 ();
+  octave_idx_type nx = x.dim2 ();
+  octave_idx_type nnz = values.numel ();
+
+  x.rep->assure_valid ();
+  assure_valid_array_prog ();
+
+  OclArray<T> result (dim_vector (nr, nx));
+  if (result.numel () == 0)
+    return result;
+  if (nnz == 0) {
+    result.fill (T (0));
+    return result;
+  }
+  if (row_ptr.numel () != nr + 1)
+    ocl_error ("OclArray: invalid row pointers of sparse matrix");
+
+  row_ptr.rep->assure_valid ();
+  col_idx.rep->assure_valid ();
+  values.rep->assure_valid ();
+
+  int kernel_index = kernel_indices [OclArrayKernels::csr_mtimes];
+
+  // about as many work-items per output element as nonzeros per row
+  size_t local_size = array_prog.reduction_group_size (kernel_index, std::numeric_limits<size_t>::max ());
+  size_t lanes = 1;
+  while ((2 * lanes <= std::min (local_size, csr_max_lanes)) && (2 * lanes * nr <= (size_t) nnz))
+    lanes *= 2;
+  size_t num_groups = array_prog.reduction_groups_per_slice (1, result.numel () * lanes, local_size);
+
+  array_prog.set_kernel_arg (kernel_index, 0, result);
+  array_prog.set_kernel_arg (kernel_index, 1, row_ptr);
+  array_prog.set_kernel_arg (kernel_index, 2, col_idx);
+  array_prog.set_kernel_arg (kernel_index, 3, values);
+  array_prog.set_kernel_arg (kernel_index, 4, x);
+  array_prog.set_kernel_arg (kernel_index, 5, octave_uint64 (x.slice_ofs));
+  array_prog.set_kernel_arg (kernel_index, 6, octave_uint64 (nr));
+  array_prog.set_kernel_arg (kernel_index, 7, octave_uint64 (nc));
+  array_prog.set_kernel_arg (kernel_index, 8, octave_uint64 (nx));
+  array_prog.set_kernel_arg (kernel_index, 9, octave_uint64 ((conj_values && is_complex_type ()) ? 1 : 0));
+  array_prog.set_kernel_arg (kernel_index, 10, octave_uint64 (lanes));
+  array_prog.set_kernel_arg_local (kernel_index, 11, local_size * sizeof (T));
+
+  array_prog.enqueue_kernel_groups (kernel_index, 1, local_size, num_groups);
+
+  return result;
+}
+
+
+template <typename T>
+OclArray<T>
+OclArray<T>::fft (octave_idx_type n, int dim, bool inverse) const
+{
+  rep->assure_valid ();
+  assure_valid_array_prog ();
+
+  if (kernel_indices [OclArrayKernels::fft_stage] < 0)
+    ocl_error ("not applicable to type OclArray of this class");
+
+  if (dim < 0)
+    dim = dimensions.first_non_singleton ();
+
+  dim_vector new_dimensions = dimensions.redim (std::max (dim + 1, ndims ()));
+  octave_idx_type len = new_dimensions (dim);
+  octave_idx_type fac = 1;
+  for (int i=0; i<dim; i++)
+    fac *= new_dimensions (i);
+  if (n < 0)
+    n = len;
+  new_dimensions (dim) = n;
+
+  if (new_dimensions.safe_numel () == 0)
+    return OclArray<T> (new_dimensions);
+
+  octave_idx_type num_transforms = new_dimensions.safe_numel () / n;
+
+  // zero padding or truncation
+  OclArray<T> src (*this);
+  if (n != len) {
+    src = OclArray<T> (new_dimensions);
+    if (len == 0) {
+      src.fill (T (0));
+    } else {
+      int kernel_index = kernel_indices [OclArrayKernels::fft_resize];
+
+      array_prog.set_kernel_arg (kernel_index, 0, src);
+      array_prog.set_kernel_arg (kernel_index, 1, *this);
+      array_prog.set_kernel_arg (kernel_index, 2, octave_uint64 (slice_ofs));
+      array_prog.set_kernel_arg (kernel_index, 3, octave_uint64 (len));
+      array_prog.set_kernel_arg (kernel_index, 4, octave_uint64 (n));
+      array_prog.set_kernel_arg (kernel_index, 5, octave_uint64 (fac));
+      array_prog.set_kernel_arg (kernel_index, 6, octave_uint64 (src.numel ()));
+
+      array_prog.enqueue_kernel_grid (kernel_index, src.numel ());
+    }
+  }
+
+  if (n == 1)
+    return OclArray<T> (src, new_dimensions);
+
+  long sign = inverse ? 1 : -1;
+  double scale = inverse ? 1.0 / n : 1.0;
+
+  OclArray<T> result (new_dimensions);
+
+  OclFftPlan<T>& plan = fft_plan<T> (n);
+
+  if (plan.m == 0) {
+    fft_stockham (result, src, plan.radices, n, fac, num_transforms, sign, scale);
+    return result;
+  }
+
+  // Bluestein: a chirp-z convolution of padded length m
+  octave_idx_type m = plan.m;
+  OclArray<T>& filter = plan.filter [inverse ? 1 : 0];
+  if (filter.numel () != m) {
+    OclArray<T> chirp (dim_vector (m, 1));
+
+    int kernel_index = kernel_indices [OclArrayKernels::fft_chirp_filter];
+
+    array_prog.set_kernel_arg (kernel_index, 0, chirp);
+    array_prog.set_kernel_arg (kernel_index, 1, octave_uint64 (n));
+    array_prog.set_kernel_arg (kernel_index, 2, octave_uint64 (m));
+    array_prog.set_kernel_arg (kernel_index, 3, octave_int64 (sign));
+
+    array_prog.enqueue_kernel_grid (kernel_index, m);
+
+    filter = OclArray<T> (dim_vector (m, 1));
+    fft_stockham (filter, chirp, plan.m_radices, m, 1, 1, -1, 1.0);
+
+    OclFftPlanCache<T>& cache = fft_plan_cache<T> ();
+    cache.filter_bytes += filter.byte_size ();
+    cache.num_filters++;
+    fft_plan_cache_trim<T> (n);
+  }
+
+  OclArray<T> a (dim_vector (m, num_transforms));
+  OclArray<T> b (dim_vector (m, num_transforms));
+
+  int kernel_index = kernel_indices [OclArrayKernels::fft_chirp_pre];
+
+  array_prog.set_kernel_arg (kernel_index, 0, a);
+  array_prog.set_kernel_arg (kernel_index, 1, src);
+  array_prog.set_kernel_arg (kernel_index, 2, octave_uint64 (src.slice_ofs));
+  array_prog.set_kernel_arg (kernel_index, 3, octave_uint64 (n));
+  array_prog.set_kernel_arg (kernel_index, 4, octave_uint64 (fac));
+  array_prog.set_kernel_arg (kernel_index, 5, octave_uint64 (m));
+  array_prog.set_kernel_arg (kernel_index, 6, octave_int64 (sign));
+  array_prog.set_kernel_arg (kernel_index, 7, octave_uint64 (a.numel ()));
+
+  array_prog.enqueue_kernel_grid (kernel_index, a.numel ());
+
+  fft_stockham (b, a, plan.m_radices, m, 1, num_transforms, -1, 1.0);
+
+  kernel_index = kernel_indices [OclArrayKernels::fft_chirp_mul];
+
+  array_prog.set_kernel_arg (kernel_index, 0, b);
+  array_prog.set_kernel_arg (kernel_index, 1, filter);
+  array_prog.set_kernel_arg (kernel_index, 2, octave_uint64 (m));
+  array_prog.set_kernel_arg (kernel_index, 3, octave_uint64 (b.numel ()));
+
+  array_prog.enqueue_kernel_grid (kernel_index, b.numel ());
+
+  fft_stockham (a, b, plan.m_radices, m, 1, num_transforms, 1, 1.0 / m);
+
+  kernel_index = kernel_indices [OclArrayKernels::fft_chirp_post];
+
+  array_prog.set_kernel_arg (kernel_index, 0, result);
+  array_prog.set_kernel_arg (kernel_index, 1, a);
+  array_prog.set_kernel_arg (kernel_index, 2, octave_uint64 (n));
+  array_prog.set_kernel_arg (kernel_index, 3, octave_uint64 (fac));
+  array_prog.set_kernel_arg (kernel_index, 4, octave_uint64 (m));
+  array_prog.set_kernel_arg (kernel_index, 5, octave_int64 (sign));
+  array_prog.set_kernel_arg (kernel_index, 6, T (scale));
+  array_prog.set_kernel_arg (kernel_index, 7, octave_uint64 (result.numel ()));
+
+  array_prog.enqueue_kernel_grid (kernel_index, result.numel ());
+
+  return result;
+}
+
+
+template <typename T>
+void
+OclArray<T>::fft_stockham (OclArray<T>& dst,
+                           const OclArray<T>& src,
+                           const std::vector<octave_idx_type>& radices,
+                           octave_idx_type n,
+                           octave_idx_type fac,
+                           octave_idx_type num_transforms,
+                           long sign,
+                           double scale)
+{
+  int kernel_index = kernel_indices [OclArrayKernels::fft_stage];
+
+  // ping-pong between dst and a work array, such that the last pass writes to dst
+  int num_passes = radices.size ();
+  OclArray<T> work;
+  if (num_passes > 1)
+    work = OclArray<T> (dst.dims ());
+
+  const OclArray<T> *pass_src = & src;
+  octave_idx_type ns = 1;
+
+  for (int p = 0; p < num_passes; p++) {
+    OclArray<T> *pass_dst = (((num_passes - p) % 2) == 1) ? & dst : & work;
+    octave_idx_type r = radices [p];
+    octave_idx_type num = num_transforms * (n / r);
+
+    array_prog.set_kernel_arg (kernel_index, 0, *pass_dst);
+    array_prog.set_kernel_arg (kernel_index, 1, *pass_src);
+    array_prog.set_kernel_arg (kernel_index, 2, octave_uint64 (pass_src->slice_ofs));
+    array_prog.set_kernel_arg (kernel_index, 3, octave_uint64 (n));
+    array_prog.set_kernel_arg (kernel_index, 4, octave_uint64 (fac));
+    array_prog.set_kernel_arg (kernel_index, 5, octave_uint64 (r));
+    array_prog.set_kernel_arg (kernel_index, 6, octave_uint64 (ns));
+    array_prog.set_kernel_arg (kernel_index, 7, octave_int64 (sign));
+    array_prog.set_kernel_arg (kernel_index, 8, T ((p == num_passes - 1) ? scale : 1.0));
+    array_prog.set_kernel_arg (kernel_index, 9, octave_uint64 (num));
+
+    array_prog.enqueue_kernel_grid (kernel_index, num);
+
+    pass_src = pass_dst;
+    ns *= r;
+  }
+}
+
+
+template <typename T>
+bool
+OclArray<T>::conv_is_direct (octave_idx_type mk, octave_idx_type nk)
+{
+  return ((mk >= 0) && (nk >= 0) && (mk * nk <= (octave_idx_type) conv_direct_max_taps));
+}
+
+
+template <typename T>
+OclArray<T>
+OclArray<T>::conv (const Array<T>& kern, int dim, octave_idx_type n_out, octave_idx_type shift) const
+{
+  rep->assure_valid ();
+  assure_valid_array_prog ();
+
+  if (dim < 0)
+    dim = dimensions.first_non_singleton ();
+
+  dim_vector new_dimensions = dimensions.redim (std::max (dim + 1, ndims ()));
+  octave_idx_type ns = new_dimensions (dim);
+  octave_idx_type nk = kern.numel ();
+  octave_idx_type fac = 1;
+  for (int i=0; i<dim; i++)
+    fac *= new_dimensions (i);
+  new_dimensions (dim) = n_out;
+
+  OclArray<T> result (new_dimensions);
+  if (result.numel () == 0)
+    return result;
+  if ((ns == 0) || (nk == 0)) {
+    result.fill (T (0));
+    return result;
+  }
+
+  octave_idx_type num_slices = result.numel () / n_out;
+  OclArray<T> kern_ocl (kern);
+
+  int kernel_index = kernel_indices [OclArrayKernels::conv1];
+
+  size_t local_size = array_prog.reduction_group_size (kernel_index, n_out);
+  size_t groups_per_slice = (n_out + local_size - 1) / local_size;
+
+  array_prog.set_kernel_arg (kernel_index, 0, result);
+  array_prog.set_kernel_arg (kernel_index, 1, *this);
+  array_prog.set_kernel_arg (kernel_index, 2, octave_uint64 (slice_ofs));
+  array_prog.set_kernel_arg (kernel_index, 3, kern_ocl);
+  array_prog.set_kernel_arg (kernel_index, 4, octave_uint64 (nk));
+  array_prog.set_kernel_arg (kernel_index, 5, octave_uint64 (ns));
+  array_prog.set_kernel_arg (kernel_index, 6, octave_uint64 (n_out));
+  array_prog.set_kernel_arg (kernel_index, 7, octave_uint64 (fac));
+  array_prog.set_kernel_arg (kernel_index, 8, octave_uint64 (shift));
+  array_prog.set_kernel_arg_local (kernel_index, 9, (local_size + 2 * nk - 1) * sizeof (T));
+
+  array_prog.enqueue_kernel_groups (kernel_index, num_slices, local_size, groups_per_slice);
+
+  return result;
+}
+
+
+template <typename T>
+OclArray<T>
+OclArray<T>::conv2 (const Array<T>& kern, octave_idx_type m_out, octave_idx_type n_out,
+                    octave_idx_type shift_r, octave_idx_type shift_c) const
+{
+  if ((ndims () != 2) || (kern.ndims () != 2))
+    ocl_error ("OclArray: operands must be 2-dim arrays, or vectors, for 2-dim convolution");
+
+  rep->assure_valid ();
+  assure_valid_array_prog ();
+
+  octave_idx_type ms = dim1 (), ns = dim2 ();
+  octave_idx_type mk = kern.rows (), nk = kern.cols ();
+
+  OclArray<T> result (dim_vector (m_out, n_out));
+  if (result.numel () == 0)
+    return result;
+  if ((numel () == 0) || (kern.numel () == 0)) {
+    result.fill (T (0));
+    return result;
+  }
+
+  OclArray<T> kern_ocl (kern);
+
+  int kernel_index = kernel_indices [OclArrayKernels::conv2];
+
+  // square output tiles, as large as the work-group size and the local
+  // memory budget for the source tile and the kernel allow
+  size_t max_items = array_prog.reduction_group_size (kernel_index, std::numeric_limits<size_t>::max ());
+  size_t ts = conv2_tile_dim;
+  while ((ts > 1) &&
+         ((ts * ts > max_items) ||
+          (((ts + mk - 1) * (ts + nk - 1) + mk * nk) * sizeof (T) > conv_local_bytes)))
+    ts /= 2;
+  size_t num_groups = ((m_out + ts - 1) / ts) * ((n_out + ts - 1) / ts);
+
+  array_prog.set_kernel_arg (kernel_index, 0, result);
+  array_prog.set_kernel_arg (kernel_index, 1, *this);
+  array_prog.set_kernel_arg (kernel_index, 2, octave_uint64 (slice_ofs));
+  array_prog.set_kernel_arg (kernel_index, 3, kern_ocl);
+  array_prog.set_kernel_arg (kernel_index, 4, octave_uint64 (mk));
+  array_prog.set_kernel_arg (kernel_index, 5, octave_uint64 (nk));
+  array_prog.set_kernel_arg (kernel_index, 6, octave_uint64 (ms));
+  array_prog.set_kernel_arg (kernel_index, 7, octave_uint64 (ns));
+  array_prog.set_kernel_arg (kernel_index, 8, octave_uint64 (m_out));
+  array_prog.set_kernel_arg (kernel_index, 9, octave_uint64 (n_out));
+  array_prog.set_kernel_arg (kernel_index, 10, octave_uint64 (shift_r));
+  array_prog.set_kernel_arg (kernel_index, 11, octave_uint64 (shift_c));
+  array_prog.set_kernel_arg (kernel_index, 12, octave_uint64 (ts));
+  array_prog.set_kernel_arg_local (kernel_index, 13, ((ts + mk - 1) * (ts + nk - 1) + mk * nk) * sizeof (T));
+
+  array_prog.enqueue_kernel_groups (kernel_index, 1, ts * ts, num_groups);
+
+  return result;
+}
+
+
+template <typename T>
+OclArray<T>
+OclArray<T>::filter_iir (const Array<T>& a, int dim) const
+{
+  rep->assure_valid ();
+  assure_valid_array_prog ();
+
+  if (dim < 0)
+    dim = dimensions.first_non_singleton ();
+
+  dim_vector new_dimensions = dimensions.redim (std::max (dim + 1, ndims ()));
+  octave_idx_type n = new_dimensions (dim);
+  octave_idx_type p = a.numel ();
+  octave_idx_type fac = 1;
+  for (int i=0; i<dim; i++)
+    fac *= new_dimensions (i);
+
+  if ((numel () == 0) || (p == 0))
+    return *this;
+
+  OclArray<T> result (dimensions);
+  octave_idx_type num_slices = numel () / n;
+
+  // chunks: enough of them for all slices together to keep the device
+  // busy, but not shorter than iir_min_chunk (nor than a few times p)
+  octave_idx_type min_len = std::max ((octave_idx_type) iir_min_chunk, 4 * p);
+  octave_idx_type nc = std::min ((n + min_len - 1) / min_len,
+                                 ((octave_idx_type) iir_target_items + num_slices - 1) / num_slices);
+  nc = std::max (nc, (octave_idx_type) 1);
+  octave_idx_type m = (n + nc - 1) / nc;
+  nc = (n + m - 1) / m;
+
+  OclArray<T> a_ocl (a);
+  OclArray<T> state (a_ocl); // not read by the zero-state pass
+
+  int kernel_index = kernel_indices [OclArrayKernels::iir_chunk];
+
+  for (int pass=0; pass<2; pass++) {
+    if (pass == 1) {
+      if (nc == 1)
+        break;
+
+      // the map of a chunk's initial state to its last p outputs,
+      // from the homogeneous recursion (x = 0) on the host
+      Array<T> trans (dim_vector (p, p));
+      Array<T> y (dim_vector (p + m, 1));
+      for (octave_idx_type i=0; i<p; i++) {
+        y.fill (T (0));
+        y (p - 1 - i) = T (1);
+        for (octave_idx_type k=0; k<m; k++) {
+          T val = T (0);
+          for (octave_idx_type j=1; j<=p; j++)
+            val -= a (j-1) * y (p + k - j);
+          y (p + k) = val;
+        }
+        for (octave_idx_type j=0; j<p; j++)
+          trans (j, i) = y (p + m - 1 - j);
+      }
+      OclArray<T> trans_ocl (trans);
+
+      state = OclArray<T> (dim_vector (num_slices * nc * p, 1));
+
+      int carry_index = kernel_indices [OclArrayKernels::iir_carry];
+
+      array_prog.set_kernel_arg (carry_index, 0, state);
+      array_prog.set_kernel_arg (carry_index, 1, result);
+      array_prog.set_kernel_arg (carry_index, 2, trans_ocl);
+      array_prog.set_kernel_arg (carry_index, 3, octave_uint64 (p));
+      array_prog.set_kernel_arg (carry_index, 4, octave_uint64 (n));
+      array_prog.set_kernel_arg (carry_index, 5, octave_uint64 (fac));
+      array_prog.set_kernel_arg (carry_index, 6, octave_uint64 (num_slices));
+      array_prog.set_kernel_arg (carry_index, 7, octave_uint64 (m));
+      array_prog.set_kernel_arg (carry_index, 8, octave_uint64 (nc));
+
+      array_prog.enqueue_kernel_grid (carry_index, num_slices);
+    }
+
+    array_prog.set_kernel_arg (kernel_index, 0, result);
+    array_prog.set_kernel_arg (kernel_index, 1, *this);
+    array_prog.set_kernel_arg (kernel_index, 2, octave_uint64 (slice_ofs));
+    array_prog.set_kernel_arg (kernel_index, 3, a_ocl);
+    array_prog.set_kernel_arg (kernel_index, 4, octave_uint64 (p));
+    array_prog.set_kernel_arg (kernel_index, 5, octave_uint64 (n));
+    array_prog.set_kernel_arg (kernel_index, 6, octave_uint64 (fac));
+    array_prog.set_kernel_arg (kernel_index, 7, octave_uint64 (num_slices));
+    array_prog.set_kernel_arg (kernel_index, 8, octave_uint64 (m));
+    array_prog.set_kernel_arg (kernel_index, 9, octave_uint64 (nc));
+    array_prog.set_kernel_arg (kernel_index, 10, state);
+    array_prog.set_kernel_arg (kernel_index, 11, octave_uint64 (pass));
+
+    array_prog.enqueue_kernel_grid (kernel_index, num_slices * nc);
+  }
+
+  return result;
+}
+
+
+template <typename T>
+OclArray<T>
+OclArray<T>::map_tri (octave_idx_type k, unsigned long fcn) const
+{
+  if (ndims () != 2)
+    ocl_error ("OclArray: triangular part needs a 2-dim array");
+
+  rep->assure_valid ();
+  assure_valid_array_prog ();
+
+  OclArray<T> result (dimensions);
+  if (numel () == 0)
+    return result;
+
+  int kernel_index = kernel_indices [OclArrayKernels::tri];
+
+  array_prog.set_kernel_arg (kernel_index, 0, result);
+  array_prog.set_kernel_arg (kernel_index, 1, *this);
+  array_prog.set_kernel_arg (kernel_index, 2, octave_uint64 (slice_ofs));
+  array_prog.set_kernel_arg (kernel_index, 3, octave_uint64 (dim1 ()));
+  array_prog.set_kernel_arg (kernel_index, 4, octave_uint64 (dim2 ()));
+  array_prog.set_kernel_arg (kernel_index, 5, octave_int64 (k));
+  array_prog.set_kernel_arg (kernel_index, 6, octave_uint64 (fcn));
+
+  array_prog.enqueue_kernel_grid (kernel_index, numel ());
+
+  return result;
+}
+
+
+template <typename T>
+OclArray<T>
+OclArray<T>::get_block (octave_idx_type r0, octave_idx_type c0,
+                        octave_idx_type m, octave_idx_type n) const
+{
+  OclArray<T> result (dim_vector (m, n));
+  if (result.numel () == 0)
+    return result;
+
+  rep->assure_valid ();
+  assure_valid_array_prog ();
+
+  int kernel_index = kernel_indices [OclArrayKernels::copy_block];
+
+  array_prog.set_kernel_arg (kernel_index, 0, result);
+  array_prog.set_kernel_arg (kernel_index, 1, octave_uint64 (0));
+  array_prog.set_kernel_arg (kernel_index, 2, octave_uint64 (m));
+  array_prog.set_kernel_arg (kernel_index, 3, *this);
+  array_prog.set_kernel_arg (kernel_index, 4, octave_uint64 (slice_ofs + r0 + c0 * dim1 ()));
+  array_prog.set_kernel_arg (kernel_index, 5, octave_uint64 (dim1 ()));
+  array_prog.set_kernel_arg (kernel_index, 6, octave_uint64 (m));
+  array_prog.set_kernel_arg (kernel_index, 7, octave_uint64 (n));
+  array_prog.set_kernel_arg (kernel_index, 8, octave_uint64 (0));
+
+  array_prog.enqueue_kernel_grid (kernel_index, m * n);
+
+  return result;
+}
+
+
+// in place: only for the unique working copies of the linear algebra
+template <typename T>
+void
+OclArray<T>::set_block (octave_idx_type r0, octave_idx_type c0, const OclArray<T>& s, bool subtract)
+{
+  octave_idx_type m = s.dim1 ();
+  octave_idx_type n = s.dim2 ();
+  if (m * n == 0)
+    return;
+
+  int kernel_index = kernel_indices [OclArrayKernels::copy_block];
+
+  array_prog.set_kernel_arg (kernel_index, 0, *this);
+  array_prog.set_kernel_arg (kernel_index, 1, octave_uint64 (slice_ofs + r0 + c0 * dim1 ()));
+  array_prog.set_kernel_arg (kernel_index, 2, octave_uint64 (dim1 ()));
+  array_prog.set_kernel_arg (kernel_index, 3, s);
+  array_prog.set_kernel_arg (kernel_index, 4, octave_uint64 (s.slice_ofs));
+  array_prog.set_kernel_arg (kernel_index, 5, octave_uint64 (m));
+  array_prog.set_kernel_arg (kernel_index, 6, octave_uint64 (m));
+  array_prog.set_kernel_arg (kernel_index, 7, octave_uint64 (n));
+  array_prog.set_kernel_arg (kernel_index, 8, octave_uint64 (subtract ? 1 : 0));
+
+  array_prog.enqueue_kernel_grid (kernel_index, m * n);
+}
+
+
+template <typename T>
+void
+OclArray<T>::lu_swap (const OclArray<ocl_idx_type>& ipiv, octave_idx_type k0, octave_idx_type k1,
+                      octave_idx_type skip0, octave_idx_type skip1)
+{
+  if ((k1 <= k0) || (dim2 () == 0))
+    return;
+
+  int kernel_index = kernel_indices [OclArrayKernels::lu_swap];
+
+  array_prog.set_kernel_arg (kernel_index, 0, *this);
+  array_prog.set_kernel_arg (kernel_index, 1, octave_uint64 (slice_ofs));
+  array_prog.set_kernel_arg (kernel_index, 2, octave_uint64 (dim1 ()));
+  array_prog.set_kernel_arg (kernel_index, 3, octave_uint64 (dim2 ()));
+  array_prog.set_kernel_arg (kernel_index, 4, ipiv);
+  array_prog.set_kernel_arg (kernel_index, 5, octave_uint64 (k0));
+  array_prog.set_kernel_arg (kernel_index, 6, octave_uint64 (k1));
+  array_prog.set_kernel_arg (kernel_index, 7, octave_uint64 (skip0));
+  array_prog.set_kernel_arg (kernel_index, 8, octave_uint64 (skip1));
+
+  array_prog.enqueue_kernel (kernel_index, dim2 ());
+}
+
+
+// blocked: the diagonal blocks of *this in the order of substitution (from
+// the top for an effectively lower triangular op (*this), else from the
+// bottom), each solved by a single launch (a work-item per column of b),
+// followed by the update of the rows of b still to be solved by a product
+template <typename T>
+void
+OclArray<T>::trsm_inplace (OclArray<T>& b, bool upper, char trans, bool unit_diag) const
+{
+  octave_idx_type n = dim1 ();
+  octave_idx_type m = b.dim2 ();
+  octave_idx_type nb = linalg_block_size;
+  unsigned long t = trans_code (trans);
+  bool forward = (upper == (t != 0));
+
+  if ((n == 0) || (m == 0))
+    return;
+
+  int kernel_index = kernel_indices [OclArrayKernels::trsm_block];
+
+  for (octave_idx_type i=0; i<n; i+=nb) {
+    octave_idx_type k0 = forward ? i : std::max (n - i - nb, (octave_idx_type) 0);
+    octave_idx_type k1 = forward ? std::min (i + nb, n) : n - i;
+    octave_idx_type kb = k1 - k0;
+
+    array_prog.set_kernel_arg (kernel_index, 0, *this);
+    array_prog.set_kernel_arg (kernel_index, 1, octave_uint64 (slice_ofs + k0 + k0 * n));
+    array_prog.set_kernel_arg (kernel_index, 2, octave_uint64 (n));
+    array_prog.set_kernel_arg (kernel_index, 3, b);
+    array_prog.set_kernel_arg (kernel_index, 4, octave_uint64 (b.slice_ofs + k0));
+    array_prog.set_kernel_arg (kernel_index, 5, octave_uint64 (n));
+    array_prog.set_kernel_arg (kernel_index, 6, octave_uint64 (kb));
+    array_prog.set_kernel_arg (kernel_index, 7, octave_uint64 (m));
+    array_prog.set_kernel_arg (kernel_index, 8, octave_uint64 (upper ? 1 : 0));
+    array_prog.set_kernel_arg (kernel_index, 9, octave_uint64 (t));
+    array_prog.set_kernel_arg (kernel_index, 10, octave_uint64 (unit_diag ? 1 : 0));
+
+    array_prog.enqueue_kernel (kernel_index, m);
+
+    // b (rows r0 .. r0+nr-1) -= op (*this) (same rows, columns k0 .. k1-1) * b (rows k0 .. k1-1)
+    octave_idx_type r0 = forward ? k1 : 0;
+    octave_idx_type nr = forward ? n - k1 : k0;
+    if (nr > 0) {
+      OclArray<T> a_blk = (t == 0) ? get_block (r0, k0, nr, kb) : get_block (k0, r0, kb, nr);
+      b.set_block (r0, 0, a_blk.mtimes (b.get_block (k0, 0, kb, m), trans, 'N'), true);
+    }
+  }
+}
+
+
+template <typename T>
+OclArray<T>
+OclArray<T>::trsm (const OclArray<T>& b, bool upper, char trans, bool unit_diag) const
+{
+  if ((ndims () != 2) || (b.ndims () != 2) || (dim1 () != dim2 ()))
+    ocl_error ("OclArray: triangular solve needs a square matrix and a 2-dim right-hand side");
+  if (b.dim1 () != dim1 ())
+    ocl_error ("OclArray: mismatch in operands' sizes for triangular solve");
+
+  rep->assure_valid ();
+  b.rep->assure_valid ();
+  assure_valid_array_prog ();
+
+  if (kernel_indices [OclArrayKernels::trsm_block] < 0)
+    ocl_error ("not applicable to type OclArray of this class");
+
+  OclArray<T> x (b);
+  x.make_unique ();
+  trsm_inplace (x, upper, trans, unit_diag);
+
+  return x;
+}
+
+
+// right-looking: each panel is factorized by a single work-group, then its
+// row interchanges are applied to the other columns, the block row of U is
+// solved (L11 \ A12), and the trailing matrix is updated (A22 -= L21 * U12)
+template <typename T>
+OclArray<T>
+OclArray<T>::lu (OclArray<ocl_idx_type>& ipiv, octave_idx_type& info) const
+{
+  if (ndims () != 2)
+    ocl_error ("OclArray: LU factorization needs a 2-dim matrix");
+
+  rep->assure_valid ();
+  assure_valid_array_prog ();
+
+  int kernel_index = kernel_indices [OclArrayKernels::lu_panel];
+
+  if (kernel_index < 0)
+    ocl_error ("not applicable to type OclArray of this class");
+
+  octave_idx_type m = dim1 ();
+  octave_idx_type n = dim2 ();
+  octave_idx_type mn = std::min (m, n);
+
+  OclArray<T> a (*this);
+  a.make_unique ();
+  ipiv = OclArray<ocl_idx_type> (dim_vector (mn, 1));
+  OclArray<ocl_idx_type> info_ocl (dim_vector (1, 1), ocl_idx_type (0));
+
+  for (octave_idx_type k0=0; k0<mn; k0+=linalg_block_size) {
+    octave_idx_type nb = std::min ((octave_idx_type) linalg_block_size, mn - k0);
+    octave_idx_type k1 = k0 + nb;
+    size_t local_size = array_prog.reduction_group_size (kernel_index, m - k0);
+
+    array_prog.set_kernel_arg (kernel_index, 0, a);
+    array_prog.set_kernel_arg (kernel_index, 1, octave_uint64 (0));
+    array_prog.set_kernel_arg (kernel_index, 2, octave_uint64 (m));
+    array_prog.set_kernel_arg (kernel_index, 3, octave_uint64 (k0));
+    array_prog.set_kernel_arg (kernel_index, 4, octave_uint64 (nb));
+    array_prog.set_kernel_arg (kernel_index, 5, ipiv);
+    array_prog.set_kernel_arg (kernel_index, 6, info_ocl);
+    array_prog.set_kernel_arg_local (kernel_index, 7, local_size * sizeof (T));
+    array_prog.set_kernel_arg_local (kernel_index, 8, local_size * sizeof (ocl_idx_type));
+
+    array_prog.enqueue_kernel_groups (kernel_index, 1, local_size);
+
+    a.lu_swap (ipiv, k0, k1, k0, k1);
+
+    if (k1 < n) {
+      OclArray<T> u12 = a.get_block (k0, k1, nb, n - k1);
+      a.get_block (k0, k0, nb, nb).trsm_inplace (u12, false, 'N', true);
+      a.set_block (k0, k1, u12, false);
+      if (k1 < m)
+        a.set_block (k1, k1, a.get_block (k1, k0, m - k1, nb).mtimes (u12), true);
+    }
+  }
+
+  info = (mn > 0) ? info_ocl.as_array () (0).value () : 0;
+
+  return a;
+}
+
+
+// right-looking, as lu: each diagonal block is factorized by a single
+// work-group, then the block row of R is solved (R11' \ A12), and the
+// trailing matrix is updated (A22 -= R12' * R12, a rank-k product)
+template <typename T>
+OclArray<T>
+OclArray<T>::chol (octave_idx_type& info) const
+{
+  if ((ndims () != 2) || (dim1 () != dim2 ()))
+    ocl_error ("OclArray: Cholesky factorization needs a square matrix");
+
+  rep->assure_valid ();
+  assure_valid_array_prog ();
+
+  int kernel_index = kernel_indices [OclArrayKernels::chol_block];
+
+  if (kernel_index < 0)
+    ocl_error ("not applicable to type OclArray of this class");
+
+  octave_idx_type n = dim1 ();
+
+  OclArray<T> a (*this);
+  a.make_unique ();
+  OclArray<ocl_idx_type> info_ocl (dim_vector (1, 1), ocl_idx_type (0));
+
+  for (octave_idx_type k0=0; k0<n; k0+=linalg_block_size) {
+    octave_idx_type nb = std::min ((octave_idx_type) linalg_block_size, n - k0);
+    octave_idx_type k1 = k0 + nb;
+    size_t local_size = array_prog.reduction_group_size (kernel_index, nb * nb);
+
+    array_prog.set_kernel_arg (kernel_index, 0, a);
+    array_prog.set_kernel_arg (kernel_index, 1, octave_uint64 (k0 + k0 * n));
+    array_prog.set_kernel_arg (kernel_index, 2, octave_uint64 (n));
+    array_prog.set_kernel_arg (kernel_index, 3, octave_uint64 (nb));
+    array_prog.set_kernel_arg (kernel_index, 4, octave_uint64 (k0));
+    array_prog.set_kernel_arg (kernel_index, 5, info_ocl);
+
+    array_prog.enqueue_kernel_groups (kernel_index, 1, local_size);
+
+    if (k1 < n) {
+      OclArray<T> r12 = a.get_block (k0, k1, nb, n - k1);
+      a.get_block (k0, k0, nb, nb).trsm_inplace (r12, true, 'C', false);
+      a.set_block (k0, k1, r12, false);
+      a.set_block (k1, k1, r12.mtimes (r12, 'C', 'N'), true);
+    }
+  }
+
+  info = (n > 0) ? info_ocl.as_array () (0).value () : 0;
+
+  return a.triu ();
+}
+
+
+template <typename T>
+OclArray<T>
+OclArray<T>::mldivide (const OclArray<T>& b, octave_idx_type& info) const
+{
+  if ((ndims () != 2) || (b.ndims () != 2))
+    ocl_error ("OclArray: operands must both be 2-dim arrays, or vectors, for left division");
+  if (dim1 () != b.dim1 ())
+    ocl_error ("OclArray: mismatch in operands' sizes for left division");
+  if (dim1 () != dim2 ())
+    ocl_error ("OclArray: left division is only implemented for square matrices");
+
+  OclArray<ocl_idx_type> ipiv;
+  OclArray<T> a = lu (ipiv, info);
+
+  b.rep->assure_valid ();
+  OclArray<T> x (b);
+  x.make_unique ();
+  x.lu_swap (ipiv, 0, dim1 ());
+  a.trsm_inplace (x, false, 'N', true);
+  a.trsm_inplace (x, true, 'N', false);
+
+  return x;
+}
+
+
+template <typename T>
+void
+OclArray<T>::sort_keys (OclArray<ocl_idx_type>& keys, OclArray<ocl_idx_type>& perm, bool use_perm)
+{
+  octave_idx_type n = keys.numel ();
+
+  int kernel_index = kernel_indices [OclArrayKernels::bitonic_step];
+
+  for (octave_idx_type k=2; k<=n; k*=2)
+    for (octave_idx_type j=k/2; j>0; j/=2) {
+      array_prog.set_kernel_arg (kernel_index, 0, keys);
+      array_prog.set_kernel_arg (kernel_index, 1, use_perm ? perm : keys);
+      array_prog.set_kernel_arg (kernel_index, 2, octave_uint64 (use_perm ? 1 : 0));
+      array_prog.set_kernel_arg (kernel_index, 3, octave_uint64 (j));
+      array_prog.set_kernel_arg (kernel_index, 4, octave_uint64 (k));
+
+      array_prog.enqueue_kernel (kernel_index, n / 2);
+    }
+}
+
+
+// the smallest power of two of at least n, the length of the sort keys
+static octave_idx_type
+sort_keys_length (octave_idx_type n)
+{
+  octave_idx_type n_keys = 1;
+  while (n_keys < n)
+    n_keys *= 2;
+  return n_keys;
+}
+
+
+// privatised histograms in local memory for up to scatter_local_bytes of
+// counts (one or more work-groups per slice), else a sort of the bin keys
+// of all elements, the counts being the lengths of the runs of equal keys
+template <typename T>
+OclArray<octave_uint32>
+OclArray<T>::histc_counts (const OclArray<T>& edges, int dim,
+                           dim_vector& new_dimensions, octave_idx_type& fac) const
+{
+  rep->assure_valid ();
+  edges.rep->assure_valid ();
+  assure_valid_array_prog ();
+
+  if (kernel_indices [OclArrayKernels::histc_local] < 0)
+    ocl_error ("not applicable to type OclArray of this class");
+
+  octave_idx_type nb = edges.numel ();
+  if (nb == 0)
+    ocl_error ("OclArray: histc needs at least one edge");
+
+  if (dim < 0)
+    dim = dimensions.first_non_singleton ();
+
+  octave_idx_type len;
+
+  dim_wise_op_newdims (dim, new_dimensions, len, fac);
+  if (dim >= new_dimensions.ndims ())
+    new_dimensions.resize (dim + 1, 1);
+  new_dimensions (dim) = nb;
+
+  if ((numel () == 0) || (len == 0))
+    return OclArray<octave_uint32> ();
+
+  octave_idx_type num_slices = slice_len / len;
+  OclArray<octave_uint32> counts (dim_vector (nb, num_slices), octave_uint32 (0));
+
+  if (nb * sizeof (octave_uint32) <= scatter_local_bytes) {
+    int kernel_index = kernel_indices [OclArrayKernels::histc_local];
+    size_t local_size = array_prog.reduction_group_size (kernel_index, len);
+    size_t groups_per_slice = array_prog.reduction_groups_per_slice (num_slices, len, local_size);
+
+    array_prog.set_kernel_arg (kernel_index, 0, counts);
+    array_prog.set_kernel_arg (kernel_index, 1, *this);
+    array_prog.set_kernel_arg (kernel_index, 2, octave_uint64 (slice_ofs));
+    array_prog.set_kernel_arg (kernel_index, 3, edges);
+    array_prog.set_kernel_arg (kernel_index, 4, octave_uint64 (edges.slice_ofs));
+    array_prog.set_kernel_arg (kernel_index, 5, octave_uint64 (nb));
+    array_prog.set_kernel_arg (kernel_index, 6, octave_uint64 (len));
+    array_prog.set_kernel_arg (kernel_index, 7, octave_uint64 (fac));
+    array_prog.set_kernel_arg_local (kernel_index, 8, nb * sizeof (octave_uint32));
+
+    array_prog.enqueue_kernel_groups (kernel_index, num_slices, local_size, groups_per_slice);
+  } else {
+    octave_idx_type n_keys = sort_keys_length (slice_len);
+    OclArray<ocl_idx_type> keys (dim_vector (n_keys, 1));
+
+    int kernel_index = kernel_indices [OclArrayKernels::histc_keys];
+
+    array_prog.set_kernel_arg (kernel_index, 0, keys);
+    array_prog.set_kernel_arg (kernel_index, 1, *this);
+    array_prog.set_kernel_arg (kernel_index, 2, octave_uint64 (slice_ofs));
+    array_prog.set_kernel_arg (kernel_index, 3, edges);
+    array_prog.set_kernel_arg (kernel_index, 4, octave_uint64 (edges.slice_ofs));
+    array_prog.set_kernel_arg (kernel_index, 5, octave_uint64 (nb));
+    array_prog.set_kernel_arg (kernel_index, 6, octave_uint64 (len));
+    array_prog.set_kernel_arg (kernel_index, 7, octave_uint64 (fac));
+    array_prog.set_kernel_arg (kernel_index, 8, octave_uint64 (slice_len));
+    array_prog.set_kernel_arg (kernel_index, 9, octave_uint64 (n_keys));
+
+    array_prog.enqueue_kernel_grid (kernel_index, n_keys);
+
+    sort_keys (keys, keys, false);
+
+    kernel_index = kernel_indices [OclArrayKernels::histc_sorted];
+
+    array_prog.set_kernel_arg (kernel_index, 0, counts);
+    array_prog.set_kernel_arg (kernel_index, 1, keys);
+    array_prog.set_kernel_arg (kernel_index, 2, octave_uint64 (n_keys));
+    array_prog.set_kernel_arg (kernel_index, 3, octave_uint64 (counts.numel ()));
+
+    array_prog.enqueue_kernel_grid (kernel_index, counts.numel ());
+  }
+
+  return counts;
+}
+
+
+template <typename T>
+OclArray<double>
+OclArray<T>::histc (const OclArray<T>& edges, int dim) const
+{
+  dim_vector new_dimensions;
+  octave_idx_type fac;
+  OclArray<octave_uint32> counts = histc_counts (edges, dim, new_dimensions, fac);
+
+  if (counts.numel () == 0)
+    return OclArray<double> (new_dimensions, 0.0);
+
+  // the exact (uint) counts are stored as doubles, as by octave's histc
+  return OclArray<double>::histc_store (counts, new_dimensions, edges.numel (), fac);
+}
+
+
+// as histc_store, on the host
+template <typename T>
+Array<double>
+OclArray<T>::histc_host (const OclArray<T>& edges, int dim) const
+{
+  dim_vector new_dimensions;
+  octave_idx_type fac;
+  OclArray<octave_uint32> counts = histc_counts (edges, dim, new_dimensions, fac);
+
+  Array<double> result (new_dimensions, 0.0);
+  if (counts.numel () == 0)
+    return result;
+
+  Array<octave_uint32> c = counts.as_array ();
+  octave_idx_type nb = edges.numel ();
+  double *d = result.fortran_vec ();
+  for (octave_idx_type p=0; p<c.numel (); p++) {
+    octave_idx_type i = p / nb;
+    octave_idx_type b = p % nb;
+    d [(i % fac) + ((i / fac) * nb + b) * fac] = c (p).value ();
+  }
+
+  return result;
+}
+
+
+template <typename T>
+OclArray<T>
+OclArray<T>::histc_store (const OclArray<octave_uint32>& counts,
+                          const dim_vector& dv,
+                          octave_idx_type nb,
+                          octave_idx_type fac)
+{
+  assure_valid_array_prog ();
+
+  int kernel_index = kernel_indices [OclArrayKernels::histc_store];
+  if (kernel_index < 0)
+    ocl_error ("not applicable to type OclArray of this class");
+
+  OclArray<T> result (dv);
+
+  array_prog.set_kernel_arg (kernel_index, 0, result);
+  array_prog.set_kernel_arg (kernel_index, 1, counts);
+  array_prog.set_kernel_arg (kernel_index, 2, octave_uint64 (nb));
+  array_prog.set_kernel_arg (kernel_index, 3, octave_uint64 (fac));
+  array_prog.set_kernel_arg (kernel_index, 4, octave_uint64 (counts.numel ()));
+
+  array_prog.enqueue_kernel_grid (kernel_index, counts.numel ());
+
+  return result;
+}
+
+
+// atomic updates (compare-and-swap) where the element words allow them,
+// privatised in local memory for outputs of up to scatter_local_bytes;
+// else (8-bit and 16-bit integers, 64-bit types without the atomics
+// extension, max and min of complex values) a sort of the subscripts,
+// each output element then reducing the run of its subscript
+template <typename T>
+OclArray<T>
+OclArray<T>::accumarray (const OclArray<ocl_idx_type>& subs, const OclArray<T>& vals,
+                         octave_idx_type n_out, int fcn, const T& fillval)
+{
+  subs.rep->assure_valid ();
+  vals.rep->assure_valid ();
+  assure_valid_array_prog ();
+
+  octave_idx_type n = subs.numel ();
+  if ((vals.numel () != n) && (vals.numel () != 1))
+    ocl_error ("OclArray: accumarray needs as many values as subscripts, or a single value");
+
+  if ((n == 0) || (n_out == 0))
+    return OclArray<T> (dim_vector (n_out, 1), fillval);
+
+  OclArray<T> result (dim_vector (n_out, 1));
+  OclArray<ocl_idx_type> flag (dim_vector (1, 1), ocl_idx_type (0));
+  octave_uint64 vals_step (vals.numel () == 1 ? 0 : 1);
+
+  bool use_atomics = (kernel_indices [OclArrayKernels::accum_atomic] >= 0) &&
+                     ((fcn == 0) || (! is_complex_type ()));
+
+  if (use_atomics) {
+    OclArray<octave_uint32> hit (dim_vector (n_out, 1), octave_uint32 (0));
+
+    int kernel_index = kernel_indices [OclArrayKernels::accum_init];
+
+    array_prog.set_kernel_arg (kernel_index, 0, result);
+    array_prog.set_kernel_arg (kernel_index, 1, octave_uint64 (fcn));
+    array_prog.set_kernel_arg (kernel_index, 2, octave_uint64 (n_out));
+
+    array_prog.enqueue_kernel_grid (kernel_index, n_out);
+
+    bool use_local = (n_out * sizeof (T) <= scatter_local_bytes);
+    kernel_index = kernel_indices [use_local ? OclArrayKernels::accum_atomic_local
+                                             : OclArrayKernels::accum_atomic];
+
+    array_prog.set_kernel_arg (kernel_index, 0, result);
+    array_prog.set_kernel_arg (kernel_index, 1, subs);
+    array_prog.set_kernel_arg (kernel_index, 2, octave_uint64 (subs.slice_ofs));
+    array_prog.set_kernel_arg (kernel_index, 3, vals);
+    array_prog.set_kernel_arg (kernel_index, 4, octave_uint64 (vals.slice_ofs));
+    array_prog.set_kernel_arg (kernel_index, 5, vals_step);
+    array_prog.set_kernel_arg (kernel_index, 6, octave_uint64 (fcn));
+    array_prog.set_kernel_arg (kernel_index, 7, hit);
+    array_prog.set_kernel_arg (kernel_index, 8, octave_uint64 (n));
+    array_prog.set_kernel_arg (kernel_index, 9, octave_uint64 (n_out));
+    array_prog.set_kernel_arg (kernel_index, 10, flag);
+
+    if (use_local) {
+      size_t local_size = array_prog.reduction_group_size (kernel_index, n);
+      size_t num_groups = array_prog.reduction_groups_per_slice (1, n, local_size);
+
+      array_prog.set_kernel_arg_local (kernel_index, 11, n_out * sizeof (T));
+
+      array_prog.enqueue_kernel_groups (kernel_index, 1, local_size, num_groups);
+    } else
+      array_prog.enqueue_kernel_grid (kernel_index, n);
+
+    if ((fcn != 0) || (fillval != T (0))) {
+      kernel_index = kernel_indices [OclArrayKernels::accum_fill];
+
+      array_prog.set_kernel_arg (kernel_index, 0, result);
+      array_prog.set_kernel_arg (kernel_index, 1, hit);
+      array_prog.set_kernel_arg (kernel_index, 2, fillval);
+      array_prog.set_kernel_arg (kernel_index, 3, octave_uint64 (n_out));
+
+      array_prog.enqueue_kernel_grid (kernel_index, n_out);
+    }
+  } else {
+    octave_idx_type n_keys = sort_keys_length (n);
+    OclArray<ocl_idx_type> keys (dim_vector (n_keys, 1));
+    OclArray<ocl_idx_type> perm (dim_vector (n_keys, 1));
+
+    int kernel_index = kernel_indices [OclArrayKernels::accum_keys];
+
+    array_prog.set_kernel_arg (kernel_index, 0, keys);
+    array_prog.set_kernel_arg (kernel_index, 1, perm);
+    array_prog.set_kernel_arg (kernel_index, 2, subs);
+    array_prog.set_kernel_arg (kernel_index, 3, octave_uint64 (subs.slice_ofs));
+    array_prog.set_kernel_arg (kernel_index, 4, octave_uint64 (n));
+    array_prog.set_kernel_arg (kernel_index, 5, octave_uint64 (n_keys));
+    array_prog.set_kernel_arg (kernel_index, 6, octave_uint64 (n_out));
+    array_prog.set_kernel_arg (kernel_index, 7, flag);
+
+    array_prog.enqueue_kernel_grid (kernel_index, n_keys);
+
+    sort_keys (keys, perm, true);
+
+    kernel_index = kernel_indices [OclArrayKernels::accum_sorted];
+
+    array_prog.set_kernel_arg (kernel_index, 0, result);
+    array_prog.set_kernel_arg (kernel_index, 1, keys);
+    array_prog.set_kernel_arg (kernel_index, 2, perm);
+    array_prog.set_kernel_arg (kernel_index, 3, octave_uint64 (n_keys));
+    array_prog.set_kernel_arg (kernel_index, 4, vals);
+    array_prog.set_kernel_arg (kernel_index, 5, octave_uint64 (vals.slice_ofs));
+    array_prog.set_kernel_arg (kernel_index, 6, vals_step);
+    array_prog.set_kernel_arg (kernel_index, 7, octave_uint64 (fcn));
+    array_prog.set_kernel_arg (kernel_index, 8, fillval);
+    array_prog.set_kernel_arg (kernel_index, 9, octave_uint64 (n_out));
+
+    array_prog.enqueue_kernel_grid (kernel_index, n_out);
+  }
+
+  if (flag.as_array () (0).value () != 0)
+    ocl_error ("OclArray: accumarray subscripts must be positive and within the output size");
+
+  return result;
+}
+
+
+// reduction of one chunk of the out-of-core streaming
+template <typename T>
+static
+OclArray<T>
+stream_reduce_chunk (const OclArray<T>& x, int fcn)
+{
+  switch (fcn) {
+    case 0:  return x.sum ();
+    case 1:  return x.sumsq ();
+    case 2:  return x.prod ();
+    case 3:  return x.max ();
+    case 4:  return x.min ();
+    default: ocl_error ("OclArray::stream_reduce: invalid reduction");
+  }
+}
+
+
+// Double buffering of the out-of-core streaming: the chunks are uploaded in
+// the transfer queue, alternately into two staging buffers, while the kernels
+// on the previous chunk run in the command queue.  The kernels on a chunk
+// wait for its upload (event ready), and the upload into a staging buffer
+// waits for the commands which last used it (event idle); so the upload of
+// chunk c+1 overlaps with the computation on chunk c.  Results are read back
+// without blocking; the destructor waits for all pending transfers (also if
+// an error interrupts the streaming) and releases the events.
+class
+OclStreamEvents
+{
+public:
+
+  OclStreamEvents (void)
+  {
+    for (int k = 0; k < 2; k++)
+      ready [k] = idle [k] = 0;
+  }
+
+  ~OclStreamEvents (void)
+  {
+    if (opencl_context_active ()) {
+      clFinish (get_command_queue ());
+      finish_transfer_queue ();
+      for (int k = 0; k < 2; k++) {
+        release (ready [k]);
+        release (idle [k]);
+      }
+    }
+  }
+
+  static void release (void *& ev)
+  {
+    if (ev != 0)
+      clReleaseEvent ((cl_event) ev);
+    ev = 0;
+  }
+
+  // the command queue waits for the event ev, which is released
+  static void wait (void *& ev)
+  {
+    if (ev == 0)
+      return;
+    cl_event e = (cl_event) ev;
+    last_error = clEnqueueWaitForEvents (get_command_queue (), 1, & e);
+    ocl_check_error ("clEnqueueWaitForEvents");
+    release (ev);
+  }
+
+  // ev is replaced by a marker of the commands enqueued so far; the command
+  // queue is flushed, as another queue is going to wait for the marker
+  static void mark (void *& ev)
+  {
+    release (ev);
+    cl_event e;
+    last_error = clEnqueueMarker (get_command_queue (), & e);
+    ocl_check_error ("clEnqueueMarker");
+    ev = e;
+    clFlush (get_command_queue ());
+  }
+
+  void *ready [2];
+  void *idle [2];
+
+private:
+
+  OclStreamEvents (const OclStreamEvents& a); // no copying
+  OclStreamEvents& operator = (const OclStreamEvents& a); // no assignment
+};
+
+
+template <typename T>
+void
+OclArray<T>::stream_upload_chunk (OclArray<T>& buf, const T *d, octave_idx_type n,
+                                  octave_idx_type len, octave_idx_type c,
+                                  void *& idle_event, void *& ready_event)
+{
+  octave_idx_type ofs = c * len;
+  octave_idx_type l = std::min (len, n - ofs);
+  if (buf.numel () != l) {
+    // a new buffer (for the first or the shorter last chunk) may be a retained
+    // one, still used by commands enqueued so far: the upload waits for them
+    buf = OclArray<T> (dim_vector (l, 1));
+    OclStreamEvents::mark (idle_event);
+  }
+
+  cl_command_queue queue = get_transfer_queue ();
+  cl_event wait_event = (cl_event) idle_event;
+  cl_event e;
+  last_error = clEnqueueWriteBuffer (queue,
+                                     (cl_mem) buf.rep->get_ocl_buffer (),
+                                     CL_FALSE,
+                                     0,
+                                     static_cast<size_t> (l) * sizeof (T),
+                                     d + ofs,
+                                     (wait_event != 0) ? 1 : 0,
+                                     (wait_event != 0) ? & wait_event : 0,
+                                     & e);
+  ocl_check_error ("clEnqueueWriteBuffer");
+  ocl_memobj_release_pins ();
+  clFlush (queue);
+
+  OclStreamEvents::release (idle_event);
+  OclStreamEvents::release (ready_event);
+  ready_event = e;
+}
+
+
+template <typename T>
+void
+OclArray<T>::stream_download_chunk (const OclArray<T>& y, T *r)
+{
+  // in the command queue, after the kernels computing y; the buffer of y may
+  // be reused as soon as y is destroyed, but only by commands enqueued later
+  last_error = clEnqueueReadBuffer (get_command_queue (),
+                                    (cl_mem) y.rep->get_ocl_buffer (),
+                                    CL_FALSE,
+                                    static_cast<size_t> (y.slice_ofs) * sizeof (T),
+                                    static_cast<size_t> (y.numel ()) * sizeof (T),
+                                    r,
+                                    0, 0, 0);
+  ocl_check_error ("clEnqueueReadBuffer");
+  ocl_memobj_release_pins ();
+}
+
+
+template <typename T>
+T
+OclArray<T>::stream_reduce (const Array<T>& a, int fcn, octave_idx_type chunk_len)
+{
+  assure_valid_array_prog ();
+
+  octave_idx_type n = a.numel ();
+  if (n == 0)
+    ocl_error ("OclArray::stream_reduce: empty array");
+
+  octave_idx_type len = (chunk_len > 0) ? chunk_len : stream_chunk_length (sizeof (T));
+  octave_idx_type num_chunks = (n + len - 1) / len;
+  const T *d = a.data ();
+
+  OclArray<T> buf [2];
+  OclArray<T> partials (dim_vector (num_chunks, 1));
+  OclStreamEvents ev; // destroyed first
+
+  stream_upload_chunk (buf [0], d, n, len, 0, ev.idle [0], ev.ready [0]);
+
+  for (octave_idx_type c = 0; c < num_chunks; c++) {
+    int s = c % 2;
+    if (c + 1 < num_chunks)
+      stream_upload_chunk (buf [1-s], d, n, len, c + 1, ev.idle [1-s], ev.ready [1-s]);
+
+    // the partial results stay on the device
+    OclStreamEvents::wait (ev.ready [s]);
+    OclArray<T> p = stream_reduce_chunk (buf [s], fcn);
+    partials.rep->copy_from_oclbuffer (*(p.rep), p.slice_ofs, c, 1);
+    OclStreamEvents::mark (ev.idle [s]);
+  }
+
+  // sums of squares of the chunks are summed
+  OclArray<T> result = stream_reduce_chunk (partials, (fcn == 1) ? 0 : fcn);
+  return result.as_array () (0);
+}
+
+
+template <typename T>
+Array<T>
+OclArray<T>::stream_map (const Array<T>& a, octave_base_value::unary_mapper_t umap,
+                         octave_idx_type chunk_len)
+{
+  assure_valid_array_prog ();
+
+  Array<T> result (a.dims ());
+  octave_idx_type n = a.numel ();
+  if (n == 0)
+    return result;
+
+  octave_idx_type len = (chunk_len > 0) ? chunk_len : stream_chunk_length (sizeof (T));
+  octave_idx_type num_chunks = (n + len - 1) / len;
+  const T *d = a.data ();
+  T *r = result.fortran_vec ();
+
+  OclArray<T> buf [2];
+  OclStreamEvents ev; // destroyed first
+
+  stream_upload_chunk (buf [0], d, n, len, 0, ev.idle [0], ev.ready [0]);
+
+  for (octave_idx_type c = 0; c < num_chunks; c++) {
+    int s = c % 2;
+    if (c + 1 < num_chunks)
+      stream_upload_chunk (buf [1-s], d, n, len, c + 1, ev.idle [1-s], ev.ready [1-s]);
+
+    OclStreamEvents::wait (ev.ready [s]);
+    OclArray<T> y = buf [s].map (umap);
+    stream_download_chunk (y, r + c * len);
+    OclStreamEvents::mark (ev.idle [s]);
+  }
+
+  return result;
+}
+
+
+template <typename T>
+Array<T>
+OclArray<T>::stream_map2 (const Array<T>& a, const Array<T>& b, int op,
+                          octave_idx_type chunk_len)
+{
+  assure_valid_array_prog ();
+
+  if (a.dims () != b.dims ())
+    ocl_error ("OclArray::stream_map2: nonconformant arguments");
+
+  Array<T> result (a.dims ());
+  octave_idx_type n = a.numel ();
+  if (n == 0)
+    return result;
+
+  // the chunks of both operands together take the memory of one chunk of
+  // the unary case
+  octave_idx_type len = (chunk_len > 0) ? chunk_len
+                        : std::max (stream_chunk_length (sizeof (T)) / 2, (octave_idx_type) 1);
+  octave_idx_type num_chunks = (n + len - 1) / len;
+  T *r = result.fortran_vec ();
+
+  OclArray<T> buf_a [2], buf_b [2];
+  OclStreamEvents ev_a, ev_b; // destroyed first
+
+  stream_upload_chunk (buf_a [0], a.data (), n, len, 0, ev_a.idle [0], ev_a.ready [0]);
+  stream_upload_chunk (buf_b [0], b.data (), n, len, 0, ev_b.idle [0], ev_b.ready [0]);
+
+  for (octave_idx_type c = 0; c < num_chunks; c++) {
+    int s = c % 2;
+    if (c + 1 < num_chunks) {
+      stream_upload_chunk (buf_a [1-s], a.data (), n, len, c + 1, ev_a.idle [1-s], ev_a.ready [1-s]);
+      stream_upload_chunk (buf_b [1-s], b.data (), n, len, c + 1, ev_b.idle [1-s], ev_b.ready [1-s]);
+    }
+
+    OclStreamEvents::wait (ev_a.ready [s]);
+    OclStreamEvents::wait (ev_b.ready [s]);
+    OclArray<T> y;
+    switch (op) {
+      case 0:  y = buf_a [s] + buf_b [s]; break;
+      case 1:  y = buf_a [s] - buf_b [s]; break;
+      case 2:  y = product (buf_a [s], buf_b [s]); break;
+      case 3:  y = quotient (buf_a [s], buf_b [s]); break;
+      default: ocl_error ("OclArray::stream_map2: invalid operation");
+    }
+    stream_download_chunk (y, r + c * len);
+    OclStreamEvents::mark (ev_a.idle [s]);
+    OclStreamEvents::mark (ev_b.idle [s]);
+  }
+
+  return result;
+}
+
+
+template <typename T>
 OclArray<T>
-OclArray<T>::mtimes (const OclArray<T>& s2) const
+OclArray<T>::diff (octave_idx_type order, int dim) const
 {
-  if ((ndims () != 2) || (s2.ndims () != 2))
-    ocl_error ("OclArray: operands must both be 2-dim arrays, or vectors, for matrix multiplication");
-  if (dim2 () != s2.dim1 ())
-    ocl_error ("OclArray: mismatch in operands' sizes for matrix multiplication");
+  rep->assure_valid ();
+  assure_valid_array_prog ();
+
+  if (dim < 0)
+    dim = dimensions.first_non_singleton ();
+
+  int kernel_index = kernel_indices [OclArrayKernels::diff];
+  OclArray<T> result (*this);
+
+  for (octave_idx_type o=0; o<order; o++) {
+    dim_vector new_dimensions;
+    octave_idx_type len, fac;
+
+    result.dim_wise_op_newdims (dim, new_dimensions, len, fac);
+    new_dimensions = new_dimensions.redim (std::max (dim + 1, result.ndims ()));
+    new_dimensions (dim) = std::max (len - 1, (octave_idx_type) 0);
+
+    OclArray<T> next (new_dimensions);
+    if (next.numel () == 0)
+      return next;
+
+    array_prog.set_kernel_arg (kernel_index, 0, next);
+    array_prog.set_kernel_arg (kernel_index, 1, result);
+    array_prog.set_kernel_arg (kernel_index, 2, octave_uint64 (result.slice_ofs));
+    array_prog.set_kernel_arg (kernel_index, 3, octave_uint64 (len));
+    array_prog.set_kernel_arg (kernel_index, 4, octave_uint64 (fac));
+    array_prog.set_kernel_arg (kernel_index, 5, octave_uint64 (next.numel ()));
+
+    array_prog.enqueue_kernel_grid (kernel_index, next.numel ());
+
+    result = next;
+  }
+
+  return result;
+}
 
-  dim_vector new_dimensions (dim1 (), s2.dim2 ());
 
+template <typename T>
+OclArray<T>
+OclArray<T>::gradient (double h, int dim) const
+{
   rep->assure_valid ();
-  s2.rep->assure_valid ();
   assure_valid_array_prog ();
 
-  OclArray<T> result (new_dimensions);
+  dim_vector new_dimensions;
+  octave_idx_type len, fac;
 
-  int kernel_index = kernel_indices [OclArrayKernels::mtimes];
+  dim_wise_op_newdims (dim, new_dimensions, len, fac);
+
+  int kernel_index = kernel_indices [OclArrayKernels::gradient];
+
+  if (kernel_index < 0)
+    ocl_error ("not applicable to type OclArray of this class");
+
+  OclArray<T> result (dimensions);
+  if (numel () == 0)
+    return result;
 
   array_prog.set_kernel_arg (kernel_index, 0, result);
   array_prog.set_kernel_arg (kernel_index, 1, *this);
   array_prog.set_kernel_arg (kernel_index, 2, octave_uint64 (slice_ofs));
-  array_prog.set_kernel_arg (kernel_index, 3, s2);
-  array_prog.set_kernel_arg (kernel_index, 4, octave_uint64 (s2.slice_ofs));
-  array_prog.set_kernel_arg (kernel_index, 5, octave_uint64 (dim1 ()));
-  array_prog.set_kernel_arg (kernel_index, 6, octave_uint64 (dim2 ()));
+  array_prog.set_kernel_arg (kernel_index, 3, octave_uint64 (len));
+  array_prog.set_kernel_arg (kernel_index, 4, octave_uint64 (fac));
+  array_prog.set_kernel_arg (kernel_index, 5, T (1.0 / h));
+  array_prog.set_kernel_arg (kernel_index, 6, T (0.5 / h));
+  array_prog.set_kernel_arg (kernel_index, 7, octave_uint64 (numel ()));
 
-  array_prog.enqueue_kernel (kernel_index, new_dimensions.numel ());
+  array_prog.enqueue_kernel_grid (kernel_index, numel ());
+
+  return result;
+}
+
+
+// the coordinates mode of the trapz kernels: 0 for unit spacing, 1 for a
+// vector along the dimension, 2 for an array of the size of the data
+template <typename T>
+static int
+trapz_xmode (const OclArray<T>& x, const dim_vector& dimensions, octave_idx_type len)
+{
+  if (x.numel () == 0)
+    return 0;
+  if (x.dims () == dimensions)
+    return 2;
+  if ((x.numel () == len) && (x.dims ().num_ones () >= x.ndims () - 1))
+    return 1;
+  ocl_error ("OclArray: coordinates must be a vector of the length along DIM, or of the size of Y");
+  return 0;
+}
+
+
+template <typename T>
+OclArray<T>
+OclArray<T>::trapz (const OclArray<T>& x, int dim) const
+{
+  rep->assure_valid ();
+  assure_valid_array_prog ();
+
+  dim_vector new_dimensions;
+  octave_idx_type len, fac;
+
+  dim_wise_op_newdims (dim, new_dimensions, len, fac);
+  int xmode = trapz_xmode (x, dimensions, len);
+
+  int kernel_index = kernel_indices [OclArrayKernels::trapz];
+
+  if (kernel_index < 0)
+    ocl_error ("not applicable to type OclArray of this class");
+
+  if (len <= 1)
+    return OclArray<T> (new_dimensions, T (0));
+
+  octave_idx_type num_slices = slice_len / len;
+  size_t local_size = array_prog.reduction_group_size (kernel_index, len - 1);
+  size_t groups_per_slice = array_prog.reduction_groups_per_slice (num_slices, len - 1, local_size);
+
+  // with several work-groups per slice, their partial sums (stored
+  // slice-wise) are summed up by a second reduction
+  OclArray<T> result;
+  if (groups_per_slice > 1)
+    result = OclArray<T> (dim_vector (groups_per_slice, num_slices));
+  else
+    result = OclArray<T> (new_dimensions);
+
+  array_prog.set_kernel_arg (kernel_index, 0, result);
+  array_prog.set_kernel_arg (kernel_index, 1, *this);
+  array_prog.set_kernel_arg (kernel_index, 2, octave_uint64 (slice_ofs));
+  if (xmode > 0) {
+    array_prog.set_kernel_arg (kernel_index, 3, x);
+    array_prog.set_kernel_arg (kernel_index, 4, octave_uint64 (x.slice_ofs));
+  } else {
+    array_prog.set_kernel_arg (kernel_index, 3, *this); // as indicator for unused coordinates
+    array_prog.set_kernel_arg (kernel_index, 4, octave_uint64 (0));
+  }
+  array_prog.set_kernel_arg (kernel_index, 5, octave_uint64 (xmode));
+  array_prog.set_kernel_arg (kernel_index, 6, octave_uint64 (len));
+  array_prog.set_kernel_arg (kernel_index, 7, octave_uint64 (fac));
+  array_prog.set_kernel_arg_local (kernel_index, 8, local_size * sizeof (T));
+
+  array_prog.enqueue_kernel_groups (kernel_index, num_slices, local_size, groups_per_slice);
+
+  if (groups_per_slice > 1)
+    result = result.sum (0).reshape (new_dimensions);
+
+  return result;
+}
+
+
+template <typename T>
+OclArray<T>
+OclArray<T>::cumtrapz (const OclArray<T>& x, int dim) const
+{
+  rep->assure_valid ();
+  assure_valid_array_prog ();
+
+  dim_vector new_dimensions;
+  octave_idx_type len, fac;
+
+  dim_wise_op_newdims (dim, new_dimensions, len, fac);
+  int xmode = trapz_xmode (x, dimensions, len);
+
+  int kernel_index = kernel_indices [OclArrayKernels::cumtrapz];
+
+  if (kernel_index < 0)
+    ocl_error ("not applicable to type OclArray of this class");
+
+  OclArray<T> result (dimensions);
+  if (numel () == 0)
+    return result;
+
+  array_prog.set_kernel_arg (kernel_index, 0, result);
+  array_prog.set_kernel_arg (kernel_index, 1, *this);
+  array_prog.set_kernel_arg (kernel_index, 2, octave_uint64 (slice_ofs));
+  if (xmode > 0) {
+    array_prog.set_kernel_arg (kernel_index, 3, x);
+    array_prog.set_kernel_arg (kernel_index, 4, octave_uint64 (x.slice_ofs));
+  } else {
+    array_prog.set_kernel_arg (kernel_index, 3, *this); // as indicator for unused coordinates
+    array_prog.set_kernel_arg (kernel_index, 4, octave_uint64 (0));
+  }
+  array_prog.set_kernel_arg (kernel_index, 5, octave_uint64 (xmode));
+  array_prog.set_kernel_arg (kernel_index, 6, octave_uint64 (len));
+  array_prog.set_kernel_arg (kernel_index, 7, octave_uint64 (fac));
+
+  array_prog.enqueue_kernel (kernel_index, slice_len / len);
 
   return result;
 }
@@ -1989,13 +4883,152 @@ OclArray<T>::map_inplace (OclArrayKernels::Kernel kernel)
   array_prog.set_kernel_arg (kernel_index, 0, result);
   array_prog.set_kernel_arg (kernel_index, 1, *this);
   array_prog.set_kernel_arg (kernel_index, 2, octave_uint64 (slice_ofs));
+  array_prog.set_kernel_arg (kernel_index, 3, octave_uint64 (slice_len));
 
-  array_prog.enqueue_kernel (kernel_index, slice_len);
+  enqueue_elementwise_kernel (kernel_index, slice_len);
 
   *this = result;
 }
 
 
+// the data is transferred in chunks of up to stream_chunk_bytes, each
+// through a blocking map of the corresponding part of the OpenCL buffer
+template <typename T>
+bool
+OclArray<T>::write_raw (std::ostream& os) const
+{
+  octave_idx_type n = numel ();
+  if (n == 0)
+    return true;
+
+  rep->assure_valid ();
+
+  octave_idx_type len = std::max (static_cast<octave_idx_type> (stream_chunk_bytes / sizeof (T)), (octave_idx_type) 1);
+  for (octave_idx_type ofs = 0; (ofs < n) && os; ofs += len) {
+    octave_idx_type l = std::min (len, n - ofs);
+    cl_mem buffer = (cl_mem) rep->get_ocl_buffer ();
+    void *p = clEnqueueMapBuffer (get_command_queue (),
+                                  buffer,
+                                  CL_TRUE,
+                                  CL_MAP_READ,
+                                  (slice_ofs + ofs) * sizeof (T),
+                                  l * sizeof (T),
+                                  0, 0, 0,
+                                  & last_error);
+    ocl_check_error ("clEnqueueMapBuffer");
+
+    os.write (static_cast<const char *> (p), l * sizeof (T));
+
+    last_error = clEnqueueUnmapMemObject (get_command_queue (), buffer, p, 0, 0, 0);
+    ocl_check_error ("clEnqueueUnmapMemObject");
+    ocl_memobj_release_pins ();
+  }
+
+  return os.good ();
+}
+
+
+// swap the bytes of each component (real and imaginary part) of l elements
+template <typename T>
+static
+void
+swap_component_bytes (void *p, octave_idx_type l)
+{
+  size_t comp_size = OclArray<T>::is_complex_type () ? sizeof (T) / 2 : sizeof (T);
+  octave_idx_type num_comps = l * (sizeof (T) / comp_size);
+
+  switch (comp_size) {
+    case 2: swap_bytes<2> (p, num_comps); break;
+    case 4: swap_bytes<4> (p, num_comps); break;
+    case 8: swap_bytes<8> (p, num_comps); break;
+    default: ; // single bytes
+  }
+}
+
+
+template <typename T>
+OclArray<T>
+OclArray<T>::read_raw (std::istream& is, const dim_vector& dv, bool swap, bool lazy_upload)
+{
+  if (lazy_upload) {
+    Array<T> a (dv);
+    is.read (reinterpret_cast<char *> (a.fortran_vec ()), a.numel () * sizeof (T));
+    if (! is)
+      ocl_error ("OclArray: reading raw data failed");
+    if (swap)
+      swap_component_bytes<T> (a.fortran_vec (), a.numel ());
+    return OclArray<T> (a, true);
+  }
+
+  OclArray<T> result (dv);
+  octave_idx_type n = result.numel ();
+  if (n == 0)
+    return result;
+
+  octave_idx_type len = std::max (static_cast<octave_idx_type> (stream_chunk_bytes / sizeof (T)), (octave_idx_type) 1);
+  for (octave_idx_type ofs = 0; ofs < n; ofs += len) {
+    octave_idx_type l = std::min (len, n - ofs);
+    cl_mem buffer = (cl_mem) result.rep->get_ocl_buffer ();
+    void *p = clEnqueueMapBuffer (get_command_queue (),
+                                  buffer,
+                                  CL_TRUE,
+                                  CL_MAP_WRITE,
+                                  ofs * sizeof (T),
+                                  l * sizeof (T),
+                                  0, 0, 0,
+                                  & last_error);
+    ocl_check_error ("clEnqueueMapBuffer");
+
+    is.read (static_cast<char *> (p), l * sizeof (T));
+    bool ok = is.good ();
+    if (ok && swap)
+      swap_component_bytes<T> (p, l);
+
+    last_error = clEnqueueUnmapMemObject (get_command_queue (), buffer, p, 0, 0, 0);
+    ocl_check_error ("clEnqueueUnmapMemObject");
+    ocl_memobj_release_pins ();
+    if (! ok)
+      ocl_error ("OclArray: reading raw data failed");
+  }
+
+  return result;
+}
+
+
+// the driver may start transferring a chunk while the next ones are enqueued;
+// the host data must stay valid until all transfers are finished, also on errors
+template <typename T>
+OclArray<T>
+OclArray<T>::upload_raw (const void *d, const dim_vector& dv)
+{
+  OclArray<T> result (dv);
+  size_t bytes = static_cast<size_t> (result.numel ()) * sizeof (T);
+  if (bytes == 0)
+    return result;
+
+  cl_mem buffer = (cl_mem) result.rep->get_ocl_buffer ();
+  for (size_t ofs = 0; ofs < bytes; ofs += stream_chunk_bytes) {
+    last_error = clEnqueueWriteBuffer (get_command_queue (),
+                                       buffer,
+                                       CL_FALSE,
+                                       ofs,
+                                       std::min (stream_chunk_bytes, bytes - ofs),
+                                       static_cast<const char *> (d) + ofs,
+                                       0, 0, 0);
+    if (last_error != CL_SUCCESS)
+      break;
+  }
+
+  cl_int err = last_error;
+  clFinish (get_command_queue ());
+  last_error = err;
+  ocl_check_error ("clEnqueueWriteBuffer");
+  ocl_memobj_release_pins ();
+
+  return result;
+}
+
+
 template <typename T>
 void
 OclArray<T>::print_info (std::ostream& os, const std::string& prefix) const
@@ -2037,7 +5070,24 @@ OclArray<T>::assure_valid_array_prog (void)
   if ((! opencl_context_is_fp64 ()) && (oclc_type == "double"))
     ocl_error ("OclArray: currently selected OpenCL context is not capable of operating on OCL arrays of 'double' type");
 
+  // atomic compare-and-swap on the (real) element words, for accumarray
+  size_t word_size = is_complex_type () ? sizeof (T) / 2 : sizeof (T);
+  if (word_size == 4)
+    build_options += "-DATOMIC32 ";
+  else if ((word_size == 8) && device_has_extension ("cl_khr_int64_base_atomics"))
+    build_options += "-DATOMIC64 ";
+
+  // vector width of elementwise kernels (non-complex types only)
+  array_prog_vector_width = 1;
+  if (! is_complex_type ()) {
+    array_prog_vector_width = elementwise_vector_width (oclc_type, sizeof (T));
+    std::ostringstream vw;
+    vw << array_prog_vector_width;
+    build_options += "-DVW=" + vw.str () + " ";
+  }
+
   array_prog = OclProgram (ocl_array_prog_source, build_options);
+  fft_plan_cache<T> ().clear ();
 
   for (int i = 0; i < OclArrayKernels::max_array_prog_kernels; i++)
     kernel_indices [i] =
@@ -2051,6 +5101,17 @@ OclArray<T>::assure_valid_array_prog (void)
 }
 
 
+template <typename T>
+void
+OclArray<T>::enqueue_elementwise_kernel (int kernel_index, octave_idx_type n)
+{
+  // the kernel loops over all n elements (in vectors of array_prog_vector_width),
+  // so the number of work-items is only an upper bound for the launch
+  octave_idx_type vw = array_prog_vector_width;
+  array_prog.enqueue_kernel_grid (kernel_index, (n + vw - 1) / vw);
+}
+
+
 // ---------- OclArray<T> non-members
 
 
@@ -64,29 +64,50 @@ protected:
   {
   public:
 
+    // Virtual arrays are described by a formula instead of an OpenCL buffer:
+    // a constant (virt_val [0]), a linear ramp from virt_val [0] to virt_val [1]
+    // (as by linspace), or the identity matrix with virt_nr rows. The buffer is
+    // only allocated and generated on first use on the device (materialize);
+    // copying to host memory evaluates the formula on the host.
+    enum VirtualKind { virt_none = 0, virt_const, virt_linspace, virt_eye };
+
     // empty, inoperable array
     OclArrayRep ()
-      : memobj (0), len (0), count (1) {}
+      : memobj (0), len (0), count (1), virt (virt_none) {}
 
     // array with length; needs/activates an OpenCL context if non-empty
     OclArrayRep (octave_idx_type n)
-      : memobj (0), len (n), count (1)
+      : memobj (0), len (n), count (1), virt (virt_none)
     {
       if (len > 0) {
         allocate ();
       }
     }
 
-    // OclArrayRep: no constructor with length and constant fill!
+    // virtual array with length, its contents given by kind and the parameters
+    // (see VirtualKind); needs/activates an OpenCL context if non-empty
+    OclArrayRep (octave_idx_type n,
+                 VirtualKind kind,
+                 const T& v0,
+                 const T& v1 = T (),
+                 octave_idx_type nr = 0)
+      : memobj (0), len (n), count (1), virt (virt_none)
+    {
+      if (len > 0) {
+        allocate_virtual (kind, v0, v1, nr);
+      }
+    }
 
     // array as copy of OpenCL array; needs/activates an OpenCL context if non-empty
     OclArrayRep (const OclArrayRep& a)
-      : memobj (0), len (a.len), count (1)
+      : memobj (0), len (a.len), count (1), virt (virt_none)
     {
       if (len > 0) {
         assure_valid (a);
-        allocate ();
-        copy_from_oclbuffer (a, 0, 0, len);
+        if (! copy_virtual (a, 0)) {
+          allocate ();
+          copy_from_oclbuffer (a, 0, 0, len);
+        }
       }
     }
 
@@ -94,22 +115,29 @@ protected:
     OclArrayRep (const OclArrayRep& a,
                  octave_idx_type slice_ofs_src,
                  octave_idx_type slice_len)
-      : memobj (0), len (slice_len), count (1)
+      : memobj (0), len (slice_len), count (1), virt (virt_none)
     {
       if (len > 0) {
         assure_valid (a);
-        allocate ();
-        copy_from_oclbuffer (a, slice_ofs_src, 0, len);
+        if (! copy_virtual (a, slice_ofs_src)) {
+          allocate ();
+          copy_from_oclbuffer (a, slice_ofs_src, 0, len);
+        }
       }
     }
 
-    // array as copy of octave memory array; needs/activates an OpenCL context if non-empty
-    OclArrayRep (const T *d, octave_idx_type l)
-      : memobj (0), len (l), count (1)
+    // array as copy of octave memory array; needs/activates an OpenCL context if non-empty;
+    // with lazy, the data is uploaded only on first use of the OpenCL buffer
+    OclArrayRep (const T *d, octave_idx_type l, bool lazy = false)
+      : memobj (0), len (l), count (1), virt (virt_none)
     {
       if (len > 0) {
-        allocate ();
-        copy_from_host (d, 0, len);
+        if (lazy)
+          allocate_lazy (d);
+        else {
+          allocate ();
+          copy_from_host (d, 0, len);
+        }
       }
     }
 
@@ -117,7 +145,8 @@ protected:
 
     void copy_from_host (const T *d_src,
                          octave_idx_type slice_ofs,
-                         octave_idx_type slice_len);
+                         octave_idx_type slice_len,
+                         bool blocking = true);
 
     void copy_from_oclbuffer (const OclArrayRep& a,
                               octave_idx_type slice_ofs_src,
@@ -138,15 +167,36 @@ protected:
 
     void *get_ocl_buffer (void) const;
 
-    OclMemoryObject *memobj;
+    bool is_virtual (VirtualKind kind) const { return (virt == kind) && is_valid (); }
+
+    // value of element i of a virtual array (which has no OpenCL buffer yet)
+    T virtual_element (octave_idx_type i) const;
+
+    // whether the elements of a virtual array are evaluated on the host
+    // with the same result as the kernels in materialize
+    bool is_host_evaluable (void) const;
+
+    mutable OclMemoryObject *memobj;
     octave_idx_type len;
     int count;
 
+    // contents of a virtual array
+    mutable VirtualKind virt;
+    T virt_val [2];
+    octave_idx_type virt_nr;
+    unsigned long virt_ctx_id;
+
   private:
 
     void allocate (void);
+    void allocate_lazy (const T *d);
+    void allocate_virtual (VirtualKind kind, const T& v0, const T& v1, octave_idx_type nr);
+    bool copy_virtual (const OclArrayRep& a, octave_idx_type slice_ofs_src);
+    void materialize (void) const;
     void deallocate (void);
 
+    static const char *memobj_type_str (void);
+
     OclArrayRep& operator = (const OclArrayRep& a); // no assignment
   };
 
@@ -196,6 +246,22 @@ protected:
     dimensions.chop_trailing_singletons ();
   }
 
+  // virtual array constructor (see OclArrayRep::VirtualKind)
+  explicit
+  OclArray (const dim_vector& dv,
+            typename OclArrayRep::VirtualKind kind,
+            const T& v0,
+            const T& v1,
+            octave_idx_type nr = 0)
+    : dimensions (dv),
+      rep (new typename OclArray<T>::OclArrayRep (dv.safe_numel (), kind, v0, v1, nr)),
+      slice_ofs (0), slice_len (rep->len), is_logical(false)
+  {
+    dimensions.chop_trailing_singletons ();
+  }
+
+  bool is_virtual_const (void) const { return rep->is_virtual (OclArrayRep::virt_const); }
+
   void fill (octave_idx_type fill_ofs, octave_idx_type fill_len, const T& val);
 
   void fill0 (octave_idx_type fill_ofs, octave_idx_type fill_len, const OclArray<T>& a);
@@ -238,23 +304,23 @@ public:
     dimensions.chop_trailing_singletons ();
   }
 
-  // nD initialized constructor.
+  // nD initialized constructor (a virtual array, see OclArrayRep::VirtualKind).
   explicit OclArray (const dim_vector& dv, const T& val)
     : dimensions (dv),
-      rep (new typename OclArray<T>::OclArrayRep (dv.safe_numel ())),
+      rep (new typename OclArray<T>::OclArrayRep (dv.safe_numel (), OclArrayRep::virt_const, val)),
       slice_ofs (0), slice_len (rep->len), is_logical(false)
   {
     dimensions.chop_trailing_singletons ();
-    fill (slice_ofs, slice_len, val);
   }
 
   // Reshape constructor.
   explicit OclArray (const OclArray<T>& a, const dim_vector& dv);
 
-  // Copy from host memory constructor.
-  OclArray (const Array<T>& a)
+  // Copy from host memory constructor (with lazy_upload, the data is kept
+  // in host memory until the array is first used on the device).
+  OclArray (const Array<T>& a, bool lazy_upload = false)
     : dimensions (a.dims ()),
-      rep (new typename OclArray<T>::OclArrayRep (a.data (), dimensions.safe_numel ())),
+      rep (new typename OclArray<T>::OclArrayRep (a.data (), dimensions.safe_numel (), lazy_upload)),
       slice_ofs (0), slice_len (a.numel ()), is_logical(false)
   {}
 
@@ -303,10 +369,10 @@ public:
   {
     if ((rep->count) > 1) {
       (rep->count)--;
-      rep = new OclArrayRep (slice_len);
+      rep = new OclArrayRep (slice_len, OclArrayRep::virt_const, val);
       slice_ofs = 0;
-    }
-    fill (slice_ofs, slice_len, val);
+    } else
+      fill (slice_ofs, slice_len, val);
   }
 
   void clear (void)
@@ -421,7 +487,19 @@ public:
   OclArray<T> reshape (const dim_vector& new_dims) const
   { return OclArray<T> (*this, new_dims); }
 
-  // OclArray: no permute, ipermute!
+  // Permutation of dimensions, as with Array<T>; flip, circshift and rot90
+  // are the same index remap.  Where the memory layout does not change
+  // (e.g., only singleton dimensions move), the result is a shallow copy.
+  OclArray<T> permute (const Array<octave_idx_type>& vec, bool inv = false) const;
+  OclArray<T> ipermute (const Array<octave_idx_type>& vec) const
+  { return permute (vec, true); }
+
+  // Circular shift by shift (k) elements along dimension k.
+  OclArray<T> circshift (const Array<octave_idx_type>& shift) const;
+  // Reversed order along dim.
+  OclArray<T> flip (int dim) const;
+  // Rotation of the matrix (of all pages) by k * 90 degrees counterclockwise.
+  OclArray<T> rot90 (int k) const;
 
 #if ! defined (OCL_OCTAVE_VERSION_4_4_0_AND_HIGHER) // for octave versions < 4.4.0
   bool is_square (void) const { return (dim1 () == dim2 ()); }
@@ -435,6 +513,8 @@ public:
 
   OclArray<T> transpose (void) const;
   OclArray<T> hermitian (void) const;
+  OclArray<T> pagetranspose (void) const;
+  OclArray<T> pagectranspose (void) const;
 
   // OclArray: no data() or fortran_vec()!
 
@@ -456,9 +536,16 @@ public:
   OclArray<T> index (const idx_vector& i, const idx_vector& j) const;
   OclArray<T> index (const Array<idx_vector>& ia) const;
 
-  // OclArray: no resize!
+  // Logical indexing A(mask), with mask.numel () <= numel ().
+  OclArray<T> index_logical (const OclArray<T>& mask) const;
 
-  // Indexed assignment (OclArray: never with resize).
+  // Resizing, only along the last dimension (or of empty arrays); new
+  // elements are set to rfv.  The OpenCL buffer keeps spare capacity: it
+  // grows geometrically, and growing within the capacity (with unshared
+  // data) needs no copying, so that repeated appending has amortised cost.
+  void resize (const dim_vector& dv, const T& rfv = T ());
+
+  // Indexed assignment (beyond the end, resizing along the last dimension).
 
   void assign (const OclArray<ocl_idx_type>& i, const T& rhs);
   void assign (const idx_vector& i, const T& rhs);
@@ -472,6 +559,9 @@ public:
 
   void assign_logical (const OclArray<T>& i, const T& rhs);
 
+  // Resize for an indexed assignment beyond the end (see above).
+  void resize_for_assign (const Array<idx_vector>& ia);
+
   // OclArray: no inserting or deleting of elements!
 
   void maybe_economize (void)
@@ -484,7 +574,14 @@ public:
     }
   }
 
-  // OclArray: no sorting or finding, no diag()!
+  // OclArray: no sorting, no diag()!
+
+  // Zero-based indices of the nonzero elements; with n >= 0, only the
+  // first n (or with backward = true, the last n) of them.
+  OclArray<ocl_idx_type> find (octave_idx_type n = -1, bool backward = false) const;
+
+  // Number of nonzero elements.
+  octave_idx_type nnz (void) const;
 
   // Concatenation along a specified (0-based) dimension, equivalent to cat().
   // dim = -1 corresponds to dim = 0 and dim = -2 corresponds to dim = 1,
@@ -500,6 +597,13 @@ public:
   // logspace constructor
   static OclArray<T> logspace (T a, T b, octave_idx_type n = 50);
 
+  // random constructors: uniform on (0,1), standard normal, and integers
+  // in [lo, hi]; counter-based streams, reproducible with ocl_rand_set_seed
+  static OclArray<T> rand (const dim_vector& dv) { return rand_fill (dv, 0, 0, 1); }
+  static OclArray<T> randn (const dim_vector& dv) { return rand_fill (dv, 1, 0, 1); }
+  static OclArray<T> randi (const dim_vector& dv, int64_t lo, int64_t hi)
+    { return rand_fill (dv, 2, lo, static_cast<uint64_t> (hi - lo) + 1); }
+
   // ndgrid utility function
   static std::vector< OclArray<T> > ndgrid (const std::vector< OclArray<T> > array_list);
 
@@ -523,7 +627,12 @@ public:
   OclArray<T> prod (int dim = -1) const { return map1r (OclArrayKernels::prod, dim); }
   OclArray<T> mean (int dim = -1) const { return map1r (OclArrayKernels::mean, dim); }
   OclArray<T> meansq (int dim = -1) const { return map1r (OclArrayKernels::meansq, dim); }
-  OclArray<T> std (int opt = 0, int dim = -1) const;
+  OclArray<T> std (int opt = 0, int dim = -1) const
+    { return var_std (opt, dim, true, 0); }
+  OclArray<T> var (int opt = 0, int dim = -1) const
+    { return var_std (opt, dim, false, 0); }
+  OclArray<T> var (OclArray<T>& mean, int opt = 0, int dim = -1) const
+    { return var_std (opt, dim, false, & mean); }
   OclArray<T> max (int dim = -1) const
     { return map1ri (OclArrayKernels::max, dim, 0); }
   OclArray<T> max (OclArray<ocl_idx_type>& indices, int dim = -1) const
@@ -568,7 +677,28 @@ public:
   OclArray<T> times (const T& factor) const { return map1 (OclArrayKernels::mul1, factor); }
   OclArray<T> times (const OclArray<T>& s2) const { return map2s (OclArrayKernels::mul2, s2); }
 
-  OclArray<T> mtimes (const OclArray<T>& s2) const;
+  // Matrix multiply op1 (*this) * op2 (s2), with op selected as in BLAS by
+  // 'N' (none), 'T' (transpose) or 'C' (conjugate transpose); the transposed
+  // operands are read in place, never materialized.
+  OclArray<T> mtimes (const OclArray<T>& s2, char trans1 = 'N', char trans2 = 'N') const;
+
+  // Pagewise matrix multiply of nD arrays, op as with mtimes, broadcasting
+  // over singleton page dimensions; a single launch for all pages.
+  OclArray<T> pagemtimes (const OclArray<T>& s2, char trans1 = 'N', char trans2 = 'N') const;
+
+  // Symmetric / hermitian rank-k product: op (*this) * (*this) for trans1 = true,
+  // else (*this) * op (*this), with op as above; only half is computed.
+  OclArray<T> syrk (bool trans1, char trans) const;
+
+  // Sparse times dense: the sparse nr x x.dim1 () matrix given in CSR
+  // format by row_ptr, col_idx and values (conjugated for conj_values)
+  // times the 2-dim array x.
+  static OclArray<T> csr_mtimes (octave_idx_type nr,
+                                 const OclArray<ocl_idx_type>& row_ptr,
+                                 const OclArray<ocl_idx_type>& col_idx,
+                                 const OclArray<T>& values,
+                                 const OclArray<T>& x,
+                                 bool conj_values = false);
 
   OclArray<T> divide_constnum (const T& numerator) const { return map1 (OclArrayKernels::div1n, numerator); }
   OclArray<T> divide_constdenom (const T& denominator) const { return map1 (OclArrayKernels::div1d, denominator); }
@@ -581,7 +711,125 @@ public:
   void changesign (void)
   { map_inplace (OclArrayKernels::uminus); }
 
-  // OclArray: no diff, no fourier!
+  // Differences of order order along dim, one launch per order; the
+  // length along dim shrinks by one with each order (down to 0).
+  OclArray<T> diff (octave_idx_type order = 1, int dim = -1) const;
+
+  // Gradient along dim for the spacing h: central differences at interior
+  // points, one-sided differences at the ends (floating point types only).
+  OclArray<T> gradient (double h, int dim = -1) const;
+
+  // Trapezoidal integral along dim, and its cumulative form, for the
+  // coordinates x: unit spacing for an empty x, else a vector of the length
+  // along dim or an array of the size of *this (floating point types only).
+  OclArray<T> trapz (const OclArray<T>& x, int dim = -1) const;
+  OclArray<T> cumtrapz (const OclArray<T>& x, int dim = -1) const;
+
+  // Discrete Fourier transform along dim (complex arrays only), of length n
+  // (zero padded or truncated; n < 0 keeps the length). Inverse with
+  // inverse = true.
+  OclArray<T> fft (octave_idx_type n = -1, int dim = -1, bool inverse = false) const;
+
+  // Direct convolution along dim with the (short) host vector kern: the
+  // n_out elements of the full convolution from element shift on; the
+  // kernel and a window of the input are staged in local memory.
+  OclArray<T> conv (const Array<T>& kern, int dim, octave_idx_type n_out, octave_idx_type shift) const;
+
+  // Direct 2-dim convolution with the (short) host matrix kern, likewise:
+  // the m_out x n_out elements of the full convolution from (shift_r, shift_c) on.
+  OclArray<T> conv2 (const Array<T>& kern, octave_idx_type m_out, octave_idx_type n_out,
+                     octave_idx_type shift_r, octave_idx_type shift_c) const;
+
+  // Whether an mk x nk kernel is short enough for the direct convolutions;
+  // for longer ones, a product of transforms (fft) is faster.
+  static bool conv_is_direct (octave_idx_type mk, octave_idx_type nk);
+
+  // Recursive part of a filter along dim: y (i) = x (i) - sum_j a (j-1) * y (i-j),
+  // for the j = 1 .. a.numel () host coefficients a; the slices run in chunks
+  // in parallel, with the chunks' initial states carried by a short serial pass.
+  OclArray<T> filter_iir (const Array<T>& a, int dim) const;
+
+  // Dense linear algebra (floating point types only), blocked, with the
+  // trailing updates as products of blocks by mtimes.  LU factorization
+  // with partial pivoting of a 2-dim array: L (unit lower) below and U on
+  // and above the diagonal of the result, the row interchanges in ipiv (row
+  // j with row ipiv (j), in turn, as LAPACK's getrf, but 0-based), and
+  // info > 0 for a zero pivot (in column info-1).
+  OclArray<T> lu (OclArray<ocl_idx_type>& ipiv, octave_idx_type& info) const;
+
+  // Cholesky factorization R' * R = *this (its upper triangle); info > 0 if
+  // it is not positive definite, with the leading info-1 rows and columns
+  // of R valid.
+  OclArray<T> chol (octave_idx_type& info) const;
+
+  // Triangular solve op (*this) * X = b (as BLAS trsm, left side) for the
+  // upper or lower triangular *this, op as with mtimes; unit_diag takes
+  // the diagonal as ones.
+  OclArray<T> trsm (const OclArray<T>& b, bool upper, char trans = 'N', bool unit_diag = false) const;
+
+  // Left division *this \ b for a square *this, by the LU factorization;
+  // info as with lu (singular matrix).
+  OclArray<T> mldivide (const OclArray<T>& b, octave_idx_type& info) const;
+
+  // A copy of the m x n block at row r0, column c0 of a 2-dim array (as
+  // index with two ranges, which need not address contiguous memory).
+  OclArray<T> get_block (octave_idx_type r0, octave_idx_type c0,
+                         octave_idx_type m, octave_idx_type n) const;
+
+  // Upper / lower triangular part (on and above / below the k-th diagonal)
+  // of a 2-dim array; unit_diag sets the k-th diagonal to ones.
+  OclArray<T> triu (octave_idx_type k = 0) const { return map_tri (k, 0); }
+  OclArray<T> tril (octave_idx_type k = 0, bool unit_diag = false) const
+    { return map_tri (k, unit_diag ? 2 : 1); }
+
+  // Histogram along dim as histc: the counts of the elements in the bins
+  // [edges (k), edges (k+1)) of the ascending edges, the last bin holding
+  // the elements equal to the last edge; the counts are exact doubles,
+  // whatever the class of the array.  Not for complex types.  histc_host
+  // returns the same counts on the host, for a context without double
+  // support (see opencl_context_is_fp64).
+  OclArray<double> histc (const OclArray<T>& edges, int dim = -1) const;
+  Array<double> histc_host (const OclArray<T>& edges, int dim = -1) const;
+
+  // The histogram array of dimensions dv (of this class) from the counts
+  // of histc, nb per slice, the bins along the dimension of stride fac.
+  static OclArray<T> histc_store (const OclArray<octave_uint32>& counts,
+                                  const dim_vector& dv,
+                                  octave_idx_type nb,
+                                  octave_idx_type fac);
+
+  // accumarray: the values vals (or a single value for all subscripts)
+  // reduced by fcn (0: sum, 1: max, 2: min) into a column of n_out elements
+  // at the one-based linear subscripts subs (as from as_index); elements
+  // without subscripts get fillval.
+  static OclArray<T> accumarray (const OclArray<ocl_idx_type>& subs, const OclArray<T>& vals,
+                                 octave_idx_type n_out, int fcn = 0, const T& fillval = T (0));
+
+  // Out-of-core reduction of all elements of a host array, which may be larger
+  // than the largest OpenCL buffer: the data is streamed to the device in chunks
+  // of chunk_len elements (by default sized from the device's memory limits),
+  // double-buffered, i.e., the upload of a chunk overlaps with the computation
+  // on the previous one; fcn is 0: sum, 1: sumsq, 2: prod, 3: max, 4: min.
+  static T stream_reduce (const Array<T>& a, int fcn, octave_idx_type chunk_len = 0);
+
+  // Out-of-core mapping function of a host array, streamed in chunks as above.
+  static Array<T> stream_map (const Array<T>& a, octave_base_value::unary_mapper_t umap,
+                              octave_idx_type chunk_len = 0);
+
+  // Out-of-core elementwise operation of two host arrays of equal dimensions,
+  // streamed in chunks as above; op is 0: plus, 1: minus, 2: times, 3: rdivide.
+  static Array<T> stream_map2 (const Array<T>& a, const Array<T>& b, int op,
+                               octave_idx_type chunk_len = 0);
+
+  // Raw element data: written through mapped memory of the OpenCL buffer,
+  // or read into a new array of dimensions dv (swapping the bytes of each
+  // element component if swap is set; with lazy_upload, as above).
+  bool write_raw (std::ostream& os) const;
+  static OclArray<T> read_raw (std::istream& is, const dim_vector& dv, bool swap, bool lazy_upload = false);
+
+  // Array of dimensions dv from raw host data (e.g., a memory-mapped file),
+  // uploaded by non-blocking writes in chunks; returns when all are done.
+  static OclArray<T> upload_raw (const void *d, const dim_vector& dv);
 
   void print_info (std::ostream& os, const std::string& prefix = "") const;
 
@@ -670,12 +918,42 @@ protected:
   OclArray<T> map (OclArrayKernels::Kernel kernel) const;
   template <typename U> OclArray<U> map_c2r (OclArrayKernels::Kernel kernel) const;
   OclArray<T> map1 (OclArrayKernels::Kernel kernel, const T& par) const;
+  OclArray<T> map_transpose (OclArrayKernels::Kernel kernel) const;
+
+  // Result dimension k is dimension perm (k) of this array, shifted
+  // circularly by shift (perm (k)) and reversed for flip (perm (k)).
+  OclArray<T> remap (const Array<octave_idx_type>& perm,
+                     const Array<bool>& flip,
+                     const Array<octave_idx_type>& shift) const;
   OclArray<T> map1r (OclArrayKernels::Kernel kernel, int dim = -1) const;
   OclArray<T> map1re (OclArrayKernels::Kernel kernel, int dim = -1) const;
   OclArray<ocl_idx_type> map1rf (OclArrayKernels::Kernel kernel, int dim = -1) const;
   OclArray<T> map1ri (OclArrayKernels::Kernel kernel, int dim = -1, OclArray<ocl_idx_type> *indices = 0) const;
   OclArray<T> map1rie (OclArrayKernels::Kernel kernel, int dim = -1, OclArray<ocl_idx_type> *indices = 0) const;
   OclArray<T> map2s (OclArrayKernels::Kernel kernel, const OclArray<T>& s2) const;
+  OclArray<T> var_std (int opt, int dim, bool take_sqrt, OclArray<T> *mean) const;
+  OclArray<T> map_tri (octave_idx_type k, unsigned long fcn) const;
+
+  // Blocks of 2-dim arrays for the linear algebra (see also get_block):
+  // copying (or subtracting) s into the block at (r0, c0) in place; the row
+  // interchanges ipiv (k0 .. k1-1) of lu in place, but in the columns
+  // skip0 .. skip1-1; and a triangular solve in place of b.
+  void set_block (octave_idx_type r0, octave_idx_type c0, const OclArray<T>& s, bool subtract);
+  void lu_swap (const OclArray<ocl_idx_type>& ipiv, octave_idx_type k0, octave_idx_type k1,
+                octave_idx_type skip0 = 0, octave_idx_type skip1 = 0);
+  void trsm_inplace (OclArray<T>& b, bool upper, char trans, bool unit_diag) const;
+
+  // Ascending bitonic sort of keys (of a power of two length) on the
+  // device, reordering perm along with the keys if use_perm.
+  static void sort_keys (OclArray<ocl_idx_type>& keys, OclArray<ocl_idx_type>& perm, bool use_perm);
+
+  // The counts of histc, nb per slice (empty for an empty histogram), the
+  // dimensions of the histogram and the stride of its bins.
+  OclArray<octave_uint32> histc_counts (const OclArray<T>& edges, int dim,
+                                        dim_vector& new_dimensions, octave_idx_type& fac) const;
+  octave_idx_type compact (const OclArray<T>& flags,
+                           OclArray<ocl_idx_type> *indices, OclArray<T> *values,
+                           octave_idx_type n = -1, bool backward = false) const;
 
   void map_inplace (OclArrayKernels::Kernel kernel);
   OclArray<T> map1_inplace (OclArrayKernels::Kernel kernel, const T& par);
@@ -687,6 +965,19 @@ protected:
                              const T& par,
                              unsigned long fcn);
 
+  static OclArray<T> rand_fill (const dim_vector& dv, unsigned long fcn,
+                                int64_t lo, uint64_t range);
+
+  // Double-buffered streaming (see OclStreamEvents in ocl_array.cc): upload
+  // of chunk c (of chunk length len) of the n elements at d into the staging
+  // buffer buf, once the event idle_event (if any) has completed; the event
+  // ready_event completes with the upload.  Readback of y into r, without
+  // blocking.
+  static void stream_upload_chunk (OclArray<T>& buf, const T *d, octave_idx_type n,
+                                   octave_idx_type len, octave_idx_type c,
+                                   void *& idle_event, void *& ready_event);
+  static void stream_download_chunk (const OclArray<T>& y, T *r);
+
   OclArray<T> repmat1 (int dim, octave_idx_type rep) const;
   void index_helper (const Array<idx_vector>& ia,
                      dim_vector& dv,
@@ -697,8 +988,18 @@ protected:
 
   static OclProgram array_prog;
   static std::vector<int> kernel_indices;
+  static int array_prog_vector_width;
 
   static void assure_valid_array_prog (void);
+  static void enqueue_elementwise_kernel (int kernel_index, octave_idx_type n);
+  static void fft_stockham (OclArray<T>& dst,
+                            const OclArray<T>& src,
+                            const std::vector<octave_idx_type>& radices,
+                            octave_idx_type n,
+                            octave_idx_type fac,
+                            octave_idx_type num_transforms,
+                            long sign,
+                            double scale);
 
 private:
 
@@ -732,6 +1033,12 @@ typedef OclArray<FloatComplex > OclFloatComplexNDArray;
 typedef OclArray<Complex      > OclComplexNDArray;
 
 
+// Seed (key) of the random number streams of OclArray<T>::rand (), randn ()
+// and randi (); setting it also restarts the stream.
+void ocl_rand_set_seed (uint64_t seed);
+uint64_t ocl_rand_get_seed (void);
+
+
 #define OCLARRAY_BINOPS_C(OP2, OP1) \
   template <typename TR> \
   OclArray< std::complex<TR> > OP2 (const OclArray<TR>& s1, const OclArray< std::complex<TR> >& s2) \
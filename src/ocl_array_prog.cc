@@ -76,25 +76,93 @@ DEFCMP (IS_LE, <=)                                           \n\
 DEFCMP (IS_GE, >=)                                           \n\
                                                              \n\
                                                              \n\
+// grid-stride loops over n elements (elementwise kernels):  \n\
+// the host launches as many work-items as the device can keep busy, \n\
+// and every work-item handles all elements i = gid, gid + gsize, ... \n\
+// VEC_LOOP runs over n/VW vectors of VW elements each, and TAIL_LOOP \n\
+// over the n%VW remaining scalar elements; vloadn/vstoren only need \n\
+// scalar alignment, so any slice offset is fine             \n\
+                                                             \n\
+#define GRID_LOOP(i, n) \\                                   \n\
+  for (size_t i = get_global_id (0); i < (n); i += get_global_size (0)) \n\
+#define VEC_LOOP(i, n) \\                                    \n\
+  for (size_t i = get_global_id (0); i < (n) / VW; i += get_global_size (0)) \n\
+#define TAIL_LOOP(i, n) \\                                   \n\
+  for (size_t i = ((n) / VW) * VW + get_global_id (0); i < (n); i += get_global_size (0)) \n\
+                                                             \n\
+#if (! defined (VW)) || defined (COMPLEX) // no vector types \n\
+                                                             \n\
+#undef VW                                                    \n\
+#define VW 1                                                 \n\
+#define VTYPE TYPE                                           \n\
+#define VLOAD(i, p) ((p) [i])                                \n\
+#define VSTORE(v, i, p) ((p) [i] = (v))                      \n\
+                                                             \n\
+#else // VW in {2, 4, 8, 16}                                 \n\
+                                                             \n\
+#define CONCAT2_(a, b) a##b                                  \n\
+#define CONCAT2(a, b) CONCAT2_(a, b)                         \n\
+#define VTYPE CONCAT2 (TYPE, VW)                             \n\
+#define VLOAD CONCAT2 (vload, VW)                            \n\
+#define VSTORE CONCAT2 (vstore, VW)                          \n\
+                                                             \n\
+#endif                                                       \n\
+                                                             \n\
+#if defined (COMPLEX)                                        \n\
+#define V_LT(a,b) IS_LT (a, b)                               \n\
+#define V_GT(a,b) IS_GT (a, b)                               \n\
+#define V_LE(a,b) IS_LE (a, b)                               \n\
+#define V_GE(a,b) IS_GE (a, b)                               \n\
+#define V_EQ(a,b) IS_EQ (a, b)                               \n\
+#define V_NE(a,b) IS_NE (a, b)                               \n\
+#else                                                        \n\
+#define V_LT(a,b) ((a) < (b))                                \n\
+#define V_GT(a,b) ((a) > (b))                                \n\
+#define V_LE(a,b) ((a) <= (b))                               \n\
+#define V_GE(a,b) ((a) >= (b))                               \n\
+#define V_EQ(a,b) ((a) == (b))                               \n\
+#define V_NE(a,b) ((a) != (b))                               \n\
+#endif                                                       \n\
+                                                             \n\
+#if VW > 1 // vector relational results are -1 (true) or 0 (false) \n\
+#define VBOOL(c) select ((VTYPE) (ZERO), (VTYPE) (ONE), c)   \n\
+#else                                                        \n\
+#define VBOOL(c) ((c) ? ONE : ZERO)                          \n\
+#endif                                                       \n\
+                                                             \n\
+                                                             \n\
 __kernel void                                                \n\
 ocl_fill                                                     \n\
   (__global TYPE *data_dst,                                  \n\
-   const TYPE value)                                         \n\
+   const ulong ofs_dst,                                      \n\
+   const TYPE value,                                         \n\
+   const ulong n)                                            \n\
 {                                                            \n\
-  size_t i = get_global_id (0);                              \n\
-  data_dst [i] = value;                                      \n\
+  data_dst += ofs_dst;                                       \n\
+  VTYPE v = (VTYPE) (value);                                 \n\
+  VEC_LOOP (i, n)                                            \n\
+    VSTORE (v, i, data_dst);                                 \n\
+  TAIL_LOOP (i, n)                                           \n\
+    data_dst [i] = value;                                    \n\
 }                                                            \n\
                                                              \n\
                                                              \n\
 __kernel void                                                \n\
 ocl_fill0                                                    \n\
   (__global TYPE *data_dst,                                  \n\
+   const ulong ofs_dst,                                      \n\
    const __global TYPE *data_src,                            \n\
-   const ulong ofs_src)                                      \n\
+   const ulong ofs_src,                                      \n\
+   const ulong n)                                            \n\
 {                                                            \n\
+  data_dst += ofs_dst;                                       \n\
   data_src += ofs_src;                                       \n\
-  size_t i = get_global_id (0);                              \n\
-  data_dst [i] = data_src [0];                               \n\
+  TYPE value = data_src [0];                                 \n\
+  VTYPE v = (VTYPE) (value);                                 \n\
+  VEC_LOOP (i, n)                                            \n\
+    VSTORE (v, i, data_dst);                                 \n\
+  TAIL_LOOP (i, n)                                           \n\
+    data_dst [i] = value;                                    \n\
 }                                                            \n\
                                                              \n\
                                                              \n\
@@ -134,6 +202,85 @@ ocl_logspace                                                 \n\
   TYPE exponent = start_val + ((end_val-start_val)*i)/(n-1); \n\
   data_dst [i] = exp (log ((TYPE) 10.0)*exponent);           \n\
 }                                                            \n\
+#endif                                                       \n\
+                                                             \n\
+                                                             \n\
+// counter-based random numbers: Philox4x32-10 (Salmon et al., 2011) \n\
+// maps a 128 bit counter and a 64 bit key to 128 random bits \n\
+                                                             \n\
+#define PHILOX_M0 0xD2511F53                                 \n\
+#define PHILOX_M1 0xCD9E8D57                                 \n\
+#define PHILOX_W0 0x9E3779B9                                 \n\
+#define PHILOX_W1 0xBB67AE85                                 \n\
+                                                             \n\
+uint4                                                        \n\
+philox4x32 (uint4 ctr, uint2 key)                            \n\
+{                                                            \n\
+  uint hi0, hi1, lo0, lo1;                                   \n\
+  for (int round=0; round<10; round++) {                     \n\
+    hi0 = mul_hi ((uint) PHILOX_M0, ctr.x);                  \n\
+    lo0 = PHILOX_M0 * ctr.x;                                 \n\
+    hi1 = mul_hi ((uint) PHILOX_M1, ctr.z);                  \n\
+    lo1 = PHILOX_M1 * ctr.z;                                 \n\
+    ctr = (uint4) (hi1 ^ ctr.y ^ key.x, lo1, hi0 ^ ctr.w ^ key.y, lo0); \n\
+    key += (uint2) (PHILOX_W0, PHILOX_W1);                   \n\
+  }                                                          \n\
+  return ctr;                                                \n\
+}                                                            \n\
+                                                             \n\
+#if defined (FLOATINGPOINT) && ! defined (COMPLEX)           \n\
+// uniform in the open interval (0,1) from the top bits of w \n\
+#define RAND_BITS ((sizeof (TYPE) == 8) ? 52 : 23)           \n\
+#define RAND_UNIFORM(w) \\                                   \n\
+  (((TYPE) ((w) >> (64 - RAND_BITS)) + (TYPE) 0.5) / (TYPE) (1UL << RAND_BITS)) \n\
+#endif                                                       \n\
+                                                             \n\
+#if ! defined (COMPLEX)                                      \n\
+                                                             \n\
+// elements 2*b and 2*b+1 take the 64 bit halves of the Philox block of \n\
+// counter ctr + b, so the result only depends on key, ctr and the \n\
+// element index (not on the work size); fcn = 0: uniform on (0,1), \n\
+// 1: standard normal (Box-Muller), 2: integers lo + [0, range) \n\
+__kernel void                                                \n\
+ocl_rand                                                     \n\
+  (__global TYPE *data_dst,                                  \n\
+   const ulong key,                                          \n\
+   const ulong ctr,                                          \n\
+   const ulong lo,                                           \n\
+   const ulong range,                                        \n\
+   const ulong fcn,                                          \n\
+   const ulong n)                                            \n\
+{                                                            \n\
+  GRID_LOOP (b, (n + 1) / 2) {                               \n\
+    ulong c = ctr + b;                                       \n\
+    uint4 r = philox4x32 ((uint4) ((uint) c, (uint) (c >> 32), 0, 0), \n\
+                          (uint2) ((uint) key, (uint) (key >> 32))); \n\
+    ulong w0 = (((ulong) r.x) << 32) | r.y;                  \n\
+    ulong w1 = (((ulong) r.z) << 32) | r.w;                  \n\
+    TYPE v0, v1;                                             \n\
+#if defined (FLOATINGPOINT) && ! defined (COMPLEX)           \n\
+    TYPE u0 = RAND_UNIFORM (w0), u1 = RAND_UNIFORM (w1);     \n\
+    if (fcn == 0) {                                          \n\
+      v0 = u0;                                               \n\
+      v1 = u1;                                               \n\
+    } else if (fcn == 1) {                                   \n\
+      TYPE rho = sqrt (((TYPE) -2.0) * log (u0));            \n\
+      v0 = rho * cospi (((TYPE) 2.0) * u1);                  \n\
+      v1 = rho * sinpi (((TYPE) 2.0) * u1);                  \n\
+    } else {                                                 \n\
+      v0 = (TYPE) ((long) (lo + w0 % range));                \n\
+      v1 = (TYPE) ((long) (lo + w1 % range));                \n\
+    }                                                        \n\
+#else                                                        \n\
+    v0 = (TYPE) (lo + w0 % range);                           \n\
+    v1 = (TYPE) (lo + w1 % range);                           \n\
+#endif                                                       \n\
+    data_dst [2*b] = v0;                                     \n\
+    if (2*b+1 < n)                                           \n\
+      data_dst [2*b+1] = v1;                                 \n\
+  }                                                          \n\
+}                                                            \n\
+                                                             \n\
 #endif                                                       \n\
                                                              \n\
                                                              \n\
@@ -167,20 +314,58 @@ ocl_repmat1                                                  \n\
 }                                                            \n\
                                                              \n\
                                                              \n\
-__kernel void                                                \n\
-ocl_cat                                                      \n\
-  (__global TYPE *data_dst,                                  \n\
-   const __global TYPE *data_src,                            \n\
-   const ulong ofs_src,                                      \n\
-   const ulong offs, const ulong fac1, const ulong fac2)     \n\
-{                                                            \n\
-  data_src += ofs_src;                                       \n\
-  size_t i = get_global_id (0), j;                           \n\
-  j = offs + (i % fac1) + (i / fac1) * fac2;                 \n\
-  data_dst [j] = data_src [i];                               \n\
+// concatenation: work-item (i, k) copies element i of     \n\
+// source k (global id 1) of a launch; per source, the table \n\
+// holds the source offset, the destination offset of its    \n\
+// first block, its length and its block length              \n\
+__kernel void                                                \n\
+ocl_cat_gather                                               \n\
+  (__global TYPE *data_dst,                                  \n\
+   const __global TYPE *src0, const __global TYPE *src1,     \n\
+   const __global TYPE *src2, const __global TYPE *src3,     \n\
+   const __global TYPE *src4, const __global TYPE *src5,     \n\
+   const __global TYPE *src6, const __global TYPE *src7,     \n\
+   const __global long *table,                               \n\
+   const ulong ofs_table,                                    \n\
+   const ulong num_src,                                      \n\
+   const ulong dst_stride)                                   \n\
+{                                                            \n\
+  size_t i = get_global_id (0), k = get_global_id (1);       \n\
+  const __global long *t = table + 4 * (ofs_table + k);      \n\
+  if ((k >= num_src) || (i >= t [2]))                        \n\
+    return;                                                  \n\
+  const __global TYPE *data_src;                             \n\
+  switch (k) {                                               \n\
+    case 0: data_src = src0; break;                          \n\
+    case 1: data_src = src1; break;                          \n\
+    case 2: data_src = src2; break;                          \n\
+    case 3: data_src = src3; break;                          \n\
+    case 4: data_src = src4; break;                          \n\
+    case 5: data_src = src5; break;                          \n\
+    case 6: data_src = src6; break;                          \n\
+    default: data_src = src7;                                \n\
+  }                                                          \n\
+  size_t b = i / t [3];                                      \n\
+  data_dst [t [1] + b * dst_stride + (i - b * t [3])] =      \n\
+    data_src [t [0] + i];                                    \n\
 }                                                            \n\
                                                              \n\
                                                              \n\
+// tiled transpose of the s1 x s2 pages (page = global id 2): \n\
+// a TILE_DIM x TILE_DIM tile is read with consecutive work-items \n\
+// on consecutive rows and written with consecutive work-items \n\
+// on consecutive columns, both coalesced; the local memory tile \n\
+// is padded by one column against bank conflicts; work-groups \n\
+// smaller than the tile loop over it                        \n\
+                                                             \n\
+#define TILE_DIM 32                                          \n\
+                                                             \n\
+#if defined (COMPLEX)                                        \n\
+#define CONJ(z) ((TYPE) ((z).x, -(z).y))                     \n\
+#else                                                        \n\
+#define CONJ(z) (z)                                          \n\
+#endif                                                       \n\
+                                                             \n\
 __kernel void                                                \n\
 ocl_transpose                                                \n\
   (__global TYPE *data_dst,                                  \n\
@@ -189,10 +374,23 @@ ocl_transpose                                                \n\
    const ulong s1,                                           \n\
    const ulong s2)                                           \n\
 {                                                            \n\
-  data_src += ofs_src;                                       \n\
-  size_t i = get_global_id (0), j;                           \n\
-  j = (i / s2) + (i % s2) * s1;                              \n\
-  data_dst [i] = data_src [j];                               \n\
+  __local TYPE tile [TILE_DIM] [TILE_DIM+1];                 \n\
+  size_t lx = get_local_id (0), ly = get_local_id (1);       \n\
+  size_t nx = get_local_size (0), ny = get_local_size (1);   \n\
+  size_t r0 = get_group_id (0) * TILE_DIM;                   \n\
+  size_t c0 = get_group_id (1) * TILE_DIM;                   \n\
+  size_t page = get_global_id (2), x, y;                     \n\
+  data_src += ofs_src + page * s1 * s2;                      \n\
+  data_dst += page * s1 * s2;                                \n\
+  for (y=ly; y<TILE_DIM; y+=ny)                              \n\
+    for (x=lx; x<TILE_DIM; x+=nx)                            \n\
+      if ((r0+x < s1) && (c0+y < s2))                        \n\
+        tile [y] [x] = data_src [(r0+x) + (c0+y) * s1];      \n\
+  barrier (CLK_LOCAL_MEM_FENCE);                             \n\
+  for (y=ly; y<TILE_DIM; y+=ny)                              \n\
+    for (x=lx; x<TILE_DIM; x+=nx)                            \n\
+      if ((c0+x < s2) && (r0+y < s1))                        \n\
+        data_dst [(c0+x) + (r0+y) * s2] = tile [x] [y];      \n\
 }                                                            \n\
                                                              \n\
                                                              \n\
@@ -203,17 +401,50 @@ ocl_hermitian                                                \n\
    const ulong ofs_src,                                      \n\
    const ulong s1,                                           \n\
    const ulong s2)                                           \n\
+{                                                            \n\
+  __local TYPE tile [TILE_DIM] [TILE_DIM+1];                 \n\
+  size_t lx = get_local_id (0), ly = get_local_id (1);       \n\
+  size_t nx = get_local_size (0), ny = get_local_size (1);   \n\
+  size_t r0 = get_group_id (0) * TILE_DIM;                   \n\
+  size_t c0 = get_group_id (1) * TILE_DIM;                   \n\
+  size_t page = get_global_id (2), x, y;                     \n\
+  data_src += ofs_src + page * s1 * s2;                      \n\
+  data_dst += page * s1 * s2;                                \n\
+  for (y=ly; y<TILE_DIM; y+=ny)                              \n\
+    for (x=lx; x<TILE_DIM; x+=nx)                            \n\
+      if ((r0+x < s1) && (c0+y < s2))                        \n\
+        tile [y] [x] = data_src [(r0+x) + (c0+y) * s1];      \n\
+  barrier (CLK_LOCAL_MEM_FENCE);                             \n\
+  for (y=ly; y<TILE_DIM; y+=ny)                              \n\
+    for (x=lx; x<TILE_DIM; x+=nx)                            \n\
+      if ((c0+x < s2) && (r0+y < s1))                        \n\
+        data_dst [(c0+x) + (r0+y) * s2] = CONJ (tile [x] [y]); \n\
+}                                                            \n\
+                                                             \n\
+// index remap (permute, circshift, flip, rot90): output element i, \n\
+// with index i_k in output dimension k of extent map [k], is source \n\
+// element sum_k ((i_k + map [2*nd+k]) % map [k]) * map [nd+k]; the \n\
+// source strides map [nd+k] may be negative (reversed dimensions) \n\
+__kernel void                                                \n\
+ocl_permute                                                  \n\
+  (__global TYPE *data_dst,                                  \n\
+   const __global TYPE *data_src,                            \n\
+   const ulong ofs_src,                                      \n\
+   const __global IDX_T *map,                                \n\
+   const ulong nd,                                           \n\
+   const ulong n)                                            \n\
 {                                                            \n\
   data_src += ofs_src;                                       \n\
-  size_t i = get_global_id (0), j;                           \n\
-  j = (i / s2) + (i % s2) * s1;                              \n\
-  TYPE z;                                                    \n\
-  z = data_src [j];                                          \n\
-#if defined (COMPLEX)                                        \n\
-  data_dst [i] = (TYPE) (z.x, -z.y);                         \n\
-#else                                                        \n\
-  data_dst [i] = z;                                          \n\
-#endif                                                       \n\
+  GRID_LOOP (i, n) {                                         \n\
+    size_t r = i, k, d;                                      \n\
+    IDX_T j = 0;                                             \n\
+    for (k=0; k<nd; k++) {                                   \n\
+      d = map [k];                                           \n\
+      j += (IDX_T) (((r % d) + map [2*nd+k]) % d) * map [nd+k]; \n\
+      r /= d;                                                \n\
+    }                                                        \n\
+    data_dst [i] = data_src [j];                             \n\
+  }                                                          \n\
 }                                                            \n\
                                                              \n\
                                                              \n\
@@ -373,6 +604,109 @@ ocl_findlast                                                 \n\
 }                                                            \n\
                                                              \n\
                                                              \n\
+// stream compaction (find, logical indexing, nnz) in three steps: \n\
+// compact_count counts the nonzero flags in each of the chunks \n\
+// of len elements (one work-group per chunk), compact_scan turns \n\
+// the counts into chunk offsets (plus the total count), and \n\
+// compact_scatter writes index and/or value of each nonzero in \n\
+// order, restricted to output positions pos_lo .. pos_hi-1  \n\
+                                                             \n\
+__kernel void                                                \n\
+ocl_compact_count                                            \n\
+  (__global IDX_T *data_dst,                                 \n\
+   const __global TYPE *data_src,                            \n\
+   const ulong ofs_src,                                      \n\
+   const ulong len,                                          \n\
+   const ulong chunk,                                        \n\
+   __local IDX_T *loc_cnt)                                   \n\
+{                                                            \n\
+  data_src += ofs_src;                                       \n\
+  size_t g = get_group_id (0), k;                            \n\
+  size_t lid = get_local_id (0), lsize = get_local_size (0); \n\
+  size_t k0 = g * chunk, k1 = min (k0 + chunk, (size_t) len); \n\
+  IDX_T cnt = 0;                                             \n\
+  for (k=k0+lid; k<k1; k+=lsize)                             \n\
+    if (IS_NONZERO (data_src [k]))                           \n\
+      cnt++;                                                 \n\
+  loc_cnt [lid] = cnt;                                       \n\
+  barrier (CLK_LOCAL_MEM_FENCE);                             \n\
+  for (k=lsize/2; k>0; k/=2) {                               \n\
+    if (lid < k)                                             \n\
+      loc_cnt [lid] += loc_cnt [lid+k];                      \n\
+    barrier (CLK_LOCAL_MEM_FENCE);                           \n\
+  }                                                          \n\
+  if (lid == 0)                                              \n\
+    data_dst [g] = loc_cnt [0];                              \n\
+}                                                            \n\
+                                                             \n\
+                                                             \n\
+__kernel void                                                \n\
+ocl_compact_scan                                             \n\
+  (__global IDX_T *data,                                     \n\
+   const ulong n)                                            \n\
+{                                                            \n\
+  IDX_T sum = 0, cnt;                                        \n\
+  size_t k;                                                  \n\
+  if (get_global_id (0) != 0)                                \n\
+    return;                                                  \n\
+  for (k=0; k<n; k++) {                                      \n\
+    cnt = data [k];                                          \n\
+    data [k] = sum;                                          \n\
+    sum += cnt;                                              \n\
+  }                                                          \n\
+  data [n] = sum;                                            \n\
+}                                                            \n\
+                                                             \n\
+                                                             \n\
+__kernel void                                                \n\
+ocl_compact_scatter                                          \n\
+  (__global IDX_T *dst_idx,                                  \n\
+   __global TYPE *dst_val,                                   \n\
+   const __global TYPE *flag_src,                            \n\
+   const ulong ofs_flag,                                     \n\
+   const __global TYPE *val_src,                             \n\
+   const ulong ofs_val,                                      \n\
+   const ulong len,                                          \n\
+   const ulong chunk,                                        \n\
+   const __global IDX_T *offsets,                            \n\
+   const ulong pos_lo,                                       \n\
+   const ulong pos_hi,                                       \n\
+   const ulong fcn,                                          \n\
+   __local IDX_T *loc_pos)                                   \n\
+{                                                            \n\
+  flag_src += ofs_flag;                                      \n\
+  val_src += ofs_val;                                        \n\
+  size_t g = get_group_id (0), k, kk, s;                     \n\
+  size_t lid = get_local_id (0), lsize = get_local_size (0); \n\
+  size_t k0 = g * chunk, k1 = min (k0 + chunk, (size_t) len); \n\
+  IDX_T base = offsets [g], p, t;                            \n\
+  int f;                                                     \n\
+  if ((base >= (IDX_T) pos_hi) || (offsets [g+1] <= (IDX_T) pos_lo)) \n\
+    return; // whole work-group: no output position in range \n\
+  for (k=k0; k<k1; k+=lsize) {                               \n\
+    kk = k + lid;                                            \n\
+    f = (kk < k1) && IS_NONZERO (flag_src [kk]);             \n\
+    loc_pos [lid] = f;                                       \n\
+    barrier (CLK_LOCAL_MEM_FENCE);                           \n\
+    for (s=1; s<lsize; s*=2) { // inclusive scan of the flags \n\
+      t = (lid >= s) ? loc_pos [lid-s] : 0;                  \n\
+      barrier (CLK_LOCAL_MEM_FENCE);                         \n\
+      loc_pos [lid] += t;                                    \n\
+      barrier (CLK_LOCAL_MEM_FENCE);                         \n\
+    }                                                        \n\
+    p = base + loc_pos [lid] - 1;                            \n\
+    if (f && (p >= (IDX_T) pos_lo) && (p < (IDX_T) pos_hi)) { \n\
+      if (fcn & 1)                                           \n\
+        dst_idx [p-pos_lo] = (IDX_T) (kk);                   \n\
+      if (fcn & 2)                                           \n\
+        dst_val [p-pos_lo] = val_src [kk];                   \n\
+    }                                                        \n\
+    base += loc_pos [lsize-1];                               \n\
+    barrier (CLK_LOCAL_MEM_FENCE);                           \n\
+  }                                                          \n\
+}                                                            \n\
+                                                             \n\
+                                                             \n\
 __kernel void                                                \n\
 ocl_all                                                      \n\
   (__global TYPE *data_dst,                                  \n\
@@ -553,29 +887,257 @@ ocl_meansq                                                   \n\
                                                              \n\
                                                              \n\
 #if defined (FLOATINGPOINT) || defined (COMPLEX)             \n\
+#if defined (COMPLEX)                                        \n\
+#define RTYPE TYPE1                                          \n\
+#define ABS2(z) ((z).x*(z).x + (z).y*(z).y)                  \n\
+#define FROM_REAL(r) ((TYPE) (r, 0))                         \n\
+#else                                                        \n\
+#define RTYPE TYPE                                           \n\
+#define ABS2(z) ((z)*(z))                                    \n\
+#define FROM_REAL(r) (r)                                     \n\
+#endif                                                       \n\
+                                                             \n\
+// mean and variance in a single pass: each work-item of a   \n\
+// work-group accumulates (count, mean, M2) of its share of one \n\
+// slice with Welford's update, then the partial results are \n\
+// merged pairwise in a tree (Chan et al.); fcn == 1 gives std \n\
+__kernel void                                                \n\
+ocl_var                                                      \n\
+  (__global TYPE *data_dst1,                                 \n\
+   __global TYPE *data_dst2,                                 \n\
+   const __global TYPE *data_src,                            \n\
+   const ulong ofs_src,                                      \n\
+   const ulong len,                                          \n\
+   const ulong fac,                                          \n\
+   const ulong n,                                            \n\
+   const ulong fcn,                                          \n\
+   __local ulong *loc_cnt,                                   \n\
+   __local TYPE *loc_mean,                                   \n\
+   __local RTYPE *loc_m2)                                    \n\
+{                                                            \n\
+  data_src += ofs_src;                                       \n\
+  size_t i = get_group_id (1), j, k;                         \n\
+  size_t lid = get_local_id (0), lsize = get_local_size (0); \n\
+  size_t j0 = (i % fac) + (i / fac) * fac * len;             \n\
+  ulong cnt = 0;                                             \n\
+  TYPE mean = ZERO, delta;                                   \n\
+  RTYPE m2 = 0;                                              \n\
+  for (k=lid; k<len; k+=lsize) {                             \n\
+    j = j0 + k * fac;                                        \n\
+    delta = data_src [j] - mean;                             \n\
+    cnt++;                                                   \n\
+    mean += delta / (RTYPE) cnt;                             \n\
+    m2 += ABS2 (delta) * ((RTYPE) (cnt-1) / (RTYPE) cnt);    \n\
+  }                                                          \n\
+  loc_cnt [lid] = cnt;                                       \n\
+  loc_mean [lid] = mean;                                     \n\
+  loc_m2 [lid] = m2;                                         \n\
+  barrier (CLK_LOCAL_MEM_FENCE);                             \n\
+  for (k=lsize/2; k>0; k/=2) {                               \n\
+    if ((lid < k) && (loc_cnt [lid+k] > 0)) {                \n\
+      ulong na = loc_cnt [lid], nb = loc_cnt [lid+k];        \n\
+      RTYPE fb = (RTYPE) nb / (RTYPE) (na + nb);             \n\
+      delta = loc_mean [lid+k] - loc_mean [lid];             \n\
+      loc_mean [lid] += delta * fb;                          \n\
+      loc_m2 [lid] += loc_m2 [lid+k] + ABS2 (delta) * (RTYPE) na * fb; \n\
+      loc_cnt [lid] = na + nb;                               \n\
+    }                                                        \n\
+    barrier (CLK_LOCAL_MEM_FENCE);                           \n\
+  }                                                          \n\
+  if (lid == 0) {                                            \n\
+    m2 = (n > 0) ? max (loc_m2 [0] / (RTYPE) n, (RTYPE) 0) : (RTYPE) 0; \n\
+    if (fcn == 1)                                            \n\
+      m2 = sqrt (m2);                                        \n\
+    if (data_dst1 != data_dst2)                              \n\
+      data_dst1 [i] = loc_mean [0];                          \n\
+    data_dst2 [i] = FROM_REAL (m2);                          \n\
+  }                                                          \n\
+}                                                            \n\
+#endif                                                       \n\
+                                                             \n\
+                                                             \n\
+// first differences along a dimension: output element i (of a slice \n\
+// length of len-1) is data_src [j+fac] - data_src [j]; higher orders \n\
+// are repeated launches, one per order                      \n\
+__kernel void                                                \n\
+ocl_diff                                                     \n\
+  (__global TYPE *data_dst,                                  \n\
+   const __global TYPE *data_src,                            \n\
+   const ulong ofs_src,                                      \n\
+   const ulong len,                                          \n\
+   const ulong fac,                                          \n\
+   const ulong n)                                            \n\
+{                                                            \n\
+  data_src += ofs_src;                                       \n\
+  GRID_LOOP (i, n) {                                         \n\
+    size_t k = (i / fac) % (len - 1);                        \n\
+    size_t j = (i % fac) + k * fac + (i / (fac * (len - 1))) * fac * len; \n\
+    data_dst [i] = data_src [j+fac] - data_src [j];          \n\
+  }                                                          \n\
+}                                                            \n\
+                                                             \n\
+                                                             \n\
+#if defined (FLOATINGPOINT) || defined (COMPLEX)             \n\
+                                                             \n\
+// gradient along a dimension: central differences (scaled by \n\
+// hinv2 = 1/(2h)) at interior points, one-sided differences (scaled \n\
+// by hinv = 1/h) at both ends of a slice, and zero for len == 1 \n\
 __kernel void                                                \n\
-ocl_std                                                      \n\
+ocl_gradient                                                 \n\
   (__global TYPE *data_dst,                                  \n\
    const __global TYPE *data_src,                            \n\
    const ulong ofs_src,                                      \n\
    const ulong len,                                          \n\
    const ulong fac,                                          \n\
+   const TYPE hinv,                                          \n\
+   const TYPE hinv2,                                         \n\
    const ulong n)                                            \n\
 {                                                            \n\
   data_src += ofs_src;                                       \n\
+  GRID_LOOP (i, n) {                                         \n\
+    size_t k = (i / fac) % len;                              \n\
+    TYPE d, h;                                               \n\
+    if (len == 1) {                                          \n\
+      d = ZERO;                                              \n\
+      h = ZERO;                                              \n\
+    } else if (k == 0) {                                     \n\
+      d = data_src [i+fac] - data_src [i];                   \n\
+      h = hinv;                                              \n\
+    } else if (k == len-1) {                                 \n\
+      d = data_src [i] - data_src [i-fac];                   \n\
+      h = hinv;                                              \n\
+    } else {                                                 \n\
+      d = data_src [i+fac] - data_src [i-fac];               \n\
+      h = hinv2;                                             \n\
+    }                                                        \n\
+    data_dst [i] = MUL (d, h);                               \n\
+  }                                                          \n\
+}                                                            \n\
+                                                             \n\
+                                                             \n\
+// the trapezoid weight of the interval [k-1, k] of a slice (starting \n\
+// at j0), from the coordinates x: unit spacing (xmode 0), a vector \n\
+// along the dimension (xmode 1), or of the size of the data (xmode 2) \n\
+TYPE                                                         \n\
+trapz_weight                                                 \n\
+  (const __global TYPE *x,                                   \n\
+   const ulong xmode,                                        \n\
+   const size_t j0,                                          \n\
+   const size_t k,                                           \n\
+   const ulong fac)                                          \n\
+{                                                            \n\
+  if (xmode == 1)                                            \n\
+    return x [k] - x [k-1];                                  \n\
+  else if (xmode == 2)                                       \n\
+    return x [j0 + k*fac] - x [j0 + (k-1)*fac];              \n\
+  return ONE;                                                \n\
+}                                                            \n\
+                                                             \n\
+// trapezoidal integration along a dimension: the work-items of one \n\
+// or more work-groups (group id 0) per slice (group id 1) accumulate \n\
+// the intervals of the slice in grid-stride fashion, followed by a \n\
+// tree reduction in local memory; with ng work-groups per slice, the \n\
+// partial results go to data_dst [i*ng + g], for a second reduction \n\
+__kernel void                                                \n\
+ocl_trapz                                                    \n\
+  (__global TYPE *data_dst,                                  \n\
+   const __global TYPE *data_src,                            \n\
+   const ulong ofs_src,                                      \n\
+   const __global TYPE *x,                                   \n\
+   const ulong ofs_x,                                        \n\
+   const ulong xmode,                                        \n\
+   const ulong len,                                          \n\
+   const ulong fac,                                          \n\
+   __local TYPE *loc_sum)                                    \n\
+{                                                            \n\
+  data_src += ofs_src;                                       \n\
+  x += ofs_x;                                                \n\
+  size_t i = get_group_id (1), j, k;                         \n\
+  size_t g = get_group_id (0), ng = get_num_groups (0);      \n\
+  size_t lid = get_local_id (0), lsize = get_local_size (0); \n\
+  size_t j0 = (i % fac) + (i / fac) * fac * len;             \n\
+  TYPE val = ZERO, w, s;                                     \n\
+  for (k=g*lsize+lid+1; k<len; k+=ng*lsize) {                \n\
+    j = j0 + k * fac;                                        \n\
+    w = trapz_weight (x, xmode, j0, k, fac);                 \n\
+    s = data_src [j-fac] + data_src [j];                     \n\
+    val += MUL (w, s);                                       \n\
+  }                                                          \n\
+  loc_sum [lid] = val;                                       \n\
+  barrier (CLK_LOCAL_MEM_FENCE);                             \n\
+  for (k=lsize/2; k>0; k/=2) {                               \n\
+    if (lid < k)                                             \n\
+      loc_sum [lid] += loc_sum [lid+k];                      \n\
+    barrier (CLK_LOCAL_MEM_FENCE);                           \n\
+  }                                                          \n\
+  if (lid == 0)                                              \n\
+    data_dst [i*ng + g] = loc_sum [0] / 2;                   \n\
+}                                                            \n\
+                                                             \n\
+                                                             \n\
+// cumulative trapezoidal integration along a dimension, a serial \n\
+// scan of one slice per work-item (as in ocl_cumsum)        \n\
+__kernel void                                                \n\
+ocl_cumtrapz                                                 \n\
+  (__global TYPE *data_dst,                                  \n\
+   const __global TYPE *data_src,                            \n\
+   const ulong ofs_src,                                      \n\
+   const __global TYPE *x,                                   \n\
+   const ulong ofs_x,                                        \n\
+   const ulong xmode,                                        \n\
+   const ulong len,                                          \n\
+   const ulong fac)                                          \n\
+{                                                            \n\
+  data_src += ofs_src;                                       \n\
+  x += ofs_x;                                                \n\
   size_t i = get_global_id (0), j, k;                        \n\
-  TYPE m1 = ZERO;                                            \n\
-  TYPE m2 = ZERO;                                            \n\
-  for (k=0; k<len; k++) {                                    \n\
-    j = (i % fac) + k * fac + (i / fac) * fac * len;         \n\
-    m1 += data_src [j];                                      \n\
-    m2 += NORM (data_src [j]);                               \n\
+  size_t j0 = (i % fac) + (i / fac) * fac * len;             \n\
+  TYPE val = ZERO, w, s;                                     \n\
+  data_dst [j0] = val;                                       \n\
+  for (k=1; k<len; k++) {                                    \n\
+    j = j0 + k * fac;                                        \n\
+    w = trapz_weight (x, xmode, j0, k, fac);                 \n\
+    s = data_src [j-fac] + data_src [j];                     \n\
+    val += MUL (w, s) / 2;                                   \n\
+    data_dst [j] = val;                                      \n\
   }                                                          \n\
-  data_dst [i] = sqrt (max ((m2-NORM(m1)/len)/n, ZERO));     \n\
 }                                                            \n\
 #endif                                                       \n\
                                                              \n\
                                                              \n\
+// arg-reductions for max / min: the work-items of one or more \n\
+// work-groups scan a slice in grid-stride fashion, and the  \n\
+// (value, index) pairs are then merged in a local-memory tree; \n\
+// with several work-groups per slice, their partial results \n\
+// (with indices in idx_src) are merged in a second launch.  \n\
+// b replaces a where the serial scan from k = 0 would pick b: \n\
+// NaN values never win, except at k == 0 where the serial scan \n\
+// starts (and keeps it); equal values go to the first occurrence \n\
+                                                             \n\
+#if defined (COMPLEX)                                        \n\
+#define IS_NAN_VAL(z) (any (isnan (z)))                      \n\
+#elif defined (FLOATINGPOINT)                                \n\
+#define IS_NAN_VAL(z) (isnan (z))                            \n\
+#else                                                        \n\
+#define IS_NAN_VAL(z) (0)                                    \n\
+#endif                                                       \n\
+                                                             \n\
+#define DEFARGBETTER(NAME, CMP) \\                           \n\
+  int NAME (TYPE vb, IDX_T kb, TYPE va, IDX_T ka) { \\       \n\
+    if (kb < 0) return 0; \\                                 \n\
+    if (ka < 0) return 1; \\                                 \n\
+    if ((ka == 0) && IS_NAN_VAL (va)) return 0; \\           \n\
+    if ((kb == 0) && IS_NAN_VAL (vb)) return 1; \\           \n\
+    if (IS_NAN_VAL (va)) return 1; \\                        \n\
+    if (IS_NAN_VAL (vb)) return 0; \\                        \n\
+    if (CMP (vb, va)) return 1; \\                           \n\
+    return ((! CMP (va, vb)) && (kb < ka)); \\               \n\
+  }                                                          \n\
+                                                             \n\
+DEFARGBETTER (ARG_BETTER_MAX, IS_GT)                         \n\
+DEFARGBETTER (ARG_BETTER_MIN, IS_LT)                         \n\
+                                                             \n\
+                                                             \n\
 __kernel void                                                \n\
 ocl_max                                                      \n\
   (__global TYPE *data_dst1,                                 \n\
@@ -583,21 +1145,42 @@ ocl_max                                                      \n\
    const __global TYPE *data_src,                            \n\
    const ulong ofs_src,                                      \n\
    const ulong len,                                          \n\
-   const ulong fac)                                          \n\
-{                                                            \n\
-  data_src += ofs_src;                                       \n\
-  size_t i = get_global_id (0), j, k, km;                    \n\
-  TYPE val, v;                                               \n\
-  for (k=0; k<len; k++) {                                    \n\
-    j = (i % fac) + k * fac + (i / fac) * fac * len;         \n\
+   const ulong fac,                                          \n\
+   const __global IDX_T *idx_src,                            \n\
+   __local TYPE *loc_val,                                    \n\
+   __local IDX_T *loc_idx)                                   \n\
+{                                                            \n\
+  int has_idx = ((const __global void *)idx_src != (const __global void *)data_src); \n\
+  data_src += ofs_src;                                       \n\
+  size_t i = get_group_id (1), j, k;                         \n\
+  size_t lid = get_local_id (0), lsize = get_local_size (0); \n\
+  size_t i_dst = i * get_num_groups (0) + get_group_id (0);  \n\
+  size_t j0 = (i % fac) + (i / fac) * fac * len;             \n\
+  TYPE val = ZERO, v;                                        \n\
+  IDX_T km = -1, kv;                                         \n\
+  for (k=get_global_id (0); k<len; k+=get_global_size (0)) { \n\
+    j = j0 + k * fac;                                        \n\
     v = data_src [j];                                        \n\
-    if ((k == 0) || (IS_GT (v, val))) {                      \n\
-      val = v; km = k;                                       \n\
+    kv = has_idx ? idx_src [j] : (IDX_T) (k);                \n\
+    if (ARG_BETTER_MAX (v, kv, val, km)) {                   \n\
+      val = v; km = kv;                                      \n\
+    }                                                        \n\
+  }                                                          \n\
+  loc_val [lid] = val;                                       \n\
+  loc_idx [lid] = km;                                        \n\
+  barrier (CLK_LOCAL_MEM_FENCE);                             \n\
+  for (k=lsize/2; k>0; k/=2) {                               \n\
+    if ((lid < k) && (ARG_BETTER_MAX (loc_val [lid+k], loc_idx [lid+k], loc_val [lid], loc_idx [lid]))) { \n\
+      loc_val [lid] = loc_val [lid+k];                       \n\
+      loc_idx [lid] = loc_idx [lid+k];                       \n\
     }                                                        \n\
+    barrier (CLK_LOCAL_MEM_FENCE);                           \n\
+  }                                                          \n\
+  if (lid == 0) {                                            \n\
+    data_dst1 [i_dst] = loc_val [0];                         \n\
+    if (data_dst2 != (__global IDX_T *)data_dst1)            \n\
+      data_dst2 [i_dst] = loc_idx [0];                       \n\
   }                                                          \n\
-  data_dst1 [i] = val;                                       \n\
-  if (data_dst2 != (__global IDX_T *)data_dst1)              \n\
-    data_dst2 [i] = (IDX_T) (km);                            \n\
 }                                                            \n\
                                                              \n\
                                                              \n\
@@ -607,15 +1190,17 @@ ocl_max2                                                     \n\
    const __global TYPE *data_src1,                           \n\
    const ulong ofs_src1,                                     \n\
    const __global TYPE *data_src2,                           \n\
-   const ulong ofs_src2)                                     \n\
+   const ulong ofs_src2,                                     \n\
+   const ulong n)                                            \n\
 {                                                            \n\
   data_src1 += ofs_src1;                                     \n\
   data_src2 += ofs_src2;                                     \n\
-  size_t i = get_global_id (0);                              \n\
-  TYPE v1, v2;                                               \n\
-  v1 = data_src1 [i];                                        \n\
-  v2 = data_src2 [i];                                        \n\
-  data_dst [i] = IS_GT (v1, v2) ? v1 : v2;                   \n\
+  GRID_LOOP (i, n) {                                         \n\
+    TYPE v1, v2;                                             \n\
+    v1 = data_src1 [i];                                      \n\
+    v2 = data_src2 [i];                                      \n\
+    data_dst [i] = IS_GT (v1, v2) ? v1 : v2;                 \n\
+  }                                                          \n\
 }                                                            \n\
                                                              \n\
                                                              \n\
@@ -624,13 +1209,15 @@ ocl_max1                                                     \n\
   (__global TYPE *data_dst,                                  \n\
    const __global TYPE *data_src,                            \n\
    const ulong ofs_src,                                      \n\
-   const TYPE v2)                                            \n\
+   const TYPE v2,                                            \n\
+   const ulong n)                                            \n\
 {                                                            \n\
   data_src += ofs_src;                                       \n\
-  size_t i = get_global_id (0);                              \n\
-  TYPE v1;                                                   \n\
-  v1 = data_src [i];                                         \n\
-  data_dst [i] = IS_GT (v1, v2) ? v1 : v2;                   \n\
+  GRID_LOOP (i, n) {                                         \n\
+    TYPE v1;                                                 \n\
+    v1 = data_src [i];                                       \n\
+    data_dst [i] = IS_GT (v1, v2) ? v1 : v2;                 \n\
+  }                                                          \n\
 }                                                            \n\
                                                              \n\
                                                              \n\
@@ -641,21 +1228,42 @@ ocl_min                                                      \n\
    const __global TYPE *data_src,                            \n\
    const ulong ofs_src,                                      \n\
    const ulong len,                                          \n\
-   const ulong fac)                                          \n\
-{                                                            \n\
-  data_src += ofs_src;                                       \n\
-  size_t i = get_global_id (0), j, k, km;                    \n\
-  TYPE val, v;                                               \n\
-  for (k=0; k<len; k++) {                                    \n\
-    j = (i % fac) + k * fac + (i / fac) * fac * len;         \n\
+   const ulong fac,                                          \n\
+   const __global IDX_T *idx_src,                            \n\
+   __local TYPE *loc_val,                                    \n\
+   __local IDX_T *loc_idx)                                   \n\
+{                                                            \n\
+  int has_idx = ((const __global void *)idx_src != (const __global void *)data_src); \n\
+  data_src += ofs_src;                                       \n\
+  size_t i = get_group_id (1), j, k;                         \n\
+  size_t lid = get_local_id (0), lsize = get_local_size (0); \n\
+  size_t i_dst = i * get_num_groups (0) + get_group_id (0);  \n\
+  size_t j0 = (i % fac) + (i / fac) * fac * len;             \n\
+  TYPE val = ZERO, v;                                        \n\
+  IDX_T km = -1, kv;                                         \n\
+  for (k=get_global_id (0); k<len; k+=get_global_size (0)) { \n\
+    j = j0 + k * fac;                                        \n\
     v = data_src [j];                                        \n\
-    if ((k == 0) || (IS_LT (v, val))) {                      \n\
-      val = v; km = k;                                       \n\
+    kv = has_idx ? idx_src [j] : (IDX_T) (k);                \n\
+    if (ARG_BETTER_MIN (v, kv, val, km)) {                   \n\
+      val = v; km = kv;                                      \n\
+    }                                                        \n\
+  }                                                          \n\
+  loc_val [lid] = val;                                       \n\
+  loc_idx [lid] = km;                                        \n\
+  barrier (CLK_LOCAL_MEM_FENCE);                             \n\
+  for (k=lsize/2; k>0; k/=2) {                               \n\
+    if ((lid < k) && (ARG_BETTER_MIN (loc_val [lid+k], loc_idx [lid+k], loc_val [lid], loc_idx [lid]))) { \n\
+      loc_val [lid] = loc_val [lid+k];                       \n\
+      loc_idx [lid] = loc_idx [lid+k];                       \n\
     }                                                        \n\
+    barrier (CLK_LOCAL_MEM_FENCE);                           \n\
+  }                                                          \n\
+  if (lid == 0) {                                            \n\
+    data_dst1 [i_dst] = loc_val [0];                         \n\
+    if (data_dst2 != (__global IDX_T *)data_dst1)            \n\
+      data_dst2 [i_dst] = loc_idx [0];                       \n\
   }                                                          \n\
-  data_dst1 [i] = val;                                       \n\
-  if (data_dst2 != (__global IDX_T *)data_dst1)              \n\
-    data_dst2 [i] = (IDX_T) (km);                            \n\
 }                                                            \n\
                                                              \n\
                                                              \n\
@@ -665,15 +1273,17 @@ ocl_min2                                                     \n\
    const __global TYPE *data_src1,                           \n\
    const ulong ofs_src1,                                     \n\
    const __global TYPE *data_src2,                           \n\
-   const ulong ofs_src2)                                     \n\
+   const ulong ofs_src2,                                     \n\
+   const ulong n)                                            \n\
 {                                                            \n\
   data_src1 += ofs_src1;                                     \n\
   data_src2 += ofs_src2;                                     \n\
-  size_t i = get_global_id (0);                              \n\
-  TYPE v1, v2;                                               \n\
-  v1 = data_src1 [i];                                        \n\
-  v2 = data_src2 [i];                                        \n\
-  data_dst [i] = IS_LT (v1, v2) ? v1 : v2;                   \n\
+  GRID_LOOP (i, n) {                                         \n\
+    TYPE v1, v2;                                             \n\
+    v1 = data_src1 [i];                                      \n\
+    v2 = data_src2 [i];                                      \n\
+    data_dst [i] = IS_LT (v1, v2) ? v1 : v2;                 \n\
+  }                                                          \n\
 }                                                            \n\
                                                              \n\
                                                              \n\
@@ -682,13 +1292,15 @@ ocl_min1                                                     \n\
   (__global TYPE *data_dst,                                  \n\
    const __global TYPE *data_src,                            \n\
    const ulong ofs_src,                                      \n\
-   const TYPE v2)                                            \n\
+   const TYPE v2,                                            \n\
+   const ulong n)                                            \n\
 {                                                            \n\
   data_src += ofs_src;                                       \n\
-  size_t i = get_global_id (0);                              \n\
-  TYPE v1;                                                   \n\
-  v1 = data_src [i];                                         \n\
-  data_dst [i] = IS_LT (v1, v2) ? v1 : v2;                   \n\
+  GRID_LOOP (i, n) {                                         \n\
+    TYPE v1;                                                 \n\
+    v1 = data_src [i];                                       \n\
+    data_dst [i] = IS_LT (v1, v2) ? v1 : v2;                 \n\
+  }                                                          \n\
 }                                                            \n\
                                                              \n\
                                                              \n\
@@ -750,27 +1362,46 @@ ocl_compare                                                  \n\
    const __global TYPE *data_src2,                           \n\
    const ulong ofs_src2,                                     \n\
    const TYPE c,                                             \n\
-   const ulong fcn)                                          \n\
+   const ulong fcn,                                          \n\
+   const ulong n)                                            \n\
 {                                                            \n\
   data_src1 += ofs_src1;                                     \n\
   data_src2 += ofs_src2;                                     \n\
-  size_t i = get_global_id (0);                              \n\
-  TYPE o1, o2;                                               \n\
-  switch (fcn & 0xF) {                                       \n\
-    case 0: o1 = data_src1 [i]; o2 = c; break;               \n\
-    case 1: o1 = c; o2 = data_src1 [i]; break;               \n\
-    case 2: o1 = data_src1 [i]; o2 = data_src2 [i]; break;   \n\
+  VTYPE v1, v2, vres;                                        \n\
+  VEC_LOOP (i, n) {                                          \n\
+    switch (fcn & 0xF) {                                     \n\
+      case 0: v1 = VLOAD (i, data_src1); v2 = (VTYPE) (c); break; \n\
+      case 1: v1 = (VTYPE) (c); v2 = VLOAD (i, data_src1); break; \n\
+      case 2: v1 = VLOAD (i, data_src1); v2 = VLOAD (i, data_src2); break; \n\
+    }                                                        \n\
+    switch (fcn >> 4) {                                      \n\
+      case 0: vres = VBOOL (V_LT (v1, v2)); break;           \n\
+      case 1: vres = VBOOL (V_LE (v1, v2)); break;           \n\
+      case 2: vres = VBOOL (V_GT (v1, v2)); break;           \n\
+      case 3: vres = VBOOL (V_GE (v1, v2)); break;           \n\
+      case 4: vres = VBOOL (V_EQ (v1, v2)); break;           \n\
+      case 5: vres = VBOOL (V_NE (v1, v2)); break;           \n\
+    }                                                        \n\
+    VSTORE (vres, i, data_dst);                              \n\
   }                                                          \n\
-  int res;                                                   \n\
-  switch (fcn >> 4) {                                        \n\
-    case 0: res = IS_LT (o1, o2); break;                     \n\
-    case 1: res = IS_LE (o1, o2); break;                     \n\
-    case 2: res = IS_GT (o1, o2); break;                     \n\
-    case 3: res = IS_GE (o1, o2); break;                     \n\
-    case 4: res = IS_EQ (o1, o2); break;                     \n\
-    case 5: res = IS_NE (o1, o2); break;                     \n\
+  TAIL_LOOP (i, n) {                                         \n\
+    TYPE o1, o2;                                             \n\
+    switch (fcn & 0xF) {                                     \n\
+      case 0: o1 = data_src1 [i]; o2 = c; break;             \n\
+      case 1: o1 = c; o2 = data_src1 [i]; break;             \n\
+      case 2: o1 = data_src1 [i]; o2 = data_src2 [i]; break; \n\
+    }                                                        \n\
+    int res;                                                 \n\
+    switch (fcn >> 4) {                                      \n\
+      case 0: res = IS_LT (o1, o2); break;                   \n\
+      case 1: res = IS_LE (o1, o2); break;                   \n\
+      case 2: res = IS_GT (o1, o2); break;                   \n\
+      case 3: res = IS_GE (o1, o2); break;                   \n\
+      case 4: res = IS_EQ (o1, o2); break;                   \n\
+      case 5: res = IS_NE (o1, o2); break;                   \n\
+    }                                                        \n\
+    data_dst [i] = res ? ONE : ZERO;                         \n\
   }                                                          \n\
-  data_dst [i] = res ? ONE : ZERO;                           \n\
 }                                                            \n\
                                                              \n\
                                                              \n\
@@ -782,33 +1413,35 @@ ocl_logic                                                    \n\
    const __global TYPE *data_src2,                           \n\
    const ulong ofs_src2,                                     \n\
    const TYPE c,                                             \n\
-   const ulong fcn)                                          \n\
+   const ulong fcn,                                          \n\
+   const ulong n)                                            \n\
 {                                                            \n\
   data_src1 += ofs_src1;                                     \n\
   data_src2 += ofs_src2;                                     \n\
-  size_t i = get_global_id (0);                              \n\
-  int o1, o2;                                                \n\
-  switch (fcn & 0xF) {                                       \n\
-    case 0:                                                  \n\
-      o1 = IS_NONZERO (data_src1 [i]);                       \n\
-      o2 = IS_NONZERO (c);                                   \n\
-      break;                                                 \n\
-    case 1:                                                  \n\
-      o1 = IS_NONZERO (c);                                   \n\
-      o2 = IS_NONZERO (data_src1 [i]);                       \n\
-      break;                                                 \n\
-    case 2:                                                  \n\
-      o1 = IS_NONZERO (data_src1 [i]);                       \n\
-      o2 = IS_NONZERO (data_src2 [i]);                       \n\
-      break;                                                 \n\
-  }                                                          \n\
-  int res;                                                   \n\
-  switch (fcn >> 4) {                                        \n\
-    case 0: res = (o1 && o2); break;                         \n\
-    case 1: res = (o1 || o2); break;                         \n\
-    case 2: res = (!o1); break;                              \n\
+  GRID_LOOP (i, n) {                                         \n\
+    int o1, o2;                                              \n\
+    switch (fcn & 0xF) {                                     \n\
+      case 0:                                                \n\
+        o1 = IS_NONZERO (data_src1 [i]);                     \n\
+        o2 = IS_NONZERO (c);                                 \n\
+        break;                                               \n\
+      case 1:                                                \n\
+        o1 = IS_NONZERO (c);                                 \n\
+        o2 = IS_NONZERO (data_src1 [i]);                     \n\
+        break;                                               \n\
+      case 2:                                                \n\
+        o1 = IS_NONZERO (data_src1 [i]);                     \n\
+        o2 = IS_NONZERO (data_src2 [i]);                     \n\
+        break;                                               \n\
+    }                                                        \n\
+    int res;                                                 \n\
+    switch (fcn >> 4) {                                      \n\
+      case 0: res = (o1 && o2); break;                       \n\
+      case 1: res = (o1 || o2); break;                       \n\
+      case 2: res = (!o1); break;                            \n\
+    }                                                        \n\
+    data_dst [i] = res ? ONE : ZERO;                         \n\
   }                                                          \n\
-  data_dst [i] = res ? ONE : ZERO;                           \n\
 }                                                            \n\
                                                              \n\
                                                              \n\
@@ -850,11 +1483,14 @@ __kernel void                                                \n\
 ocl_uminus                                                   \n\
   (__global TYPE *data_dst,                                  \n\
    const __global TYPE *data_src,                            \n\
-   const ulong ofs_src)                                      \n\
+   const ulong ofs_src,                                      \n\
+   const ulong n)                                            \n\
 {                                                            \n\
   data_src += ofs_src;                                       \n\
-  size_t i = get_global_id (0);                              \n\
-  data_dst [i] = -data_src [i];                              \n\
+  VEC_LOOP (i, n)                                            \n\
+    VSTORE (-VLOAD (i, data_src), i, data_dst);              \n\
+  TAIL_LOOP (i, n)                                           \n\
+    data_dst [i] = -data_src [i];                            \n\
 }                                                            \n\
                                                              \n\
                                                              \n\
@@ -863,11 +1499,14 @@ ocl_add1                                                     \n\
   (__global TYPE *data_dst,                                  \n\
    const __global TYPE *data_src,                            \n\
    const ulong ofs_src,                                      \n\
-   const TYPE summand)                                       \n\
+   const TYPE summand,                                       \n\
+   const ulong n)                                            \n\
 {                                                            \n\
   data_src += ofs_src;                                       \n\
-  size_t i = get_global_id (0);                              \n\
-  data_dst [i] = data_src [i] + summand;                     \n\
+  VEC_LOOP (i, n)                                            \n\
+    VSTORE (VLOAD (i, data_src) + summand, i, data_dst);     \n\
+  TAIL_LOOP (i, n)                                           \n\
+    data_dst [i] = data_src [i] + summand;                   \n\
 }                                                            \n\
                                                              \n\
                                                              \n\
@@ -877,12 +1516,15 @@ ocl_add2                                                     \n\
    const __global TYPE *data_src1,                           \n\
    const ulong ofs_src1,                                     \n\
    const __global TYPE *data_src2,                           \n\
-   const ulong ofs_src2)                                     \n\
+   const ulong ofs_src2,                                     \n\
+   const ulong n)                                            \n\
 {                                                            \n\
   data_src1 += ofs_src1;                                     \n\
   data_src2 += ofs_src2;                                     \n\
-  size_t i = get_global_id (0);                              \n\
-  data_dst [i] = data_src1 [i] + data_src2 [i];              \n\
+  VEC_LOOP (i, n)                                            \n\
+    VSTORE (VLOAD (i, data_src1) + VLOAD (i, data_src2), i, data_dst); \n\
+  TAIL_LOOP (i, n)                                           \n\
+    data_dst [i] = data_src1 [i] + data_src2 [i];            \n\
 }                                                            \n\
                                                              \n\
                                                              \n\
@@ -891,11 +1533,14 @@ ocl_sub1m                                                    \n\
   (__global TYPE *data_dst,                                  \n\
    const __global TYPE *data_src,                            \n\
    const ulong ofs_src,                                      \n\
-   const TYPE minuend)                                       \n\
+   const TYPE minuend,                                       \n\
+   const ulong n)                                            \n\
 {                                                            \n\
   data_src += ofs_src;                                       \n\
-  size_t i = get_global_id (0);                              \n\
-  data_dst [i] = minuend - data_src [i];                     \n\
+  VEC_LOOP (i, n)                                            \n\
+    VSTORE (minuend - VLOAD (i, data_src), i, data_dst);     \n\
+  TAIL_LOOP (i, n)                                           \n\
+    data_dst [i] = minuend - data_src [i];                   \n\
 }                                                            \n\
                                                              \n\
                                                              \n\
@@ -904,11 +1549,14 @@ ocl_sub1s                                                    \n\
   (__global TYPE *data_dst,                                  \n\
    const __global TYPE *data_src,                            \n\
    const ulong ofs_src,                                      \n\
-   const TYPE subtrahend)                                    \n\
+   const TYPE subtrahend,                                    \n\
+   const ulong n)                                            \n\
 {                                                            \n\
   data_src += ofs_src;                                       \n\
-  size_t i = get_global_id (0);                              \n\
-  data_dst [i] = data_src [i] - subtrahend;                  \n\
+  VEC_LOOP (i, n)                                            \n\
+    VSTORE (VLOAD (i, data_src) - subtrahend, i, data_dst);  \n\
+  TAIL_LOOP (i, n)                                           \n\
+    data_dst [i] = data_src [i] - subtrahend;                \n\
 }                                                            \n\
                                                              \n\
                                                              \n\
@@ -918,12 +1566,15 @@ ocl_sub2                                                     \n\
    const __global TYPE *data_src1,                           \n\
    const ulong ofs_src1,                                     \n\
    const __global TYPE *data_src2,                           \n\
-   const ulong ofs_src2)                                     \n\
+   const ulong ofs_src2,                                     \n\
+   const ulong n)                                            \n\
 {                                                            \n\
   data_src1 += ofs_src1;                                     \n\
   data_src2 += ofs_src2;                                     \n\
-  size_t i = get_global_id (0);                              \n\
-  data_dst [i] = data_src1 [i] - data_src2 [i];              \n\
+  VEC_LOOP (i, n)                                            \n\
+    VSTORE (VLOAD (i, data_src1) - VLOAD (i, data_src2), i, data_dst); \n\
+  TAIL_LOOP (i, n)                                           \n\
+    data_dst [i] = data_src1 [i] - data_src2 [i];            \n\
 }                                                            \n\
                                                              \n\
                                                              \n\
@@ -932,72 +1583,1390 @@ ocl_mul1                                                     \n\
   (__global TYPE *data_dst,                                  \n\
    const __global TYPE *data_src,                            \n\
    const ulong ofs_src,                                      \n\
-   const TYPE factor)                                        \n\
+   const TYPE factor,                                        \n\
+   const ulong n)                                            \n\
 {                                                            \n\
   data_src += ofs_src;                                       \n\
-  size_t i = get_global_id (0);                              \n\
-  TYPE val;                                                  \n\
-  val = data_src [i];                                        \n\
-  data_dst [i] = MUL (val, factor);                          \n\
+  VEC_LOOP (i, n) {                                          \n\
+    VTYPE val;                                               \n\
+    val = VLOAD (i, data_src);                               \n\
+    VSTORE (MUL (val, factor), i, data_dst);                 \n\
+  }                                                          \n\
+  TAIL_LOOP (i, n) {                                         \n\
+    TYPE val;                                                \n\
+    val = data_src [i];                                      \n\
+    data_dst [i] = MUL (val, factor);                        \n\
+  }                                                          \n\
+}                                                            \n\
+                                                             \n\
+                                                             \n\
+__kernel void                                                \n\
+ocl_mul2                                                     \n\
+  (__global TYPE *data_dst,                                  \n\
+   const __global TYPE *data_src1,                           \n\
+   const ulong ofs_src1,                                     \n\
+   const __global TYPE *data_src2,                           \n\
+   const ulong ofs_src2,                                     \n\
+   const ulong n)                                            \n\
+{                                                            \n\
+  data_src1 += ofs_src1;                                     \n\
+  data_src2 += ofs_src2;                                     \n\
+  VEC_LOOP (i, n) {                                          \n\
+    VTYPE v1, v2;                                            \n\
+    v1 = VLOAD (i, data_src1);                               \n\
+    v2 = VLOAD (i, data_src2);                               \n\
+    VSTORE (MUL (v1, v2), i, data_dst);                      \n\
+  }                                                          \n\
+  TAIL_LOOP (i, n) {                                         \n\
+    TYPE v1, v2;                                             \n\
+    v1 = data_src1 [i];                                      \n\
+    v2 = data_src2 [i];                                      \n\
+    data_dst [i] = MUL (v1, v2);                             \n\
+  }                                                          \n\
+}                                                            \n\
+                                                             \n\
+                                                             \n\
+// matrix multiply: data_dst (s1 x s2) = op1 (src1) * op2 (src2) \n\
+// with inner dimension len; op is selected by trans1 / trans2 as \n\
+// 0 (none), 1 (transpose) or 2 (conjugate transpose)        \n\
+__kernel void                                                \n\
+ocl_mtimes                                                   \n\
+  (__global TYPE *data_dst,                                  \n\
+   const __global TYPE *data_src1,                           \n\
+   const ulong ofs_src1,                                     \n\
+   const __global TYPE *data_src2,                           \n\
+   const ulong ofs_src2,                                     \n\
+   const ulong s1,                                           \n\
+   const ulong len,                                          \n\
+   const ulong s2,                                           \n\
+   const ulong trans1,                                       \n\
+   const ulong trans2)                                       \n\
+{                                                            \n\
+  data_src1 += ofs_src1;                                     \n\
+  data_src2 += ofs_src2;                                     \n\
+  size_t i = get_global_id (0), j1, j2, k;                   \n\
+  size_t r = i % s1, c = i / s1;                             \n\
+  size_t stride1 = (trans1 == 0) ? s1 : 1;                   \n\
+  size_t stride2 = (trans2 == 0) ? 1 : s2;                   \n\
+  TYPE val = ZERO;                                           \n\
+  TYPE v1, v2;                                               \n\
+  j1 = (trans1 == 0) ? r : r * len;                          \n\
+  j2 = (trans2 == 0) ? c * len : c;                          \n\
+  for (k=0; k<len; k++) {                                    \n\
+    v1 = data_src1 [j1 + k * stride1];                       \n\
+    v2 = data_src2 [j2 + k * stride2];                       \n\
+    if (trans1 == 2)                                         \n\
+      v1 = CONJ (v1);                                        \n\
+    if (trans2 == 2)                                         \n\
+      v2 = CONJ (v2);                                        \n\
+    val += MUL (v1, v2);                                     \n\
+  }                                                          \n\
+  data_dst [i] = val;                                        \n\
+}                                                            \n\
+                                                             \n\
+                                                             \n\
+// symmetric / hermitian rank-k product data_dst (n x n):    \n\
+// trans == 1 gives op (src) * src with src (len x n), and   \n\
+// trans == 0 gives src * op (src) with src (n x len), where op is \n\
+// the (conjugate, with fcn == 2) transpose; only the upper half \n\
+// is computed (2-D NDRange), and mirrored to the lower half \n\
+__kernel void                                                \n\
+ocl_syrk                                                     \n\
+  (__global TYPE *data_dst,                                  \n\
+   const __global TYPE *data_src,                            \n\
+   const ulong ofs_src,                                      \n\
+   const ulong n,                                            \n\
+   const ulong len,                                          \n\
+   const ulong trans,                                        \n\
+   const ulong fcn)                                          \n\
+{                                                            \n\
+  data_src += ofs_src;                                       \n\
+  size_t r = get_global_id (0), c = get_global_id (1), k;    \n\
+  size_t stride = (trans == 1) ? 1 : n;                      \n\
+  size_t jr = (trans == 1) ? r * len : r;                    \n\
+  size_t jc = (trans == 1) ? c * len : c;                    \n\
+  TYPE val = ZERO;                                           \n\
+  TYPE v1, v2;                                               \n\
+  if (r > c)                                                 \n\
+    return;                                                  \n\
+  for (k=0; k<len; k++) {                                    \n\
+    v1 = data_src [jr + k * stride];                         \n\
+    v2 = data_src [jc + k * stride];                         \n\
+    if (fcn == 2) {                                          \n\
+      if (trans == 1)                                        \n\
+        v1 = CONJ (v1);                                      \n\
+      else                                                   \n\
+        v2 = CONJ (v2);                                      \n\
+    }                                                        \n\
+    val += MUL (v1, v2);                                     \n\
+  }                                                          \n\
+  data_dst [r + c * n] = val;                                \n\
+  if (r != c)                                                \n\
+    data_dst [c + r * n] = (fcn == 2) ? CONJ (val) : val;    \n\
+}                                                            \n\
+                                                             \n\
+                                                             \n\
+// dense linear algebra: blocked LU and Cholesky factorizations and \n\
+// triangular solves, with the trailing updates as ocl_mtimes products \n\
+// of (copied) blocks; a block is addressed by an offset and the \n\
+// leading dimension ld (the number of rows) of its matrix   \n\
+                                                             \n\
+// copy the m x n block src into the block dst (fcn == 0), or \n\
+// subtract it from dst (fcn == 1)                           \n\
+__kernel void                                                \n\
+ocl_copy_block                                               \n\
+  (__global TYPE *data_dst,                                  \n\
+   const ulong ofs_dst,                                      \n\
+   const ulong ld_dst,                                       \n\
+   const __global TYPE *data_src,                            \n\
+   const ulong ofs_src,                                      \n\
+   const ulong ld_src,                                       \n\
+   const ulong m,                                            \n\
+   const ulong n,                                            \n\
+   const ulong fcn)                                          \n\
+{                                                            \n\
+  data_dst += ofs_dst;                                       \n\
+  data_src += ofs_src;                                       \n\
+  GRID_LOOP (i, m * n) {                                     \n\
+    size_t r = i % m, c = i / m;                             \n\
+    if (fcn == 1)                                            \n\
+      data_dst [r + c * ld_dst] -= data_src [r + c * ld_src]; \n\
+    else                                                     \n\
+      data_dst [r + c * ld_dst] = data_src [r + c * ld_src]; \n\
+  }                                                          \n\
+}                                                            \n\
+                                                             \n\
+                                                             \n\
+// triangular part of the nr x nc matrix src: the elements on and \n\
+// above the k-th diagonal (fcn == 0), or on and below it (fcn == 1); \n\
+// fcn == 2 is as fcn == 1, with ones on the k-th diagonal   \n\
+__kernel void                                                \n\
+ocl_tri                                                      \n\
+  (__global TYPE *data_dst,                                  \n\
+   const __global TYPE *data_src,                            \n\
+   const ulong ofs_src,                                      \n\
+   const ulong nr,                                           \n\
+   const ulong nc,                                           \n\
+   const long k,                                             \n\
+   const ulong fcn)                                          \n\
+{                                                            \n\
+  data_src += ofs_src;                                       \n\
+  GRID_LOOP (i, nr * nc) {                                   \n\
+    long d = (long) (i / nr) - (long) (i % nr);              \n\
+    TYPE val = data_src [i];                                 \n\
+    if (fcn == 0) {                                          \n\
+      if (d < k)                                             \n\
+        val = ZERO;                                          \n\
+    } else if (d > k)                                        \n\
+      val = ZERO;                                            \n\
+    else if ((fcn == 2) && (d == k))                         \n\
+      val = ONE;                                             \n\
+    data_dst [i] = val;                                      \n\
+  }                                                          \n\
+}                                                            \n\
+                                                             \n\
+                                                             \n\
+#if defined (FLOATINGPOINT) || defined (COMPLEX)             \n\
+                                                             \n\
+// LU factorization with partial pivoting of the panel of columns k0 \n\
+// to k0+nb-1 (rows k0 to m-1) of a matrix with m rows, in place, by \n\
+// a single work-group: the pivot row of row j goes to ipiv [j] (the \n\
+// rows being swapped within the panel only), the first zero pivot \n\
+// (row j, as j+1) to info [0]                               \n\
+__kernel void                                                \n\
+ocl_lu_panel                                                 \n\
+  (__global TYPE *data,                                      \n\
+   const ulong ofs,                                          \n\
+   const ulong m,                                            \n\
+   const ulong k0,                                           \n\
+   const ulong nb,                                           \n\
+   __global IDX_T *ipiv,                                     \n\
+   __global IDX_T *info,                                     \n\
+   __local RTYPE *loc_val,                                   \n\
+   __local IDX_T *loc_idx)                                   \n\
+{                                                            \n\
+  data += ofs;                                               \n\
+  size_t lid = get_local_id (0), lsize = get_local_size (0); \n\
+  size_t j, k, r, c, t, p, mr, nc;                           \n\
+  RTYPE best, v;                                             \n\
+  IDX_T bi;                                                  \n\
+  TYPE x, y, piv;                                            \n\
+  for (j=k0; j<k0+nb; j++) {                                 \n\
+    best = -1;                                               \n\
+    bi = -1;                                                 \n\
+    for (r=j+lid; r<m; r+=lsize) {                           \n\
+      x = data [r + j * m];                                  \n\
+      v = ABS2 (x);                                          \n\
+      if (v > best) {                                        \n\
+        best = v;                                            \n\
+        bi = r;                                              \n\
+      }                                                      \n\
+    }                                                        \n\
+    loc_val [lid] = best;                                    \n\
+    loc_idx [lid] = bi;                                      \n\
+    barrier (CLK_LOCAL_MEM_FENCE);                           \n\
+    for (k=lsize/2; k>0; k/=2) {                             \n\
+      if ((lid < k) && (loc_idx [lid+k] >= 0) &&             \n\
+          ((loc_idx [lid] < 0) || (loc_val [lid+k] > loc_val [lid]) || \n\
+           ((loc_val [lid+k] == loc_val [lid]) && (loc_idx [lid+k] < loc_idx [lid])))) { \n\
+        loc_val [lid] = loc_val [lid+k];                     \n\
+        loc_idx [lid] = loc_idx [lid+k];                     \n\
+      }                                                      \n\
+      barrier (CLK_LOCAL_MEM_FENCE);                         \n\
+    }                                                        \n\
+    p = (loc_idx [0] < 0) ? j : loc_idx [0];                 \n\
+    best = loc_val [0];                                      \n\
+    barrier (CLK_LOCAL_MEM_FENCE);                           \n\
+    if (lid == 0) {                                          \n\
+      ipiv [j] = p;                                          \n\
+      if ((! (best > 0)) && (info [0] == 0))                 \n\
+        info [0] = j + 1;                                    \n\
+    }                                                        \n\
+    if (p != j)                                              \n\
+      for (c=k0+lid; c<k0+nb; c+=lsize) {                    \n\
+        x = data [j + c * m];                                \n\
+        data [j + c * m] = data [p + c * m];                 \n\
+        data [p + c * m] = x;                                \n\
+      }                                                      \n\
+    barrier (CLK_GLOBAL_MEM_FENCE);                          \n\
+    if (best > 0) {                                          \n\
+      piv = data [j + j * m];                                \n\
+      for (r=j+1+lid; r<m; r+=lsize) {                       \n\
+        x = data [r + j * m];                                \n\
+        data [r + j * m] = DIV (x, piv);                     \n\
+      }                                                      \n\
+    }                                                        \n\
+    barrier (CLK_GLOBAL_MEM_FENCE);                          \n\
+    mr = m - j - 1;                                          \n\
+    nc = k0 + nb - j - 1;                                    \n\
+    for (t=lid; t<mr*nc; t+=lsize) {                         \n\
+      r = j + 1 + t % mr;                                    \n\
+      c = j + 1 + t / mr;                                    \n\
+      x = data [r + j * m];                                  \n\
+      y = data [j + c * m];                                  \n\
+      data [r + c * m] -= MUL (x, y);                        \n\
+    }                                                        \n\
+    barrier (CLK_GLOBAL_MEM_FENCE);                          \n\
+  }                                                          \n\
+}                                                            \n\
+                                                             \n\
+                                                             \n\
+// row interchanges of the LU factorization: the swaps of rows j and \n\
+// ipiv [j], for j = k0 to k1-1 in turn, applied to the columns of an \n\
+// n-column matrix with ld rows but the columns skip0 to skip1-1 (the \n\
+// panel); one work-item per column                          \n\
+__kernel void                                                \n\
+ocl_lu_swap                                                  \n\
+  (__global TYPE *data,                                      \n\
+   const ulong ofs,                                          \n\
+   const ulong ld,                                           \n\
+   const ulong n,                                            \n\
+   const __global IDX_T *ipiv,                               \n\
+   const ulong k0,                                           \n\
+   const ulong k1,                                           \n\
+   const ulong skip0,                                        \n\
+   const ulong skip1)                                        \n\
+{                                                            \n\
+  size_t c = get_global_id (0), j, p;                        \n\
+  TYPE x;                                                    \n\
+  if ((c >= n) || ((c >= skip0) && (c < skip1)))             \n\
+    return;                                                  \n\
+  data += ofs + c * ld;                                      \n\
+  for (j=k0; j<k1; j++) {                                    \n\
+    p = ipiv [j];                                            \n\
+    if (p != j) {                                            \n\
+      x = data [j];                                          \n\
+      data [j] = data [p];                                   \n\
+      data [p] = x;                                          \n\
+    }                                                        \n\
+  }                                                          \n\
+}                                                            \n\
+                                                             \n\
+                                                             \n\
+// Cholesky factorization R' * R of the n x n diagonal block at ofs of \n\
+// a matrix with ld rows (its upper triangle), in place, by a single \n\
+// work-group; a non-positive pivot in row j stops it, with k0+j+1 in \n\
+// info [0] (k0 being the row of the block in its matrix), and the \n\
+// blocks after such a failure are skipped                   \n\
+__kernel void                                                \n\
+ocl_chol_block                                               \n\
+  (__global TYPE *data,                                      \n\
+   const ulong ofs,                                          \n\
+   const ulong ld,                                           \n\
+   const ulong n,                                            \n\
+   const ulong k0,                                           \n\
+   __global IDX_T *info)                                     \n\
+{                                                            \n\
+  data += ofs;                                               \n\
+  size_t lid = get_local_id (0), lsize = get_local_size (0); \n\
+  size_t j, r, c, t, nr;                                     \n\
+  RTYPE d;                                                   \n\
+  TYPE x, y;                                                 \n\
+  if (info [0] != 0)                                         \n\
+    return;                                                  \n\
+  for (j=0; j<n; j++) {                                      \n\
+    x = data [j + j * ld];                                   \n\
+#if defined (COMPLEX)                                        \n\
+    d = x.x;                                                 \n\
+#else                                                        \n\
+    d = x;                                                   \n\
+#endif                                                       \n\
+    if (! (d > 0)) {                                         \n\
+      if (lid == 0)                                          \n\
+        info [0] = k0 + j + 1;                               \n\
+      return;                                                \n\
+    }                                                        \n\
+    d = sqrt (d);                                            \n\
+    barrier (CLK_GLOBAL_MEM_FENCE);                          \n\
+    if (lid == 0)                                            \n\
+      data [j + j * ld] = FROM_REAL (d);                     \n\
+    for (c=j+1+lid; c<n; c+=lsize)                           \n\
+      data [j + c * ld] /= d;                                \n\
+    barrier (CLK_GLOBAL_MEM_FENCE);                          \n\
+    nr = n - j - 1;                                          \n\
+    for (t=lid; t<nr*nr; t+=lsize) {                         \n\
+      r = j + 1 + t % nr;                                    \n\
+      c = j + 1 + t / nr;                                    \n\
+      if (r <= c) {                                          \n\
+        x = CONJ (data [j + r * ld]);                        \n\
+        y = data [j + c * ld];                               \n\
+        data [r + c * ld] -= MUL (x, y);                     \n\
+      }                                                      \n\
+    }                                                        \n\
+    barrier (CLK_GLOBAL_MEM_FENCE);                          \n\
+  }                                                          \n\
+}                                                            \n\
+                                                             \n\
+                                                             \n\
+// element (r, c) of op (A), op as in ocl_mtimes             \n\
+TYPE                                                         \n\
+trsm_elem                                                    \n\
+  (const __global TYPE *data,                                \n\
+   const ulong ld,                                           \n\
+   const size_t r,                                           \n\
+   const size_t c,                                           \n\
+   const ulong trans)                                        \n\
+{                                                            \n\
+  if (trans == 0)                                            \n\
+    return data [r + c * ld];                                \n\
+  else if (trans == 1)                                       \n\
+    return data [c + r * ld];                                \n\
+  return CONJ (data [c + r * ld]);                           \n\
+}                                                            \n\
+                                                             \n\
+// triangular solve op (A) X = B for the n x n block A (upper or lower \n\
+// triangular, with a unit diagonal for unit == 1) in place of the \n\
+// n x m block B, op as in ocl_mtimes; one work-item per column of B \n\
+__kernel void                                                \n\
+ocl_trsm_block                                               \n\
+  (const __global TYPE *data_a,                              \n\
+   const ulong ofs_a,                                        \n\
+   const ulong ld_a,                                         \n\
+   __global TYPE *data_b,                                    \n\
+   const ulong ofs_b,                                        \n\
+   const ulong ld_b,                                         \n\
+   const ulong n,                                            \n\
+   const ulong m,                                            \n\
+   const ulong upper,                                        \n\
+   const ulong trans,                                        \n\
+   const ulong unit)                                         \n\
+{                                                            \n\
+  size_t c = get_global_id (0), i, k, r;                     \n\
+  int forward = ((upper != 0) == (trans != 0));              \n\
+  TYPE val, v, w;                                            \n\
+  if (c >= m)                                                \n\
+    return;                                                  \n\
+  data_a += ofs_a;                                           \n\
+  data_b += ofs_b + c * ld_b;                                \n\
+  for (k=0; k<n; k++) {                                      \n\
+    r = forward ? k : n - 1 - k;                             \n\
+    val = data_b [r];                                        \n\
+    for (i=(forward ? 0 : r+1); i<(forward ? r : n); i++) {  \n\
+      w = trsm_elem (data_a, ld_a, r, i, trans);             \n\
+      v = data_b [i];                                        \n\
+      val -= MUL (w, v);                                     \n\
+    }                                                        \n\
+    if (unit == 0) {                                         \n\
+      w = trsm_elem (data_a, ld_a, r, r, trans);             \n\
+      val = DIV (val, w);                                    \n\
+    }                                                        \n\
+    data_b [r] = val;                                        \n\
+  }                                                          \n\
+}                                                            \n\
+#endif                                                       \n\
+                                                             \n\
+                                                             \n\
+// ---------- histograms and accumarray (scatter reductions) \n\
+                                                             \n\
+                                                             \n\
+// one compare-exchange step (j, k) of a bitonic sort of n_keys (a power \n\
+// of two) keys: each of the n_keys/2 work-items orders the pair (i, i+j), \n\
+// reordering the permutation perm along with the keys if use_perm \n\
+__kernel void                                                \n\
+ocl_bitonic_step                                             \n\
+  (__global IDX_T *keys,                                     \n\
+   __global IDX_T *perm,                                     \n\
+   const ulong use_perm,                                     \n\
+   const ulong j,                                            \n\
+   const ulong k)                                            \n\
+{                                                            \n\
+  size_t t = get_global_id (0);                              \n\
+  size_t i = 2*j*(t/j) + (t%j), l = i + j;                   \n\
+  IDX_T a = keys [i], b = keys [l], p;                       \n\
+  if ((a != b) && ((a > b) == ((i & k) == 0))) {             \n\
+    keys [i] = b;                                            \n\
+    keys [l] = a;                                            \n\
+    if (use_perm) {                                          \n\
+      p = perm [i];                                          \n\
+      perm [i] = perm [l];                                   \n\
+      perm [l] = p;                                          \n\
+    }                                                        \n\
+  }                                                          \n\
+}                                                            \n\
+                                                             \n\
+                                                             \n\
+// the first position in the sorted keys [0 .. n-1] with a key >= key \n\
+size_t                                                       \n\
+lower_bound_key                                              \n\
+  (const __global IDX_T *keys,                               \n\
+   const size_t n,                                           \n\
+   const IDX_T key)                                          \n\
+{                                                            \n\
+  size_t lo = 0, hi = n, mid;                                \n\
+  while (lo < hi) {                                          \n\
+    mid = (lo + hi) / 2;                                     \n\
+    if (keys [mid] < key)                                    \n\
+      lo = mid + 1;                                          \n\
+    else                                                     \n\
+      hi = mid;                                              \n\
+  }                                                          \n\
+  return lo;                                                 \n\
+}                                                            \n\
+                                                             \n\
+                                                             \n\
+// the reductions of accumarray: sum (fcn 0, saturating for integers), \n\
+// max (fcn 1) and min (fcn 2), the latter two ignoring NaN values \n\
+#if defined (COMPLEX)                                        \n\
+                                                             \n\
+TYPE                                                         \n\
+accum_op                                                     \n\
+  (const TYPE a,                                             \n\
+   const TYPE b,                                             \n\
+   const ulong fcn)                                          \n\
+{                                                            \n\
+  if (fcn == 0)                                              \n\
+    return a + b;                                            \n\
+  if (isnan (b.x) || isnan (b.y))                            \n\
+    return a;                                                \n\
+  if (isnan (a.x) || isnan (a.y))                            \n\
+    return b;                                                \n\
+  if (fcn == 1)                                              \n\
+    return IS_GT (b, a) ? b : a;                             \n\
+  return IS_LT (b, a) ? b : a;                               \n\
+}                                                            \n\
+                                                             \n\
+#else // non-COMPLEX                                         \n\
+                                                             \n\
+#if defined (FLOATINGPOINT)                                  \n\
+#define ACCUM_SUM(a,b) ((a) + (b))                           \n\
+#define ACCUM_MAX(a,b) fmax (a, b)                           \n\
+#define ACCUM_MIN(a,b) fmin (a, b)                           \n\
+#else                                                        \n\
+#define ACCUM_SUM(a,b) add_sat (a, b)                        \n\
+#define ACCUM_MAX(a,b) max (a, b)                            \n\
+#define ACCUM_MIN(a,b) min (a, b)                            \n\
+#endif                                                       \n\
+                                                             \n\
+TYPE                                                         \n\
+accum_op                                                     \n\
+  (const TYPE a,                                             \n\
+   const TYPE b,                                             \n\
+   const ulong fcn)                                          \n\
+{                                                            \n\
+  if (fcn == 1)                                              \n\
+    return ACCUM_MAX (a, b);                                 \n\
+  else if (fcn == 2)                                         \n\
+    return ACCUM_MIN (a, b);                                 \n\
+  return ACCUM_SUM (a, b);                                   \n\
+}                                                            \n\
+                                                             \n\
+#endif                                                       \n\
+                                                             \n\
+                                                             \n\
+// the sort keys of accumarray: the zero-based (linear) subscripts, with \n\
+// the largest key for the padding up to the power of two length n_keys, \n\
+// and for subscripts outside of the n_out output elements, which are \n\
+// also flagged; perm starts as the identity permutation     \n\
+__kernel void                                                \n\
+ocl_accum_keys                                               \n\
+  (__global IDX_T *keys,                                     \n\
+   __global IDX_T *perm,                                     \n\
+   const __global IDX_T *subs,                               \n\
+   const ulong ofs_subs,                                     \n\
+   const ulong n,                                            \n\
+   const ulong n_keys,                                       \n\
+   const ulong n_out,                                        \n\
+   __global IDX_T *flag)                                     \n\
+{                                                            \n\
+  subs += ofs_subs;                                          \n\
+  IDX_T s;                                                   \n\
+  GRID_LOOP (j, n_keys) {                                    \n\
+    s = LONG_MAX;                                            \n\
+    if (j < n) {                                             \n\
+      s = subs [j] - 1;                                      \n\
+      if ((s < 0) || (s >= (IDX_T) n_out)) {                 \n\
+        flag [0] = 1;                                        \n\
+        s = LONG_MAX;                                        \n\
+      }                                                      \n\
+    }                                                        \n\
+    keys [j] = s;                                            \n\
+    perm [j] = j;                                            \n\
+  }                                                          \n\
+}                                                            \n\
+                                                             \n\
+                                                             \n\
+// accumarray from the sorted keys: output element p reduces the values \n\
+// of its run of keys (in the order of the permutation), or is fillval \n\
+// for an empty run; a value step vals_step of 0 repeats a single value \n\
+__kernel void                                                \n\
+ocl_accum_sorted                                             \n\
+  (__global TYPE *data_dst,                                  \n\
+   const __global IDX_T *keys,                               \n\
+   const __global IDX_T *perm,                               \n\
+   const ulong n_keys,                                       \n\
+   const __global TYPE *vals,                                \n\
+   const ulong ofs_vals,                                     \n\
+   const ulong vals_step,                                    \n\
+   const ulong fcn,                                          \n\
+   const TYPE fillval,                                       \n\
+   const ulong n_out)                                        \n\
+{                                                            \n\
+  vals += ofs_vals;                                          \n\
+  size_t q, q0, q1;                                          \n\
+  TYPE acc;                                                  \n\
+  GRID_LOOP (p, n_out) {                                     \n\
+    q0 = lower_bound_key (keys, n_keys, p);                  \n\
+    q1 = q0 + lower_bound_key (keys + q0, n_keys - q0, p + 1); \n\
+    acc = fillval;                                           \n\
+    if (q1 > q0) {                                           \n\
+      acc = vals [perm [q0] * vals_step];                    \n\
+      for (q=q0+1; q<q1; q++)                                \n\
+        acc = accum_op (acc, vals [perm [q] * vals_step], fcn); \n\
+    }                                                        \n\
+    data_dst [p] = acc;                                      \n\
+  }                                                          \n\
+}                                                            \n\
+                                                             \n\
+                                                             \n\
+// the neutral element of the accumarray reduction fcn (NaN for max and \n\
+// min of floating point values, as they ignore NaN values)  \n\
+TYPE                                                         \n\
+accum_neutral                                                \n\
+  (const ulong fcn)                                          \n\
+{                                                            \n\
+  if (fcn == 0)                                              \n\
+    return ZERO;                                             \n\
+#if defined (FLOATINGPOINT)                                  \n\
+  return (TYPE) (NAN);                                       \n\
+#else                                                        \n\
+  TYPE lowest = ((TYPE) (-1) < (TYPE) (0)) ? (TYPE) ((ulong) 1 << (8 * sizeof (TYPE) - 1)) : (TYPE) (0); \n\
+  return (fcn == 1) ? lowest : (TYPE) (~lowest);             \n\
+#endif                                                       \n\
+}                                                            \n\
+                                                             \n\
+                                                             \n\
+// atomic updates for accumarray, with compare-and-swap loops on the \n\
+// 32-bit or (by cl_khr_int64_base_atomics) 64-bit words of the (real) \n\
+// values; this also emulates the atomic floating point operations that \n\
+// OpenCL 1.1 lacks.  Complex values are updated per component (sum only) \n\
+#if defined (ATOMIC32) || defined (ATOMIC64)                 \n\
+                                                             \n\
+#if defined (ATOMIC64)                                       \n\
+#pragma OPENCL EXTENSION cl_khr_int64_base_atomics : enable  \n\
+#define AWORD ulong                                          \n\
+#define ATOMIC_CMPXCHG atom_cmpxchg                          \n\
+#else                                                        \n\
+#define AWORD uint                                           \n\
+#define ATOMIC_CMPXCHG atomic_cmpxchg                        \n\
+#endif                                                       \n\
+                                                             \n\
+#define AS_TYPE_(t, x) as_##t (x)                            \n\
+#define AS_TYPE(t, x) AS_TYPE_(t, x)                         \n\
+                                                             \n\
+#if defined (COMPLEX)                                        \n\
+#define ATYPE TYPE1                                          \n\
+#define ATOMIC_OP(a, b, fcn) ((a) + (b))                     \n\
+#else                                                        \n\
+#define ATYPE TYPE                                           \n\
+#define ATOMIC_OP(a, b, fcn) accum_op (a, b, fcn)            \n\
+#endif                                                       \n\
+                                                             \n\
+#define DEFATOMIC(NAME, SPACE) \\                            \n\
+  void NAME (SPACE ATYPE *p, const ATYPE v, const ulong fcn) { \\ \n\
+    volatile SPACE AWORD *w = (volatile SPACE AWORD *) p; \\ \n\
+    AWORD old_w = *w, cmp_w; \\                              \n\
+    do { \\                                                  \n\
+      cmp_w = old_w; \\                                      \n\
+      old_w = ATOMIC_CMPXCHG (w, cmp_w, AS_TYPE (AWORD, ATOMIC_OP (AS_TYPE (ATYPE, cmp_w), v, fcn))); \\ \n\
+    } while (old_w != cmp_w); \\                             \n\
+  }                                                          \n\
+                                                             \n\
+DEFATOMIC (atomic_accum_global, __global)                    \n\
+DEFATOMIC (atomic_accum_local, __local)                      \n\
+                                                             \n\
+#if defined (COMPLEX)                                        \n\
+#define ATOMIC_ACCUM(NAME, p, v, fcn) \\                     \n\
+  { NAME ((SPACE_OF_##NAME ATYPE *) (p), v.x, fcn); NAME ((SPACE_OF_##NAME ATYPE *) (p) + 1, v.y, fcn); } \n\
+#else                                                        \n\
+#define ATOMIC_ACCUM(NAME, p, v, fcn) NAME (p, v, fcn)       \n\
+#endif                                                       \n\
+#define SPACE_OF_atomic_accum_global __global                \n\
+#define SPACE_OF_atomic_accum_local __local                  \n\
+                                                             \n\
+                                                             \n\
+__kernel void                                                \n\
+ocl_accum_init                                               \n\
+  (__global TYPE *data_dst,                                  \n\
+   const ulong fcn,                                          \n\
+   const ulong n_out)                                        \n\
+{                                                            \n\
+  TYPE value = accum_neutral (fcn);                          \n\
+  GRID_LOOP (p, n_out)                                       \n\
+    data_dst [p] = value;                                    \n\
+}                                                            \n\
+                                                             \n\
+                                                             \n\
+// accumarray with atomic updates of the output in global memory (for \n\
+// large outputs); the elements hit get marked (for the fill value of \n\
+// the others by ocl_accum_fill), invalid subscripts get flagged \n\
+__kernel void                                                \n\
+ocl_accum_atomic                                             \n\
+  (__global TYPE *data_dst,                                  \n\
+   const __global IDX_T *subs,                               \n\
+   const ulong ofs_subs,                                     \n\
+   const __global TYPE *vals,                                \n\
+   const ulong ofs_vals,                                     \n\
+   const ulong vals_step,                                    \n\
+   const ulong fcn,                                          \n\
+   __global uint *hit,                                       \n\
+   const ulong n,                                            \n\
+   const ulong n_out,                                        \n\
+   __global IDX_T *flag)                                     \n\
+{                                                            \n\
+  subs += ofs_subs;                                          \n\
+  vals += ofs_vals;                                          \n\
+  IDX_T s;                                                   \n\
+  TYPE v;                                                    \n\
+  GRID_LOOP (j, n) {                                         \n\
+    s = subs [j] - 1;                                        \n\
+    if ((s < 0) || (s >= (IDX_T) n_out)) {                   \n\
+      flag [0] = 1;                                          \n\
+      continue;                                              \n\
+    }                                                        \n\
+    v = vals [j * vals_step];                                \n\
+    ATOMIC_ACCUM (atomic_accum_global, data_dst + s, v, fcn); \n\
+    hit [s] = 1;                                             \n\
+  }                                                          \n\
+}                                                            \n\
+                                                             \n\
+                                                             \n\
+// as ocl_accum_atomic, privatised per work-group in local memory (for \n\
+// outputs of up to the size of loc_acc), which is merged into the \n\
+// output with atomic updates at the end                     \n\
+__kernel void                                                \n\
+ocl_accum_atomic_local                                       \n\
+  (__global TYPE *data_dst,                                  \n\
+   const __global IDX_T *subs,                               \n\
+   const ulong ofs_subs,                                     \n\
+   const __global TYPE *vals,                                \n\
+   const ulong ofs_vals,                                     \n\
+   const ulong vals_step,                                    \n\
+   const ulong fcn,                                          \n\
+   __global uint *hit,                                       \n\
+   const ulong n,                                            \n\
+   const ulong n_out,                                        \n\
+   __global IDX_T *flag,                                     \n\
+   __local TYPE *loc_acc)                                    \n\
+{                                                            \n\
+  subs += ofs_subs;                                          \n\
+  vals += ofs_vals;                                          \n\
+  size_t lid = get_local_id (0), lsize = get_local_size (0), k; \n\
+  TYPE neutral = accum_neutral (fcn), v;                     \n\
+  IDX_T s;                                                   \n\
+  for (k=lid; k<n_out; k+=lsize)                             \n\
+    loc_acc [k] = neutral;                                   \n\
+  barrier (CLK_LOCAL_MEM_FENCE);                             \n\
+  GRID_LOOP (j, n) {                                         \n\
+    s = subs [j] - 1;                                        \n\
+    if ((s < 0) || (s >= (IDX_T) n_out)) {                   \n\
+      flag [0] = 1;                                          \n\
+      continue;                                              \n\
+    }                                                        \n\
+    v = vals [j * vals_step];                                \n\
+    ATOMIC_ACCUM (atomic_accum_local, loc_acc + s, v, fcn);  \n\
+    hit [s] = 1;                                             \n\
+  }                                                          \n\
+  barrier (CLK_LOCAL_MEM_FENCE);                             \n\
+  for (k=lid; k<n_out; k+=lsize) {                           \n\
+    v = loc_acc [k];                                         \n\
+    if (IS_NE (v, neutral))                                  \n\
+      ATOMIC_ACCUM (atomic_accum_global, data_dst + k, v, fcn); \n\
+  }                                                          \n\
+}                                                            \n\
+                                                             \n\
+#endif                                                       \n\
+                                                             \n\
+                                                             \n\
+// the fill value for the output elements not hit by ocl_accum_atomic \n\
+__kernel void                                                \n\
+ocl_accum_fill                                               \n\
+  (__global TYPE *data_dst,                                  \n\
+   const __global uint *hit,                                 \n\
+   const TYPE fillval,                                       \n\
+   const ulong n_out)                                        \n\
+{                                                            \n\
+  GRID_LOOP (p, n_out)                                       \n\
+    if (hit [p] == 0)                                        \n\
+      data_dst [p] = fillval;                                \n\
+}                                                            \n\
+                                                             \n\
+                                                             \n\
+#if ! defined (COMPLEX)                                      \n\
+                                                             \n\
+// the bin of value v in the ascending edges e [0 .. nb-1] as by histc: \n\
+// the last k with e [k] <= v, where the last bin only holds v == e [nb-1]; \n\
+// -1 for values outside of the edges (and NaN)              \n\
+long                                                         \n\
+histc_bin                                                    \n\
+  (const TYPE v,                                             \n\
+   const __global TYPE *e,                                   \n\
+   const ulong nb)                                           \n\
+{                                                            \n\
+  long lo = 0, hi = nb - 1, mid;                             \n\
+  if ((! (v >= e [0])) || (v > e [hi]))                      \n\
+    return -1;                                               \n\
+  if (v == e [hi])                                           \n\
+    return hi;                                               \n\
+  while (hi - lo > 1) {                                      \n\
+    mid = (lo + hi) / 2;                                     \n\
+    if (e [mid] <= v)                                        \n\
+      lo = mid;                                              \n\
+    else                                                     \n\
+      hi = mid;                                              \n\
+  }                                                          \n\
+  return lo;                                                 \n\
+}                                                            \n\
+                                                             \n\
+                                                             \n\
+// histograms along a dimension (as in ocl_trapz, one or more work-groups \n\
+// per slice): each work-group counts its elements in a private histogram \n\
+// in local memory, which is then merged into the counts (nb per slice, \n\
+// slice after slice) with atomic additions                  \n\
+__kernel void                                                \n\
+ocl_histc_local                                              \n\
+  (__global uint *counts,                                    \n\
+   const __global TYPE *data_src,                            \n\
+   const ulong ofs_src,                                      \n\
+   const __global TYPE *edges,                               \n\
+   const ulong ofs_edges,                                    \n\
+   const ulong nb,                                           \n\
+   const ulong len,                                          \n\
+   const ulong fac,                                          \n\
+   __local uint *loc_hist)                                   \n\
+{                                                            \n\
+  data_src += ofs_src;                                       \n\
+  edges += ofs_edges;                                        \n\
+  size_t i = get_group_id (1), k;                            \n\
+  size_t g = get_group_id (0), ng = get_num_groups (0);      \n\
+  size_t lid = get_local_id (0), lsize = get_local_size (0); \n\
+  size_t j0 = (i % fac) + (i / fac) * fac * len;             \n\
+  long b;                                                    \n\
+  for (k=lid; k<nb; k+=lsize)                                \n\
+    loc_hist [k] = 0;                                        \n\
+  barrier (CLK_LOCAL_MEM_FENCE);                             \n\
+  for (k=g*lsize+lid; k<len; k+=ng*lsize) {                  \n\
+    b = histc_bin (data_src [j0 + k*fac], edges, nb);        \n\
+    if (b >= 0)                                              \n\
+      atomic_inc (loc_hist + b);                             \n\
+  }                                                          \n\
+  barrier (CLK_LOCAL_MEM_FENCE);                             \n\
+  for (k=lid; k<nb; k+=lsize)                                \n\
+    if (loc_hist [k] > 0)                                    \n\
+      atomic_add (counts + i*nb + k, loc_hist [k]);          \n\
+}                                                            \n\
+                                                             \n\
+                                                             \n\
+// the sort keys of histograms with many bins: i*nb + b for an element of \n\
+// slice i in bin b, and the largest key for elements outside of the edges \n\
+// and for the padding up to the power of two length n_keys  \n\
+__kernel void                                                \n\
+ocl_histc_keys                                               \n\
+  (__global IDX_T *keys,                                     \n\
+   const __global TYPE *data_src,                            \n\
+   const ulong ofs_src,                                      \n\
+   const __global TYPE *edges,                               \n\
+   const ulong ofs_edges,                                    \n\
+   const ulong nb,                                           \n\
+   const ulong len,                                          \n\
+   const ulong fac,                                          \n\
+   const ulong n,                                            \n\
+   const ulong n_keys)                                       \n\
+{                                                            \n\
+  data_src += ofs_src;                                       \n\
+  edges += ofs_edges;                                        \n\
+  long b;                                                    \n\
+  IDX_T key;                                                 \n\
+  GRID_LOOP (j, n_keys) {                                    \n\
+    key = LONG_MAX;                                          \n\
+    if (j < n) {                                             \n\
+      b = histc_bin (data_src [j], edges, nb);               \n\
+      if (b >= 0)                                            \n\
+        key = ((j % fac) + (j / (fac * len)) * fac) * nb + b; \n\
+    }                                                        \n\
+    keys [j] = key;                                          \n\
+  }                                                          \n\
+}                                                            \n\
+                                                             \n\
+                                                             \n\
+// the counts from the sorted keys: the length of the run of each key \n\
+__kernel void                                                \n\
+ocl_histc_sorted                                             \n\
+  (__global uint *counts,                                    \n\
+   const __global IDX_T *keys,                               \n\
+   const ulong n_keys,                                       \n\
+   const ulong n_out)                                        \n\
+{                                                            \n\
+  size_t q0;                                                 \n\
+  GRID_LOOP (p, n_out) {                                     \n\
+    q0 = lower_bound_key (keys, n_keys, p);                  \n\
+    counts [p] = lower_bound_key (keys + q0, n_keys - q0, p + 1); \n\
+  }                                                          \n\
+}                                                            \n\
+                                                             \n\
+                                                             \n\
+// the counts (nb per slice, slice after slice) into the histogram \n\
+// array, with the bins along the dimension (histc stores them with \n\
+// the double program, so that they are exact)               \n\
+__kernel void                                                \n\
+ocl_histc_store                                              \n\
+  (__global TYPE *data_dst,                                  \n\
+   const __global uint *counts,                              \n\
+   const ulong nb,                                           \n\
+   const ulong fac,                                          \n\
+   const ulong n)                                            \n\
+{                                                            \n\
+  size_t i, b;                                               \n\
+  GRID_LOOP (p, n) {                                         \n\
+    i = p / nb;                                              \n\
+    b = p % nb;                                              \n\
+    data_dst [(i % fac) + ((i / fac) * nb + b) * fac] = (TYPE) (counts [p]); \n\
+  }                                                          \n\
+}                                                            \n\
+                                                             \n\
+#endif                                                       \n\
+                                                             \n\
+                                                             \n\
+// pagewise matrix multiply data_dst (s1 x s2 x num_pages) = \n\
+// op1 (src1 page) * op2 (src2 page), op as in ocl_mtimes; the \n\
+// source pages of output page p are data_idx [2*p] and      \n\
+// data_idx [2*p+1] (broadcasting).  Each work-group handles \n\
+// pages_per_group pages with get_local_size (0) / pages_per_group \n\
+// work-items per page; with use_local, the operand pages are \n\
+// staged in local memory first (tiny matrices)              \n\
+__kernel void                                                \n\
+ocl_pagemtimes                                               \n\
+  (__global TYPE *data_dst,                                  \n\
+   const __global TYPE *data_src1,                           \n\
+   const ulong ofs_src1,                                     \n\
+   const __global TYPE *data_src2,                           \n\
+   const ulong ofs_src2,                                     \n\
+   const ulong s1,                                           \n\
+   const ulong len,                                          \n\
+   const ulong s2,                                           \n\
+   const ulong trans1,                                       \n\
+   const ulong trans2,                                       \n\
+   const __global IDX_T *data_idx,                           \n\
+   const ulong num_pages,                                    \n\
+   const ulong pages_per_group,                              \n\
+   const ulong use_local,                                    \n\
+   __local TYPE *tile)                                       \n\
+{                                                            \n\
+  size_t lid = get_local_id (0);                             \n\
+  size_t items_per_page = get_local_size (0) / pages_per_group; \n\
+  size_t sub = lid / items_per_page, l = lid % items_per_page; \n\
+  size_t p = get_group_id (1) * pages_per_group + sub;       \n\
+  size_t n1 = s1 * len, n2 = len * s2, n = s1 * s2;          \n\
+  size_t stride1 = (trans1 == 0) ? s1 : 1;                   \n\
+  size_t stride2 = (trans2 == 0) ? 1 : s2;                   \n\
+  size_t i, j1, j2, k, r, c;                                 \n\
+  const __global TYPE *page1 = data_src1 + ofs_src1;         \n\
+  const __global TYPE *page2 = data_src2 + ofs_src2;         \n\
+  __local TYPE *tile1 = tile + sub * (n1 + n2);              \n\
+  __local TYPE *tile2 = tile1 + n1;                          \n\
+  TYPE val, v1, v2;                                          \n\
+  if (p < num_pages) {                                       \n\
+    page1 += data_idx [2*p] * n1;                            \n\
+    page2 += data_idx [2*p+1] * n2;                          \n\
+  }                                                          \n\
+  if (use_local) {                                           \n\
+    if (p < num_pages) {                                     \n\
+      for (k=l; k<n1; k+=items_per_page)                     \n\
+        tile1 [k] = page1 [k];                               \n\
+      for (k=l; k<n2; k+=items_per_page)                     \n\
+        tile2 [k] = page2 [k];                               \n\
+    }                                                        \n\
+    barrier (CLK_LOCAL_MEM_FENCE);                           \n\
+  }                                                          \n\
+  if (p >= num_pages)                                        \n\
+    return;                                                  \n\
+  data_dst += p * n;                                         \n\
+  for (i=l; i<n; i+=items_per_page) {                        \n\
+    r = i % s1;                                              \n\
+    c = i / s1;                                              \n\
+    j1 = (trans1 == 0) ? r : r * len;                        \n\
+    j2 = (trans2 == 0) ? c * len : c;                        \n\
+    val = ZERO;                                              \n\
+    for (k=0; k<len; k++) {                                  \n\
+      if (use_local) {                                       \n\
+        v1 = tile1 [j1 + k * stride1];                       \n\
+        v2 = tile2 [j2 + k * stride2];                       \n\
+      } else {                                               \n\
+        v1 = page1 [j1 + k * stride1];                       \n\
+        v2 = page2 [j2 + k * stride2];                       \n\
+      }                                                      \n\
+      if (trans1 == 2)                                       \n\
+        v1 = CONJ (v1);                                      \n\
+      if (trans2 == 2)                                       \n\
+        v2 = CONJ (v2);                                      \n\
+      val += MUL (v1, v2);                                   \n\
+    }                                                        \n\
+    data_dst [i] = val;                                      \n\
+  }                                                          \n\
+}                                                            \n\
+                                                             \n\
+                                                             \n\
+// sparse times dense data_dst (nr x nx) = A * src (nc x nx), with A \n\
+// in CSR format (row_ptr, col_idx, values), values conjugated for \n\
+// conj != 0.  lanes (power of 2) work-items share each of the \n\
+// nr * nx output elements; their partial sums over the row's \n\
+// nonzeros are added up in local memory                     \n\
+__kernel void                                                \n\
+ocl_csr_mtimes                                               \n\
+  (__global TYPE *data_dst,                                  \n\
+   const __global IDX_T *row_ptr,                            \n\
+   const __global IDX_T *col_idx,                            \n\
+   const __global TYPE *values,                              \n\
+   const __global TYPE *data_src,                            \n\
+   const ulong ofs_src,                                      \n\
+   const ulong nr,                                           \n\
+   const ulong nc,                                           \n\
+   const ulong nx,                                           \n\
+   const ulong conj,                                         \n\
+   const ulong lanes,                                        \n\
+   __local TYPE *part)                                       \n\
+{                                                            \n\
+  size_t lid = get_local_id (0);                             \n\
+  size_t lane = lid & (lanes - 1);                           \n\
+  size_t outs_per_group = get_local_size (0) / lanes;        \n\
+  size_t n = nr * nx;                                        \n\
+  size_t base, i, r, s;                                      \n\
+  IDX_T k, k_end;                                            \n\
+  const __global TYPE *x;                                    \n\
+  TYPE val, v;                                               \n\
+  data_src += ofs_src;                                       \n\
+  for (base = get_group_id (0) * outs_per_group; base < n;   \n\
+       base += get_num_groups (0) * outs_per_group) {        \n\
+    i = base + lid / lanes;                                  \n\
+    val = ZERO;                                              \n\
+    if (i < n) {                                             \n\
+      r = i % nr;                                            \n\
+      x = data_src + (i / nr) * nc;                          \n\
+      k_end = row_ptr [r+1];                                 \n\
+      for (k=row_ptr [r]+lane; k<k_end; k+=lanes) {          \n\
+        v = values [k];                                      \n\
+        if (conj)                                            \n\
+          v = CONJ (v);                                      \n\
+        val += MUL (v, x [col_idx [k]]);                     \n\
+      }                                                      \n\
+    }                                                        \n\
+    part [lid] = val;                                        \n\
+    barrier (CLK_LOCAL_MEM_FENCE);                           \n\
+    for (s=lanes/2; s>0; s>>=1) {                            \n\
+      if (lane < s)                                          \n\
+        part [lid] += part [lid+s];                          \n\
+      barrier (CLK_LOCAL_MEM_FENCE);                         \n\
+    }                                                        \n\
+    if ((lane == 0) && (i < n))                              \n\
+      data_dst [i] = part [lid];                             \n\
+    barrier (CLK_LOCAL_MEM_FENCE);                           \n\
+  }                                                          \n\
+}                                                            \n\
+                                                             \n\
+// direct convolution along a dimension with element stride fac: \n\
+// output i of slice t is sum_k kern [k] * src [i + shift - k], for \n\
+// 0 <= i < nd, taking zero for source indices outside [0, ns); each \n\
+// work-group computes get_local_size (0) consecutive outputs from the \n\
+// nk kernel coefficients and a window of the source, both staged in \n\
+// local memory                                              \n\
+__kernel void                                                \n\
+ocl_conv1                                                    \n\
+  (__global TYPE *data_dst,                                  \n\
+   const __global TYPE *data_src,                            \n\
+   const ulong ofs_src,                                      \n\
+   const __global TYPE *kern,                                \n\
+   const ulong nk,                                           \n\
+   const ulong ns,                                           \n\
+   const ulong nd,                                           \n\
+   const ulong fac,                                          \n\
+   const ulong shift,                                        \n\
+   __local TYPE *tile)                                       \n\
+{                                                            \n\
+  size_t lid = get_local_id (0);                             \n\
+  size_t ls = get_local_size (0);                            \n\
+  size_t t = get_group_id (1);                               \n\
+  size_t i0 = get_group_id (0) * ls;                         \n\
+  size_t nw = ls + nk - 1;                                   \n\
+  __local TYPE *lk = tile + nw;                              \n\
+  size_t j, k;                                               \n\
+  long s;                                                    \n\
+  TYPE val;                                                  \n\
+  data_src += ofs_src + (t % fac) + (t / fac) * fac * ns;    \n\
+  data_dst += (t % fac) + (t / fac) * fac * nd;              \n\
+  for (k=lid; k<nk; k+=ls)                                   \n\
+    lk [k] = kern [k];                                       \n\
+  for (j=lid; j<nw; j+=ls) {                                 \n\
+    s = (long) (i0 + shift + j) - (long) (nk - 1);           \n\
+    tile [j] = ((s >= 0) && (s < (long) ns)) ? data_src [s * fac] : ZERO; \n\
+  }                                                          \n\
+  barrier (CLK_LOCAL_MEM_FENCE);                             \n\
+  if (i0 + lid < nd) {                                       \n\
+    val = ZERO;                                              \n\
+    for (k=0; k<nk; k++)                                     \n\
+      val += MUL (lk [k], tile [lid + nk - 1 - k]);          \n\
+    data_dst [(i0 + lid) * fac] = val;                       \n\
+  }                                                          \n\
+}                                                            \n\
+                                                             \n\
+                                                             \n\
+// direct 2-dim convolution: output (r, c) is sum_{p,q}      \n\
+// kern [p + q * mk] * src [(r + sr - p) + (c + sc - q) * ms], for \n\
+// 0 <= r < md and 0 <= c < nd, taking zero outside the ms x ns \n\
+// source; each work-group computes a ts x ts tile of outputs from \n\
+// the kernel and a source tile, both staged in local memory \n\
+__kernel void                                                \n\
+ocl_conv2                                                    \n\
+  (__global TYPE *data_dst,                                  \n\
+   const __global TYPE *data_src,                            \n\
+   const ulong ofs_src,                                      \n\
+   const __global TYPE *kern,                                \n\
+   const ulong mk,                                           \n\
+   const ulong nk,                                           \n\
+   const ulong ms,                                           \n\
+   const ulong ns,                                           \n\
+   const ulong md,                                           \n\
+   const ulong nd,                                           \n\
+   const ulong sr,                                           \n\
+   const ulong sc,                                           \n\
+   const ulong ts,                                           \n\
+   __local TYPE *tile)                                       \n\
+{                                                            \n\
+  size_t lid = get_local_id (0);                             \n\
+  size_t ls = get_local_size (0);                            \n\
+  size_t ngr = (md + ts - 1) / ts;                           \n\
+  size_t r0 = (get_group_id (0) % ngr) * ts;                 \n\
+  size_t c0 = (get_group_id (0) / ngr) * ts;                 \n\
+  size_t lr = lid % ts, lc = lid / ts;                       \n\
+  size_t mw = ts + mk - 1, nw = ts + nk - 1;                 \n\
+  __local TYPE *lk = tile + mw * nw;                         \n\
+  size_t j, p, q;                                            \n\
+  long r, c;                                                 \n\
+  TYPE val;                                                  \n\
+  data_src += ofs_src;                                       \n\
+  for (j=lid; j<mk*nk; j+=ls)                                \n\
+    lk [j] = kern [j];                                       \n\
+  for (j=lid; j<mw*nw; j+=ls) {                              \n\
+    r = (long) (r0 + sr + j % mw) - (long) (mk - 1);         \n\
+    c = (long) (c0 + sc + j / mw) - (long) (nk - 1);         \n\
+    tile [j] = ((r >= 0) && (r < (long) ms) && (c >= 0) && (c < (long) ns)) ? \n\
+               data_src [r + c * ms] : ZERO;                 \n\
+  }                                                          \n\
+  barrier (CLK_LOCAL_MEM_FENCE);                             \n\
+  if ((r0 + lr < md) && (c0 + lc < nd)) {                    \n\
+    val = ZERO;                                              \n\
+    for (q=0; q<nk; q++)                                     \n\
+      for (p=0; p<mk; p++)                                   \n\
+        val += MUL (lk [p + q * mk], tile [(lr + mk - 1 - p) + (lc + nk - 1 - q) * mw]); \n\
+    data_dst [(r0 + lr) + (c0 + lc) * md] = val;             \n\
+  }                                                          \n\
+}                                                            \n\
+                                                             \n\
+                                                             \n\
+// recursive part of filter, y [i] = x [i] - sum_{j=1..p} a [j-1] * y [i-j], \n\
+// along a dimension of length n (element stride fac), in chunks of m \n\
+// elements: one work-item runs chunk c of slice t.  With init == 0, \n\
+// all chunks start from a zero state; else chunk c > 0 starts from \n\
+// state [(t * nc + c) * p + j-1] = y [c * m - j], j = 1..p, and chunk 0 \n\
+// (which has no predecessor) is left as it is               \n\
+__kernel void                                                \n\
+ocl_iir_chunk                                                \n\
+  (__global TYPE *data_dst,                                  \n\
+   const __global TYPE *data_src,                            \n\
+   const ulong ofs_src,                                      \n\
+   const __global TYPE *a,                                   \n\
+   const ulong p,                                            \n\
+   const ulong n,                                            \n\
+   const ulong fac,                                          \n\
+   const ulong num_slices,                                   \n\
+   const ulong m,                                            \n\
+   const ulong nc,                                           \n\
+   const __global TYPE *state,                               \n\
+   const ulong init)                                         \n\
+{                                                            \n\
+  GRID_LOOP (w, num_slices * nc) {                           \n\
+    size_t t = w / nc, c = w % nc;                           \n\
+    size_t base = (t % fac) + (t / fac) * fac * n;           \n\
+    size_t i0 = c * m, i1 = (i0 + m < n) ? i0 + m : n;       \n\
+    size_t i, j;                                             \n\
+    TYPE val, y;                                             \n\
+    if (init && (c == 0))                                    \n\
+      continue;                                              \n\
+    for (i=i0; i<i1; i++) {                                  \n\
+      val = data_src [ofs_src + base + i * fac];             \n\
+      for (j=1; j<=p; j++) {                                 \n\
+        if (i >= i0 + j)                                     \n\
+          y = data_dst [base + (i - j) * fac];               \n\
+        else if (init)                                       \n\
+          y = state [w * p + j - (i - i0) - 1];              \n\
+        else                                                 \n\
+          break;                                             \n\
+        val -= MUL (a [j-1], y);                             \n\
+      }                                                      \n\
+      data_dst [base + i * fac] = val;                       \n\
+    }                                                        \n\
+  }                                                          \n\
+}                                                            \n\
+                                                             \n\
+                                                             \n\
+// carries the chunk states of ocl_iir_chunk along the slices, one \n\
+// work-item per slice: from the zero-state outputs in data_src, the \n\
+// state of chunk c is the last p outputs of chunk c-1 plus trans \n\
+// (p x p, column-major; the map of a chunk's initial state to its \n\
+// last p outputs) times the state of chunk c-1              \n\
+__kernel void                                                \n\
+ocl_iir_carry                                                \n\
+  (__global TYPE *state,                                     \n\
+   const __global TYPE *data_src,                            \n\
+   const __global TYPE *trans,                               \n\
+   const ulong p,                                            \n\
+   const ulong n,                                            \n\
+   const ulong fac,                                          \n\
+   const ulong num_slices,                                   \n\
+   const ulong m,                                            \n\
+   const ulong nc)                                           \n\
+{                                                            \n\
+  GRID_LOOP (t, num_slices) {                                \n\
+    size_t base = (t % fac) + (t / fac) * fac * n;           \n\
+    __global TYPE *s = state + t * nc * p;                   \n\
+    size_t c, i, j;                                          \n\
+    TYPE val;                                                \n\
+    for (j=0; j<p; j++)                                      \n\
+      s [j] = ZERO;                                          \n\
+    for (c=1; c<nc; c++)                                     \n\
+      for (j=0; j<p; j++) {                                  \n\
+        val = data_src [base + (c * m - 1 - j) * fac];       \n\
+        for (i=0; i<p; i++)                                  \n\
+          val += MUL (trans [j + i * p], s [(c-1) * p + i]); \n\
+        s [c * p + j] = val;                                 \n\
+      }                                                      \n\
+  }                                                          \n\
+}                                                            \n\
+                                                             \n\
+                                                             \n\
+#if defined (COMPLEX)                                        \n\
+                                                             \n\
+// FFT: transforms of length n run along a dimension with element \n\
+// stride fac, transform t starting at (t % fac) + (t / fac) * fac * n; \n\
+// sign is -1 (forward) or +1 (inverse), and scale.x scales the output \n\
+                                                             \n\
+#define FFT_BASE(t, n, fac) (((t) % (fac)) + ((t) / (fac)) * (fac) * (n)) \n\
+                                                             \n\
+// exp (sign * pi * i * a / b), with a reduced modulo 2 * b  \n\
+TYPE                                                         \n\
+fft_root (ulong a, ulong b, long sign)                       \n\
+{                                                            \n\
+  TYPE1 x = (TYPE1) (a % (2 * b)) / (TYPE1) b;               \n\
+  return (TYPE) (cospi (x), sign * sinpi (x));               \n\
+}                                                            \n\
+                                                             \n\
+                                                             \n\
+// copy with the transform dimension resized from len to n (zero \n\
+// padding or truncation); num = number of transforms * n    \n\
+__kernel void                                                \n\
+ocl_fft_resize                                               \n\
+  (__global TYPE *data_dst,                                  \n\
+   const __global TYPE *data_src,                            \n\
+   const ulong ofs_src,                                      \n\
+   const ulong len,                                          \n\
+   const ulong n,                                            \n\
+   const ulong fac,                                          \n\
+   const ulong num)                                          \n\
+{                                                            \n\
+  data_src += ofs_src;                                       \n\
+  GRID_LOOP (i, num) {                                       \n\
+    ulong a = i % fac, k = (i / fac) % n, b = i / (fac * n); \n\
+    data_dst [i] = (k < len) ? data_src [a + k * fac + b * fac * len] : ZERO; \n\
+  }                                                          \n\
 }                                                            \n\
                                                              \n\
                                                              \n\
+// one Stockham autosort pass of radix r (2, 3, 4, 5 or 7), ns being \n\
+// the product of the radices of the previous passes;        \n\
+// num = number of transforms * n / r                        \n\
 __kernel void                                                \n\
-ocl_mul2                                                     \n\
+ocl_fft_stage                                                \n\
   (__global TYPE *data_dst,                                  \n\
-   const __global TYPE *data_src1,                           \n\
-   const ulong ofs_src1,                                     \n\
-   const __global TYPE *data_src2,                           \n\
-   const ulong ofs_src2)                                     \n\
+   const __global TYPE *data_src,                            \n\
+   const ulong ofs_src,                                      \n\
+   const ulong n,                                            \n\
+   const ulong fac,                                          \n\
+   const ulong r,                                            \n\
+   const ulong ns,                                           \n\
+   const long sign,                                          \n\
+   const TYPE scale,                                         \n\
+   const ulong num)                                          \n\
+{                                                            \n\
+  data_src += ofs_src;                                       \n\
+  TYPE v [7], u [7], w;                                      \n\
+  ulong m = n / r, p, q;                                     \n\
+  GRID_LOOP (i, num) {                                       \n\
+    ulong j = i % m, base = FFT_BASE (i / m, n, fac);        \n\
+    ulong k = j % ns, ofs_dst = (j / ns) * ns * r + k;       \n\
+    for (p=0; p<r; p++) {                                    \n\
+      v [p] = data_src [base + (j + p * m) * fac];           \n\
+      if ((p > 0) && (k > 0))                                \n\
+        v [p] = MUL (v [p], fft_root (2 * k * p, ns * r, sign)); \n\
+    }                                                        \n\
+    if (r == 2) {                                            \n\
+      u [0] = v [0] + v [1];                                 \n\
+      u [1] = v [0] - v [1];                                 \n\
+    } else if (r == 4) {                                     \n\
+      TYPE a0 = v [0] + v [2], a1 = v [0] - v [2];           \n\
+      TYPE b0 = v [1] + v [3], b1 = v [1] - v [3];           \n\
+      b1 = (TYPE) (-sign * b1.y, sign * b1.x); // times sign * i \n\
+      u [0] = a0 + b0;                                       \n\
+      u [1] = a1 + b1;                                       \n\
+      u [2] = a0 - b0;                                       \n\
+      u [3] = a1 - b1;                                       \n\
+    } else {                                                 \n\
+      for (q=0; q<r; q++) {                                  \n\
+        w = v [0];                                           \n\
+        for (p=1; p<r; p++)                                  \n\
+          w += MUL (v [p], fft_root (2 * ((p * q) % r), r, sign)); \n\
+        u [q] = w;                                           \n\
+      }                                                      \n\
+    }                                                        \n\
+    for (q=0; q<r; q++)                                      \n\
+      data_dst [base + (ofs_dst + q * ns) * fac] = u [q] * scale.x; \n\
+  }                                                          \n\
+}                                                            \n\
+                                                             \n\
+                                                             \n\
+// Bluestein: data_dst (m x number of transforms) is the input times \n\
+// the chirp exp (sign * pi * i * k^2 / n), zero padded to length m; \n\
+// num = number of transforms * m                            \n\
+__kernel void                                                \n\
+ocl_fft_chirp_pre                                            \n\
+  (__global TYPE *data_dst,                                  \n\
+   const __global TYPE *data_src,                            \n\
+   const ulong ofs_src,                                      \n\
+   const ulong n,                                            \n\
+   const ulong fac,                                          \n\
+   const ulong m,                                            \n\
+   const long sign,                                          \n\
+   const ulong num)                                          \n\
 {                                                            \n\
-  data_src1 += ofs_src1;                                     \n\
-  data_src2 += ofs_src2;                                     \n\
-  size_t i = get_global_id (0);                              \n\
-  TYPE v1, v2;                                               \n\
-  v1 = data_src1 [i];                                        \n\
-  v2 = data_src2 [i];                                        \n\
-  data_dst [i] = MUL (v1, v2);                               \n\
+  data_src += ofs_src;                                       \n\
+  GRID_LOOP (i, num) {                                       \n\
+    ulong k = i % m, base = FFT_BASE (i / m, n, fac);        \n\
+    data_dst [i] = (k < n) ? MUL (data_src [base + k * fac], fft_root (k * k, n, sign)) : ZERO; \n\
+  }                                                          \n\
 }                                                            \n\
                                                              \n\
                                                              \n\
+// Bluestein: the conjugate chirp of length n, wrapped around to \n\
+// length m (m >= 2 * n - 1)                                 \n\
 __kernel void                                                \n\
-ocl_mtimes                                                   \n\
+ocl_fft_chirp_filter                                         \n\
   (__global TYPE *data_dst,                                  \n\
-   const __global TYPE *data_src1,                           \n\
-   const ulong ofs_src1,                                     \n\
-   const __global TYPE *data_src2,                           \n\
-   const ulong ofs_src2,                                     \n\
-   const ulong s1,                                           \n\
-   const ulong len)                                          \n\
+   const ulong n,                                            \n\
+   const ulong m,                                            \n\
+   const long sign)                                          \n\
 {                                                            \n\
-  data_src1 += ofs_src1;                                     \n\
-  data_src2 += ofs_src2;                                     \n\
-  size_t i = get_global_id (0), j1, j2, k;                   \n\
-  TYPE val = ZERO;                                           \n\
-  TYPE v1, v2;                                               \n\
-  for (k=0; k<len; k++) {                                    \n\
-    j1 = (i % s1) +  k       * s1;                           \n\
-    j2 =  k       + (i / s1) * len;                          \n\
-    v1 = data_src1 [j1];                                     \n\
-    v2 = data_src2 [j2];                                     \n\
-    val += MUL (v1, v2);                                     \n\
+  GRID_LOOP (i, m) {                                         \n\
+    ulong k = (i < n) ? i : (m - i);                         \n\
+    data_dst [i] = (k < n) ? fft_root (k * k, n, -sign) : ZERO; \n\
+  }                                                          \n\
+}                                                            \n\
+                                                             \n\
+                                                             \n\
+// Bluestein: multiply every transform (length m) in place with the \n\
+// spectrum of the filter; num = number of transforms * m    \n\
+__kernel void                                                \n\
+ocl_fft_chirp_mul                                            \n\
+  (__global TYPE *data,                                      \n\
+   const __global TYPE *data_filter,                         \n\
+   const ulong m,                                            \n\
+   const ulong num)                                          \n\
+{                                                            \n\
+  GRID_LOOP (i, num) {                                       \n\
+    data [i] = MUL (data [i], data_filter [i % m]);          \n\
+  }                                                          \n\
+}                                                            \n\
+                                                             \n\
+                                                             \n\
+// Bluestein: the first n elements of each transform (length m in \n\
+// data_src) times the chirp, scaled, to data_dst;           \n\
+// num = number of transforms * n                            \n\
+__kernel void                                                \n\
+ocl_fft_chirp_post                                           \n\
+  (__global TYPE *data_dst,                                  \n\
+   const __global TYPE *data_src,                            \n\
+   const ulong n,                                            \n\
+   const ulong fac,                                          \n\
+   const ulong m,                                            \n\
+   const long sign,                                          \n\
+   const TYPE scale,                                         \n\
+   const ulong num)                                          \n\
+{                                                            \n\
+  GRID_LOOP (i, num) {                                       \n\
+    ulong k = i % n, t = i / n;                              \n\
+    data_dst [FFT_BASE (t, n, fac) + k * fac] =              \n\
+      MUL (data_src [t * m + k], fft_root (k * k, n, sign)) * scale.x; \n\
   }                                                          \n\
-  data_dst [i] = val;                                        \n\
 }                                                            \n\
                                                              \n\
+#endif                                                       \n\
+                                                             \n\
                                                              \n\
 __kernel void                                                \n\
 ocl_div1n                                                    \n\
   (__global TYPE *data_dst,                                  \n\
    const __global TYPE *data_src,                            \n\
    const ulong ofs_src,                                      \n\
-   const TYPE numerator)                                     \n\
+   const TYPE numerator,                                     \n\
+   const ulong n)                                            \n\
 {                                                            \n\
   data_src += ofs_src;                                       \n\
-  size_t i = get_global_id (0);                              \n\
-  TYPE val;                                                  \n\
-  val = data_src [i];                                        \n\
-  data_dst [i] = DIV (numerator, val);                       \n\
+  VEC_LOOP (i, n) {                                          \n\
+    VTYPE val;                                               \n\
+    val = VLOAD (i, data_src);                               \n\
+    VSTORE (DIV (numerator, val), i, data_dst);              \n\
+  }                                                          \n\
+  TAIL_LOOP (i, n) {                                         \n\
+    TYPE val;                                                \n\
+    val = data_src [i];                                      \n\
+    data_dst [i] = DIV (numerator, val);                     \n\
+  }                                                          \n\
 }                                                            \n\
                                                              \n\
                                                              \n\
@@ -1006,13 +2975,20 @@ ocl_div1d                                                    \n\
   (__global TYPE *data_dst,                                  \n\
    const __global TYPE *data_src,                            \n\
    const ulong ofs_src,                                      \n\
-   const TYPE denominator)                                   \n\
+   const TYPE denominator,                                   \n\
+   const ulong n)                                            \n\
 {                                                            \n\
   data_src += ofs_src;                                       \n\
-  size_t i = get_global_id (0);                              \n\
-  TYPE val;                                                  \n\
-  val = data_src [i];                                        \n\
-  data_dst [i] = DIV (val, denominator);                     \n\
+  VEC_LOOP (i, n) {                                          \n\
+    VTYPE val;                                               \n\
+    val = VLOAD (i, data_src);                               \n\
+    VSTORE (DIV (val, denominator), i, data_dst);            \n\
+  }                                                          \n\
+  TAIL_LOOP (i, n) {                                         \n\
+    TYPE val;                                                \n\
+    val = data_src [i];                                      \n\
+    data_dst [i] = DIV (val, denominator);                   \n\
+  }                                                          \n\
 }                                                            \n\
                                                              \n\
                                                              \n\
@@ -1022,15 +2998,23 @@ ocl_div2                                                     \n\
    const __global TYPE *data_src1,                           \n\
    const ulong ofs_src1,                                     \n\
    const __global TYPE *data_src2,                           \n\
-   const ulong ofs_src2)                                     \n\
+   const ulong ofs_src2,                                     \n\
+   const ulong n)                                            \n\
 {                                                            \n\
   data_src1 += ofs_src1;                                     \n\
   data_src2 += ofs_src2;                                     \n\
-  size_t i = get_global_id (0);                              \n\
-  TYPE v1, v2;                                               \n\
-  v1 = data_src1 [i];                                        \n\
-  v2 = data_src2 [i];                                        \n\
-  data_dst [i] = DIV (v1, v2);                               \n\
+  VEC_LOOP (i, n) {                                          \n\
+    VTYPE v1, v2;                                            \n\
+    v1 = VLOAD (i, data_src1);                               \n\
+    v2 = VLOAD (i, data_src2);                               \n\
+    VSTORE (DIV (v1, v2), i, data_dst);                      \n\
+  }                                                          \n\
+  TAIL_LOOP (i, n) {                                         \n\
+    TYPE v1, v2;                                             \n\
+    v1 = data_src1 [i];                                      \n\
+    v2 = data_src2 [i];                                      \n\
+    data_dst [i] = DIV (v1, v2);                             \n\
+  }                                                          \n\
 }                                                            \n\
                                                              \n\
                                                              \n\
@@ -1039,11 +3023,12 @@ __kernel void \\                                             \n\
 ocl_##fcn \\                                                 \n\
   (__global TYPE *data_dst, \\                               \n\
    const __global TYPE *data_src, \\                         \n\
-   const ulong ofs_src) \\                                   \n\
+   const ulong ofs_src, \\                                   \n\
+   const ulong n) \\                                         \n\
 { \\                                                         \n\
   data_src += ofs_src; \\                                    \n\
-  size_t i = get_global_id (0); \\                           \n\
-  data_dst [i] = fcn (data_src [i]); \\                      \n\
+  GRID_LOOP (i, n) \\                                        \n\
+    data_dst [i] = fcn (data_src [i]); \\                    \n\
 }                                                            \n\
                                                              \n\
                                                              \n\
@@ -1094,17 +3079,19 @@ __kernel void                                                \n\
 ocl_fix                                                      \n\
   (__global TYPE *data_dst,                                  \n\
    const __global TYPE *data_src,                            \n\
-   const ulong ofs_src)                                      \n\
+   const ulong ofs_src,                                      \n\
+   const ulong n)                                            \n\
 {                                                            \n\
   data_src += ofs_src;                                       \n\
-  size_t i = get_global_id (0);                              \n\
-  TYPE v;                                                    \n\
-  v = data_src [i];                                          \n\
-  if (v < ZERO)                                              \n\
-    v = ceil (v);                                            \n\
-  else                                                       \n\
-    v = floor (v);                                           \n\
-  data_dst [i] = v;                                          \n\
+  GRID_LOOP (i, n) {                                         \n\
+    TYPE v;                                                  \n\
+    v = data_src [i];                                        \n\
+    if (v < ZERO)                                            \n\
+      v = ceil (v);                                          \n\
+    else                                                     \n\
+      v = floor (v);                                         \n\
+    data_dst [i] = v;                                        \n\
+  }                                                          \n\
 }                                                            \n\
                                                              \n\
                                                              \n\
@@ -1113,11 +3100,13 @@ ocl_power1e                                                  \n\
   (__global TYPE *data_dst,                                  \n\
    const __global TYPE *data_src,                            \n\
    const ulong ofs_src,                                      \n\
-   const TYPE exponent)                                      \n\
+   const TYPE exponent,                                      \n\
+   const ulong n)                                            \n\
 {                                                            \n\
   data_src += ofs_src;                                       \n\
-  size_t i = get_global_id (0);                              \n\
-  data_dst [i] = pow (data_src [i], exponent);               \n\
+  GRID_LOOP (i, n) {                                         \n\
+    data_dst [i] = pow (data_src [i], exponent);             \n\
+  }                                                          \n\
 }                                                            \n\
                                                              \n\
                                                              \n\
@@ -1126,11 +3115,13 @@ ocl_power1b                                                  \n\
   (__global TYPE *data_dst,                                  \n\
    const __global TYPE *data_src,                            \n\
    const ulong ofs_src,                                      \n\
-   const TYPE base)                                          \n\
+   const TYPE base,                                          \n\
+   const ulong n)                                            \n\
 {                                                            \n\
   data_src += ofs_src;                                       \n\
-  size_t i = get_global_id (0);                              \n\
-  data_dst [i] = pow (base, data_src [i]);                   \n\
+  GRID_LOOP (i, n) {                                         \n\
+    data_dst [i] = pow (base, data_src [i]);                 \n\
+  }                                                          \n\
 }                                                            \n\
                                                              \n\
                                                              \n\
@@ -1140,12 +3131,14 @@ ocl_power2                                                   \n\
    const __global TYPE *data_src1,                           \n\
    const ulong ofs_src1,                                     \n\
    const __global TYPE *data_src2,                           \n\
-   const ulong ofs_src2)                                     \n\
+   const ulong ofs_src2,                                     \n\
+   const ulong n)                                            \n\
 {                                                            \n\
   data_src1 += ofs_src1;                                     \n\
   data_src2 += ofs_src2;                                     \n\
-  size_t i = get_global_id (0);                              \n\
-  data_dst [i] = pow (data_src1 [i], data_src2 [i]);         \n\
+  GRID_LOOP (i, n) {                                         \n\
+    data_dst [i] = pow (data_src1 [i], data_src2 [i]);       \n\
+  }                                                          \n\
 }                                                            \n\
                                                              \n\
                                                              \n\
@@ -1155,12 +3148,14 @@ ocl_atan2                                                    \n\
    const __global TYPE *data_src1,                           \n\
    const ulong ofs_src1,                                     \n\
    const __global TYPE *data_src2,                           \n\
-   const ulong ofs_src2)                                     \n\
+   const ulong ofs_src2,                                     \n\
+   const ulong n)                                            \n\
 {                                                            \n\
   data_src1 += ofs_src1;                                     \n\
   data_src2 += ofs_src2;                                     \n\
-  size_t i = get_global_id (0);                              \n\
-  data_dst [i] = atan2 (data_src1 [i], data_src2 [i]);       \n\
+  GRID_LOOP (i, n) {                                         \n\
+    data_dst [i] = atan2 (data_src1 [i], data_src2 [i]);     \n\
+  }                                                          \n\
 }                                                            \n\
                                                              \n\
 #endif                                                       \n\
@@ -1223,11 +3218,13 @@ __kernel void                                                \n\
 ocl_real                                                     \n\
   (__global TYPE1 *data_dst,                                 \n\
    const __global TYPE *data_src,                            \n\
-   const ulong ofs_src)                                      \n\
+   const ulong ofs_src,                                      \n\
+   const ulong n)                                            \n\
 {                                                            \n\
   data_src += ofs_src;                                       \n\
-  size_t i = get_global_id (0);                              \n\
-  data_dst [i] = data_src [i].x;                             \n\
+  GRID_LOOP (i, n) {                                         \n\
+    data_dst [i] = data_src [i].x;                           \n\
+  }                                                          \n\
 }                                                            \n\
                                                              \n\
                                                              \n\
@@ -1235,11 +3232,13 @@ __kernel void                                                \n\
 ocl_imag                                                     \n\
   (__global TYPE1 *data_dst,                                 \n\
    const __global TYPE *data_src,                            \n\
-   const ulong ofs_src)                                      \n\
+   const ulong ofs_src,                                      \n\
+   const ulong n)                                            \n\
 {                                                            \n\
   data_src += ofs_src;                                       \n\
-  size_t i = get_global_id (0);                              \n\
-  data_dst [i] = data_src [i].y;                             \n\
+  GRID_LOOP (i, n) {                                         \n\
+    data_dst [i] = data_src [i].y;                           \n\
+  }                                                          \n\
 }                                                            \n\
                                                              \n\
                                                              \n\
@@ -1247,13 +3246,15 @@ __kernel void                                                \n\
 ocl_fabs                                                     \n\
   (__global TYPE1 *data_dst,                                 \n\
    const __global TYPE *data_src,                            \n\
-   const ulong ofs_src)                                      \n\
+   const ulong ofs_src,                                      \n\
+   const ulong n)                                            \n\
 {                                                            \n\
   data_src += ofs_src;                                       \n\
-  size_t i = get_global_id (0);                              \n\
-  TYPE z;                                                    \n\
-  z = data_src [i];                                          \n\
-  data_dst [i] = R_ABS (z);                                  \n\
+  GRID_LOOP (i, n) {                                         \n\
+    TYPE z;                                                  \n\
+    z = data_src [i];                                        \n\
+    data_dst [i] = R_ABS (z);                                \n\
+  }                                                          \n\
 }                                                            \n\
                                                              \n\
                                                              \n\
@@ -1261,13 +3262,15 @@ __kernel void                                                \n\
 ocl_arg                                                      \n\
   (__global TYPE1 *data_dst,                                 \n\
    const __global TYPE *data_src,                            \n\
-   const ulong ofs_src)                                      \n\
+   const ulong ofs_src,                                      \n\
+   const ulong n)                                            \n\
 {                                                            \n\
   data_src += ofs_src;                                       \n\
-  size_t i = get_global_id (0);                              \n\
-  TYPE z;                                                    \n\
-  z = data_src [i];                                          \n\
-  data_dst [i] = R_ARG (z);                                  \n\
+  GRID_LOOP (i, n) {                                         \n\
+    TYPE z;                                                  \n\
+    z = data_src [i];                                        \n\
+    data_dst [i] = R_ARG (z);                                \n\
+  }                                                          \n\
 }                                                            \n\
                                                              \n\
                                                              \n\
@@ -1275,11 +3278,13 @@ __kernel void                                                \n\
 ocl_isfinite                                                 \n\
   (__global TYPE1 *data_dst,                                 \n\
    const __global TYPE *data_src,                            \n\
-   const ulong ofs_src)                                      \n\
+   const ulong ofs_src,                                      \n\
+   const ulong n)                                            \n\
 {                                                            \n\
   data_src += ofs_src;                                       \n\
-  size_t i = get_global_id (0);                              \n\
-  data_dst [i] = all (isfinite (data_src [i]));              \n\
+  GRID_LOOP (i, n) {                                         \n\
+    data_dst [i] = all (isfinite (data_src [i]));            \n\
+  }                                                          \n\
 }                                                            \n\
                                                              \n\
                                                              \n\
@@ -1287,11 +3292,13 @@ __kernel void                                                \n\
 ocl_isinf                                                    \n\
   (__global TYPE1 *data_dst,                                 \n\
    const __global TYPE *data_src,                            \n\
-   const ulong ofs_src)                                      \n\
+   const ulong ofs_src,                                      \n\
+   const ulong n)                                            \n\
 {                                                            \n\
   data_src += ofs_src;                                       \n\
-  size_t i = get_global_id (0);                              \n\
-  data_dst [i] = any (isinf (data_src [i]));                 \n\
+  GRID_LOOP (i, n) {                                         \n\
+    data_dst [i] = any (isinf (data_src [i]));               \n\
+  }                                                          \n\
 }                                                            \n\
                                                              \n\
                                                              \n\
@@ -1299,11 +3306,13 @@ __kernel void                                                \n\
 ocl_isnan                                                    \n\
   (__global TYPE1 *data_dst,                                 \n\
    const __global TYPE *data_src,                            \n\
-   const ulong ofs_src)                                      \n\
+   const ulong ofs_src,                                      \n\
+   const ulong n)                                            \n\
 {                                                            \n\
   data_src += ofs_src;                                       \n\
-  size_t i = get_global_id (0);                              \n\
-  data_dst [i] = any (isnan (data_src [i]));                 \n\
+  GRID_LOOP (i, n) {                                         \n\
+    data_dst [i] = any (isnan (data_src [i]));               \n\
+  }                                                          \n\
 }                                                            \n\
                                                              \n\
                                                              \n\
@@ -1319,21 +3328,23 @@ __kernel void                                                \n\
 ocl_fix                                                      \n\
   (__global TYPE *data_dst,                                  \n\
    const __global TYPE *data_src,                            \n\
-   const ulong ofs_src)                                      \n\
+   const ulong ofs_src,                                      \n\
+   const ulong n)                                            \n\
 {                                                            \n\
   data_src += ofs_src;                                       \n\
-  size_t i = get_global_id (0);                              \n\
-  TYPE v;                                                    \n\
-  v = data_src [i];                                          \n\
-  if (v.x < ZERO1)                                           \n\
-    v.x = ceil (v.x);                                        \n\
-  else                                                       \n\
-    v.x = floor (v.x);                                       \n\
-  if (v.y < ZERO1)                                           \n\
-    v.y = ceil (v.y);                                        \n\
-  else                                                       \n\
-    v.y = floor (v.y);                                       \n\
-  data_dst [i] = v;                                          \n\
+  GRID_LOOP (i, n) {                                         \n\
+    TYPE v;                                                  \n\
+    v = data_src [i];                                        \n\
+    if (v.x < ZERO1)                                         \n\
+      v.x = ceil (v.x);                                      \n\
+    else                                                     \n\
+      v.x = floor (v.x);                                     \n\
+    if (v.y < ZERO1)                                         \n\
+      v.y = ceil (v.y);                                      \n\
+    else                                                     \n\
+      v.y = floor (v.y);                                     \n\
+    data_dst [i] = v;                                        \n\
+  }                                                          \n\
 }                                                            \n\
                                                              \n\
                                                              \n\
@@ -1341,15 +3352,17 @@ __kernel void                                                \n\
 ocl_sign                                                     \n\
   (__global TYPE *data_dst,                                  \n\
    const __global TYPE *data_src,                            \n\
-   const ulong ofs_src)                                      \n\
+   const ulong ofs_src,                                      \n\
+   const ulong n)                                            \n\
 {                                                            \n\
   data_src += ofs_src;                                       \n\
-  size_t i = get_global_id (0);                              \n\
-  TYPE z;                                                    \n\
-  z = data_src [i];                                          \n\
-  if (IS_NE (z, ZERO))                                       \n\
-    z = z / R_ABS (z);                                       \n\
-  data_dst [i] = z;                                          \n\
+  GRID_LOOP (i, n) {                                         \n\
+    TYPE z;                                                  \n\
+    z = data_src [i];                                        \n\
+    if (IS_NE (z, ZERO))                                     \n\
+      z = z / R_ABS (z);                                     \n\
+    data_dst [i] = z;                                        \n\
+  }                                                          \n\
 }                                                            \n\
                                                              \n\
                                                              \n\
@@ -1357,13 +3370,15 @@ __kernel void                                                \n\
 ocl_conj                                                     \n\
   (__global TYPE *data_dst,                                  \n\
    const __global TYPE *data_src,                            \n\
-   const ulong ofs_src)                                      \n\
+   const ulong ofs_src,                                      \n\
+   const ulong n)                                            \n\
 {                                                            \n\
   data_src += ofs_src;                                       \n\
-  size_t i = get_global_id (0);                              \n\
-  TYPE z;                                                    \n\
-  z = data_src [i];                                          \n\
-  data_dst [i] = (TYPE) (z.x, -z.y);                         \n\
+  GRID_LOOP (i, n) {                                         \n\
+    TYPE z;                                                  \n\
+    z = data_src [i];                                        \n\
+    data_dst [i] = (TYPE) (z.x, -z.y);                       \n\
+  }                                                          \n\
 }                                                            \n\
                                                              \n\
                                                              \n\
@@ -1465,13 +3480,15 @@ __kernel void                                                \n\
 ocl_sqrt                                                     \n\
   (__global TYPE *data_dst,                                  \n\
    const __global TYPE *data_src,                            \n\
-   const ulong ofs_src)                                      \n\
+   const ulong ofs_src,                                      \n\
+   const ulong n)                                            \n\
 {                                                            \n\
   data_src += ofs_src;                                       \n\
-  size_t i = get_global_id (0);                              \n\
-  TYPE z, t;                                                 \n\
-  z = data_src [i];                                          \n\
-  data_dst [i] = c_sqrt (z);                                 \n\
+  GRID_LOOP (i, n) {                                         \n\
+    TYPE z, t;                                               \n\
+    z = data_src [i];                                        \n\
+    data_dst [i] = c_sqrt (z);                               \n\
+  }                                                          \n\
 }                                                            \n\
                                                              \n\
                                                              \n\
@@ -1479,13 +3496,15 @@ __kernel void                                                \n\
 ocl_exp                                                      \n\
   (__global TYPE *data_dst,                                  \n\
    const __global TYPE *data_src,                            \n\
-   const ulong ofs_src)                                      \n\
+   const ulong ofs_src,                                      \n\
+   const ulong n)                                            \n\
 {                                                            \n\
   data_src += ofs_src;                                       \n\
-  size_t i = get_global_id (0);                              \n\
-  TYPE z;                                                    \n\
-  z = data_src [i];                                          \n\
-  data_dst [i] = c_exp (z);                                  \n\
+  GRID_LOOP (i, n) {                                         \n\
+    TYPE z;                                                  \n\
+    z = data_src [i];                                        \n\
+    data_dst [i] = c_exp (z);                                \n\
+  }                                                          \n\
 }                                                            \n\
                                                              \n\
                                                              \n\
@@ -1493,13 +3512,15 @@ __kernel void                                                \n\
 ocl_log                                                      \n\
   (__global TYPE *data_dst,                                  \n\
    const __global TYPE *data_src,                            \n\
-   const ulong ofs_src)                                      \n\
+   const ulong ofs_src,                                      \n\
+   const ulong n)                                            \n\
 {                                                            \n\
   data_src += ofs_src;                                       \n\
-  size_t i = get_global_id (0);                              \n\
-  TYPE z;                                                    \n\
-  z = data_src [i];                                          \n\
-  data_dst [i] = c_log (z);                                  \n\
+  GRID_LOOP (i, n) {                                         \n\
+    TYPE z;                                                  \n\
+    z = data_src [i];                                        \n\
+    data_dst [i] = c_log (z);                                \n\
+  }                                                          \n\
 }                                                            \n\
                                                              \n\
                                                              \n\
@@ -1507,13 +3528,15 @@ __kernel void                                                \n\
 ocl_log2                                                     \n\
   (__global TYPE *data_dst,                                  \n\
    const __global TYPE *data_src,                            \n\
-   const ulong ofs_src)                                      \n\
+   const ulong ofs_src,                                      \n\
+   const ulong n)                                            \n\
 {                                                            \n\
   data_src += ofs_src;                                       \n\
-  size_t i = get_global_id (0);                              \n\
-  TYPE z;                                                    \n\
-  z = data_src [i];                                          \n\
-  data_dst [i] = c_log (z) / log ((TYPE1) 2);                \n\
+  GRID_LOOP (i, n) {                                         \n\
+    TYPE z;                                                  \n\
+    z = data_src [i];                                        \n\
+    data_dst [i] = c_log (z) / log ((TYPE1) 2);              \n\
+  }                                                          \n\
 }                                                            \n\
                                                              \n\
                                                              \n\
@@ -1521,13 +3544,15 @@ __kernel void                                                \n\
 ocl_log10                                                    \n\
   (__global TYPE *data_dst,                                  \n\
    const __global TYPE *data_src,                            \n\
-   const ulong ofs_src)                                      \n\
+   const ulong ofs_src,                                      \n\
+   const ulong n)                                            \n\
 {                                                            \n\
   data_src += ofs_src;                                       \n\
-  size_t i = get_global_id (0);                              \n\
-  TYPE z;                                                    \n\
-  z = data_src [i];                                          \n\
-  data_dst [i] = c_log (z) / log ((TYPE1) 10);               \n\
+  GRID_LOOP (i, n) {                                         \n\
+    TYPE z;                                                  \n\
+    z = data_src [i];                                        \n\
+    data_dst [i] = c_log (z) / log ((TYPE1) 10);             \n\
+  }                                                          \n\
 }                                                            \n\
                                                              \n\
                                                              \n\
@@ -1535,13 +3560,15 @@ __kernel void                                                \n\
 ocl_cos                                                      \n\
   (__global TYPE *data_dst,                                  \n\
    const __global TYPE *data_src,                            \n\
-   const ulong ofs_src)                                      \n\
+   const ulong ofs_src,                                      \n\
+   const ulong n)                                            \n\
 {                                                            \n\
   data_src += ofs_src;                                       \n\
-  size_t i = get_global_id (0);                              \n\
-  TYPE z;                                                    \n\
-  z = data_src [i];                                          \n\
-  data_dst [i] = (TYPE) (cos (z.x) * cosh (z.y), -sin (z.x) * sinh (z.y)); \n\
+  GRID_LOOP (i, n) {                                         \n\
+    TYPE z;                                                  \n\
+    z = data_src [i];                                        \n\
+    data_dst [i] = (TYPE) (cos (z.x) * cosh (z.y), -sin (z.x) * sinh (z.y)); \n\
+  }                                                          \n\
 }                                                            \n\
                                                              \n\
                                                              \n\
@@ -1549,13 +3576,15 @@ __kernel void                                                \n\
 ocl_cosh                                                     \n\
   (__global TYPE *data_dst,                                  \n\
    const __global TYPE *data_src,                            \n\
-   const ulong ofs_src)                                      \n\
+   const ulong ofs_src,                                      \n\
+   const ulong n)                                            \n\
 {                                                            \n\
   data_src += ofs_src;                                       \n\
-  size_t i = get_global_id (0);                              \n\
-  TYPE z;                                                    \n\
-  z = data_src [i];                                          \n\
-  data_dst [i] = (TYPE) (cosh (z.x) * cos (z.y), sinh (z.x) * sin (z.y)); \n\
+  GRID_LOOP (i, n) {                                         \n\
+    TYPE z;                                                  \n\
+    z = data_src [i];                                        \n\
+    data_dst [i] = (TYPE) (cosh (z.x) * cos (z.y), sinh (z.x) * sin (z.y)); \n\
+  }                                                          \n\
 }                                                            \n\
                                                              \n\
                                                              \n\
@@ -1563,13 +3592,15 @@ __kernel void                                                \n\
 ocl_sin                                                      \n\
   (__global TYPE *data_dst,                                  \n\
    const __global TYPE *data_src,                            \n\
-   const ulong ofs_src)                                      \n\
+   const ulong ofs_src,                                      \n\
+   const ulong n)                                            \n\
 {                                                            \n\
   data_src += ofs_src;                                       \n\
-  size_t i = get_global_id (0);                              \n\
-  TYPE z;                                                    \n\
-  z = data_src [i];                                          \n\
-  data_dst [i] = (TYPE) (sin (z.x) * cosh (z.y), cos (z.x) * sinh (z.y)); \n\
+  GRID_LOOP (i, n) {                                         \n\
+    TYPE z;                                                  \n\
+    z = data_src [i];                                        \n\
+    data_dst [i] = (TYPE) (sin (z.x) * cosh (z.y), cos (z.x) * sinh (z.y)); \n\
+  }                                                          \n\
 }                                                            \n\
                                                              \n\
                                                              \n\
@@ -1577,13 +3608,15 @@ __kernel void                                                \n\
 ocl_sinh                                                     \n\
   (__global TYPE *data_dst,                                  \n\
    const __global TYPE *data_src,                            \n\
-   const ulong ofs_src)                                      \n\
+   const ulong ofs_src,                                      \n\
+   const ulong n)                                            \n\
 {                                                            \n\
   data_src += ofs_src;                                       \n\
-  size_t i = get_global_id (0);                              \n\
-  TYPE z;                                                    \n\
-  z = data_src [i];                                          \n\
-  data_dst [i] = (TYPE) (sinh (z.x) * cos (z.y), cosh (z.x) * sin (z.y)); \n\
+  GRID_LOOP (i, n) {                                         \n\
+    TYPE z;                                                  \n\
+    z = data_src [i];                                        \n\
+    data_dst [i] = (TYPE) (sinh (z.x) * cos (z.y), cosh (z.x) * sin (z.y)); \n\
+  }                                                          \n\
 }                                                            \n\
                                                              \n\
                                                              \n\
@@ -1591,15 +3624,17 @@ __kernel void                                                \n\
 ocl_tan                                                      \n\
   (__global TYPE *data_dst,                                  \n\
    const __global TYPE *data_src,                            \n\
-   const ulong ofs_src)                                      \n\
+   const ulong ofs_src,                                      \n\
+   const ulong n)                                            \n\
 {                                                            \n\
   data_src += ofs_src;                                       \n\
-  size_t i = get_global_id (0);                              \n\
-  TYPE z, zs, zc;                                            \n\
-  z = data_src [i];                                          \n\
-  zs = (TYPE) (sin (z.x) * cosh (z.y), cos (z.x) * sinh (z.y)); \n\
-  zc = (TYPE) (cos (z.x) * cosh (z.y), -sin (z.x) * sinh (z.y)); \n\
-  data_dst [i] = DIV (zs, zc);                               \n\
+  GRID_LOOP (i, n) {                                         \n\
+    TYPE z, zs, zc;                                          \n\
+    z = data_src [i];                                        \n\
+    zs = (TYPE) (sin (z.x) * cosh (z.y), cos (z.x) * sinh (z.y)); \n\
+    zc = (TYPE) (cos (z.x) * cosh (z.y), -sin (z.x) * sinh (z.y)); \n\
+    data_dst [i] = DIV (zs, zc);                             \n\
+  }                                                          \n\
 }                                                            \n\
                                                              \n\
                                                              \n\
@@ -1607,15 +3642,17 @@ __kernel void                                                \n\
 ocl_tanh                                                     \n\
   (__global TYPE *data_dst,                                  \n\
    const __global TYPE *data_src,                            \n\
-   const ulong ofs_src)                                      \n\
+   const ulong ofs_src,                                      \n\
+   const ulong n)                                            \n\
 {                                                            \n\
   data_src += ofs_src;                                       \n\
-  size_t i = get_global_id (0);                              \n\
-  TYPE z, zs, zc;                                            \n\
-  z = data_src [i];                                          \n\
-  zs = (TYPE) (sinh (z.x) * cos (z.y), cosh (z.x) * sin (z.y)); \n\
-  zc = (TYPE) (cosh (z.x) * cos (z.y), sinh (z.x) * sin (z.y)); \n\
-  data_dst [i] = DIV (zs, zc);                               \n\
+  GRID_LOOP (i, n) {                                         \n\
+    TYPE z, zs, zc;                                          \n\
+    z = data_src [i];                                        \n\
+    zs = (TYPE) (sinh (z.x) * cos (z.y), cosh (z.x) * sin (z.y)); \n\
+    zc = (TYPE) (cosh (z.x) * cos (z.y), sinh (z.x) * sin (z.y)); \n\
+    data_dst [i] = DIV (zs, zc);                             \n\
+  }                                                          \n\
 }                                                            \n\
                                                              \n\
                                                              \n\
@@ -1623,13 +3660,15 @@ __kernel void                                                \n\
 ocl_acos                                                     \n\
   (__global TYPE *data_dst,                                  \n\
    const __global TYPE *data_src,                            \n\
-   const ulong ofs_src)                                      \n\
+   const ulong ofs_src,                                      \n\
+   const ulong n)                                            \n\
 {                                                            \n\
   data_src += ofs_src;                                       \n\
-  size_t i = get_global_id (0);                              \n\
-  TYPE z;                                                    \n\
-  z = data_src [i];                                          \n\
-  data_dst [i] = c_acos (z);                                 \n\
+  GRID_LOOP (i, n) {                                         \n\
+    TYPE z;                                                  \n\
+    z = data_src [i];                                        \n\
+    data_dst [i] = c_acos (z);                               \n\
+  }                                                          \n\
 }                                                            \n\
                                                              \n\
                                                              \n\
@@ -1637,13 +3676,15 @@ __kernel void                                                \n\
 ocl_acosh                                                    \n\
   (__global TYPE *data_dst,                                  \n\
    const __global TYPE *data_src,                            \n\
-   const ulong ofs_src)                                      \n\
+   const ulong ofs_src,                                      \n\
+   const ulong n)                                            \n\
 {                                                            \n\
   data_src += ofs_src;                                       \n\
-  size_t i = get_global_id (0);                              \n\
-  TYPE z;                                                    \n\
-  z = data_src [i];                                          \n\
-  data_dst [i] = c_acosh (z);                                \n\
+  GRID_LOOP (i, n) {                                         \n\
+    TYPE z;                                                  \n\
+    z = data_src [i];                                        \n\
+    data_dst [i] = c_acosh (z);                              \n\
+  }                                                          \n\
 }                                                            \n\
                                                              \n\
                                                              \n\
@@ -1651,13 +3692,15 @@ __kernel void                                                \n\
 ocl_asin                                                     \n\
   (__global TYPE *data_dst,                                  \n\
    const __global TYPE *data_src,                            \n\
-   const ulong ofs_src)                                      \n\
+   const ulong ofs_src,                                      \n\
+   const ulong n)                                            \n\
 {                                                            \n\
   data_src += ofs_src;                                       \n\
-  size_t i = get_global_id (0);                              \n\
-  TYPE z;                                                    \n\
-  z = data_src [i];                                          \n\
-  data_dst [i] = c_asin (z);                                 \n\
+  GRID_LOOP (i, n) {                                         \n\
+    TYPE z;                                                  \n\
+    z = data_src [i];                                        \n\
+    data_dst [i] = c_asin (z);                               \n\
+  }                                                          \n\
 }                                                            \n\
                                                              \n\
                                                              \n\
@@ -1665,13 +3708,15 @@ __kernel void                                                \n\
 ocl_asinh                                                    \n\
   (__global TYPE *data_dst,                                  \n\
    const __global TYPE *data_src,                            \n\
-   const ulong ofs_src)                                      \n\
+   const ulong ofs_src,                                      \n\
+   const ulong n)                                            \n\
 {                                                            \n\
   data_src += ofs_src;                                       \n\
-  size_t i = get_global_id (0);                              \n\
-  TYPE z;                                                    \n\
-  z = data_src [i];                                          \n\
-  data_dst [i] = c_asinh (z);                                \n\
+  GRID_LOOP (i, n) {                                         \n\
+    TYPE z;                                                  \n\
+    z = data_src [i];                                        \n\
+    data_dst [i] = c_asinh (z);                              \n\
+  }                                                          \n\
 }                                                            \n\
                                                              \n\
                                                              \n\
@@ -1679,13 +3724,15 @@ __kernel void                                                \n\
 ocl_atan                                                     \n\
   (__global TYPE *data_dst,                                  \n\
    const __global TYPE *data_src,                            \n\
-   const ulong ofs_src)                                      \n\
+   const ulong ofs_src,                                      \n\
+   const ulong n)                                            \n\
 {                                                            \n\
   data_src += ofs_src;                                       \n\
-  size_t i = get_global_id (0);                              \n\
-  TYPE z;                                                    \n\
-  z = data_src [i];                                          \n\
-  data_dst [i] = c_atan (z);                                 \n\
+  GRID_LOOP (i, n) {                                         \n\
+    TYPE z;                                                  \n\
+    z = data_src [i];                                        \n\
+    data_dst [i] = c_atan (z);                               \n\
+  }                                                          \n\
 }                                                            \n\
                                                              \n\
                                                              \n\
@@ -1693,13 +3740,15 @@ __kernel void                                                \n\
 ocl_atanh                                                    \n\
   (__global TYPE *data_dst,                                  \n\
    const __global TYPE *data_src,                            \n\
-   const ulong ofs_src)                                      \n\
+   const ulong ofs_src,                                      \n\
+   const ulong n)                                            \n\
 {                                                            \n\
   data_src += ofs_src;                                       \n\
-  size_t i = get_global_id (0);                              \n\
-  TYPE z;                                                    \n\
-  z = data_src [i];                                          \n\
-  data_dst [i] = c_atanh (z);                                \n\
+  GRID_LOOP (i, n) {                                         \n\
+    TYPE z;                                                  \n\
+    z = data_src [i];                                        \n\
+    data_dst [i] = c_atanh (z);                              \n\
+  }                                                          \n\
 }                                                            \n\
                                                              \n\
                                                              \n\
@@ -1708,11 +3757,13 @@ ocl_power1e                                                  \n\
   (__global TYPE *data_dst,                                  \n\
    const __global TYPE *data_src,                            \n\
    const ulong ofs_src,                                      \n\
-   const TYPE exponent)                                      \n\
+   const TYPE exponent,                                      \n\
+   const ulong n)                                            \n\
 {                                                            \n\
   data_src += ofs_src;                                       \n\
-  size_t i = get_global_id (0);                              \n\
-  data_dst [i] = c_pow (data_src [i], exponent);             \n\
+  GRID_LOOP (i, n) {                                         \n\
+    data_dst [i] = c_pow (data_src [i], exponent);           \n\
+  }                                                          \n\
 }                                                            \n\
                                                              \n\
                                                              \n\
@@ -1721,11 +3772,13 @@ ocl_power1b                                                  \n\
   (__global TYPE *data_dst,                                  \n\
    const __global TYPE *data_src,                            \n\
    const ulong ofs_src,                                      \n\
-   const TYPE base)                                          \n\
+   const TYPE base,                                          \n\
+   const ulong n)                                            \n\
 {                                                            \n\
   data_src += ofs_src;                                       \n\
-  size_t i = get_global_id (0);                              \n\
-  data_dst [i] = c_pow (base, data_src [i]);                 \n\
+  GRID_LOOP (i, n) {                                         \n\
+    data_dst [i] = c_pow (base, data_src [i]);               \n\
+  }                                                          \n\
 }                                                            \n\
                                                              \n\
                                                              \n\
@@ -1735,12 +3788,14 @@ ocl_power2                                                   \n\
    const __global TYPE *data_src1,                           \n\
    const ulong ofs_src1,                                     \n\
    const __global TYPE *data_src2,                           \n\
-   const ulong ofs_src2)                                     \n\
+   const ulong ofs_src2,                                     \n\
+   const ulong n)                                            \n\
 {                                                            \n\
   data_src1 += ofs_src1;                                     \n\
   data_src2 += ofs_src2;                                     \n\
-  size_t i = get_global_id (0);                              \n\
-  data_dst [i] = c_pow (data_src1 [i], data_src2 [i]);       \n\
+  GRID_LOOP (i, n) {                                         \n\
+    data_dst [i] = c_pow (data_src1 [i], data_src2 [i]);     \n\
+  }                                                          \n\
 }                                                            \n\
                                                              \n\
 #endif                                                       \n\
@@ -1758,12 +3813,14 @@ get_array_prog_kernel_name (OclArrayKernels::Kernel kernel)
     KERNEL_ENTRY( fill0 );
     KERNEL_ENTRY( eye );
     KERNEL_ENTRY( linspace );
+    KERNEL_ENTRY( rand );
     KERNEL_ENTRY( logspace );
     KERNEL_ENTRY( ndgrid1 );
     KERNEL_ENTRY( repmat1 );
-    KERNEL_ENTRY( cat );
+    KERNEL_ENTRY( cat_gather );
     KERNEL_ENTRY( transpose );
     KERNEL_ENTRY( hermitian );
+    KERNEL_ENTRY( permute );
     KERNEL_ENTRY( as_index );
     KERNEL_ENTRY( index );
     KERNEL_ENTRY( assign_el );
@@ -1772,6 +3829,9 @@ get_array_prog_kernel_name (OclArrayKernels::Kernel kernel)
     KERNEL_ENTRY( assign_el_logind );
     KERNEL_ENTRY( findfirst );
     KERNEL_ENTRY( findlast );
+    KERNEL_ENTRY( compact_count );
+    KERNEL_ENTRY( compact_scan );
+    KERNEL_ENTRY( compact_scatter );
     KERNEL_ENTRY( all );
     KERNEL_ENTRY( any );
     KERNEL_ENTRY( sum );
@@ -1781,7 +3841,11 @@ get_array_prog_kernel_name (OclArrayKernels::Kernel kernel)
     KERNEL_ENTRY( cumprod );
     KERNEL_ENTRY( mean );
     KERNEL_ENTRY( meansq );
-    KERNEL_ENTRY( std );
+    KERNEL_ENTRY( var );
+    KERNEL_ENTRY( diff );
+    KERNEL_ENTRY( gradient );
+    KERNEL_ENTRY( trapz );
+    KERNEL_ENTRY( cumtrapz );
     KERNEL_ENTRY( max );
     KERNEL_ENTRY( max2 );
     KERNEL_ENTRY( max1 );
@@ -1803,6 +3867,36 @@ get_array_prog_kernel_name (OclArrayKernels::Kernel kernel)
     KERNEL_ENTRY( mul1 );
     KERNEL_ENTRY( mul2 );
     KERNEL_ENTRY( mtimes );
+    KERNEL_ENTRY( syrk );
+    KERNEL_ENTRY( copy_block );
+    KERNEL_ENTRY( tri );
+    KERNEL_ENTRY( lu_panel );
+    KERNEL_ENTRY( lu_swap );
+    KERNEL_ENTRY( chol_block );
+    KERNEL_ENTRY( trsm_block );
+    KERNEL_ENTRY( bitonic_step );
+    KERNEL_ENTRY( accum_keys );
+    KERNEL_ENTRY( accum_sorted );
+    KERNEL_ENTRY( accum_init );
+    KERNEL_ENTRY( accum_atomic );
+    KERNEL_ENTRY( accum_atomic_local );
+    KERNEL_ENTRY( accum_fill );
+    KERNEL_ENTRY( histc_local );
+    KERNEL_ENTRY( histc_keys );
+    KERNEL_ENTRY( histc_sorted );
+    KERNEL_ENTRY( histc_store );
+    KERNEL_ENTRY( pagemtimes );
+    KERNEL_ENTRY( csr_mtimes );
+    KERNEL_ENTRY( conv1 );
+    KERNEL_ENTRY( conv2 );
+    KERNEL_ENTRY( iir_chunk );
+    KERNEL_ENTRY( iir_carry );
+    KERNEL_ENTRY( fft_resize );
+    KERNEL_ENTRY( fft_stage );
+    KERNEL_ENTRY( fft_chirp_pre );
+    KERNEL_ENTRY( fft_chirp_filter );
+    KERNEL_ENTRY( fft_chirp_mul );
+    KERNEL_ENTRY( fft_chirp_post );
     KERNEL_ENTRY( div1n );
     KERNEL_ENTRY( div1d );
     KERNEL_ENTRY( div2 );
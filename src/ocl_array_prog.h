@@ -30,12 +30,14 @@ namespace OclArrayKernels
     fill0,
     eye,
     linspace,
+    rand,
     logspace,
     ndgrid1,
     repmat1,
-    cat,
+    cat_gather,
     transpose,
     hermitian,
+    permute,
     as_index,
     index,
     assign_el,
@@ -44,6 +46,9 @@ namespace OclArrayKernels
     assign_el_logind,
     findfirst,
     findlast,
+    compact_count,
+    compact_scan,
+    compact_scatter,
     all,
     any,
     sum,
@@ -53,7 +58,11 @@ namespace OclArrayKernels
     cumprod,
     mean,
     meansq,
-    std,
+    var,
+    diff,
+    gradient,
+    trapz,
+    cumtrapz,
     max,
     max2,
     max1,
@@ -75,6 +84,36 @@ namespace OclArrayKernels
     mul1,
     mul2,
     mtimes,
+    syrk,
+    copy_block,
+    tri,
+    lu_panel,
+    lu_swap,
+    chol_block,
+    trsm_block,
+    bitonic_step,
+    accum_keys,
+    accum_sorted,
+    accum_init,
+    accum_atomic,
+    accum_atomic_local,
+    accum_fill,
+    histc_local,
+    histc_keys,
+    histc_sorted,
+    histc_store,
+    pagemtimes,
+    csr_mtimes,
+    conv1,
+    conv2,
+    iir_chunk,
+    iir_carry,
+    fft_resize,
+    fft_stage,
+    fft_chirp_pre,
+    fft_chirp_filter,
+    fft_chirp_mul,
+    fft_chirp_post,
     div1n,
     div1d,
     div2,
@@ -556,6 +556,7 @@ static bool active_opencl_context_is_fp64 = false;
 
 static cl_context context = 0;
 static cl_command_queue command_queue = 0;
+static cl_command_queue transfer_queue = 0;
 
 static unsigned long active_opencl_context_id = 0;
 static unsigned long next_opencl_context_id = 1;
@@ -606,12 +607,15 @@ void
 destroy_opencl_context (void)
 {
   if (opencl_library_loaded () && opencl_context_active ()) {
+    if (transfer_queue != 0)
+      last_error = clReleaseCommandQueue (transfer_queue);
     last_error = clReleaseCommandQueue (command_queue);
     last_error = clReleaseContext (context);
     platform_id = 0;
     device_id = 0;
     context = 0;
     command_queue = 0;
+    transfer_queue = 0;
     active_opencl_context_id = 0;
     active_opencl_context_is_fp64 = false;
     reset_memmgr ();
@@ -647,6 +651,31 @@ get_command_queue (void)
 }
 
 
+cl_command_queue
+get_transfer_queue (void)
+{
+  // a second in-order queue of the active context, for host transfers
+  // overlapping with the kernels in the command queue (synchronized by
+  // events); only created on first use
+  if ((transfer_queue == 0) && opencl_context_active ()) {
+    transfer_queue = clCreateCommandQueue (context, device_id, 0, & last_error);
+    if (last_error != CL_SUCCESS)
+      transfer_queue = 0;
+    ocl_check_error ("clCreateCommandQueue");
+  }
+  return transfer_queue;
+}
+
+
+void
+finish_transfer_queue (void)
+{
+  // wait for the pending transfers, if the transfer queue is in use
+  if (transfer_queue != 0)
+    clFinish (transfer_queue);
+}
+
+
 unsigned long
 opencl_context_id (void)
 {
@@ -700,6 +729,7 @@ DEFUN_DLD (ocl_context, args, nargout,
 "-*- texinfo -*-\n\
 @deftypefn  {Loadable Function} ocl_context (@qcode{\"assure\"}) \n\
 @deftypefnx {Loadable Function} ocl_context (@qcode{\"destroy\"}) \n\
+@deftypefnx {Loadable Function} ocl_context (@qcode{\"clear\"}) \n\
 @deftypefnx {Loadable Function} {[@var{active}, [@var{fp64}]] =} \
  ocl_context (@qcode{\"active\"}) \n\
 @deftypefnx {Loadable Function} {[@var{activeid}, [@var{fp64}]] =} \
@@ -708,6 +738,8 @@ DEFUN_DLD (ocl_context, args, nargout,
  ocl_context (@qcode{\"get_resources\"}) \n\
 @deftypefnx {Loadable Function} {[@var{selection}] =} \
  ocl_context (@qcode{\"device_selection\"}, [@var{str}]) \n\
+@deftypefnx {Loadable Function} {@var{usage} =} \
+ ocl_context (@qcode{\"memory_usage\"}, [@qcode{\"reset\"}]) \n\
 \n\
 Manage the OpenCL Context.  \n\
 \n\
@@ -727,6 +759,16 @@ Second, all OCL or octave objects which rely on these deleted OpenCL objects \n\
 and which remain in octave \n\
 memory are made inoperable and will produce an error when used afterwards.  \n\
 \n\
+@code{ocl_context (\"clear\")} releases OpenCL memory kept by OCL for reuse, \n\
+without affecting any OCL objects: the cached plans of fft (with device data \n\
+for transform lengths with prime factors other than 2, 3, 5 and 7), and the \n\
+OpenCL buffers retained in OCL's pool (except reserved ones, see \n\
+@code{ocl_memory_plan}).  \n\
+In interactive sessions, this is done automatically after @code{clear all} \n\
+while octave waits for input; scripts and @code{octave --eval} runs should \n\
+call @code{ocl_context (\"clear\")} after @code{clear all} instead.  \n\
+If no OpenCL context is active, @code{ocl_context} has no effect.  \n\
+\n\
 @code{ocl_context (\"active\")} returns whether an OpenCL context is currently active.  \n\
 A nonzero value @var{active} means that a context is currently active.  \n\
 A nonzero value of the optional output variable @var{fp64} means that the active context \n\
@@ -811,6 +853,19 @@ with an error at this point.  \n\
 Otherwise, @var{selection} returns a 2x1 array containing the platform and \n\
 device index (starting from zero; as counted in the @var{resources} fields).  \n\
 \n\
+@code{ocl_context (\"memory_usage\")} returns the accounting of OpenCL memory used \n\
+by OCL in the active context, as a struct @var{usage} with the fields \n\
+@code{live_objects} and @code{live_bytes} (all existing OpenCL memory objects), \n\
+@code{device_bytes} (the part currently in device memory), @code{pooled_bytes} \n\
+(released but retained buffers), @code{spilled_bytes} (the part spilled to host memory), \n\
+@code{peak_bytes} (the high-water mark of assigned and retained device memory), \n\
+@code{global_mem_size} (of the device), @code{by_type} (a struct array with the \n\
+fields @code{type}, @code{objects} and @code{bytes} per element type), and \n\
+@code{by_size} (rows of lower size bound, number of objects and bytes, for \n\
+sizes grouped by powers of two).  \n\
+@code{ocl_context (\"memory_usage\", \"reset\")} resets the high-water mark \n\
+to the current device memory usage.  \n\
+\n\
 The first four subfunctions of @code{ocl_context} only need to be called explicitly \n\
 in rare situations, since many other (\"higher\") OCL functions call them internally.  \n\
 These subfunctions are provided mainly for testing.  \n\
@@ -906,6 +961,14 @@ Note that @code{ocl_context (\"assure\")}, @code{ocl_context (\"get_resources\")
 
     destroy_opencl_context ();
 
+  } else if (fcn == "clear") {
+
+    if (nargin > 1)
+      ocl_error ("clear: too many arguments");
+
+    if (opencl_context_active ())
+      ocl_memobj_clear ();
+
   } else if (fcn == "active") {
 
     if (nargin > 1)
@@ -916,6 +979,20 @@ Note that @code{ocl_context (\"assure\")}, @code{ocl_context (\"get_resources\")
     if (nargout > 1)
       retval (1) = octave_value (double (opencl_context_is_fp64 ()));
 
+  } else if (fcn == "memory_usage") {
+
+    if (nargin > 2)
+      ocl_error ("memory_usage: too many arguments");
+
+    if (nargin > 1) {
+      if (! (args (1).is_string () && (args (1).string_value () == "reset")))
+        ocl_error ("memory_usage: second argument must be \"reset\", if given");
+      ocl_memobj_reset_peak ();
+    }
+
+    if ((nargout > 0) || (nargin == 1))
+      retval (0) = ocl_memobj_usage ();
+
   } else if (fcn == "active_id") {
 
     if (nargin > 1)
@@ -176,6 +176,8 @@ extern cl_platform_id get_platform_id (void);
 extern cl_device_id get_device_id (void);
 extern cl_context get_context (void);
 extern cl_command_queue get_command_queue (void);
+extern cl_command_queue get_transfer_queue (void);
+extern void finish_transfer_queue (void);
 extern unsigned long opencl_context_id (void);
 extern bool opencl_context_active (void);
 extern bool opencl_context_id_active (unsigned long);
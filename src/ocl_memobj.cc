@@ -18,11 +18,26 @@
  *
  */
 
+#include "ocl_octave_versions.h"
 #include "ocl_memobj.h"
 #include "ocl_lib.h"
 #include <list>
 #include <map>
+#include <set>
+#include <new>
+#include <algorithm>
+#include <cstring>
+#include <ctime>
+#include <cmath>
 #include <octave/oct.h>
+#include <octave/parse.h>
+
+
+#if ! defined (OCL_OCTAVE_VERSION_4_4_0_AND_HIGHER) // for octave versions < 4.4.0
+#define OCL_FEVAL feval
+#else // for octave versions >= 4.4.0
+#define OCL_FEVAL octave::feval
+#endif
 
 
 // ---------- static variables
@@ -31,9 +46,10 @@
 // a pool of retained OpenCL memory buffer handles,
 // only for the currently active context
 // (as opposed to OclMemoryObject objects, which may remain
-// in octave memory but become inoperable)
+// in octave memory but become inoperable);
+// each buffer with the time it was retained, the most recent at the back
 
-typedef std::list<cl_mem> OclMemobjSizedPool_t;
+typedef std::list< std::pair<cl_mem, time_t> > OclMemobjSizedPool_t;
 typedef std::map<size_t, OclMemobjSizedPool_t> OclMemobjPool_t;
 
 static OclMemobjPool_t memobj_pool;
@@ -42,14 +58,131 @@ static OclMemobjPool_t memobj_pool;
 static size_t max_sized_memobj_pool_objs = 3;
 
 
+// retention policy: when the last assigned memory object is released, the pool
+// is trimmed down to pool_retain_bytes (instead of being emptied), so that loops
+// creating and dropping their only OCL arrays keep reusing the retained buffers;
+// buffers not reused for pool_idle_seconds (zero meaning never) are released,
+// as are all retained buffers once no memory objects are left and octave waits
+// for input (e.g., after "clear all")
+
+static size_t pool_retain_bytes = 256 << 20;
+static double pool_idle_seconds = 10;
+
+static bool pool_idle_hook_registered = false;
+
+
+// reservations: a minimum number of retained buffers per size, e.g. for
+// a latency-critical phase; reserved buffers are kept by all trimming of
+// the pool, and only released if an allocation would fail otherwise
+
+static std::map<size_t, size_t> reserved_memobj_counts;
+
+
 // a list of assigned (and not retained) memory objects, in order to remember their sizes
 
 static std::map<cl_mem, size_t> assigned_ocl_memobjs;
 
 
+// all memory objects of the currently active context, resident on the device
+// or spilled to host memory; least recently used objects are spilled when
+// an allocation fails or the device memory budget would be exceeded
+
+static std::set<const OclMemoryObject *> live_ocl_memobjs;
+
+
+// a clock for the least recently used order; objects used at the current
+// time are pinned on the device (they may be arguments of a pending command)
+
+static uint64_t memobj_use_clock = 1;
+
+
+// holders (kernels whose arguments are being set) keep the clock from
+// advancing: the objects bound to their arguments stay pinned, even across
+// other commands enqueued meanwhile, until the kernel itself is enqueued
+
+static std::set<const void *> memobj_pin_holders;
+
+
+// spilling settings: budgets in bytes, zero meaning no limit
+// (the device budget is a soft limit: if nothing can be spilled any more,
+// the allocation is attempted anyway)
+
+static bool memobj_spilling = true;
+static bool memobj_lazy_load = false;
+static size_t device_memory_budget = 0;
+static size_t host_memory_budget = 0;
+
+
+// byte counts and spilling counters
+
+static size_t assigned_bytes = 0;
+static size_t pooled_bytes = 0;
+static size_t spilled_bytes = 0;
+
+static uint64_t num_spills = 0;
+static uint64_t num_spilled_bytes = 0;
+static uint64_t num_page_ins = 0;
+static uint64_t num_paged_in_bytes = 0;
+
+static uint64_t num_pool_hits = 0;
+static uint64_t num_pool_misses = 0;
+static uint64_t num_pool_trimmed = 0;
+
+
+// memory usage accounting of the live memory objects, by element type
+// (keyed by the static type string) and by size bucket (bucket k holding
+// sizes from 2^k to 2^(k+1)-1 bytes), and the high-water mark of the
+// device memory held (assigned and retained buffers)
+
+struct OclMemobjUsage_t
+{
+  OclMemobjUsage_t (void) : objs (0), bytes (0) { }
+  uint64_t objs;
+  uint64_t bytes;
+};
+
+static const int num_size_buckets = 64;
+
+static std::map<const char *, OclMemobjUsage_t> memobj_usage_by_type;
+static OclMemobjUsage_t memobj_usage_by_size[num_size_buckets];
+static OclMemobjUsage_t memobj_usage_live;
+
+static size_t peak_device_bytes = 0;
+
+
 // ---------- static functions
 
 
+static
+void
+account_memobj (const char *type_str, size_t size, bool add)
+{
+  int k = 0;
+  while ((k < num_size_buckets - 1) && ((size >> (k + 1)) > 0))
+    k++;
+
+  OclMemobjUsage_t *u[3] = { & memobj_usage_live, & memobj_usage_by_type[type_str], & memobj_usage_by_size[k] };
+  for (int i = 0; i < 3; i++) {
+    if (add) {
+      u[i]->objs++;
+      u[i]->bytes += size;
+    } else {
+      u[i]->objs--;
+      u[i]->bytes -= size;
+    }
+  }
+}
+
+
+static
+void
+update_peak_device_bytes (void)
+{
+  if (assigned_bytes + pooled_bytes > peak_device_bytes)
+    peak_device_bytes = assigned_bytes + pooled_bytes;
+}
+
+
 static
 cl_mem
 new_ocl_buffer (size_t size)
@@ -72,6 +205,134 @@ delete_ocl_buffer (cl_mem mem_obj)
 }
 
 
+static
+size_t
+reserved_count (size_t size)
+{
+  std::map<size_t, size_t>::const_iterator it = reserved_memobj_counts.find (size);
+  return (it == reserved_memobj_counts.end ()) ? 0 : it->second;
+}
+
+
+static
+bool
+release_largest_pooled_buffer (bool keep_reserved = false)
+{
+  OclMemobjPool_t::reverse_iterator it = memobj_pool.rbegin ();
+  if (keep_reserved)
+    while ((it != memobj_pool.rend ()) && (it->second.size () <= reserved_count (it->first)))
+      it++;
+  if (it == memobj_pool.rend ())
+    return false;
+
+  size_t sizemax = it->first;
+  OclMemobjSizedPool_t sp = memobj_pool[sizemax];
+  cl_mem mem_obj = sp.back ().first;
+  sp.pop_back ();
+  if (sp.empty ())
+    memobj_pool.erase (sizemax);
+  else
+    memobj_pool[sizemax] = sp;
+  pooled_bytes -= sizemax;
+  num_pool_trimmed++;
+  delete_ocl_buffer (mem_obj);
+  return true;
+}
+
+
+static
+void
+trim_pool (size_t max_bytes)
+{
+  // release retained (and not reserved) buffers, largest first, down to max_bytes
+  while ((pooled_bytes > max_bytes) && release_largest_pooled_buffer (true))
+    ;
+}
+
+
+static
+void
+trim_idle_pool (void)
+{
+  // release retained buffers which have not been reused for pool_idle_seconds
+
+  if (pool_idle_seconds <= 0)
+    return;
+
+  time_t now = std::time (0);
+  OclMemobjPool_t::iterator it = memobj_pool.begin ();
+  while (it != memobj_pool.end ()) {
+    OclMemobjSizedPool_t& sp = it->second;
+    size_t nkeep = reserved_count (it->first);
+    while ((sp.size () > nkeep) && (std::difftime (now, sp.front ().second) >= pool_idle_seconds)) {
+      delete_ocl_buffer (sp.front ().first);
+      sp.pop_front ();
+      pooled_bytes -= it->first;
+      num_pool_trimmed++;
+    }
+    if (sp.empty ())
+      memobj_pool.erase (it++);
+    else
+      it++;
+  }
+}
+
+
+static
+void
+register_pool_idle_hook (void)
+{
+  // have octave call '__ocl_memmgr__ ("idle")' while waiting for input;
+  // the hook removes itself once no buffers are left
+  if (pool_idle_hook_registered)
+    return;
+
+  octave_value_list args;
+  args(0) = octave_value ("__ocl_memmgr__");
+  args(1) = octave_value ("idle");
+  OCL_FEVAL ("add_input_event_hook", args, 0);
+  pool_idle_hook_registered = true;
+}
+
+
+static
+void
+unregister_pool_idle_hook (void)
+{
+  if (! pool_idle_hook_registered)
+    return;
+
+  octave_value_list args;
+  args(0) = octave_value ("__ocl_memmgr__");
+  OCL_FEVAL ("remove_input_event_hook", args, 0);
+  pool_idle_hook_registered = false;
+}
+
+
+static
+bool
+spill_lru_memobj (void)
+{
+  // spill the least recently used memory object which is not pinned
+
+  if (! memobj_spilling)
+    return false;
+
+  const OclMemoryObject *lru = 0;
+  for (std::set<const OclMemoryObject *>::iterator it = live_ocl_memobjs.begin (); it != live_ocl_memobjs.end (); it++) {
+    const OclMemoryObject *m = *it;
+    if (m->is_spilled () || (m->get_last_use () >= memobj_use_clock))
+      continue;
+    if ((host_memory_budget > 0) && (spilled_bytes + m->get_size () > host_memory_budget))
+      continue;
+    if ((lru == 0) || (m->get_last_use () < lru->get_last_use ()))
+      lru = m;
+  }
+
+  return (lru != 0) && lru->spill_to_host ();
+}
+
+
 static
 cl_mem
 obtain_ocl_buffer (size_t size)
@@ -80,41 +341,90 @@ obtain_ocl_buffer (size_t size)
 
   // TODO: possibly also return a retained buffer which is slightly larger than requested; conditions?
 
+  register_pool_idle_hook ();
+  trim_idle_pool ();
+
   cl_mem mem_obj;
   if (memobj_pool.count (size) == 0) { // allocate new buffer (since pool of buffers of this size is empty)
+    num_pool_misses++;
+    if (device_memory_budget > 0)
+      while ((assigned_bytes + pooled_bytes + size > device_memory_budget) &&
+             (release_largest_pooled_buffer (true) || spill_lru_memobj ()))
+        ;
+
     while (1) {
       mem_obj = new_ocl_buffer (size);
-      if ((last_error == CL_SUCCESS) || (memobj_pool.empty ()))
+      if (last_error == CL_SUCCESS)
         break;
 
-      // allocation of new buffer failed, release a large retained one and retry
-      size_t sizemax = memobj_pool.rbegin ()->first;
-      OclMemobjSizedPool_t sp = memobj_pool[sizemax];
-      mem_obj = sp.back ();
-      sp.pop_back ();
-      if (sp.empty ())
-        memobj_pool.erase (sizemax);
-      else
-        memobj_pool[sizemax] = sp;
-      delete_ocl_buffer (mem_obj);
+      // allocation of new buffer failed, release a large retained one
+      // or spill the least recently used memory object, and retry
+      if (! (release_largest_pooled_buffer () || spill_lru_memobj ()))
+        break;
     }
 
     ocl_check_error ("clCreateBuffer");
     // successfully allocated the buffer
   } else { // a non-empty pool entry exists, reuse a retained memory object
     OclMemobjSizedPool_t sp = memobj_pool[size];
-    mem_obj = sp.back ();
+    mem_obj = sp.back ().first;
     sp.pop_back ();
     if (sp.empty ())
       memobj_pool.erase (size);
     else
       memobj_pool[size] = sp;
+    pooled_bytes -= size;
+    num_pool_hits++;
   }
   assigned_ocl_memobjs[mem_obj] = size;
+  assigned_bytes += size;
+  update_peak_device_bytes ();
   return mem_obj;
 }
 
 
+static
+size_t
+pooled_bytes_of_reserved_sizes (bool reserved_only)
+{
+  // retained bytes in buffers of reserved sizes (all of them, or only up
+  // to the reserved number per size)
+  size_t bytes = 0;
+  for (std::map<size_t, size_t>::const_iterator it = reserved_memobj_counts.begin (); it != reserved_memobj_counts.end (); it++) {
+    OclMemobjPool_t::const_iterator p = memobj_pool.find (it->first);
+    if (p == memobj_pool.end ())
+      continue;
+    size_t count = reserved_only ? std::min (p->second.size (), it->second) : p->second.size ();
+    bytes += it->first * count;
+  }
+  return bytes;
+}
+
+
+static
+double
+pool_fragmentation (void)
+{
+  // as retained buffers are only reused for their exact size: the fraction
+  // of retained bytes which cannot serve any of the reserved sizes (zero
+  // without reservations, i.e., without a plan of sizes to serve)
+  if ((pooled_bytes == 0) || reserved_memobj_counts.empty ())
+    return 0;
+  return 1 - double (pooled_bytes_of_reserved_sizes (false)) / double (pooled_bytes);
+}
+
+
+static
+size_t
+reserved_bytes (void)
+{
+  size_t bytes = 0;
+  for (std::map<size_t, size_t>::const_iterator it = reserved_memobj_counts.begin (); it != reserved_memobj_counts.end (); it++)
+    bytes += it->first * it->second;
+  return bytes;
+}
+
+
 static
 void
 release_ocl_buffer (cl_mem mem_obj)
@@ -127,18 +437,7 @@ release_ocl_buffer (cl_mem mem_obj)
   }
   size_t size  = assigned_ocl_memobjs[mem_obj];
   assigned_ocl_memobjs.erase (mem_obj);
-
-  if (assigned_ocl_memobjs.empty ()) {
-    // deletion of last assigned memory object: delete all retained buffers
-    // i.e., the octave command "clear" also empties the pool of retained buffers
-    // (OCL matrix objects should never be assigned to persistent variables)
-    delete_ocl_buffer (mem_obj);
-    for (OclMemobjPool_t::iterator it1 = memobj_pool.begin (); it1 != memobj_pool.end (); it1++)
-      for (OclMemobjSizedPool_t::iterator it2 = it1->second.begin (); it2 != it1->second.end (); it2++)
-        delete_ocl_buffer (*it2);
-    memobj_pool.clear ();
-    return;
-  }
+  assigned_bytes -= size;
 
   size_t count;
   if (memobj_pool.count (size) == 0)
@@ -146,14 +445,35 @@ release_ocl_buffer (cl_mem mem_obj)
   else
     count = memobj_pool[size].size ();
 
-  if (count >= max_sized_memobj_pool_objs) { // already many buffers retained
+  if (count >= std::max (max_sized_memobj_pool_objs, reserved_count (size))) { // already many buffers retained
     delete_ocl_buffer (mem_obj);
   } else { // retain buffer
-    memobj_pool[size].push_back (mem_obj);
+    memobj_pool[size].push_back (std::make_pair (mem_obj, std::time (0)));
+    pooled_bytes += size;
+  }
+
+  if (assigned_ocl_memobjs.empty ()) {
+    // deletion of last assigned memory object: retain buffers only up to
+    // pool_retain_bytes; the remaining ones are released by the idle hook,
+    // i.e., the octave command "clear" still empties the pool of retained buffers
+    // (OCL matrix objects should never be assigned to persistent variables)
+    trim_pool (pool_retain_bytes);
   }
 }
 
 
+static
+size_t
+byte_count_arg (const octave_value& v, const char *fcn)
+{
+  // a user given number of bytes, rejecting values which cannot be converted
+  double d = v.double_value ();
+  if ((! (d >= 0)) || (d >= 18446744073709551616.0)) // also NaN and Inf
+    ocl_error ("__ocl_memmgr__: %s: byte counts must be non-negative and finite", fcn);
+  return static_cast<size_t> (d);
+}
+
+
 // ---------- public functions
 
 
@@ -163,27 +483,236 @@ void reset_memmgr (void)
   // no OpenCL library calls needed, so no querying of "opencl_library_loaded" needed
   assigned_ocl_memobjs.clear ();
   memobj_pool.clear ();
+  live_ocl_memobjs.clear ();
+  reserved_memobj_counts.clear ();
+  memobj_pin_holders.clear ();
+  memobj_usage_by_type.clear ();
+  for (int k = 0; k < num_size_buckets; k++)
+    memobj_usage_by_size[k] = OclMemobjUsage_t ();
+  memobj_usage_live = OclMemobjUsage_t ();
+  assigned_bytes = 0;
+  pooled_bytes = 0;
+  spilled_bytes = 0;
+  peak_device_bytes = 0;
+  unregister_pool_idle_hook ();
+}
+
+
+void ocl_memobj_hold_pins (const void *holder)
+{
+  memobj_pin_holders.insert (holder);
+}
+
+
+void ocl_memobj_release_pins (const void *holder, bool unpin)
+{
+  if (holder != 0)
+    memobj_pin_holders.erase (holder);
+  if (unpin && memobj_pin_holders.empty ())
+    memobj_use_clock++;
+}
+
+
+bool ocl_memobj_lazy_load (void)
+{
+  return memobj_lazy_load;
+}
+
+
+octave_value ocl_memobj_usage (void)
+{
+  octave_scalar_map m;
+
+  m.assign ("live_objects", octave_value (double (memobj_usage_live.objs)));
+  m.assign ("live_bytes", octave_value (double (memobj_usage_live.bytes)));
+  m.assign ("device_bytes", octave_value (double (assigned_bytes)));
+  m.assign ("pooled_bytes", octave_value (double (pooled_bytes)));
+  m.assign ("spilled_bytes", octave_value (double (spilled_bytes)));
+  m.assign ("peak_bytes", octave_value (double (peak_device_bytes)));
+
+  cl_ulong global_mem = 0;
+  if (opencl_context_active ())
+    clGetDeviceInfo (get_device_id (), CL_DEVICE_GLOBAL_MEM_SIZE, sizeof (cl_ulong), & global_mem, 0);
+  m.assign ("global_mem_size", octave_value (double (global_mem)));
+
+  // element types with live memory objects: a struct array
+  std::map<const char *, OclMemobjUsage_t>::iterator it;
+  octave_idx_type n = 0;
+  for (it = memobj_usage_by_type.begin (); it != memobj_usage_by_type.end (); it++)
+    if (it->second.objs > 0)
+      n++;
+  Cell types (dim_vector (n, 1));
+  Cell objs (dim_vector (n, 1));
+  Cell bytes (dim_vector (n, 1));
+  octave_idx_type i = 0;
+  for (it = memobj_usage_by_type.begin (); it != memobj_usage_by_type.end (); it++)
+    if (it->second.objs > 0) {
+      types(i) = octave_value (std::string (it->first ? it->first : "unknown"));
+      objs(i) = octave_value (double (it->second.objs));
+      bytes(i++) = octave_value (double (it->second.bytes));
+    }
+  octave_map by_type (dim_vector (n, 1));
+  by_type.assign ("type", types);
+  by_type.assign ("objects", objs);
+  by_type.assign ("bytes", bytes);
+  m.assign ("by_type", octave_value (by_type));
+
+  // non-empty size buckets: rows of lower size bound, objects and bytes
+  n = 0;
+  for (int k = 0; k < num_size_buckets; k++)
+    if (memobj_usage_by_size[k].objs > 0)
+      n++;
+  Matrix by_size (n, 3);
+  i = 0;
+  for (int k = 0; k < num_size_buckets; k++)
+    if (memobj_usage_by_size[k].objs > 0) {
+      by_size(i  ,0) = std::ldexp (1.0, k);
+      by_size(i  ,1) = memobj_usage_by_size[k].objs;
+      by_size(i++,2) = memobj_usage_by_size[k].bytes;
+    }
+  m.assign ("by_size", octave_value (by_size));
+
+  return octave_value (m);
+}
+
+
+void ocl_memobj_reset_peak (void)
+{
+  peak_device_bytes = assigned_bytes + pooled_bytes;
+}
+
+
+void ocl_memobj_clear (void)
+{
+  // release the cached data and all retained (and not reserved) buffers;
+  // unlike the idle hook, this also works in non-interactive sessions
+  ocl_array_clear_caches ();
+  trim_pool (0);
+  if (live_ocl_memobjs.empty () && (pooled_bytes == pooled_bytes_of_reserved_sizes (true)))
+    unregister_pool_idle_hook ();
 }
 
 
 // ---------- OclMemoryObject members
 
 
-OclMemoryObject::OclMemoryObject (size_t size)
-  : OclContextObject (true)
+OclMemoryObject::OclMemoryObject (size_t size, const char *type_str)
+  : OclContextObject (true), ocl_mem_buffer (0), mem_size (size),
+    host_copy (0), last_use (memobj_use_clock), mem_type (type_str)
 {
   if (size <= 0)
     ocl_error ("OclArray: requesting empty buffer");
 
   // we know: size > 0, and OpenCL context is active
   ocl_mem_buffer = (void *) obtain_ocl_buffer (size);
+  live_ocl_memobjs.insert (this);
+  account_memobj (mem_type, mem_size, true);
+}
+
+
+OclMemoryObject::OclMemoryObject (size_t size, const void *host_data, const char *type_str)
+  : OclContextObject (true), ocl_mem_buffer (0), mem_size (size),
+    host_copy (0), last_use (memobj_use_clock), mem_type (type_str)
+{
+  if (size <= 0)
+    ocl_error ("OclArray: requesting empty buffer");
+
+  host_copy = new char [size];
+  std::memcpy (host_copy, host_data, size);
+  spilled_bytes += size;
+  live_ocl_memobjs.insert (this);
+  account_memobj (mem_type, mem_size, true);
 }
 
 
 OclMemoryObject::~OclMemoryObject ()
 {
-  if (object_context_still_valid ())
-    release_ocl_buffer ((cl_mem) ocl_mem_buffer);
+  if (object_context_still_valid ()) {
+    live_ocl_memobjs.erase (this);
+    account_memobj (mem_type, mem_size, false);
+    if (is_spilled ())
+      spilled_bytes -= mem_size;
+    else
+      release_ocl_buffer ((cl_mem) ocl_mem_buffer);
+  }
+  delete [] host_copy;
+}
+
+
+void *
+OclMemoryObject::get_ocl_buffer (void) const
+{
+  last_use = memobj_use_clock;
+  if (is_spilled () && object_context_still_valid ())
+    page_in ();
+  return ocl_mem_buffer;
+}
+
+
+bool
+OclMemoryObject::spill_to_host (void) const
+{
+  if (is_spilled ())
+    return true;
+
+  char *h = new (std::nothrow) char [mem_size];
+  if (h == 0)
+    return false;
+
+  // an upload into the buffer may still be pending in the transfer queue
+  finish_transfer_queue ();
+  last_error = clEnqueueReadBuffer (get_command_queue (),
+                                    (cl_mem) ocl_mem_buffer,
+                                    CL_TRUE,
+                                    0,
+                                    mem_size,
+                                    h,
+                                    0, 0, 0);
+  if (last_error != CL_SUCCESS)
+    delete [] h;
+  ocl_check_error ("clEnqueueReadBuffer");
+
+  // the buffer is neither assigned any more nor retained in the pool
+  assigned_ocl_memobjs.erase ((cl_mem) ocl_mem_buffer);
+  assigned_bytes -= mem_size;
+  delete_ocl_buffer ((cl_mem) ocl_mem_buffer);
+  ocl_mem_buffer = 0;
+  host_copy = h;
+
+  spilled_bytes += mem_size;
+  num_spills++;
+  num_spilled_bytes += mem_size;
+  return true;
+}
+
+
+void
+OclMemoryObject::page_in (void) const
+{
+  // may in turn spill other (not pinned) memory objects
+  cl_mem mem_obj = obtain_ocl_buffer (mem_size);
+
+  last_error = clEnqueueWriteBuffer (get_command_queue (),
+                                     mem_obj,
+                                     CL_TRUE,
+                                     0,
+                                     mem_size,
+                                     host_copy,
+                                     0, 0, 0);
+  if (last_error != CL_SUCCESS) {
+    cl_int err = last_error;
+    release_ocl_buffer (mem_obj);
+    last_error = err;
+  }
+  ocl_check_error ("clEnqueueWriteBuffer");
+
+  ocl_mem_buffer = (void *) mem_obj;
+  delete [] host_copy;
+  host_copy = 0;
+
+  spilled_bytes -= mem_size;
+  num_page_ins++;
+  num_paged_in_bytes += mem_size;
 }
 
 
@@ -226,6 +755,211 @@ DEFUN_DLD (__ocl_memmgr__, args, nargout,
     }
     retval = octave_value (m);
 
+  } else if (fcn == "spill") {
+
+    // handle spilling of least recently used memory objects to host memory
+
+    if (nargout > 0)
+      retval = octave_value (memobj_spilling);
+    if (nargin > 1)
+      memobj_spilling = args (1).bool_value ();
+
+  } else if (fcn == "lazyload") {
+
+    // handle lazy uploading of loaded OCL arrays (on first use)
+
+    if (nargout > 0)
+      retval = octave_value (memobj_lazy_load);
+    if (nargin > 1)
+      memobj_lazy_load = args (1).bool_value ();
+
+  } else if (fcn == "budget") {
+
+    // handle device and host memory budgets for spilling (in bytes, 0 for no limit)
+
+    if (nargout > 0) {
+      Matrix m(1, 2);
+      m(0) = device_memory_budget;
+      m(1) = host_memory_budget;
+      retval = octave_value (m);
+    }
+    size_t dev = device_memory_budget;
+    size_t host = host_memory_budget;
+    if (nargin > 1)
+      dev = byte_count_arg (args (1), "budget");
+    if (nargin > 2)
+      host = byte_count_arg (args (2), "budget");
+    device_memory_budget = dev;
+    host_memory_budget = host;
+
+  } else if (fcn == "retain") {
+
+    // handle the pool retention policy: retained bytes when the last
+    // memory object is released, and idle time (in seconds, 0 for never)
+
+    if (nargout > 0) {
+      Matrix m(1, 2);
+      m(0) = pool_retain_bytes;
+      m(1) = pool_idle_seconds;
+      retval = octave_value (m);
+    }
+    size_t retain = pool_retain_bytes;
+    double idle = pool_idle_seconds;
+    if (nargin > 1)
+      retain = byte_count_arg (args (1), "retain");
+    if (nargin > 2) {
+      idle = args (2).double_value ();
+      if (! (idle >= 0)) // also NaN
+        ocl_error ("__ocl_memmgr__: retain: idle time must be non-negative");
+    }
+    pool_retain_bytes = retain;
+    pool_idle_seconds = idle;
+
+  } else if (fcn == "trim") {
+
+    // release retained buffers down to a number of bytes (default: all)
+
+    size_t max_bytes = 0;
+    if (nargin > 1)
+      max_bytes = byte_count_arg (args (1), "trim");
+    trim_pool (max_bytes);
+    if (nargout > 0)
+      retval = octave_value (double (pooled_bytes));
+
+  } else if (fcn == "fftcache") {
+
+    // handle the cache of fft plans: cached bytes and limit (in bytes),
+    // setting the limit drops least recently used plans above it
+
+    if (nargout > 0) {
+      Matrix m(1, 2);
+      m(0) = ocl_array_cached_bytes ();
+      m(1) = ocl_array_cache_limit ();
+      retval = octave_value (m);
+    }
+    if (nargin > 1)
+      ocl_array_set_cache_limit (byte_count_arg (args (1), "fftcache"));
+
+  } else if (fcn == "clearcache") {
+
+    // drop the cache of fft plans (their device memory is released to the pool)
+
+    ocl_array_clear_caches ();
+
+  } else if (fcn == "reserve") {
+
+    // reserve retained buffers of the given sizes (in bytes), allocating them
+    // now; an empty argument cancels all reservations (the buffers remain
+    // retained as usual)
+
+    if (nargin < 2)
+      ocl_error ("__ocl_memmgr__: missing sizes for reservation");
+
+    Array<double> sizes = args (1).array_value ();
+    for (octave_idx_type i = 0; i < sizes.numel (); i++)
+      if ((! (sizes (i) >= 0)) || std::isinf (sizes (i)) || (sizes (i) != std::floor (sizes (i))))
+        ocl_error ("__ocl_memmgr__: sizes for reservation must be non-negative integers");
+
+    if (sizes.numel () == 0) {
+      // the formerly reserved buffers are now trimmed as usual (by the idle hook)
+      reserved_memobj_counts.clear ();
+      if (memobj_pool.empty () && live_ocl_memobjs.empty ())
+        unregister_pool_idle_hook ();
+      else if (! memobj_pool.empty ())
+        register_pool_idle_hook ();
+    } else
+      assure_opencl_context ();
+
+    double requested = 0;
+    double reserved = 0;
+    double failed = 0;
+    for (octave_idx_type i = 0; i < sizes.numel (); i++) {
+      size_t size = static_cast<size_t> (sizes (i));
+      if (size == 0)
+        continue;
+      requested += size;
+
+      cl_mem mem_obj = 0;
+      if ((device_memory_budget == 0) || (assigned_bytes + pooled_bytes + size <= device_memory_budget))
+        mem_obj = new_ocl_buffer (size);
+      if ((mem_obj == 0) || (last_error != CL_SUCCESS)) {
+        failed++;
+        continue;
+      }
+
+      memobj_pool[size].push_back (std::make_pair (mem_obj, std::time (0)));
+      pooled_bytes += size;
+      update_peak_device_bytes ();
+      reserved_memobj_counts[size]++;
+      reserved += size;
+    }
+    last_error = CL_SUCCESS;
+    if (! memobj_pool.empty ())
+      register_pool_idle_hook ();
+
+    octave_scalar_map m;
+    m.assign ("requested_bytes", octave_value (requested));
+    m.assign ("reserved_bytes", octave_value (reserved));
+    m.assign ("failed", octave_value (failed));
+    m.assign ("fragmentation", octave_value (pool_fragmentation ()));
+    retval = octave_value (m);
+
+  } else if (fcn == "idle") {
+
+    // called by octave while waiting for input (see register_pool_idle_hook);
+    // no kernel arguments are pending then (holders left by an error are stale)
+
+    memobj_pin_holders.clear ();
+    memobj_use_clock++;
+    if (live_ocl_memobjs.size () <= ocl_array_cached_memobjs ())
+      ocl_array_clear_caches (); // only cached data is left, e.g., after "clear all"
+    if (live_ocl_memobjs.empty ())
+      trim_pool (0);
+    else
+      trim_idle_pool ();
+    // nothing left to release (reserved buffers are kept): the hook is
+    // registered again by the next allocation or cancelled reservation
+    if (live_ocl_memobjs.empty () && (pooled_bytes == pooled_bytes_of_reserved_sizes (true)))
+      unregister_pool_idle_hook ();
+
+  } else if (fcn == "poolstats") {
+
+    // report pool byte count and reuse counters
+
+    octave_scalar_map m;
+    m.assign ("pooled_bytes", octave_value (double (pooled_bytes)));
+    m.assign ("hits", octave_value (double (num_pool_hits)));
+    m.assign ("misses", octave_value (double (num_pool_misses)));
+    m.assign ("trimmed", octave_value (double (num_pool_trimmed)));
+    m.assign ("reserved_bytes", octave_value (double (reserved_bytes ())));
+    m.assign ("fragmentation", octave_value (pool_fragmentation ()));
+    retval = octave_value (m);
+
+  } else if (fcn == "usage") {
+
+    // report memory usage accounting; "reset" resets the high-water mark
+
+    if ((nargin > 1) && args (1).is_string () && (args (1).string_value () == "reset"))
+      ocl_memobj_reset_peak ();
+    else if (nargin > 1)
+      ocl_error ("usage: invalid argument");
+    if ((nargout > 0) || (nargin == 1))
+      retval = ocl_memobj_usage ();
+
+  } else if (fcn == "spillstats") {
+
+    // report byte counts and spilling counters
+
+    octave_scalar_map m;
+    m.assign ("assigned_bytes", octave_value (double (assigned_bytes)));
+    m.assign ("pooled_bytes", octave_value (double (pooled_bytes)));
+    m.assign ("spilled_bytes", octave_value (double (spilled_bytes)));
+    m.assign ("spills", octave_value (double (num_spills)));
+    m.assign ("spilled_total", octave_value (double (num_spilled_bytes)));
+    m.assign ("page_ins", octave_value (double (num_page_ins)));
+    m.assign ("paged_in_total", octave_value (double (num_paged_in_bytes)));
+    retval = octave_value (m);
+
   } else {
 
     ocl_error ("unknown subfunction");
@@ -25,28 +25,81 @@
 #include <stdint.h>
 #include <stddef.h>
 
+class octave_value;
+
 
 class
 OclMemoryObject : public OclContextObject
 {
 public:
 
-  OclMemoryObject (size_t size = 0);
+  // type_str (a static string naming the element type) is only used
+  // for the memory usage accounting
+  OclMemoryObject (size_t size = 0, const char *type_str = 0);
+
+  // memory object starting out spilled, with a copy of the host data;
+  // the OpenCL buffer is only allocated on first use (lazy upload)
+  OclMemoryObject (size_t size, const void *host_data, const char *type_str);
 
   ~OclMemoryObject ();
 
-  void *get_ocl_buffer (void) const { return ocl_mem_buffer; };
+  // returns the OpenCL buffer, after paging it back in if it was spilled
+  // to host memory; the object stays pinned on the device until the next
+  // enqueued command (see ocl_memobj_release_pins)
+  void *get_ocl_buffer (void) const;
+
+  size_t get_size (void) const { return mem_size; }
+
+  bool is_spilled (void) const { return (host_copy != 0); }
+
+  // copy the buffer contents to host memory and release the OpenCL buffer
+  bool spill_to_host (void) const;
+
+  uint64_t get_last_use (void) const { return last_use; }
 
 private:
 
   OclMemoryObject (const OclMemoryObject& a); // no copying
   OclMemoryObject& operator = (const OclMemoryObject& a); // no assignment
 
-  void *ocl_mem_buffer;
+  void page_in (void) const;
+
+  mutable void *ocl_mem_buffer;
+  size_t mem_size;
+  mutable char *host_copy;
+  mutable uint64_t last_use;
+  const char *mem_type;
 };
 
 
 extern void reset_memmgr (void);
 
+// to be called after enqueueing OpenCL commands: the memory objects used so
+// far may be spilled to host memory again; but not before every holder
+// (a kernel whose arguments are being set) has been released by enqueueing it;
+// releasing a holder without unpin leaves the objects used so far pinned
+extern void ocl_memobj_hold_pins (const void *holder);
+extern void ocl_memobj_release_pins (const void *holder = 0, bool unpin = true);
+
+// whether loaded OCL arrays are uploaded lazily, on first use
+extern bool ocl_memobj_lazy_load (void);
+
+// memory usage accounting (a struct, see '__ocl_memmgr__ ("usage")'),
+// and resetting the high-water mark to the current device memory usage
+extern octave_value ocl_memobj_usage (void);
+extern void ocl_memobj_reset_peak (void);
+
+// releasing the cached data of OCL arrays and the retained buffers of the
+// pool (except reserved ones), see 'ocl_context ("clear")'
+extern void ocl_memobj_clear (void);
+
+// cached device data of OCL arrays (the FFT plans, see ocl_array.cc): dropping
+// it, its number of memory objects and bytes, and its limit in bytes
+extern void ocl_array_clear_caches (void);
+extern size_t ocl_array_cached_memobjs (void);
+extern size_t ocl_array_cached_bytes (void);
+extern void ocl_array_set_cache_limit (size_t max_bytes);
+extern size_t ocl_array_cache_limit (void);
+
 
 #endif  /* __OCL_MEMOBJ_H */
@@ -32,45 +32,13 @@
 #include "ocl_ov_matrix.h"
 #include "ocl_array.h"
 #include "ocl_lib.h"
+#include "ocl_memobj.h"
 #include <ops.h>
+#include <ov-fcn-handle.h>
+#include <byte-swap.h>
 
-
-#if ! defined (DEFINE_TEMPLATE_OV_TYPEID_FUNCTIONS_AND_DATA)
-// macro for template classes to be registered as a new octave type
-// as replacement for DEFINE_OV_TYPEID_FUNCTIONS_AND_DATA for non-template classes
-#if ! defined (OCL_OCTAVE_VERSION_4_4_0_AND_HIGHER) // for octave versions < 4.4.0
-#define DEFINE_OV_TYPEID_FUNCTIONS_AND_DATA_TC(t, n, c)                 \
-  template <> int t::t_id (-1);                                         \
-  template <> const std::string t::t_name (n);                          \
-  template <> const std::string t::c_name (c);                          \
-  template <> void t::register_type (void)                              \
-  {                                                                     \
-    static t exemplar;                                                  \
-    octave_value v (&exemplar, true);                                   \
-    t_id = octave_value_typeinfo::register_type (t::t_name, t::c_name, v); \
-  }
-#else // for octave versions >= 4.4.0
-#define DEFINE_OV_TYPEID_FUNCTIONS_AND_DATA_TC(t, n, c)         \
-  template <> int t::t_id (-1);                                 \
-  template <> const std::string t::t_name (n);                  \
-  template <> const std::string t::c_name (c);                  \
-  template <> void t::register_type (octave::type_info& ti)     \
-  {                                                             \
-    octave_value v (new t ());                                  \
-    t_id = ti.register_type (t::t_name, t::c_name, v);          \
-  }                                                             \
-  template <> void t::register_type (void)                      \
-  {                                                             \
-    octave::type_info& type_info                                \
-      = octave::__get_type_info__ (#t "::register_type");       \
-                                                                \
-    register_type (type_info);                                  \
-  }
-#endif
-#else // DEFINE_TEMPLATE_OV_TYPEID_FUNCTIONS_AND_DATA is defined
-#define DEFINE_OV_TYPEID_FUNCTIONS_AND_DATA_TC(t, n, c)         \
-  DEFINE_TEMPLATE_OV_TYPEID_FUNCTIONS_AND_DATA(t, n, c)
-#endif
+#include <algorithm>
+#include <limits>
 
 
 static
@@ -79,8 +47,7 @@ warning_save_oclmat (void)
 {
   const char warning_id_oclmat_save[] = "Ocl:matrix_save";
   const char warn_str[] =
-"saving context-dependent ocl matrix is ignored (saved as if empty). \n\
-Use 'ocl_to_octave' to convert data of interest to octave matrix before saving.";
+"saving ocl matrix of a destroyed OpenCL context is ignored (saved as if empty).";
 
 //  warning (warn_str);
   (*current_liboctave_warning_with_id_handler)
@@ -89,18 +56,14 @@ Use 'ocl_to_octave' to convert data of interest to octave matrix before saving."
 }
 
 
-static
-bool
-warning_load_oclmat (void)
+void
+warning_singular_oclmat (void)
 {
-//  const char warning_id_oclmat_load[] = "Ocl:matrix_load";
-//  const char warn_str[] =
-//"loading context-dependent ocl matrix is ignored, returning an empty ocl matrix.";
-//  warning (warn_str);
-//  (*current_liboctave_warning_with_id_handler)
-//    (warning_id_oclmat_load, warn_str);
-// nothing to do, since data is never saved (no need to skip)
-  return true;
+  const char warning_id_singular[] = "Octave:singular-matrix";
+  const char warn_str[] = "matrix singular to machine precision";
+
+  (*current_liboctave_warning_with_id_handler)
+    (warning_id_singular, warn_str);
 }
 
 
@@ -358,8 +321,7 @@ octave_base_ocl_matrix<AT>::ocl_index_op (const octave_value_list& idx,
     case 1:
     {
       if (is_ocllogicidx) {
-        octave_stdout << "logical indexing is not possible\n";
-        ocl_error ("indexing error");
+        retval = new octave_base_ocl_matrix<AT> (matrix.index_logical (ocllogicidx));
       } else if (is_oclidx) {
         oclidx -= 1; // this is where the conversion one-based to zero-based takes place
         retval = new octave_base_ocl_matrix<AT> (matrix.index (oclidx));
@@ -531,20 +493,69 @@ octave_base_ocl_matrix<AT>::map (octave_base_value::unary_mapper_t umap) const
 }
 
 
-// saving ocl matrix data does not really make sense, because:
-// - the data's existence or reachability is (OpenCL) context-dependent
-// - the data cannot easily be re-loaded without assumptions about (OpenCL) resources
-// hence, the 'save_...' functions only exist to not abort while saving the whole workspace etc.
+// ocl matrices are saved with their data and, on loading, uploaded into the
+// current OpenCL context (or, see '__ocl_memmgr__ ("lazyload")', on first use);
+// the text and HDF5 formats are those of the corresponding octave matrix types,
+// the binary format is a header followed by the raw elements, written through
+// mapped memory of the OpenCL buffer
 
-// similarly, for 'load_...' functions; there, the additional complication
-// is that the user-types have to be known to octave (e.g. at least 'pkg load ocl' is needed)
+// the user-types have to be known to octave (e.g. at least 'pkg load ocl' is needed)
 // prior to loading, or else the error "wrong type argument '<unknown type>'" is reported
 
+template <typename T>
+struct
+ocl_host_matrix;
+
+#define OCL_HOST_MATRIX(T, OV_TYPE, ARRAY_TYPE, ARRAY_FCN) \
+  template <> \
+  struct \
+  ocl_host_matrix<T> \
+  { \
+    typedef OV_TYPE type; \
+    typedef ARRAY_TYPE array_type; \
+    static Array<T> value (const OV_TYPE& m) { return m.ARRAY_FCN (); } \
+  };
+
+OCL_HOST_MATRIX( double,        octave_matrix,               NDArray,             array_value               )
+OCL_HOST_MATRIX( float,         octave_float_matrix,         FloatNDArray,        float_array_value         )
+OCL_HOST_MATRIX( Complex,       octave_complex_matrix,       ComplexNDArray,      complex_array_value       )
+OCL_HOST_MATRIX( FloatComplex,  octave_float_complex_matrix, FloatComplexNDArray, float_complex_array_value )
+OCL_HOST_MATRIX( octave_int8,   octave_int8_matrix,          int8NDArray,         int8_array_value          )
+OCL_HOST_MATRIX( octave_int16,  octave_int16_matrix,         int16NDArray,        int16_array_value         )
+OCL_HOST_MATRIX( octave_int32,  octave_int32_matrix,         int32NDArray,        int32_array_value         )
+OCL_HOST_MATRIX( octave_int64,  octave_int64_matrix,         int64NDArray,        int64_array_value         )
+OCL_HOST_MATRIX( octave_uint8,  octave_uint8_matrix,         uint8NDArray,        uint8_array_value         )
+OCL_HOST_MATRIX( octave_uint16, octave_uint16_matrix,        uint16NDArray,       uint16_array_value        )
+OCL_HOST_MATRIX( octave_uint32, octave_uint32_matrix,        uint32NDArray,       uint32_array_value        )
+OCL_HOST_MATRIX( octave_uint64, octave_uint64_matrix,        uint64NDArray,       uint64_array_value        )
+
+#undef OCL_HOST_MATRIX
+
+
+// the data of an ocl matrix as octave matrix, empty if the matrix is inoperable
+template <typename AT>
+static
+typename ocl_host_matrix<typename AT::element_type>::type *
+host_matrix_for_saving (const AT& matrix)
+{
+  typedef ocl_host_matrix<typename AT::element_type> host;
+
+  if (matrix.numel () == 0)
+    return new typename host::type (typename host::array_type (matrix.dims ()));
+  if (! matrix.is_valid ()) {
+    warning_save_oclmat ();
+    return new typename host::type (typename host::array_type (dim_vector (0, 0)));
+  }
+  return new typename host::type (typename host::array_type (matrix.as_array ()));
+}
+
+
 template <typename AT>
 bool
 octave_base_ocl_matrix<AT>::save_ascii (std::ostream& os)
 {
-  return warning_save_oclmat ();
+  octave_value host (host_matrix_for_saving (matrix));
+  return host.save_ascii (os);
 }
 
 
@@ -552,7 +563,15 @@ template <typename AT>
 bool
 octave_base_ocl_matrix<AT>::load_ascii (std::istream& is)
 {
-  return warning_load_oclmat ();
+  typedef ocl_host_matrix<element_type> host;
+
+  typename host::type *m = new typename host::type ();
+  octave_value ov (m); // owns m
+  if (! m->load_ascii (is))
+    return false;
+
+  matrix = AT (host::value (*m), ocl_memobj_lazy_load ());
+  return true;
 }
 
 
@@ -564,7 +583,26 @@ octave_base_ocl_matrix<AT>::save_binary (std::ostream& os, bool& save_as_floats)
 octave_base_ocl_matrix<AT>::save_binary (std::ostream& os, bool save_as_floats)
 #endif
 {
-  return warning_save_oclmat ();
+  // header: the negative number of dimensions (as with octave's own matrix types),
+  // the dimensions as 64 bit integers, and the size of an element in bytes
+  AT m = matrix;
+  if ((m.numel () > 0) && (! m.is_valid ())) {
+    warning_save_oclmat ();
+    m = AT ();
+  }
+
+  dim_vector dv = m.dims ();
+  int32_t nd = dv.ndims ();
+  int32_t tmp = -nd;
+  os.write (reinterpret_cast<char *> (& tmp), 4);
+  for (int i = 0; i < nd; i++) {
+    int64_t d = dv(i);
+    os.write (reinterpret_cast<char *> (& d), 8);
+  }
+  tmp = sizeof (element_type);
+  os.write (reinterpret_cast<char *> (& tmp), 4);
+
+  return os.good () && m.write_raw (os);
 }
 
 
@@ -572,7 +610,35 @@ template <typename AT>
 bool
 octave_base_ocl_matrix<AT>::load_binary (std::istream& is, bool swap, octave::mach_info::float_format fmt)
 {
-  return warning_load_oclmat ();
+  int32_t mdims;
+  if (! is.read (reinterpret_cast<char *> (& mdims), 4))
+    return false;
+  if (swap)
+    swap_bytes<4> (& mdims);
+  if (mdims > -2)
+    return false;
+
+  dim_vector dv;
+  dv.resize (-mdims);
+  for (int i = 0; i < -mdims; i++) {
+    int64_t d;
+    if (! is.read (reinterpret_cast<char *> (& d), 8))
+      return false;
+    if (swap)
+      swap_bytes<8> (& d);
+    dv(i) = d;
+  }
+
+  int32_t elem_size;
+  if (! is.read (reinterpret_cast<char *> (& elem_size), 4))
+    return false;
+  if (swap)
+    swap_bytes<4> (& elem_size);
+  if (elem_size != static_cast<int32_t> (sizeof (element_type)))
+    return false;
+
+  matrix = AT::read_raw (is, dv, swap, ocl_memobj_lazy_load ());
+  return true;
 }
 
 
@@ -580,7 +646,8 @@ template <typename AT>
 bool
 octave_base_ocl_matrix<AT>::save_hdf5 (octave_hdf5_id loc_id, const char *name, bool save_as_floats)
 {
-  return warning_save_oclmat ();
+  octave_value host (host_matrix_for_saving (matrix));
+  return host.save_hdf5 (loc_id, name, save_as_floats);
 }
 
 
@@ -588,7 +655,15 @@ template <typename AT>
 bool
 octave_base_ocl_matrix<AT>::load_hdf5 (octave_hdf5_id loc_id, const char *name)
 {
-  return warning_load_oclmat ();
+  typedef ocl_host_matrix<element_type> host;
+
+  typename host::type *m = new typename host::type ();
+  octave_value ov (m); // owns m
+  if (! m->load_hdf5 (loc_id, name))
+    return false;
+
+  matrix = AT (host::value (*m), ocl_memobj_lazy_load ());
+  return true;
 }
 
 
@@ -614,6 +689,288 @@ octave_base_ocl_matrix<AT>::as_index (const octave_value_list& args, int nargout
 }
 
 
+template <typename AT>
+octave_value_list
+octave_base_ocl_matrix<AT>::pagetranspose (const octave_value_list& args, int nargout)
+{
+  int nargin = args.length ();
+  if ((nargout > 1) || (nargin != 1))
+    ocl_error ("wrong number or type of arguments");
+
+  octave_base_value *arg0_rep = args(0).internal_rep ();
+  if (arg0_rep->type_id () != static_type_id ())
+    ocl_error ("wrong argument type");
+  octave_base_ocl_matrix<AT> *ovom = dynamic_cast< octave_base_ocl_matrix<AT> *> (arg0_rep);
+  if (ovom == 0)
+    return octave_value ();
+
+  return ovom->pagetranspose ();
+}
+
+
+template <typename AT>
+octave_value_list
+octave_base_ocl_matrix<AT>::pagectranspose (const octave_value_list& args, int nargout)
+{
+  int nargin = args.length ();
+  if ((nargout > 1) || (nargin != 1))
+    ocl_error ("wrong number or type of arguments");
+
+  octave_base_value *arg0_rep = args(0).internal_rep ();
+  if (arg0_rep->type_id () != static_type_id ())
+    ocl_error ("wrong argument type");
+  octave_base_ocl_matrix<AT> *ovom = dynamic_cast< octave_base_ocl_matrix<AT> *> (arg0_rep);
+  if (ovom == 0)
+    return octave_value ();
+
+  return ovom->pagectranspose ();
+}
+
+
+// concatenation of all OCL matrix arguments from index first on, by a single
+// OclArray<T>::cat (empty octave matrices are skipped)
+template <typename AT>
+octave_value_list
+octave_base_ocl_matrix<AT>::cat_args (int dim, const octave_value_list& args, int first)
+{
+  std::vector<AT> array_list;
+
+  for (int i = first; i < args.length (); i++) {
+    octave_base_value *arg_rep = args(i).internal_rep ();
+    if (arg_rep->type_id () == static_type_id ()) {
+      octave_base_ocl_matrix<AT> *ovom = dynamic_cast< octave_base_ocl_matrix<AT> *> (arg_rep);
+      if (ovom != 0) {
+        array_list.push_back (ovom->ocl_array_value ());
+        continue;
+      }
+    }
+    if (args(i).numel () > 0)
+      ocl_error ("arguments to concatenate must be ocl matrices, of same type");
+  }
+
+  if (array_list.empty ())
+    return octave_value (new octave_base_ocl_matrix<AT> ());
+
+  return octave_value (new octave_base_ocl_matrix<AT> (AT::cat (dim, array_list.size (), & array_list [0])));
+}
+
+
+template <typename AT>
+octave_value_list
+octave_base_ocl_matrix<AT>::cat (const octave_value_list& args, int nargout)
+{
+  int nargin = args.length ();
+  if ((nargout > 1) || (nargin < 1) || (! args(0).is_real_scalar ()))
+    ocl_error ("wrong number or type of arguments");
+
+  int dim = args(0).scalar_value () - 1;
+  if (dim < 0)
+    ocl_error ("cat: DIM must be a valid dimension");
+
+  return cat_args (dim, args, 1);
+}
+
+
+template <typename AT>
+octave_value_list
+octave_base_ocl_matrix<AT>::horzcat (const octave_value_list& args, int nargout)
+{
+  if (nargout > 1)
+    ocl_error ("wrong number of arguments");
+
+  return cat_args (1, args, 0);
+}
+
+
+template <typename AT>
+octave_value_list
+octave_base_ocl_matrix<AT>::vertcat (const octave_value_list& args, int nargout)
+{
+  if (nargout > 1)
+    ocl_error ("wrong number of arguments");
+
+  return cat_args (0, args, 0);
+}
+
+
+// circshift (X, N) with a shift per dimension in N (or, for scalar N,
+// along the first non-singleton dimension), or circshift (X, N, DIM)
+template <typename AT>
+octave_value_list
+octave_base_ocl_matrix<AT>::circshift (const octave_value_list& args, int nargout)
+{
+  int nargin = args.length ();
+  if ((nargout > 1) || (nargin < 2) || (nargin > 3) ||
+      ((nargin > 2) && (! args(2).is_real_scalar ())))
+    ocl_error ("wrong number or type of arguments");
+
+  octave_base_value *arg0_rep = args(0).internal_rep ();
+  if (arg0_rep->type_id () != static_type_id ())
+    ocl_error ("wrong argument type");
+  octave_base_ocl_matrix<AT> *ovom = dynamic_cast< octave_base_ocl_matrix<AT> *> (arg0_rep);
+  if (ovom == 0)
+    return octave_value ();
+
+  Array<double> n = args(1).array_value ();
+  const AT& x = ovom->ocl_array_value ();
+
+  int dim = -1;
+  if (nargin > 2) {
+    dim = args(2).scalar_value () - 1;
+    if ((dim < 0) || (n.numel () != 1))
+      ocl_error ("circshift: DIM must be a valid dimension, with a scalar N");
+  } else if (n.numel () == 1)
+    dim = x.dims ().first_non_singleton ();
+
+  Array<octave_idx_type> shift (dim_vector ((dim < 0) ? n.numel () : dim + 1, 1), 0);
+  if (dim < 0) {
+    for (octave_idx_type k=0; k<n.numel (); k++)
+      shift (k) = n (k);
+  } else
+    shift (dim) = n (0);
+
+  return octave_value (new octave_base_ocl_matrix<AT> (x.circshift (shift)));
+}
+
+
+template <typename AT>
+octave_value_list
+octave_base_ocl_matrix<AT>::flip (const octave_value_list& args, int nargout)
+{
+  int nargin = args.length ();
+  if ((nargout > 1) || (nargin < 1) || (nargin > 2) ||
+      ((nargin > 1) && (! args(1).is_real_scalar ())))
+    ocl_error ("wrong number or type of arguments");
+
+  octave_base_value *arg0_rep = args(0).internal_rep ();
+  if (arg0_rep->type_id () != static_type_id ())
+    ocl_error ("wrong argument type");
+  octave_base_ocl_matrix<AT> *ovom = dynamic_cast< octave_base_ocl_matrix<AT> *> (arg0_rep);
+  if (ovom == 0)
+    return octave_value ();
+
+  int dim = -1;
+  if (nargin > 1) {
+    dim = args(1).scalar_value () - 1;
+    if (dim < 0)
+      ocl_error ("flip: DIM must be a positive integer");
+  }
+
+  return octave_value (new octave_base_ocl_matrix<AT> (ovom->ocl_array_value ().flip (dim)));
+}
+
+
+template <typename AT>
+octave_value_list
+octave_base_ocl_matrix<AT>::rot90 (const octave_value_list& args, int nargout)
+{
+  int nargin = args.length ();
+  if ((nargout > 1) || (nargin < 1) || (nargin > 2) ||
+      ((nargin > 1) && (! args(1).is_real_scalar ())))
+    ocl_error ("wrong number or type of arguments");
+
+  octave_base_value *arg0_rep = args(0).internal_rep ();
+  if (arg0_rep->type_id () != static_type_id ())
+    ocl_error ("wrong argument type");
+  octave_base_ocl_matrix<AT> *ovom = dynamic_cast< octave_base_ocl_matrix<AT> *> (arg0_rep);
+  if (ovom == 0)
+    return octave_value ();
+
+  double k = (nargin > 1) ? args(1).scalar_value () : 1;
+  if (k != (int) k)
+    ocl_error ("rot90: K must be a single real integer");
+
+  return octave_value (new octave_base_ocl_matrix<AT> (ovom->ocl_array_value ().rot90 ((int) k)));
+}
+
+
+// diff (X, K, DIM): differences of order K (default 1) along DIM (default:
+// the first non-singleton dimension)
+template <typename AT>
+octave_value_list
+octave_base_ocl_matrix<AT>::diff (const octave_value_list& args, int nargout)
+{
+  int nargin = args.length ();
+  if ((nargout > 1) || (nargin < 1) || (nargin > 3) ||
+      ((nargin > 1) && (args(1).numel () > 0) && (! args(1).is_real_scalar ())) ||
+      ((nargin > 2) && (! args(2).is_real_scalar ())))
+    ocl_error ("wrong number or type of arguments");
+
+  octave_base_value *arg0_rep = args(0).internal_rep ();
+  if (arg0_rep->type_id () != static_type_id ())
+    ocl_error ("wrong argument type");
+  octave_base_ocl_matrix<AT> *ovom = dynamic_cast< octave_base_ocl_matrix<AT> *> (arg0_rep);
+  if (ovom == 0)
+    return octave_value ();
+
+  double k = 1;
+  if ((nargin > 1) && (args(1).numel () > 0)) {
+    k = args(1).scalar_value ();
+    if ((k < 0) || (k != (octave_idx_type) k))
+      ocl_error ("diff: order K must be a non-negative integer");
+  }
+
+  int dim = -1;
+  if (nargin > 2) {
+    dim = args(2).scalar_value () - 1;
+    if (dim < 0)
+      ocl_error ("diff: DIM must be a valid dimension");
+  }
+
+  return octave_value (new octave_base_ocl_matrix<AT> (ovom->ocl_array_value ().diff ((octave_idx_type) k, dim)));
+}
+
+
+// [DX, DY, DZ, ...] = gradient (M, S) or gradient (M, DX, DY, ...), with
+// scalar spacings only: DX along the columns (dimension 2), DY along the
+// rows (dimension 1), further outputs along the further dimensions; for
+// a vector M, the single output is along the vector
+template <typename AT>
+octave_value_list
+octave_base_ocl_matrix<AT>::gradient (const octave_value_list& args, int nargout)
+{
+  int nargin = args.length ();
+  if (nargin < 1)
+    ocl_error ("wrong number or type of arguments");
+  for (int k=1; k<nargin; k++)
+    if (! args(k).is_real_scalar ())
+      ocl_error ("gradient: only scalar spacings are supported for OCL matrices");
+
+  octave_base_value *arg0_rep = args(0).internal_rep ();
+  if (arg0_rep->type_id () != static_type_id ())
+    ocl_error ("wrong argument type");
+  octave_base_ocl_matrix<AT> *ovom = dynamic_cast< octave_base_ocl_matrix<AT> *> (arg0_rep);
+  if (ovom == 0)
+    return octave_value ();
+
+#if ! defined (OCL_OCTAVE_VERSION_4_4_0_AND_HIGHER) // for octave versions < 4.4.0
+  if (ovom->is_integer_type ())
+#else // for octave versions >= 4.4.0
+  if (ovom->isinteger ())
+#endif
+    ocl_error ("wrong argument type");
+
+  const AT& m = ovom->ocl_array_value ();
+  dim_vector dv = m.dims ();
+  bool is_vector = (dv.ndims () == 2) && ((dv(0) == 1) || (dv(1) == 1));
+
+  int nout = std::max (nargout, 1);
+  if ((is_vector && (nout > 1)) || ((! is_vector) && (nout > dv.ndims ())))
+    ocl_error ("gradient: too many output arguments");
+  if ((nargin > 2) && (nargin != nout + 1))
+    ocl_error ("gradient: a spacing is required for each output");
+
+  octave_value_list retval (nout);
+  for (int k=0; k<nout; k++) {
+    double h = (nargin == 2) ? args(1).scalar_value () : (nargin > 2) ? args(k+1).scalar_value () : 1;
+    int dim = is_vector ? dv.first_non_singleton () : (k < 2) ? 1-k : k;
+    retval(k) = octave_value (new octave_base_ocl_matrix<AT> (m.gradient (h, dim)));
+  }
+
+  return retval;
+}
+
+
 #define DEFINE_METHOD(METHOD) \
   template <typename AT> \
   octave_value_list \
@@ -650,6 +1007,44 @@ DEFINE_METHOD(findlast)
 #undef DEFINE_METHOD
 
 
+template <typename AT>
+octave_value_list
+octave_base_ocl_matrix<AT>::find (const octave_value_list& args, int nargout)
+{
+  int nargin = args.length ();
+  if ((nargout > 1) || (nargin > 3) ||
+      ((nargin > 1) && (!args(1).is_real_scalar ())) ||
+      ((nargin > 2) && (!args(2).is_string ())))
+    ocl_error ("wrong number or type of arguments");
+
+  octave_idx_type n = -1;
+  if (nargin > 1) {
+    double d = args(1).scalar_value ();
+    if ((d < 1) || (d != (octave_idx_type) d))
+      ocl_error ("find: N must be an integer greater than zero");
+    n = d;
+  }
+
+  bool backward = false;
+  if (nargin > 2) {
+    std::string direction = args(2).string_value ();
+    if (direction == "last")
+      backward = true;
+    else if (direction != "first")
+      ocl_error ("find: DIRECTION must be \"first\" or \"last\"");
+  }
+
+  octave_base_value *arg0_rep = args(0).internal_rep ();
+  if (arg0_rep->type_id () != static_type_id ())
+    ocl_error ("wrong argument type");
+  octave_base_ocl_matrix<AT> *ovom = dynamic_cast< octave_base_ocl_matrix<AT> *> (arg0_rep);
+  if (ovom == 0)
+    return octave_value ();
+
+  return ovom->find (n, backward);
+}
+
+
 template <typename AT>
 octave_value_list
 octave_base_ocl_matrix<AT>::std (const octave_value_list& args, int nargout)
@@ -688,22 +1083,67 @@ octave_base_ocl_matrix<AT>::std (const octave_value_list& args, int nargout)
 
 template <typename AT>
 octave_value_list
-octave_base_ocl_matrix<AT>::max (const octave_value_list& args, int nargout)
+octave_base_ocl_matrix<AT>::var (const octave_value_list& args, int nargout)
 {
   int nargin = args.length ();
   if ((nargout > 2) || (nargin > 3) ||
-      ((nargin > 2) && (!args(2).is_real_scalar ())) ||
-      ((nargin == 2) && (nargout == 2)))
+      ((nargin > 1) && (!args(1).is_real_scalar ())) ||
+      ((nargin > 2) && (!args(2).is_real_scalar ())))
     ocl_error ("wrong number or type of arguments");
 
+  int opt = 0;
+  if (nargin > 1)
+    opt = args(1).scalar_value ();
+
   int dim = -1;
   if (nargin > 2)
     dim = args(2).scalar_value () - 1;
 
-  int i0 = 0, i1 = 1;
-  if ((nargin == 2) && (args(0).is_scalar_type ())) { // max (scalar, oclmat)
-    i0 = 1;
-    i1 = 0;
+  octave_base_value *arg0_rep = args(0).internal_rep ();
+  if (arg0_rep->type_id () != static_type_id ())
+    ocl_error ("wrong argument type");
+  octave_base_ocl_matrix<AT> *ovom = dynamic_cast< octave_base_ocl_matrix<AT> *> (arg0_rep);
+  if (ovom == 0)
+    return octave_value ();
+
+#if ! defined (OCL_OCTAVE_VERSION_4_4_0_AND_HIGHER) // for octave versions < 4.4.0
+  if (ovom->is_integer_type ())
+#else // for octave versions >= 4.4.0
+  if (ovom->isinteger ())
+#endif
+    ocl_error ("wrong argument type");
+
+  if (nargout < 2)
+    return ovom->var (opt, dim);
+  else {
+    octave_value result, mean;
+    result = ovom->var (mean, opt, dim);
+    octave_value_list retval;
+    retval (0) = result;
+    retval (1) = mean;
+    return retval;
+  }
+}
+
+
+template <typename AT>
+octave_value_list
+octave_base_ocl_matrix<AT>::max (const octave_value_list& args, int nargout)
+{
+  int nargin = args.length ();
+  if ((nargout > 2) || (nargin > 3) ||
+      ((nargin > 2) && (!args(2).is_real_scalar ())) ||
+      ((nargin == 2) && (nargout == 2)))
+    ocl_error ("wrong number or type of arguments");
+
+  int dim = -1;
+  if (nargin > 2)
+    dim = args(2).scalar_value () - 1;
+
+  int i0 = 0, i1 = 1;
+  if ((nargin == 2) && (args(0).is_scalar_type ())) { // max (scalar, oclmat)
+    i0 = 1;
+    i1 = 0;
   }
 
   octave_base_value *arg0_rep = args(i0).internal_rep ();
@@ -832,15 +1272,857 @@ octave_base_ocl_matrix<AT>::cummax (const octave_value_list& args, int nargout)
 
 template <typename AT>
 octave_value_list
-octave_base_ocl_matrix<AT>::cummin (const octave_value_list& args, int nargout)
+octave_base_ocl_matrix<AT>::cummin (const octave_value_list& args, int nargout)
+{
+  int nargin = args.length ();
+  if ((nargout > 2) || (nargin > 2) || ((nargin > 1) && (!args(1).is_real_scalar ())))
+    ocl_error ("wrong number or type of arguments");
+
+  int dim = -1;
+  if (nargin > 1)
+    dim = args(1).scalar_value () - 1;
+
+  octave_base_value *arg0_rep = args(0).internal_rep ();
+  if (arg0_rep->type_id () != static_type_id ())
+    ocl_error ("wrong argument type");
+  octave_base_ocl_matrix<AT> *ovom = dynamic_cast< octave_base_ocl_matrix<AT> *> (arg0_rep);
+  if (ovom == 0)
+    return octave_value ();
+
+  if (nargout < 2)
+    return ovom->cummin (dim);
+  else {
+    octave_value result, indices;
+    result = ovom->cummin (indices, dim);
+    octave_value_list retval;
+    retval (0) = result;
+    retval (1) = indices;
+    return retval;
+  }
+}
+
+
+static
+char
+pagemtimes_trans_arg (const octave_value& arg)
+{
+  if (! arg.is_string ())
+    ocl_error ("wrong number or type of arguments");
+
+  std::string transp = arg.string_value ();
+  if (transp == "none")
+    return 'N';
+  else if (transp == "transpose")
+    return 'T';
+  else if (transp == "ctranspose")
+    return 'C';
+
+  ocl_error ("invalid transpose option");
+  return 'N';
+}
+
+
+template <typename AT>
+octave_value_list
+octave_base_ocl_matrix<AT>::pagemtimes (const octave_value_list& args, int nargout)
+{
+  int nargin = args.length ();
+  if ((nargout > 1) || ((nargin != 2) && (nargin != 4)))
+    ocl_error ("wrong number or type of arguments");
+
+  // pagemtimes (X, Y) or pagemtimes (X, transpX, Y, transpY)
+  int iarg1 = (nargin == 2) ? 1 : 2;
+  char trans0 = (nargin == 2) ? 'N' : pagemtimes_trans_arg (args(1));
+  char trans1 = (nargin == 2) ? 'N' : pagemtimes_trans_arg (args(3));
+
+  if (args(iarg1).type_id () != args(0).type_id ())
+    ocl_error ("wrong number or type of arguments");
+
+  octave_base_value *arg0_rep = args(0).internal_rep ();
+  if (arg0_rep->type_id () != static_type_id ())
+    ocl_error ("wrong argument type");
+  octave_base_ocl_matrix<AT> *ovom0 = dynamic_cast< octave_base_ocl_matrix<AT> *> (arg0_rep);
+  if (ovom0 == 0)
+    return octave_value ();
+
+  octave_base_value *arg1_rep = args(iarg1).internal_rep ();
+  if (arg1_rep->type_id () != static_type_id ())
+    ocl_error ("wrong argument type");
+  octave_base_ocl_matrix<AT> *ovom1 = dynamic_cast< octave_base_ocl_matrix<AT> *> (arg1_rep);
+  if (ovom1 == 0)
+    return octave_value ();
+
+  return ovom0->pagemtimes (*ovom1, trans0, trans1);
+}
+
+
+template <typename AT>
+octave_value_list
+octave_base_ocl_matrix<AT>::atan2 (const octave_value_list& args, int nargout)
+{
+  int nargin = args.length ();
+  if ((nargout > 1) || (nargin != 2) ||
+      (args(1).type_id () != args(0).type_id ()))
+    ocl_error ("wrong number or type of arguments");
+
+  octave_base_value *arg0_rep = args(0).internal_rep ();
+  if (arg0_rep->type_id () != static_type_id ())
+    ocl_error ("wrong argument type");
+  octave_base_ocl_matrix<AT> *ovom0 = dynamic_cast< octave_base_ocl_matrix<AT> *> (arg0_rep);
+  if (ovom0 == 0)
+    return octave_value ();
+
+  octave_base_value *arg1_rep = args(1).internal_rep ();
+  if (arg1_rep->type_id () != static_type_id ())
+    ocl_error ("wrong argument type");
+  octave_base_ocl_matrix<AT> *ovom1 = dynamic_cast< octave_base_ocl_matrix<AT> *> (arg1_rep);
+  if (ovom1 == 0)
+    return octave_value ();
+
+#if ! defined (OCL_OCTAVE_VERSION_4_4_0_AND_HIGHER) // for octave versions < 4.4.0
+  if (ovom0->is_integer_type ())
+#else // for octave versions >= 4.4.0
+  if (ovom0->isinteger ())
+#endif
+    ocl_error ("wrong argument type");
+
+  return ovom0->atan2 (*ovom1);
+}
+
+
+template <typename AT>
+octave_value_list
+octave_base_ocl_matrix<AT>::ndgrid (const octave_value_list& args, int nargout)
+{
+  int nargin = args.length ();
+  if (((nargin == 1) && (nargout != 2)) ||
+      ((nargin != 1) && (nargout != nargin)))
+    ocl_error ("wrong number of arguments");
+
+  int type_id = args(0).type_id ();
+  if (type_id != static_type_id ())
+    ocl_error ("wrong argument type");
+  for (int i = 0; i < nargin; i++) {
+    octave_value ai = args(i);
+    if ((ai.type_id () != type_id) || (ai.ndims () > 2) || ((ai.rows () != 1) && (ai.columns () != 1)))
+      ocl_error ("all input arguments must be vectors of the same ocl matrix type");
+  }
+
+  std::vector< array_type > array_list (nargin);
+  for (int i = 0; i < nargin; i++) {
+    octave_base_value *argi_rep = args(i).internal_rep ();
+    octave_base_ocl_matrix<AT> *ovom = dynamic_cast< octave_base_ocl_matrix<AT> *> (argi_rep);
+    if (ovom == 0)
+      return octave_value ();
+    array_list [i] = ovom->ocl_array_value ();
+  }
+
+  std::vector< array_type > result_list;
+  result_list = array_type::ndgrid (array_list);
+
+  octave_value_list retval;
+  for (int i = 0; i < nargout; i++)
+    retval (i) = new octave_base_ocl_matrix<AT> (result_list [i]);
+
+  return retval;
+}
+
+
+template <typename AT>
+octave_value_list
+octave_base_ocl_matrix<AT>::meshgrid (const octave_value_list& args, int nargout)
+{
+  int nargin = args.length ();
+  if (((nargin == 1) && (nargout != 2)) ||
+      ((nargin != 1) && (nargout != nargin)))
+    ocl_error ("wrong number of arguments");
+
+  int type_id = args(0).type_id ();
+  if (type_id != static_type_id ())
+    ocl_error ("wrong argument type");
+  for (int i = 0; i < nargin; i++) {
+    octave_value ai = args(i);
+    if ((ai.type_id () != type_id) || (ai.ndims () > 2) || ((ai.rows () != 1) && (ai.columns () != 1)))
+      ocl_error ("all input arguments must be vectors of the same ocl matrix type");
+  }
+
+  std::vector< array_type > array_list (nargin);
+  for (int i = 0; i < nargin; i++) {
+    octave_base_value *argi_rep = args(i).internal_rep ();
+    octave_base_ocl_matrix<AT> *ovom = dynamic_cast< octave_base_ocl_matrix<AT> *> (argi_rep);
+    if (ovom == 0)
+      return octave_value ();
+    array_list [i] = ovom->ocl_array_value ();
+  }
+
+  std::vector< array_type > result_list;
+  result_list = array_type::meshgrid (array_list);
+
+  octave_value_list retval;
+  for (int i = 0; i < nargout; i++)
+    retval (i) = new octave_base_ocl_matrix<AT> (result_list [i]);
+
+  return retval;
+}
+
+
+template <typename AT>
+octave_value_list
+octave_base_ocl_matrix<AT>::repmat (const octave_value_list& args, int nargout)
+{
+  int nargin = args.length ();
+  if (nargin < 2)
+    ocl_error ("too few arguments");
+
+  octave_base_value *arg0_rep = args(0).internal_rep ();
+  if (arg0_rep->type_id () != static_type_id ())
+    ocl_error ("wrong argument type");
+  octave_base_ocl_matrix<AT> *ovom = dynamic_cast< octave_base_ocl_matrix<AT> *> (arg0_rep);
+  if (ovom == 0)
+    return octave_value ();
+
+  dim_vector dv (1,1);
+  if (args (1).is_real_matrix ()) {
+    if (nargin > 2)
+      ocl_error ("too many arguments");
+    Matrix m = args (1).matrix_value ();
+    int ndim = m.numel ();
+    dv = dv.redim (ndim);
+    for (octave_idx_type i = 0; i < ndim; i++)
+      dv (i) = m (i);
+  } else {
+    int ndim = nargin-1;
+    dv = dv.redim (ndim);
+    for (octave_idx_type i = 0; i < ndim; i++) {
+      if (!args (1+i).is_real_scalar ())
+        ocl_error ("wrong argument type");
+      dv (i) = args (1+i).scalar_value ();
+    }
+    if (nargin == 2)
+      dv (1) = dv (0);
+  }
+
+  return octave_value (new octave_base_ocl_matrix<AT> (ovom->ocl_array_value ().repmat (dv)));
+}
+
+
+template <typename AT>
+octave_value_list
+octave_base_ocl_matrix<AT>::complex (const octave_value_list& args, int nargout)
+{
+  ocl_error ("complex: invalid conversion");
+}
+
+
+static
+octave_idx_type
+fft_length_arg (const octave_value& arg)
+{
+  if (! arg.is_real_scalar ())
+    ocl_error ("wrong number or type of arguments");
+
+  double d = arg.scalar_value ();
+  if ((d < 1) || (d != (octave_idx_type) d))
+    ocl_error ("fft: N must be an integer greater than zero");
+
+  return d;
+}
+
+
+// fft / ifft (X, N, DIM) and, with two_dim, fft2 / ifft2 (A, M, N)
+// of a complex OCL array
+template <typename CAT>
+static
+octave_value
+ocl_fft_apply (const CAT& x, const octave_value_list& args, bool inverse, bool two_dim)
+{
+  int nargin = args.length ();
+
+  if (two_dim) {
+    if ((nargin != 1) && (nargin != 3))
+      ocl_error ("wrong number or type of arguments");
+
+    octave_idx_type m = -1, n = -1;
+    if (nargin == 3) {
+      m = fft_length_arg (args(1));
+      n = fft_length_arg (args(2));
+    }
+
+    return new octave_base_ocl_matrix<CAT> (x.fft (m, 0, inverse).fft (n, 1, inverse));
+  }
+
+  if (nargin > 3)
+    ocl_error ("wrong number or type of arguments");
+
+  octave_idx_type n = -1;
+  if ((nargin > 1) && (args(1).numel () > 0))
+    n = fft_length_arg (args(1));
+
+  int dim = -1;
+  if (nargin > 2) {
+    if (! args(2).is_real_scalar ())
+      ocl_error ("wrong number or type of arguments");
+    dim = args(2).scalar_value () - 1;
+    if (dim < 0)
+      ocl_error ("fft: DIM must be a valid dimension");
+  }
+
+  return new octave_base_ocl_matrix<CAT> (x.fft (n, dim, inverse));
+}
+
+
+// convolution helpers (conv, conv2, filter)
+
+enum conv_shape { conv_full, conv_same, conv_valid };
+
+
+static
+conv_shape
+conv_shape_arg (const octave_value& arg)
+{
+  if (! arg.is_string ())
+    ocl_error ("wrong number or type of arguments");
+
+  std::string shape = arg.string_value ();
+  std::transform (shape.begin (), shape.end (), shape.begin (), ::tolower);
+  if (shape == "full")
+    return conv_full;
+  else if (shape == "same")
+    return conv_same;
+  else if (shape == "valid")
+    return conv_valid;
+
+  ocl_error ("conv: SHAPE type not valid");
+  return conv_full;
+}
+
+
+// number of outputs, and their offset into the full convolution, for a
+// convolution of ns source elements with nk kernel elements
+static
+void
+conv_shape_range (conv_shape shape, octave_idx_type ns, octave_idx_type nk,
+                  octave_idx_type& n_out, octave_idx_type& shift)
+{
+  const octave_idx_type zero = 0;
+
+  switch (shape) {
+    case conv_same:
+      n_out = ns;
+      shift = nk / 2;
+      break;
+    case conv_valid:
+      n_out = std::max (ns - std::max (nk - 1, zero), zero);
+      shift = std::max (nk - 1, zero);
+      break;
+    default:
+      n_out = std::max (ns + nk - 1, zero);
+      shift = 0;
+  }
+}
+
+
+static
+bool
+conv_is_vector (const dim_vector& dv)
+{
+  return ((dv.ndims () == 2) && ((dv(0) == 1) || (dv(1) == 1)));
+}
+
+
+// host values of an operand (octave or OCL matrix) as an array of class T
+
+static void host_array_value (const octave_value& arg, Array<double>& a)
+{ a = arg.array_value (); }
+
+static void host_array_value (const octave_value& arg, Array<float>& a)
+{ a = arg.float_array_value (); }
+
+static void host_array_value (const octave_value& arg, Array<Complex>& a)
+{ a = arg.complex_array_value (); }
+
+static void host_array_value (const octave_value& arg, Array<FloatComplex>& a)
+{ a = arg.float_complex_array_value (); }
+
+static void host_array_value (const octave_value& arg, Array<octave_int8>& a)
+{ a = arg.int8_array_value (); }
+
+static void host_array_value (const octave_value& arg, Array<octave_int16>& a)
+{ a = arg.int16_array_value (); }
+
+static void host_array_value (const octave_value& arg, Array<octave_int32>& a)
+{ a = arg.int32_array_value (); }
+
+static void host_array_value (const octave_value& arg, Array<octave_int64>& a)
+{ a = arg.int64_array_value (); }
+
+static void host_array_value (const octave_value& arg, Array<octave_uint8>& a)
+{ a = arg.uint8_array_value (); }
+
+static void host_array_value (const octave_value& arg, Array<octave_uint16>& a)
+{ a = arg.uint16_array_value (); }
+
+static void host_array_value (const octave_value& arg, Array<octave_uint32>& a)
+{ a = arg.uint32_array_value (); }
+
+static void host_array_value (const octave_value& arg, Array<octave_uint64>& a)
+{ a = arg.uint64_array_value (); }
+
+
+static double conv_eps (double) { return std::numeric_limits<double>::epsilon (); }
+static double conv_eps (float) { return std::numeric_limits<float>::epsilon (); }
+static double conv_eps (const Complex&) { return std::numeric_limits<double>::epsilon (); }
+static double conv_eps (const FloatComplex&) { return std::numeric_limits<float>::epsilon (); }
+
+
+// an operand as an OCL array of class T: an OCL matrix of that class as it
+// is, other (octave) arrays are converted and transferred to the device
+template <typename T>
+static
+OclArray<T>
+conv_ocl_arg (const octave_value& arg)
+{
+  octave_base_ocl_matrix<OclArray<T> > *ovom = dynamic_cast< octave_base_ocl_matrix<OclArray<T> > *> (arg.internal_rep ());
+  if (ovom != 0)
+    return ovom->ocl_array_value ();
+
+  Array<T> a;
+  host_array_value (arg, a);
+  return OclArray<T> (a);
+}
+
+
+// real part of a result computed via complex transforms, for real T
+
+static void conv_result (OclArray<double>& r, const OclArray<Complex>& y)
+{ r = y.map_c2r<double> (octave_base_value::umap_real); }
+
+static void conv_result (OclArray<float>& r, const OclArray<FloatComplex>& y)
+{ r = y.map_c2r<float> (octave_base_value::umap_real); }
+
+static void conv_result (OclArray<Complex>& r, const OclArray<Complex>& y)
+{ r = y; }
+
+static void conv_result (OclArray<FloatComplex>& r, const OclArray<FloatComplex>& y)
+{ r = y; }
+
+
+// convolution along dim with a long kernel vector, as the product of the
+// transforms of length ns + nk - 1 (the kernel's transform replicated
+// over all slices of x)
+template <typename T, typename CT>
+static
+OclArray<T>
+ocl_conv_fft_dim (const OclArray<T>& x, const OclArray<T>& kern, int dim,
+                  octave_idx_type n_out, octave_idx_type shift)
+{
+  dim_vector dv = x.dims ().redim (std::max (dim + 1, x.ndims ()));
+  octave_idx_type nk = kern.numel ();
+  if ((x.numel () == 0) || (nk == 0))
+    return x.conv (Array<T> (dim_vector (0, 1)), dim, n_out, shift);
+
+  octave_idx_type len = dv(dim) + nk - 1;
+  dim_vector kdv = dv;
+  for (int i=0; i<kdv.ndims (); i++)
+    kdv(i) = 1;
+  kdv(dim) = nk;
+
+  OclArray<CT> fx = OclArray<CT> (x).fft (len, dim);
+  OclArray<CT> fk = OclArray<CT> (kern.reshape (kdv)).fft (len, dim);
+  if (fk.numel () != fx.numel ()) {
+    dim_vector rdv = fx.dims ();
+    rdv(dim) = 1;
+    fk = fk.repmat (rdv);
+  }
+
+  Array<idx_vector> ia (dim_vector (fx.ndims (), 1), idx_vector::colon);
+  ia(dim) = idx_vector (shift, shift + n_out);
+
+  OclArray<T> result;
+  conv_result (result, fx.times (fk).fft (-1, dim, true).index (ia));
+  return result;
+}
+
+
+// convolution along dim with the host kernel vector kern: directly for
+// short kernels, else via transforms
+template <typename T, typename CT>
+static
+OclArray<T>
+ocl_conv_dim (const OclArray<T>& x, const Array<T>& kern, int dim,
+              octave_idx_type n_out, octave_idx_type shift)
+{
+  if ((kern.numel () == 1) && (x.numel () > 0)) {
+    if (kern(0) == T (1))
+      return x;
+    return x.times (kern(0));
+  }
+
+  if (OclArray<T>::conv_is_direct (kern.numel (), 1))
+    return x.conv (kern, dim, n_out, shift);
+
+  return ocl_conv_fft_dim<T, CT> (x, OclArray<T> (kern), dim, n_out, shift);
+}
+
+
+// conv2 with the kernel u * v.' (u, v vectors): a convolution along the
+// columns with u followed by one along the rows with v
+template <typename T, typename CT>
+static
+OclArray<T>
+ocl_conv_separable (const OclArray<T>& a, const Array<T>& u, const Array<T>& v, conv_shape shape)
+{
+  octave_idx_type m_out, n_out, shift_r, shift_c;
+  conv_shape_range (shape, a.dim1 (), u.numel (), m_out, shift_r);
+  conv_shape_range (shape, a.dim2 (), v.numel (), n_out, shift_c);
+
+  return ocl_conv_dim<T, CT> (ocl_conv_dim<T, CT> (a, u, 0, m_out, shift_r), v, 1, n_out, shift_c);
+}
+
+
+// whether the host matrix k is, to rounding, of rank one: k = u * v.'
+template <typename T>
+static
+bool
+conv_rank1 (const Array<T>& k, Array<T>& u, Array<T>& v)
+{
+  octave_idx_type mk = k.rows (), nk = k.cols ();
+  octave_idx_type p = 0, q = 0;
+  double kmax = 0;
+
+  for (octave_idx_type j=0; j<nk; j++)
+    for (octave_idx_type i=0; i<mk; i++)
+      if (std::abs (k(i,j)) > kmax) {
+        kmax = std::abs (k(i,j));
+        p = i;
+        q = j;
+      }
+  if (kmax == 0)
+    return false;
+
+  u = Array<T> (dim_vector (mk, 1));
+  v = Array<T> (dim_vector (nk, 1));
+  for (octave_idx_type i=0; i<mk; i++)
+    u(i) = k(i,q);
+  for (octave_idx_type j=0; j<nk; j++)
+    v(j) = k(p,j) / k(p,q);
+
+  double tol = 8 * conv_eps (T ()) * std::max (mk, nk) * kmax;
+  for (octave_idx_type j=0; j<nk; j++)
+    for (octave_idx_type i=0; i<mk; i++)
+      if (std::abs (k(i,j) - u(i) * v(j)) > tol)
+        return false;
+
+  return true;
+}
+
+
+// Kernels with up to conv2_separable_max elements are checked for
+// separability (which needs them on the host).
+static const octave_idx_type conv2_separable_max = 4096;
+
+
+// conv (A, B, SHAPE) of two vectors, along the longer one (B, if of equal
+// length); it also determines the orientation of the result
+template <typename T, typename CT>
+static
+octave_value
+ocl_conv_apply (const octave_value_list& args, int nargout)
+{
+  int nargin = args.length ();
+  if ((nargout > 1) || (nargin < 2) || (nargin > 3))
+    ocl_error ("wrong number or type of arguments");
+
+  conv_shape shape = (nargin > 2) ? conv_shape_arg (args(2)) : conv_full;
+
+  if ((! conv_is_vector (args(0).dims ())) || (! conv_is_vector (args(1).dims ())))
+    ocl_error ("conv: both arguments A and B must be vectors");
+
+  octave_idx_type la = args(0).numel (), lb = args(1).numel ();
+  octave_idx_type n_out, shift;
+  conv_shape_range (shape, la, lb, n_out, shift);
+
+  int ix = (la > lb) ? 0 : 1;
+  OclArray<T> x = conv_ocl_arg<T> (args(ix));
+  const octave_value& kern = args(1-ix);
+  int dim = ((x.dim1 () == 1) && (x.dim2 () != 1)) ? 1 : 0;
+
+  if (OclArray<T>::conv_is_direct (kern.numel (), 1)) {
+    Array<T> k;
+    host_array_value (kern, k);
+    return new octave_base_ocl_matrix<OclArray<T> > (ocl_conv_dim<T, CT> (x, k, dim, n_out, shift));
+  }
+
+  return new octave_base_ocl_matrix<OclArray<T> > (ocl_conv_fft_dim<T, CT> (x, conv_ocl_arg<T> (kern), dim, n_out, shift));
+}
+
+
+// conv2 (A, B, SHAPE), and conv2 (M, V1, V2, SHAPE) for the separable
+// form conv2 (V1, V2, M, SHAPE) (reordered by the method wrapper)
+template <typename T, typename CT>
+static
+octave_value
+ocl_conv2_apply (const octave_value_list& args, int nargout)
+{
+  int nargin = args.length ();
+  if ((nargout > 1) || (nargin < 2) || (nargin > 4))
+    ocl_error ("wrong number or type of arguments");
+
+  bool separable_form = (nargin > 2) && (! args(2).is_string ());
+  if ((nargin == 4) && (! separable_form))
+    ocl_error ("wrong number or type of arguments");
+  conv_shape shape = (nargin > (separable_form ? 3 : 2)) ? conv_shape_arg (args(nargin-1)) : conv_full;
+
+  OclArray<T> a = conv_ocl_arg<T> (args(0));
+  if ((a.ndims () != 2) || (args(1).ndims () != 2))
+    ocl_error ("conv2: A and B must be 1-D vectors or 2-D matrices");
+
+  if (separable_form) {
+    if ((! conv_is_vector (args(1).dims ())) || (! conv_is_vector (args(2).dims ())))
+      ocl_error ("conv2: arguments V1 and V2 must be vectors");
+
+    Array<T> u, v;
+    host_array_value (args(1), u);
+    host_array_value (args(2), v);
+    return new octave_base_ocl_matrix<OclArray<T> > (ocl_conv_separable<T, CT> (a, u, v, shape));
+  }
+
+  octave_idx_type mk = args(1).rows (), nk = args(1).columns ();
+  octave_idx_type m_out, n_out, shift_r, shift_c;
+  conv_shape_range (shape, a.dim1 (), mk, m_out, shift_r);
+  conv_shape_range (shape, a.dim2 (), nk, n_out, shift_c);
+
+  // short or separable kernels are applied directly
+  if (mk * nk <= conv2_separable_max) {
+    Array<T> k, u, v;
+    host_array_value (args(1), k);
+    if (conv_rank1 (k, u, v))
+      return new octave_base_ocl_matrix<OclArray<T> > (ocl_conv_separable<T, CT> (a, u, v, shape));
+    if (OclArray<T>::conv_is_direct (mk, nk))
+      return new octave_base_ocl_matrix<OclArray<T> > (a.conv2 (k, m_out, n_out, shift_r, shift_c));
+  }
+
+  // else, as the product of the 2-dim transforms
+  OclArray<T> b = conv_ocl_arg<T> (args(1));
+  if ((a.numel () == 0) || (b.numel () == 0))
+    return new octave_base_ocl_matrix<OclArray<T> > (a.conv2 (Array<T> (dim_vector (0, 0)), m_out, n_out, 0, 0));
+
+  octave_idx_type m = a.dim1 () + mk - 1, n = a.dim2 () + nk - 1;
+  OclArray<CT> fa = OclArray<CT> (a).fft (m, 0).fft (n, 1);
+  OclArray<CT> fb = OclArray<CT> (b).fft (m, 0).fft (n, 1);
+
+  OclArray<T> result;
+  conv_result (result, fa.times (fb).fft (-1, 0, true).fft (-1, 1, true)
+                         .index (idx_vector (shift_r, shift_r + m_out), idx_vector (shift_c, shift_c + n_out)));
+  return new octave_base_ocl_matrix<OclArray<T> > (result);
+}
+
+
+// filter (X, B, A, SI, DIM) for filter (B, A, X, SI, DIM) (reordered by
+// the method wrapper): the moving average part as a convolution, and the
+// recursive part in chunks in parallel; no initial conditions
+template <typename T, typename CT>
+static
+octave_value
+ocl_filter_apply (const octave_value_list& args, int nargout)
+{
+  int nargin = args.length ();
+  if ((nargout > 1) || (nargin < 3) || (nargin > 5))
+    ocl_error ("wrong number or type of arguments");
+  if ((nargin > 3) && (args(3).numel () > 0))
+    ocl_error ("filter: initial conditions SI are not supported for OCL matrices");
+
+  OclArray<T> x = conv_ocl_arg<T> (args(0));
+  Array<T> b, a;
+  host_array_value (args(1), b);
+  host_array_value (args(2), a);
+
+  int dim = -1;
+  if (nargin > 4) {
+    if (! args(4).is_real_scalar ())
+      ocl_error ("wrong number or type of arguments");
+    dim = args(4).scalar_value () - 1;
+    if (dim < 0)
+      ocl_error ("filter: DIM must be a valid dimension");
+  }
+  if (dim < 0)
+    dim = x.dims ().first_non_singleton ();
+
+  // normalized to a (0) = 1, and without trailing zeros of a
+  octave_idx_type na = a.numel ();
+  while ((na > 0) && (a(na-1) == T (0)))
+    na--;
+  if ((na == 0) || (a(0) == T (0)))
+    ocl_error ("filter: a(1) must be nonzero");
+
+  Array<T> bn (dim_vector (b.numel (), 1));
+  Array<T> an (dim_vector (na - 1, 1));
+  for (octave_idx_type k=0; k<b.numel (); k++)
+    bn(k) = b(k) / a(0);
+  for (octave_idx_type k=1; k<na; k++)
+    an(k-1) = a(k) / a(0);
+
+  octave_idx_type n = (dim < x.ndims ()) ? x.dims ()(dim) : 1;
+  OclArray<T> y = ocl_conv_dim<T, CT> (x, bn, dim, n, 0);
+
+  return new octave_base_ocl_matrix<OclArray<T> > (y.filter_iir (an, dim));
+}
+
+
+// X = linsolve (A, B) or linsolve (A, B, OPTS): a triangular solve for the
+// fields LT or UT (lower or upper triangular A) of OPTS, else by the LU
+// factorization; with the field TRANSA, for A' * X = B
+template <typename T>
+static
+octave_value
+ocl_linsolve_apply (const octave_value_list& args, int nargout)
+{
+  int nargin = args.length ();
+  if ((nargout > 1) || (nargin < 2) || (nargin > 3))
+    ocl_error ("wrong number or type of arguments");
+
+  bool lower = false, upper = false, trans = false;
+  if (nargin > 2) {
+    octave_scalar_map opts = args(2).scalar_map_value ();
+    lower = opts.isfield ("LT") && opts.getfield ("LT").is_true ();
+    upper = opts.isfield ("UT") && opts.getfield ("UT").is_true ();
+    trans = opts.isfield ("TRANSA") && opts.getfield ("TRANSA").is_true ();
+  }
+
+  OclArray<T> a = conv_ocl_arg<T> (args(0));
+  OclArray<T> b = conv_ocl_arg<T> (args(1));
+
+  if (lower || upper)
+    return new octave_base_ocl_matrix<OclArray<T> > (a.trsm (b, upper, trans ? 'C' : 'N'));
+
+  octave_idx_type info;
+  OclArray<T> x = (trans ? a.hermitian () : a).mldivide (b, info);
+  if (info > 0)
+    warning_singular_oclmat ();
+
+  return new octave_base_ocl_matrix<OclArray<T> > (x);
+}
+
+
+// trapz (Y), trapz (X, Y), trapz (Y, DIM) or trapz (X, Y, DIM), and likewise
+// cumtrapz: X are coordinates along DIM (a vector) or of the size of Y; a
+// scalar second argument is DIM, as with octave's trapz
+template <typename T>
+static
+octave_value
+ocl_trapz_apply (const octave_value_list& args, int nargout, bool cumulative)
+{
+  int nargin = args.length ();
+  if ((nargout > 1) || (nargin < 1) || (nargin > 3))
+    ocl_error ("wrong number or type of arguments");
+
+  bool have_x = (nargin == 3) ||
+                ((nargin == 2) && ! (args(1).is_real_scalar () && (args(0).numel () != 1)));
+  bool have_dim = (nargin == 3) || ((nargin == 2) && ! have_x);
+
+  OclArray<T> y = conv_ocl_arg<T> (args(have_x ? 1 : 0));
+  OclArray<T> x;
+  if (have_x)
+    x = conv_ocl_arg<T> (args(0));
+
+  int dim = -1;
+  if (have_dim) {
+    if (! args(nargin-1).is_real_scalar ())
+      ocl_error ("wrong number or type of arguments");
+    dim = args(nargin-1).scalar_value () - 1;
+    if (dim < 0)
+      ocl_error ("trapz: DIM must be a valid dimension");
+  }
+
+  if (cumulative)
+    return new octave_base_ocl_matrix<OclArray<T> > (y.cumtrapz (x, dim));
+  else
+    return new octave_base_ocl_matrix<OclArray<T> > (y.trapz (x, dim));
+}
+
+
+template <typename AT>
+octave_value_list
+octave_base_ocl_matrix<AT>::fft_common (const octave_value_list& args, int nargout, bool inverse, bool two_dim)
+{
+  ocl_error ("wrong argument type");
+}
+
+
+template <typename AT>
+octave_value_list
+octave_base_ocl_matrix<AT>::fft (const octave_value_list& args, int nargout)
+{
+  return fft_common (args, nargout, false, false);
+}
+
+
+template <typename AT>
+octave_value_list
+octave_base_ocl_matrix<AT>::ifft (const octave_value_list& args, int nargout)
+{
+  return fft_common (args, nargout, true, false);
+}
+
+
+template <typename AT>
+octave_value_list
+octave_base_ocl_matrix<AT>::fft2 (const octave_value_list& args, int nargout)
+{
+  return fft_common (args, nargout, false, true);
+}
+
+
+template <typename AT>
+octave_value_list
+octave_base_ocl_matrix<AT>::ifft2 (const octave_value_list& args, int nargout)
+{
+  return fft_common (args, nargout, true, true);
+}
+
+
+template <typename AT>
+octave_value_list
+octave_base_ocl_matrix<AT>::conv (const octave_value_list& args, int nargout)
+{
+  ocl_error ("wrong argument type");
+}
+
+
+template <typename AT>
+octave_value_list
+octave_base_ocl_matrix<AT>::conv2 (const octave_value_list& args, int nargout)
+{
+  ocl_error ("wrong argument type");
+}
+
+
+template <typename AT>
+octave_value_list
+octave_base_ocl_matrix<AT>::filter (const octave_value_list& args, int nargout)
+{
+  ocl_error ("wrong argument type");
+}
+
+
+// Y = lu (A) (L and U in one matrix, as LAPACK's getrf), [L, U] = lu (A)
+// (with the rows of L permuted), or [L, U, P] = lu (A), also with the
+// "vector" option for P as (host) permutation vector
+template <typename AT>
+octave_value_list
+octave_base_ocl_matrix<AT>::lu (const octave_value_list& args, int nargout)
 {
   int nargin = args.length ();
-  if ((nargout > 2) || (nargin > 2) || ((nargin > 1) && (!args(1).is_real_scalar ())))
+  if ((nargout > 3) || (nargin < 1) || (nargin > 2) ||
+      ((nargin > 1) && (! args(1).is_string ())))
     ocl_error ("wrong number or type of arguments");
 
-  int dim = -1;
-  if (nargin > 1)
-    dim = args(1).scalar_value () - 1;
+  bool vector_perm = false;
+  if (nargin > 1) {
+    if (args(1).string_value () != "vector")
+      ocl_error ("lu: the only option for OCL matrices is \"vector\"");
+    vector_perm = true;
+  }
 
   octave_base_value *arg0_rep = args(0).internal_rep ();
   if (arg0_rep->type_id () != static_type_id ())
@@ -849,174 +2131,251 @@ octave_base_ocl_matrix<AT>::cummin (const octave_value_list& args, int nargout)
   if (ovom == 0)
     return octave_value ();
 
+  OclArray<ocl_idx_type> ipiv;
+  octave_idx_type info;
+  AT y = ovom->ocl_array_value ().lu (ipiv, info);
+
   if (nargout < 2)
-    return ovom->cummin (dim);
-  else {
-    octave_value result, indices;
-    result = ovom->cummin (indices, dim);
-    octave_value_list retval;
-    retval (0) = result;
-    retval (1) = indices;
-    return retval;
+    return octave_value (new octave_base_ocl_matrix<AT> (y));
+
+  octave_idx_type m = y.dim1 ();
+  octave_idx_type n = y.dim2 ();
+  octave_idx_type mn = std::min (m, n);
+  AT l = y.get_block (0, 0, m, mn).tril (0, true);
+  AT u = y.get_block (0, 0, mn, n).triu ();
+
+  // the row permutation from the interchanges
+  Array<ocl_idx_type> piv = ipiv.as_array ();
+  Array<octave_idx_type> perm (dim_vector (m, 1));
+  for (octave_idx_type i=0; i<m; i++)
+    perm (i) = i;
+  for (octave_idx_type j=0; j<mn; j++)
+    std::swap (perm (j), perm (piv (j).value ()));
+
+  octave_value_list retval (nargout);
+
+  if (nargout == 2) {
+    // P' * L, gathered on the device by the linear indices of its elements
+    Array<octave_idx_type> iperm (dim_vector (m, 1));
+    for (octave_idx_type i=0; i<m; i++)
+      iperm (perm (i)) = i;
+    if (l.numel () > 0) {
+      Array<ocl_idx_type> idx (dim_vector (m, mn));
+      for (octave_idx_type j=0; j<mn; j++)
+        for (octave_idx_type i=0; i<m; i++)
+          idx (i, j) = ocl_idx_type (iperm (i) + j * m);
+      l = l.index (OclArray<ocl_idx_type> (idx));
+    }
+    retval(0) = octave_value (new octave_base_ocl_matrix<AT> (l));
+  } else {
+    retval(0) = octave_value (new octave_base_ocl_matrix<AT> (l));
+    if (vector_perm) {
+      Array<double> p (dim_vector (1, m));
+      for (octave_idx_type i=0; i<m; i++)
+        p (i) = perm (i) + 1;
+      retval(2) = octave_value (p);
+    } else {
+      Array<typename AT::element_type> p (dim_vector (m, m), typename AT::element_type (0));
+      for (octave_idx_type i=0; i<m; i++)
+        p (i, perm (i)) = typename AT::element_type (1);
+      retval(2) = octave_value (new octave_base_ocl_matrix<AT> (AT (p)));
+    }
   }
+  retval(1) = octave_value (new octave_base_ocl_matrix<AT> (u));
+
+  return retval;
 }
 
 
+// R = chol (A), [R, P] = chol (A) (P > 0 if A is not positive definite,
+// with R of size P-1), also with the "lower" option for L = R'
 template <typename AT>
 octave_value_list
-octave_base_ocl_matrix<AT>::atan2 (const octave_value_list& args, int nargout)
+octave_base_ocl_matrix<AT>::chol (const octave_value_list& args, int nargout)
 {
   int nargin = args.length ();
-  if ((nargout > 1) || (nargin != 2) ||
-      (args(1).type_id () != args(0).type_id ()))
+  if ((nargout > 2) || (nargin < 1) || (nargin > 2) ||
+      ((nargin > 1) && (! args(1).is_string ())))
     ocl_error ("wrong number or type of arguments");
 
+  bool lower = false;
+  if (nargin > 1) {
+    std::string shape = args(1).string_value ();
+    if (shape == "lower")
+      lower = true;
+    else if (shape != "upper")
+      ocl_error ("chol: optional argument must be one of \"upper\" or \"lower\"");
+  }
+
   octave_base_value *arg0_rep = args(0).internal_rep ();
   if (arg0_rep->type_id () != static_type_id ())
     ocl_error ("wrong argument type");
-  octave_base_ocl_matrix<AT> *ovom0 = dynamic_cast< octave_base_ocl_matrix<AT> *> (arg0_rep);
-  if (ovom0 == 0)
+  octave_base_ocl_matrix<AT> *ovom = dynamic_cast< octave_base_ocl_matrix<AT> *> (arg0_rep);
+  if (ovom == 0)
     return octave_value ();
 
-  octave_base_value *arg1_rep = args(1).internal_rep ();
-  if (arg1_rep->type_id () != static_type_id ())
-    ocl_error ("wrong argument type");
-  octave_base_ocl_matrix<AT> *ovom1 = dynamic_cast< octave_base_ocl_matrix<AT> *> (arg1_rep);
-  if (ovom1 == 0)
-    return octave_value ();
+  octave_idx_type info;
+  AT r = ovom->ocl_array_value ().chol (info);
 
-#if ! defined (OCL_OCTAVE_VERSION_4_4_0_AND_HIGHER) // for octave versions < 4.4.0
-  if (ovom0->is_integer_type ())
-#else // for octave versions >= 4.4.0
-  if (ovom0->isinteger ())
-#endif
-    ocl_error ("wrong argument type");
+  if (info > 0) {
+    if (nargout < 2)
+      ocl_error ("chol: input matrix must be positive definite");
+    r = r.get_block (0, 0, info - 1, info - 1);
+  }
+  if (lower)
+    r = r.hermitian ();
 
-  return ovom0->atan2 (*ovom1);
+  octave_value_list retval (std::max (nargout, 1));
+  retval(0) = octave_value (new octave_base_ocl_matrix<AT> (r));
+  if (nargout > 1)
+    retval(1) = octave_value ((double) info);
+
+  return retval;
 }
 
 
 template <typename AT>
 octave_value_list
-octave_base_ocl_matrix<AT>::ndgrid (const octave_value_list& args, int nargout)
+octave_base_ocl_matrix<AT>::linsolve (const octave_value_list& args, int nargout)
+{
+  ocl_error ("wrong argument type");
+}
+
+
+// N = histc (X, EDGES) or histc (X, EDGES, DIM), with the counts as an
+// ocl double matrix (as octave's histc), or as an octave double matrix if
+// the context lacks double support; EDGES may also be an octave vector
+template <typename AT>
+octave_value_list
+octave_base_ocl_matrix<AT>::histc (const octave_value_list& args, int nargout)
 {
   int nargin = args.length ();
-  if (((nargin == 1) && (nargout != 2)) ||
-      ((nargin != 1) && (nargout != nargin)))
-    ocl_error ("wrong number of arguments");
+  if ((nargout > 1) || (nargin < 2) || (nargin > 3) ||
+      ((nargin > 2) && (! args(2).is_real_scalar ())))
+    ocl_error ("wrong number or type of arguments");
 
-  int type_id = args(0).type_id ();
-  if (type_id != static_type_id ())
+  octave_base_value *arg0_rep = args(0).internal_rep ();
+  if (arg0_rep->type_id () != static_type_id ())
     ocl_error ("wrong argument type");
-  for (int i = 0; i < nargin; i++) {
-    octave_value ai = args(i);
-    if ((ai.type_id () != type_id) || (ai.ndims () > 2) || ((ai.rows () != 1) && (ai.columns () != 1)))
-      ocl_error ("all input arguments must be vectors of the same ocl matrix type");
-  }
-
-  std::vector< array_type > array_list (nargin);
-  for (int i = 0; i < nargin; i++) {
-    octave_base_value *argi_rep = args(i).internal_rep ();
-    octave_base_ocl_matrix<AT> *ovom = dynamic_cast< octave_base_ocl_matrix<AT> *> (argi_rep);
-    if (ovom == 0)
-      return octave_value ();
-    array_list [i] = ovom->ocl_array_value ();
-  }
+  octave_base_ocl_matrix<AT> *ovom = dynamic_cast< octave_base_ocl_matrix<AT> *> (arg0_rep);
+  if (ovom == 0)
+    return octave_value ();
 
-  std::vector< array_type > result_list;
-  result_list = array_type::ndgrid (array_list);
+  AT edges = conv_ocl_arg<typename AT::element_type> (args(1));
 
-  octave_value_list retval;
-  for (int i = 0; i < nargout; i++)
-    retval (i) = new octave_base_ocl_matrix<AT> (result_list [i]);
+  int dim = -1;
+  if (nargin > 2) {
+    dim = args(2).scalar_value () - 1;
+    if (dim < 0)
+      ocl_error ("histc: DIM must be a valid dimension");
+  }
 
-  return retval;
+  if (opencl_context_is_fp64 ())
+    return octave_value (new octave_ocl_matrix (ovom->ocl_array_value ().histc (edges, dim)));
+  else
+    return octave_value (NDArray (ovom->ocl_array_value ().histc_host (edges, dim)));
 }
 
 
+// A = accumarray (SUBS, VALS), accumarray (SUBS, VALS, SZ),
+// accumarray (SUBS, VALS, SZ, FUNC) or accumarray (SUBS, VALS, SZ, FUNC, FILLVAL)
+// for VALS of this class (or for octave VALS, with SUBS of this class):
+// SUBS is a vector of (linear) subscripts or a matrix with the subscripts
+// of each dimension in its columns, as OCL matrix of any class (e.g., from
+// as_index) or octave matrix; FUNC is @sum (the default), @max or @min
 template <typename AT>
 octave_value_list
-octave_base_ocl_matrix<AT>::meshgrid (const octave_value_list& args, int nargout)
+octave_base_ocl_matrix<AT>::accumarray (const octave_value_list& args, int nargout)
 {
+  typedef typename AT::element_type T;
+
   int nargin = args.length ();
-  if (((nargin == 1) && (nargout != 2)) ||
-      ((nargin != 1) && (nargout != nargin)))
-    ocl_error ("wrong number of arguments");
+  if ((nargout > 1) || (nargin < 2) || (nargin > 5) ||
+      ((nargin > 4) && (! args(4).is_scalar_type ())))
+    ocl_error ("wrong number or type of arguments");
 
-  int type_id = args(0).type_id ();
-  if (type_id != static_type_id ())
-    ocl_error ("wrong argument type");
-  for (int i = 0; i < nargin; i++) {
-    octave_value ai = args(i);
-    if ((ai.type_id () != type_id) || (ai.ndims () > 2) || ((ai.rows () != 1) && (ai.columns () != 1)))
-      ocl_error ("all input arguments must be vectors of the same ocl matrix type");
+  OclArray<ocl_idx_type> subs;
+  if (! oclmat_to_oclidxarray (args(0), subs))
+    subs = conv_ocl_arg<ocl_idx_type> (args(0));
+  AT vals = conv_ocl_arg<T> (args(1));
+
+  int fcn = 0;
+  if ((nargin > 3) && (args(3).numel () > 0)) {
+    if (! args(3).is_function_handle ())
+      ocl_error ("accumarray: FUNC must be @sum, @max or @min");
+    std::string name = args(3).fcn_handle_value ()->fcn_name ();
+    if ((name.length () > 0) && (name [0] == '@'))
+      name = name.substr (1);
+    if (name == "max")
+      fcn = 1;
+    else if (name == "min")
+      fcn = 2;
+    else if (name != "sum")
+      ocl_error ("accumarray: FUNC must be @sum, @max or @min");
   }
 
-  std::vector< array_type > array_list (nargin);
-  for (int i = 0; i < nargin; i++) {
-    octave_base_value *argi_rep = args(i).internal_rep ();
-    octave_base_ocl_matrix<AT> *ovom = dynamic_cast< octave_base_ocl_matrix<AT> *> (argi_rep);
-    if (ovom == 0)
-      return octave_value ();
-    array_list [i] = ovom->ocl_array_value ();
+  T fillval = T (0);
+  if (nargin > 4)
+    fillval = conv_ocl_arg<T> (args(4)).as_array () (0);
+
+  // a column (or any vector but a row) of linear subscripts, or the
+  // subscripts of each dimension in the columns
+  octave_idx_type nd = ((subs.ndims () == 2) && (subs.columns () > 1)) ? subs.columns () : 1;
+  if (nd == 1)
+    subs = subs.reshape (subs.numel (), 1);
+
+  dim_vector sz;
+  if ((nargin > 2) && (args(2).numel () > 0)) {
+    Array<octave_idx_type> sz_arg = args(2).octave_idx_type_vector_value ();
+    if ((sz_arg.numel () < 2) || ((nd == 1) && ((sz_arg.numel () != 2) || (sz_arg (1) != 1))) ||
+        ((nd > 1) && (sz_arg.numel () != nd)))
+      ocl_error ("accumarray: dimensions mismatch");
+    sz = dim_vector::alloc (sz_arg.numel ());
+    for (octave_idx_type k=0; k<sz_arg.numel (); k++)
+      sz (k) = sz_arg (k);
+  } else {
+    sz = dim_vector::alloc (std::max (nd, (octave_idx_type) 2));
+    sz (1) = 1;
+    if (subs.numel () > 0) {
+      Array<ocl_idx_type> subs_max = subs.max (0).as_array ();
+      for (octave_idx_type k=0; k<nd; k++)
+        sz (k) = std::max ((octave_idx_type) subs_max (k).value (), (octave_idx_type) 0);
+    } else
+      sz (0) = 0;
   }
 
-  std::vector< array_type > result_list;
-  result_list = array_type::meshgrid (array_list);
+  // linear subscripts from the subscripts of each dimension (checked for
+  // the range of the output only as linear subscripts)
+  if (nd > 1) {
+    OclArray<ocl_idx_type> lin = subs.index (idx_vector::colon, idx_vector (0));
+    octave_idx_type stride = 1;
+    for (octave_idx_type k=1; k<nd; k++) {
+      stride *= sz (k-1);
+      OclArray<ocl_idx_type> col = subs.index (idx_vector::colon, idx_vector (k));
+      lin += (col - ocl_idx_type (1)) * ocl_idx_type (stride);
+    }
+    subs = lin;
+  }
 
-  octave_value_list retval;
-  for (int i = 0; i < nargout; i++)
-    retval (i) = new octave_base_ocl_matrix<AT> (result_list [i]);
+  AT result = AT::accumarray (subs, vals, sz.numel (), fcn, fillval);
 
-  return retval;
+  return octave_value (new octave_base_ocl_matrix<AT> (result.reshape (sz)));
 }
 
 
 template <typename AT>
 octave_value_list
-octave_base_ocl_matrix<AT>::repmat (const octave_value_list& args, int nargout)
+octave_base_ocl_matrix<AT>::trapz (const octave_value_list& args, int nargout)
 {
-  int nargin = args.length ();
-  if (nargin < 2)
-    ocl_error ("too few arguments");
-
-  octave_base_value *arg0_rep = args(0).internal_rep ();
-  if (arg0_rep->type_id () != static_type_id ())
-    ocl_error ("wrong argument type");
-  octave_base_ocl_matrix<AT> *ovom = dynamic_cast< octave_base_ocl_matrix<AT> *> (arg0_rep);
-  if (ovom == 0)
-    return octave_value ();
-
-  dim_vector dv (1,1);
-  if (args (1).is_real_matrix ()) {
-    if (nargin > 2)
-      ocl_error ("too many arguments");
-    Matrix m = args (1).matrix_value ();
-    int ndim = m.numel ();
-    dv = dv.redim (ndim);
-    for (octave_idx_type i = 0; i < ndim; i++)
-      dv (i) = m (i);
-  } else {
-    int ndim = nargin-1;
-    dv = dv.redim (ndim);
-    for (octave_idx_type i = 0; i < ndim; i++) {
-      if (!args (1+i).is_real_scalar ())
-        ocl_error ("wrong argument type");
-      dv (i) = args (1+i).scalar_value ();
-    }
-    if (nargin == 2)
-      dv (1) = dv (0);
-  }
-
-  return octave_value (new octave_base_ocl_matrix<AT> (ovom->ocl_array_value ().repmat (dv)));
+  ocl_error ("wrong argument type");
 }
 
 
 template <typename AT>
 octave_value_list
-octave_base_ocl_matrix<AT>::complex (const octave_value_list& args, int nargout)
+octave_base_ocl_matrix<AT>::cumtrapz (const octave_value_list& args, int nargout)
 {
-  ocl_error ("complex: invalid conversion");
+  ocl_error ("wrong argument type");
 }
 
 
@@ -1307,6 +2666,94 @@ octave_base_ocl_matrix<OclArray<float> >::complex (const octave_value_list& args
 }
 
 
+// real arrays are transformed as complex arrays
+
+#define SPECIALIZE_OCL_FFT_COMMON( T, CT ) \
+  template <> \
+  octave_value_list \
+  octave_base_ocl_matrix<OclArray<T> >::fft_common (const octave_value_list& args, int nargout, bool inverse, bool two_dim) \
+  { \
+    if ((nargout > 1) || (args.length () < 1)) \
+      ocl_error ("wrong number or type of arguments"); \
+     \
+    octave_base_value *arg0_rep = args(0).internal_rep (); \
+    if (arg0_rep->type_id () != static_type_id ()) \
+      ocl_error ("wrong argument type"); \
+    octave_base_ocl_matrix<OclArray<T> > *ovom = dynamic_cast< octave_base_ocl_matrix<OclArray<T> > *> (arg0_rep); \
+    if (ovom == 0) \
+      return octave_value (); \
+     \
+    return ocl_fft_apply (OclArray<CT> (ovom->matrix_ref ()), args, inverse, two_dim); \
+  }
+
+
+SPECIALIZE_OCL_FFT_COMMON (double,       Complex     );
+SPECIALIZE_OCL_FFT_COMMON (float,        FloatComplex);
+SPECIALIZE_OCL_FFT_COMMON (Complex,      Complex     );
+SPECIALIZE_OCL_FFT_COMMON (FloatComplex, FloatComplex);
+
+
+// convolution and filtering of floating point arrays, with complex
+// transforms for long kernels
+
+#define SPECIALIZE_OCL_CONV( T, CT ) \
+  template <> \
+  octave_value_list \
+  octave_base_ocl_matrix<OclArray<T> >::conv (const octave_value_list& args, int nargout) \
+  { return ocl_conv_apply<T, CT> (args, nargout); } \
+   \
+  template <> \
+  octave_value_list \
+  octave_base_ocl_matrix<OclArray<T> >::conv2 (const octave_value_list& args, int nargout) \
+  { return ocl_conv2_apply<T, CT> (args, nargout); } \
+   \
+  template <> \
+  octave_value_list \
+  octave_base_ocl_matrix<OclArray<T> >::filter (const octave_value_list& args, int nargout) \
+  { return ocl_filter_apply<T, CT> (args, nargout); }
+
+
+SPECIALIZE_OCL_CONV (double,       Complex     );
+SPECIALIZE_OCL_CONV (float,        FloatComplex);
+SPECIALIZE_OCL_CONV (Complex,      Complex     );
+SPECIALIZE_OCL_CONV (FloatComplex, FloatComplex);
+
+
+// trapezoidal integration of floating point arrays
+
+#define SPECIALIZE_OCL_TRAPZ( T ) \
+  template <> \
+  octave_value_list \
+  octave_base_ocl_matrix<OclArray<T> >::trapz (const octave_value_list& args, int nargout) \
+  { return ocl_trapz_apply<T> (args, nargout, false); } \
+   \
+  template <> \
+  octave_value_list \
+  octave_base_ocl_matrix<OclArray<T> >::cumtrapz (const octave_value_list& args, int nargout) \
+  { return ocl_trapz_apply<T> (args, nargout, true); }
+
+
+SPECIALIZE_OCL_TRAPZ (double      );
+SPECIALIZE_OCL_TRAPZ (float       );
+SPECIALIZE_OCL_TRAPZ (Complex     );
+SPECIALIZE_OCL_TRAPZ (FloatComplex);
+
+
+// linear systems of floating point matrices
+
+#define SPECIALIZE_OCL_LINSOLVE( T ) \
+  template <> \
+  octave_value_list \
+  octave_base_ocl_matrix<OclArray<T> >::linsolve (const octave_value_list& args, int nargout) \
+  { return ocl_linsolve_apply<T> (args, nargout); }
+
+
+SPECIALIZE_OCL_LINSOLVE (double      );
+SPECIALIZE_OCL_LINSOLVE (float       );
+SPECIALIZE_OCL_LINSOLVE (Complex     );
+SPECIALIZE_OCL_LINSOLVE (FloatComplex);
+
+
 // ---------- octave_base_ocl_matrix<AT> instantiations
 
 
@@ -1549,7 +2996,9 @@ DEFINE_OCL_MAT_METHOD(cumsum)
 DEFINE_OCL_MAT_METHOD(cumprod)
 DEFINE_OCL_MAT_METHOD(findfirst)
 DEFINE_OCL_MAT_METHOD(findlast)
+DEFINE_OCL_MAT_METHOD(find)
 DEFINE_OCL_MAT_METHOD(std)
+DEFINE_OCL_MAT_METHOD(var)
 DEFINE_OCL_MAT_METHOD(max)
 DEFINE_OCL_MAT_METHOD(min)
 DEFINE_OCL_MAT_METHOD(cummax)
@@ -1559,6 +3008,60 @@ DEFINE_OCL_MAT_METHOD(ndgrid)
 DEFINE_OCL_MAT_METHOD(meshgrid)
 DEFINE_OCL_MAT_METHOD(repmat)
 DEFINE_OCL_MAT_METHOD(complex)
+DEFINE_OCL_MAT_METHOD(pagetranspose)
+DEFINE_OCL_MAT_METHOD(pagectranspose)
+DEFINE_OCL_MAT_METHOD(circshift)
+DEFINE_OCL_MAT_METHOD(flip)
+DEFINE_OCL_MAT_METHOD(rot90)
+DEFINE_OCL_MAT_METHOD(pagemtimes)
+DEFINE_OCL_MAT_METHOD(fft)
+DEFINE_OCL_MAT_METHOD(ifft)
+DEFINE_OCL_MAT_METHOD(fft2)
+DEFINE_OCL_MAT_METHOD(ifft2)
+DEFINE_OCL_MAT_METHOD(conv)
+DEFINE_OCL_MAT_METHOD(conv2)
+DEFINE_OCL_MAT_METHOD(filter)
+DEFINE_OCL_MAT_METHOD(diff)
+DEFINE_OCL_MAT_METHOD(gradient)
+DEFINE_OCL_MAT_METHOD(trapz)
+DEFINE_OCL_MAT_METHOD(cumtrapz)
+DEFINE_OCL_MAT_METHOD(lu)
+DEFINE_OCL_MAT_METHOD(chol)
+DEFINE_OCL_MAT_METHOD(linsolve)
+DEFINE_OCL_MAT_METHOD(histc)
+DEFINE_OCL_MAT_METHOD(cat)
+DEFINE_OCL_MAT_METHOD(horzcat)
+DEFINE_OCL_MAT_METHOD(vertcat)
+
+
+// accumarray dispatches on the class of VALS (the result's class), or on
+// the class of SUBS for octave VALS
+DEFUN_DLD (__ocl_mat_accumarray__, args, nargout, "internal OCL function")
+{
+  int nargin = args.length ();
+  if (nargin < 2)
+    ocl_error ("too few arguments");
+
+  for (int k=1; k>=0; k--) {
+    int type_id = args(k).type_id ();
+    OCL_MAT_METHOD( accumarray, octave_base_ocl_matrix< OclArray< double > > )
+    OCL_MAT_METHOD( accumarray, octave_base_ocl_matrix< OclArray< float > > )
+    OCL_MAT_METHOD( accumarray, octave_base_ocl_matrix< OclArray< Complex > > )
+    OCL_MAT_METHOD( accumarray, octave_base_ocl_matrix< OclArray< FloatComplex > > )
+    OCL_MAT_METHOD( accumarray, octave_base_ocl_matrix< OclArray< octave_int8 > > )
+    OCL_MAT_METHOD( accumarray, octave_base_ocl_matrix< OclArray< octave_int16 > > )
+    OCL_MAT_METHOD( accumarray, octave_base_ocl_matrix< OclArray< octave_int32 > > )
+    OCL_MAT_METHOD( accumarray, octave_base_ocl_matrix< OclArray< octave_int64 > > )
+    OCL_MAT_METHOD( accumarray, octave_base_ocl_matrix< OclArray< octave_uint8 > > )
+    OCL_MAT_METHOD( accumarray, octave_base_ocl_matrix< OclArray< octave_uint16 > > )
+    OCL_MAT_METHOD( accumarray, octave_base_ocl_matrix< OclArray< octave_uint32 > > )
+    OCL_MAT_METHOD( accumarray, octave_base_ocl_matrix< OclArray< octave_uint64 > > )
+      continue; /* default case after last "else": not an ocl matrix */
+  }
+  ocl_error ("method arguments must contain ocl matrices consistently");
+
+  return octave_value_list ();
+}
 
 
 // The following two comment lines are needed verbatim for the Octave package manager:
@@ -1601,10 +3104,18 @@ DEFINE_OCL_MAT_METHOD(complex)
 // PKG_ADD: autoload ("__ocl_mat_findlast__", "ocl_bin.oct");
 // PKG_DEL: autoload ("__ocl_mat_findlast__", "ocl_bin.oct", "remove");
 
+// The following two comment lines are needed verbatim for the Octave package manager:
+// PKG_ADD: autoload ("__ocl_mat_find__", "ocl_bin.oct");
+// PKG_DEL: autoload ("__ocl_mat_find__", "ocl_bin.oct", "remove");
+
 // The following two comment lines are needed verbatim for the Octave package manager:
 // PKG_ADD: autoload ("__ocl_mat_std__", "ocl_bin.oct");
 // PKG_DEL: autoload ("__ocl_mat_std__", "ocl_bin.oct", "remove");
 
+// The following two comment lines are needed verbatim for the Octave package manager:
+// PKG_ADD: autoload ("__ocl_mat_var__", "ocl_bin.oct");
+// PKG_DEL: autoload ("__ocl_mat_var__", "ocl_bin.oct", "remove");
+
 // The following two comment lines are needed verbatim for the Octave package manager:
 // PKG_ADD: autoload ("__ocl_mat_max__", "ocl_bin.oct");
 // PKG_DEL: autoload ("__ocl_mat_max__", "ocl_bin.oct", "remove");
@@ -1640,3 +3151,103 @@ DEFINE_OCL_MAT_METHOD(complex)
 // The following two comment lines are needed verbatim for the Octave package manager:
 // PKG_ADD: autoload ("__ocl_mat_complex__", "ocl_bin.oct");
 // PKG_DEL: autoload ("__ocl_mat_complex__", "ocl_bin.oct", "remove");
+
+// The following two comment lines are needed verbatim for the Octave package manager:
+// PKG_ADD: autoload ("__ocl_mat_pagetranspose__", "ocl_bin.oct");
+// PKG_DEL: autoload ("__ocl_mat_pagetranspose__", "ocl_bin.oct", "remove");
+
+// The following two comment lines are needed verbatim for the Octave package manager:
+// PKG_ADD: autoload ("__ocl_mat_pagectranspose__", "ocl_bin.oct");
+// PKG_DEL: autoload ("__ocl_mat_pagectranspose__", "ocl_bin.oct", "remove");
+
+// The following two comment lines are needed verbatim for the Octave package manager:
+// PKG_ADD: autoload ("__ocl_mat_pagemtimes__", "ocl_bin.oct");
+// PKG_DEL: autoload ("__ocl_mat_pagemtimes__", "ocl_bin.oct", "remove");
+
+// The following two comment lines are needed verbatim for the Octave package manager:
+// PKG_ADD: autoload ("__ocl_mat_fft__", "ocl_bin.oct");
+// PKG_DEL: autoload ("__ocl_mat_fft__", "ocl_bin.oct", "remove");
+
+// The following two comment lines are needed verbatim for the Octave package manager:
+// PKG_ADD: autoload ("__ocl_mat_ifft__", "ocl_bin.oct");
+// PKG_DEL: autoload ("__ocl_mat_ifft__", "ocl_bin.oct", "remove");
+
+// The following two comment lines are needed verbatim for the Octave package manager:
+// PKG_ADD: autoload ("__ocl_mat_fft2__", "ocl_bin.oct");
+// PKG_DEL: autoload ("__ocl_mat_fft2__", "ocl_bin.oct", "remove");
+
+// The following two comment lines are needed verbatim for the Octave package manager:
+// PKG_ADD: autoload ("__ocl_mat_ifft2__", "ocl_bin.oct");
+// PKG_DEL: autoload ("__ocl_mat_ifft2__", "ocl_bin.oct", "remove");
+
+// The following two comment lines are needed verbatim for the Octave package manager:
+// PKG_ADD: autoload ("__ocl_mat_conv__", "ocl_bin.oct");
+// PKG_DEL: autoload ("__ocl_mat_conv__", "ocl_bin.oct", "remove");
+
+// The following two comment lines are needed verbatim for the Octave package manager:
+// PKG_ADD: autoload ("__ocl_mat_conv2__", "ocl_bin.oct");
+// PKG_DEL: autoload ("__ocl_mat_conv2__", "ocl_bin.oct", "remove");
+
+// The following two comment lines are needed verbatim for the Octave package manager:
+// PKG_ADD: autoload ("__ocl_mat_filter__", "ocl_bin.oct");
+// PKG_DEL: autoload ("__ocl_mat_filter__", "ocl_bin.oct", "remove");
+
+// The following two comment lines are needed verbatim for the Octave package manager:
+// PKG_ADD: autoload ("__ocl_mat_circshift__", "ocl_bin.oct");
+// PKG_DEL: autoload ("__ocl_mat_circshift__", "ocl_bin.oct", "remove");
+
+// The following two comment lines are needed verbatim for the Octave package manager:
+// PKG_ADD: autoload ("__ocl_mat_flip__", "ocl_bin.oct");
+// PKG_DEL: autoload ("__ocl_mat_flip__", "ocl_bin.oct", "remove");
+
+// The following two comment lines are needed verbatim for the Octave package manager:
+// PKG_ADD: autoload ("__ocl_mat_rot90__", "ocl_bin.oct");
+// PKG_DEL: autoload ("__ocl_mat_rot90__", "ocl_bin.oct", "remove");
+
+// The following two comment lines are needed verbatim for the Octave package manager:
+// PKG_ADD: autoload ("__ocl_mat_diff__", "ocl_bin.oct");
+// PKG_DEL: autoload ("__ocl_mat_diff__", "ocl_bin.oct", "remove");
+
+// The following two comment lines are needed verbatim for the Octave package manager:
+// PKG_ADD: autoload ("__ocl_mat_gradient__", "ocl_bin.oct");
+// PKG_DEL: autoload ("__ocl_mat_gradient__", "ocl_bin.oct", "remove");
+
+// The following two comment lines are needed verbatim for the Octave package manager:
+// PKG_ADD: autoload ("__ocl_mat_trapz__", "ocl_bin.oct");
+// PKG_DEL: autoload ("__ocl_mat_trapz__", "ocl_bin.oct", "remove");
+
+// The following two comment lines are needed verbatim for the Octave package manager:
+// PKG_ADD: autoload ("__ocl_mat_cumtrapz__", "ocl_bin.oct");
+// PKG_DEL: autoload ("__ocl_mat_cumtrapz__", "ocl_bin.oct", "remove");
+
+// The following two comment lines are needed verbatim for the Octave package manager:
+// PKG_ADD: autoload ("__ocl_mat_lu__", "ocl_bin.oct");
+// PKG_DEL: autoload ("__ocl_mat_lu__", "ocl_bin.oct", "remove");
+
+// The following two comment lines are needed verbatim for the Octave package manager:
+// PKG_ADD: autoload ("__ocl_mat_chol__", "ocl_bin.oct");
+// PKG_DEL: autoload ("__ocl_mat_chol__", "ocl_bin.oct", "remove");
+
+// The following two comment lines are needed verbatim for the Octave package manager:
+// PKG_ADD: autoload ("__ocl_mat_linsolve__", "ocl_bin.oct");
+// PKG_DEL: autoload ("__ocl_mat_linsolve__", "ocl_bin.oct", "remove");
+
+// The following two comment lines are needed verbatim for the Octave package manager:
+// PKG_ADD: autoload ("__ocl_mat_histc__", "ocl_bin.oct");
+// PKG_DEL: autoload ("__ocl_mat_histc__", "ocl_bin.oct", "remove");
+
+// The following two comment lines are needed verbatim for the Octave package manager:
+// PKG_ADD: autoload ("__ocl_mat_accumarray__", "ocl_bin.oct");
+// PKG_DEL: autoload ("__ocl_mat_accumarray__", "ocl_bin.oct", "remove");
+
+// The following two comment lines are needed verbatim for the Octave package manager:
+// PKG_ADD: autoload ("__ocl_mat_cat__", "ocl_bin.oct");
+// PKG_DEL: autoload ("__ocl_mat_cat__", "ocl_bin.oct", "remove");
+
+// The following two comment lines are needed verbatim for the Octave package manager:
+// PKG_ADD: autoload ("__ocl_mat_horzcat__", "ocl_bin.oct");
+// PKG_DEL: autoload ("__ocl_mat_horzcat__", "ocl_bin.oct", "remove");
+
+// The following two comment lines are needed verbatim for the Octave package manager:
+// PKG_ADD: autoload ("__ocl_mat_vertcat__", "ocl_bin.oct");
+// PKG_DEL: autoload ("__ocl_mat_vertcat__", "ocl_bin.oct", "remove");
@@ -201,9 +201,15 @@ public:
 
   int ndims (void) const { return matrix.ndims (); }
 
-  // octave_base_ocl_matrix: no nnz!
+  octave_idx_type nnz (void) const { return matrix.nnz (); }
 
-  // octave_base_ocl_matrix: no permute, no resize!
+  // resizing only along the last dimension (see OclArray<T>::resize)
+  octave_value resize (const dim_vector& dv, bool = false) const
+  {
+    AT retval (matrix);
+    retval.resize (dv);
+    return octave_value (new octave_base_ocl_matrix<AT> (retval));
+  }
 
   // octave_base_ocl_matrix: no diag, no sorting!
 
@@ -279,12 +285,21 @@ public:
   octave_value hermitian (void) const
   { return new octave_base_ocl_matrix<AT> (matrix.hermitian ()); }
 
+  octave_value pagetranspose (void) const
+  { return new octave_base_ocl_matrix<AT> (matrix.pagetranspose ()); }
+
+  octave_value pagectranspose (void) const
+  { return new octave_base_ocl_matrix<AT> (matrix.pagectranspose ()); }
+
   octave_value reshape (const dim_vector& new_dims) const
   { return new octave_base_ocl_matrix<AT> (matrix.reshape (new_dims)); }
 
   octave_value squeeze (void) const
   { return new octave_base_ocl_matrix<AT> (matrix.squeeze ()); }
 
+  octave_value permute (const Array<int>& vec, bool inv = false) const
+  { return new octave_base_ocl_matrix<AT> (matrix.permute (Array<octave_idx_type> (vec), inv)); }
+
   octave_value all (int dim = 0) const
   { return new octave_base_ocl_matrix<AT> (matrix.all (dim)); }
 
@@ -309,6 +324,18 @@ public:
   octave_value std (int opt = 0, int dim = 0) const
   { return new octave_base_ocl_matrix<AT> (matrix.std (opt, dim)); }
 
+  octave_value var (int opt = 0, int dim = 0) const
+  { return new octave_base_ocl_matrix<AT> (matrix.var (opt, dim)); }
+
+  octave_value var (octave_value& mean, int opt = 0, int dim = 0) const
+  {
+    octave_base_ocl_matrix<AT> *newmat;
+    AT m;
+    newmat = new octave_base_ocl_matrix<AT> (matrix.var (m, opt, dim));
+    mean = octave_value (new octave_base_ocl_matrix<AT> (m));
+    return newmat;
+  }
+
   octave_value cumsum (int dim = 0) const
   { return new octave_base_ocl_matrix<AT> (matrix.cumsum (dim)); }
 
@@ -333,6 +360,14 @@ public:
     return new octave_base_ocl_matrix< OclArray<ocl_idx_type> > (inds += 1);
   }
 
+  octave_value find (octave_idx_type n = -1, bool backward = false) const
+  {
+    OclArray<ocl_idx_type> inds = matrix.find (n, backward);
+    if (inds.numel () == 0) // nothing found: no buffer to offset
+      return new octave_base_ocl_matrix< OclArray<ocl_idx_type> > (inds);
+    return new octave_base_ocl_matrix< OclArray<ocl_idx_type> > (inds += 1);
+  }
+
   octave_value max2 (const element_type& v) const
   { return new octave_base_ocl_matrix<AT> (matrix.max2 (v)); }
 
@@ -396,6 +431,9 @@ public:
   octave_value atan2 (const octave_base_ocl_matrix<AT>& s2) const
   { return new octave_base_ocl_matrix<AT> (matrix.atan2 (s2.matrix)); }
 
+  octave_value pagemtimes (const octave_base_ocl_matrix<AT>& s2, char trans1, char trans2) const
+  { return new octave_base_ocl_matrix<AT> (matrix.pagemtimes (s2.matrix, trans1, trans2)); }
+
   octave_value map (octave_base_value::unary_mapper_t umap) const;
 
   octave_value do_index_op (const octave_value_list& idx,
@@ -438,6 +476,27 @@ public:
   static octave_value_list
   as_index (const octave_value_list& args, int nargout);
 
+  static octave_value_list
+  pagetranspose (const octave_value_list& args, int nargout);
+
+  static octave_value_list
+  pagectranspose (const octave_value_list& args, int nargout);
+
+  static octave_value_list
+  circshift (const octave_value_list& args, int nargout);
+
+  static octave_value_list
+  flip (const octave_value_list& args, int nargout);
+
+  static octave_value_list
+  rot90 (const octave_value_list& args, int nargout);
+
+  static octave_value_list
+  diff (const octave_value_list& args, int nargout);
+
+  static octave_value_list
+  gradient (const octave_value_list& args, int nargout);
+
   static octave_value_list
   sum (const octave_value_list& args, int nargout);
 
@@ -465,9 +524,15 @@ public:
   static octave_value_list
   findlast (const octave_value_list& args, int nargout);
 
+  static octave_value_list
+  find (const octave_value_list& args, int nargout);
+
   static octave_value_list
   std (const octave_value_list& args, int nargout);
 
+  static octave_value_list
+  var (const octave_value_list& args, int nargout);
+
   static octave_value_list
   max (const octave_value_list& args, int nargout);
 
@@ -483,6 +548,9 @@ public:
   static octave_value_list
   atan2 (const octave_value_list& args, int nargout);
 
+  static octave_value_list
+  pagemtimes (const octave_value_list& args, int nargout);
+
   static octave_value_list
   ndgrid (const octave_value_list& args, int nargout);
 
@@ -495,10 +563,67 @@ public:
   static octave_value_list
   complex (const octave_value_list& args, int nargout);
 
+  static octave_value_list
+  fft (const octave_value_list& args, int nargout);
+
+  static octave_value_list
+  ifft (const octave_value_list& args, int nargout);
+
+  static octave_value_list
+  fft2 (const octave_value_list& args, int nargout);
+
+  static octave_value_list
+  ifft2 (const octave_value_list& args, int nargout);
+
+  static octave_value_list
+  conv (const octave_value_list& args, int nargout);
+
+  static octave_value_list
+  conv2 (const octave_value_list& args, int nargout);
+
+  static octave_value_list
+  filter (const octave_value_list& args, int nargout);
+
+  static octave_value_list
+  trapz (const octave_value_list& args, int nargout);
+
+  static octave_value_list
+  cumtrapz (const octave_value_list& args, int nargout);
+
+  static octave_value_list
+  lu (const octave_value_list& args, int nargout);
+
+  static octave_value_list
+  chol (const octave_value_list& args, int nargout);
+
+  static octave_value_list
+  linsolve (const octave_value_list& args, int nargout);
+
+  static octave_value_list
+  histc (const octave_value_list& args, int nargout);
+
+  static octave_value_list
+  accumarray (const octave_value_list& args, int nargout);
+
+  static octave_value_list
+  cat (const octave_value_list& args, int nargout);
+
+  static octave_value_list
+  horzcat (const octave_value_list& args, int nargout);
+
+  static octave_value_list
+  vertcat (const octave_value_list& args, int nargout);
+
 protected:
 
   AT matrix;
 
+  static octave_value_list
+  cat_args (int dim, const octave_value_list& args, int first);
+
+  static octave_value_list
+  fft_common (const octave_value_list& args, int nargout, bool inverse, bool two_dim);
+
 private:
 
   octave_base_ocl_matrix& operator = (const octave_base_ocl_matrix&); // No assignment.
@@ -510,6 +635,44 @@ private:
   DECLARE_OV_TYPEID_FUNCTIONS_AND_DATA
 };
 
+
+#if ! defined (DEFINE_TEMPLATE_OV_TYPEID_FUNCTIONS_AND_DATA)
+// macro for template classes to be registered as a new octave type
+// as replacement for DEFINE_OV_TYPEID_FUNCTIONS_AND_DATA for non-template classes
+#if ! defined (OCL_OCTAVE_VERSION_4_4_0_AND_HIGHER) // for octave versions < 4.4.0
+#define DEFINE_OV_TYPEID_FUNCTIONS_AND_DATA_TC(t, n, c)                 \
+  template <> int t::t_id (-1);                                         \
+  template <> const std::string t::t_name (n);                          \
+  template <> const std::string t::c_name (c);                          \
+  template <> void t::register_type (void)                              \
+  {                                                                     \
+    static t exemplar;                                                  \
+    octave_value v (&exemplar, true);                                   \
+    t_id = octave_value_typeinfo::register_type (t::t_name, t::c_name, v); \
+  }
+#else // for octave versions >= 4.4.0
+#define DEFINE_OV_TYPEID_FUNCTIONS_AND_DATA_TC(t, n, c)         \
+  template <> int t::t_id (-1);                                 \
+  template <> const std::string t::t_name (n);                  \
+  template <> const std::string t::c_name (c);                  \
+  template <> void t::register_type (octave::type_info& ti)     \
+  {                                                             \
+    octave_value v (new t ());                                  \
+    t_id = ti.register_type (t::t_name, t::c_name, v);          \
+  }                                                             \
+  template <> void t::register_type (void)                      \
+  {                                                             \
+    octave::type_info& type_info                                \
+      = octave::__get_type_info__ (#t "::register_type");       \
+                                                                \
+    register_type (type_info);                                  \
+  }
+#endif
+#else // DEFINE_TEMPLATE_OV_TYPEID_FUNCTIONS_AND_DATA is defined
+#define DEFINE_OV_TYPEID_FUNCTIONS_AND_DATA_TC(t, n, c)         \
+  DEFINE_TEMPLATE_OV_TYPEID_FUNCTIONS_AND_DATA(t, n, c)
+#endif
+
 #if defined (DEFINE_TEMPLATE_OV_TYPEID_FUNCTIONS_AND_DATA)
 DECLARE_TEMPLATE_OV_TYPEID_SPECIALIZATIONS (octave_base_ocl_matrix, OclArray< double        >)
 DECLARE_TEMPLATE_OV_TYPEID_SPECIALIZATIONS (octave_base_ocl_matrix, OclArray< float         >)
@@ -538,4 +701,8 @@ typedef octave_base_ocl_matrix< OclArray< octave_uint16 > > octave_ocl_uint16_ma
 typedef octave_base_ocl_matrix< OclArray< octave_uint32 > > octave_ocl_uint32_matrix;
 typedef octave_base_ocl_matrix< OclArray< octave_uint64 > > octave_ocl_uint64_matrix;
 
+// the warning for a left division by a singular ocl matrix, as octave's
+extern void
+warning_singular_oclmat (void);
+
 #endif  /* __OCL_OV_MATRIX_H */
@@ -36,6 +36,15 @@
 #include "ocl_lib.h"
 #include "ocl_ov_matrix.h"
 #include "ocl_ov_types.h"
+#include <cmath>
+#include <limits>
+#include <fstream>
+
+#if ! defined (_WIN32)
+#include <sys/mman.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
 
 
 // ---------- the octave entry point to the 'ocl_cat' function
@@ -130,7 +139,8 @@ Return an OCL matrix or N-dimensional OCL array whose elements are all 1.  \n\
 \n\
 For details, see help for @code{ones}.  \n\
 \n\
-The OCL matrix is assembled on the OpenCL device.  \n\
+The OCL matrix is assembled on the OpenCL device, but only on its first use \n\
+there (it is described by its formula until then, without device memory).  \n\
 \n\
 @seealso{ones, ocl_zeros, oclArray} \n\
 @end deftypefn")
@@ -214,7 +224,8 @@ Return an OCL matrix or N-dimensional OCL array whose elements are all 0.  \n\
 \n\
 For details, see help for @code{zeros}.  \n\
 \n\
-The OCL matrix is assembled on the OpenCL device.  \n\
+The OCL matrix is assembled on the OpenCL device, but only on its first use \n\
+there (it is described by its formula until then, without device memory).  \n\
 \n\
 @seealso{zeros, ocl_ones, oclArray} \n\
 @end deftypefn")
@@ -297,7 +308,8 @@ Return an identity matrix as OCL matrix.  \n\
 \n\
 For details, see help for @code{eye}.  \n\
 \n\
-The OCL matrix is assembled on the OpenCL device.  \n\
+The OCL matrix is assembled on the OpenCL device, but only on its first use \n\
+there (it is described by its formula until then, without device memory).  \n\
 \n\
 @seealso{eye, ocl_ones, ocl_zeros, oclArray} \n\
 @end deftypefn")
@@ -383,7 +395,8 @@ Return an OCL row vector with @var{n} linearly spaced elements between \n\
 \n\
 For details, see help for @code{linspace}.  \n\
 \n\
-The OCL matrix is assembled on the OpenCL device.  \n\
+The OCL matrix is assembled on the OpenCL device, but only on its first use \n\
+there (it is described by its formula until then, without device memory).  \n\
 \n\
 @seealso{linspace, ocl_logspace, oclArray} \n\
 @end deftypefn")
@@ -463,3 +476,700 @@ The OCL matrix is assembled on the OpenCL device.  \n\
 
   return retval;
 }
+
+
+// ---------- helpers of the 'ocl_rand', 'ocl_randn' and 'ocl_randi' functions
+
+
+// ocl_rand ("seed") returns, and ocl_rand ("seed", S) sets, the seed of
+// the random number streams; returns false if args is no seed request
+static
+bool
+ocl_rand_seed_args (const octave_value_list& args, const char *name,
+                    octave_value_list& retval)
+{
+  int nargin = args.length ();
+
+  if ((nargin < 1) || (! args (0).is_string ()) ||
+      (args (0).string_value () != "seed"))
+    return false;
+
+  if (nargin > 2)
+    ocl_error ("%s: too many arguments", name);
+
+  if (nargin == 1) {
+    retval (0) = octave_value (octave_uint64 (ocl_rand_get_seed ()));
+  } else {
+    if (! args (1).is_real_scalar ())
+      ocl_error ("%s: the seed must be a real scalar", name);
+    ocl_rand_set_seed (args (1).uint64_scalar_value ().value ());
+  }
+
+  return true;
+}
+
+
+// dimensions from args (first), ..., args (nargin-1), as for 'rand'
+static
+dim_vector
+ocl_rand_dims (const octave_value_list& args, int first, int nargin,
+               const char *name)
+{
+  dim_vector dv (1,1);
+
+  if (nargin <= first)
+    return dv;
+
+  if (args (first).is_real_matrix ()) {
+    if (nargin > first+1)
+      ocl_error ("%s: too many arguments", name);
+    Matrix m = args (first).matrix_value ();
+    int ndim = m.numel ();
+    dv = dv.redim (ndim);
+    for (octave_idx_type i = 0; i < ndim; i++)
+      dv (i) = m (i);
+  } else {
+    int ndim = nargin - first;
+    dv = dv.redim (ndim);
+    for (octave_idx_type i = 0; i < ndim; i++) {
+      if (!args (first+i).is_real_scalar ())
+        ocl_error ("%s: wrong argument type", name);
+      dv (i) = args (first+i).scalar_value ();
+    }
+    if (ndim == 1)
+      dv (1) = dv (0);
+  }
+
+  return dv;
+}
+
+
+// ---------- the octave entry point to the 'ocl_rand' function
+
+
+// The following two comment lines are needed verbatim for the Octave package manager:
+// PKG_ADD: autoload ("ocl_rand", "ocl_bin.oct");
+// PKG_DEL: autoload ("ocl_rand", "ocl_bin.oct", "remove");
+
+
+DEFUN_DLD (ocl_rand, args, nargout,
+"-*- texinfo -*-\n\
+@deftypefn  {Loadable Function} {} ocl_rand (@var{n}) \n\
+@deftypefnx {Loadable Function} {} ocl_rand (@var{m}, @var{n}, @dots{}) \n\
+@deftypefnx {Loadable Function} {} ocl_rand ([@var{m} @var{n} @dots{}]) \n\
+@deftypefnx {Loadable Function} {} ocl_rand (@dots{}, @var{class}) \n\
+@deftypefnx {Loadable Function} {@var{s} =} ocl_rand (\"seed\") \n\
+@deftypefnx {Loadable Function} {} ocl_rand (\"seed\", @var{s}) \n\
+\n\
+Return an OCL matrix or N-dimensional OCL array with random elements \n\
+uniformly distributed on the interval (0, 1).  @var{class} may be \n\
+\"double\" (default) or \"single\".  \n\
+\n\
+The numbers are generated on the OpenCL device by the counter-based \n\
+Philox4x32-10 generator.  @code{ocl_rand}, @code{ocl_randn} and \n\
+@code{ocl_randi} share one stream, whose seed is queried or set by \n\
+the \"seed\" forms; after setting the seed @var{s}, the same sequence of \n\
+calls returns the same numbers on every OpenCL device.  \n\
+\n\
+For details, see help for @code{rand}.  \n\
+\n\
+@seealso{rand, ocl_randn, ocl_randi, oclArray} \n\
+@end deftypefn")
+{
+  octave_value_list retval;
+
+  if (ocl_rand_seed_args (args, "ocl_rand", retval))
+    return retval;
+
+  int nargin = args.length ();
+  std::string val_class = "double";
+
+  if ((nargin > 0) && (args (nargin-1).is_string ())) {
+    val_class = args (nargin-1).string_value ();
+    nargin--;
+  }
+
+  dim_vector dv = ocl_rand_dims (args, 0, nargin, "ocl_rand");
+
+  assure_installed_ocl_types ();
+
+#define OCL_RAND_TYPE(C, T) \
+  if (val_class == #C) { \
+    retval (0) = octave_value (new T (T::array_type::rand (dv))); \
+  } else
+
+  OCL_RAND_TYPE( double, octave_ocl_matrix )
+  OCL_RAND_TYPE( single, octave_ocl_float_matrix )
+    ocl_error ("ocl_rand: 'class' must be \"double\" or \"single\""); // default case after last "else"
+
+#undef OCL_RAND_TYPE
+
+  return retval;
+}
+
+
+// ---------- the octave entry point to the 'ocl_randn' function
+
+
+// The following two comment lines are needed verbatim for the Octave package manager:
+// PKG_ADD: autoload ("ocl_randn", "ocl_bin.oct");
+// PKG_DEL: autoload ("ocl_randn", "ocl_bin.oct", "remove");
+
+
+DEFUN_DLD (ocl_randn, args, nargout,
+"-*- texinfo -*-\n\
+@deftypefn  {Loadable Function} {} ocl_randn (@var{n}) \n\
+@deftypefnx {Loadable Function} {} ocl_randn (@var{m}, @var{n}, @dots{}) \n\
+@deftypefnx {Loadable Function} {} ocl_randn ([@var{m} @var{n} @dots{}]) \n\
+@deftypefnx {Loadable Function} {} ocl_randn (@dots{}, @var{class}) \n\
+@deftypefnx {Loadable Function} {@var{s} =} ocl_randn (\"seed\") \n\
+@deftypefnx {Loadable Function} {} ocl_randn (\"seed\", @var{s}) \n\
+\n\
+Return an OCL matrix or N-dimensional OCL array with random elements \n\
+normally distributed with mean 0 and standard deviation 1.  @var{class} \n\
+may be \"double\" (default) or \"single\".  \n\
+\n\
+The numbers are generated on the OpenCL device, see @code{ocl_rand}.  \n\
+\n\
+For details, see help for @code{randn}.  \n\
+\n\
+@seealso{randn, ocl_rand, ocl_randi, oclArray} \n\
+@end deftypefn")
+{
+  octave_value_list retval;
+
+  if (ocl_rand_seed_args (args, "ocl_randn", retval))
+    return retval;
+
+  int nargin = args.length ();
+  std::string val_class = "double";
+
+  if ((nargin > 0) && (args (nargin-1).is_string ())) {
+    val_class = args (nargin-1).string_value ();
+    nargin--;
+  }
+
+  dim_vector dv = ocl_rand_dims (args, 0, nargin, "ocl_randn");
+
+  assure_installed_ocl_types ();
+
+#define OCL_RANDN_TYPE(C, T) \
+  if (val_class == #C) { \
+    retval (0) = octave_value (new T (T::array_type::randn (dv))); \
+  } else
+
+  OCL_RANDN_TYPE( double, octave_ocl_matrix )
+  OCL_RANDN_TYPE( single, octave_ocl_float_matrix )
+    ocl_error ("ocl_randn: 'class' must be \"double\" or \"single\""); // default case after last "else"
+
+#undef OCL_RANDN_TYPE
+
+  return retval;
+}
+
+
+// ---------- the octave entry point to the 'ocl_randi' function
+
+
+// The following two comment lines are needed verbatim for the Octave package manager:
+// PKG_ADD: autoload ("ocl_randi", "ocl_bin.oct");
+// PKG_DEL: autoload ("ocl_randi", "ocl_bin.oct", "remove");
+
+
+DEFUN_DLD (ocl_randi, args, nargout,
+"-*- texinfo -*-\n\
+@deftypefn  {Loadable Function} {} ocl_randi (@var{imax}) \n\
+@deftypefnx {Loadable Function} {} ocl_randi (@var{imax}, @var{n}) \n\
+@deftypefnx {Loadable Function} {} ocl_randi (@var{imax}, @var{m}, @var{n}, @dots{}) \n\
+@deftypefnx {Loadable Function} {} ocl_randi ([@var{imin} @var{imax}], @dots{}) \n\
+@deftypefnx {Loadable Function} {} ocl_randi (@dots{}, @var{class}) \n\
+\n\
+Return an OCL matrix or N-dimensional OCL array with random integers \n\
+uniformly distributed on the interval [1, @var{imax}] or \n\
+[@var{imin}, @var{imax}].  @var{class} may be \"double\" (default), \n\
+\"single\", or any integer type.  \n\
+\n\
+The numbers are generated on the OpenCL device, see @code{ocl_rand}.  \n\
+\n\
+For details, see help for @code{randi}.  \n\
+\n\
+@seealso{randi, ocl_rand, ocl_randn, oclArray} \n\
+@end deftypefn")
+{
+  octave_value_list retval;
+  int nargin = args.length ();
+  std::string val_class = "double";
+
+  if ((nargin > 0) && (args (nargin-1).is_string ())) {
+    val_class = args (nargin-1).string_value ();
+    nargin--;
+  }
+  if (nargin < 1)
+    ocl_error ("ocl_randi: too few arguments");
+
+  Matrix bounds = args (0).matrix_value ();
+  if ((bounds.numel () < 1) || (bounds.numel () > 2))
+    ocl_error ("ocl_randi: wrong argument type");
+  double imin = (bounds.numel () == 2) ? bounds (0) : 1;
+  double imax = bounds (bounds.numel () - 1);
+  if ((imin != std::floor (imin)) || (imax != std::floor (imax)))
+    ocl_error ("ocl_randi: IMIN and IMAX must be integer bounds");
+  if (imax < imin)
+    ocl_error ("ocl_randi: require IMIN <= IMAX");
+
+  dim_vector dv = ocl_rand_dims (args, 1, nargin, "ocl_randi");
+
+  assure_installed_ocl_types ();
+
+#define OCL_RANDI_TYPE(C, T, MIN, MAX) \
+  if (val_class == #C) { \
+    if ((imin < (MIN)) || (imax > (MAX))) \
+      ocl_error ("ocl_randi: IMIN and IMAX must be representable in class '%s'", #C); \
+    retval (0) = octave_value (new T (T::array_type::randi (dv, imin, imax))); \
+  } else
+
+  OCL_RANDI_TYPE( double, octave_ocl_matrix,        -9007199254740992.0, 9007199254740992.0 )
+  OCL_RANDI_TYPE( single, octave_ocl_float_matrix,  -16777216.0, 16777216.0 )
+  OCL_RANDI_TYPE( int8,   octave_ocl_int8_matrix,   std::numeric_limits<int8_t>::min (),   std::numeric_limits<int8_t>::max () )
+  OCL_RANDI_TYPE( int16,  octave_ocl_int16_matrix,  std::numeric_limits<int16_t>::min (),  std::numeric_limits<int16_t>::max () )
+  OCL_RANDI_TYPE( int32,  octave_ocl_int32_matrix,  std::numeric_limits<int32_t>::min (),  std::numeric_limits<int32_t>::max () )
+  OCL_RANDI_TYPE( int64,  octave_ocl_int64_matrix,  -9007199254740992.0, 9007199254740992.0 )
+  OCL_RANDI_TYPE( uint8,  octave_ocl_uint8_matrix,  0, std::numeric_limits<uint8_t>::max () )
+  OCL_RANDI_TYPE( uint16, octave_ocl_uint16_matrix, 0, std::numeric_limits<uint16_t>::max () )
+  OCL_RANDI_TYPE( uint32, octave_ocl_uint32_matrix, 0, std::numeric_limits<uint32_t>::max () )
+  OCL_RANDI_TYPE( uint64, octave_ocl_uint64_matrix, 0, 9007199254740992.0 )
+    ocl_error ("ocl_randi: 'class' must be a data type as for 'randi'"); // default case after last "else"
+
+#undef OCL_RANDI_TYPE
+
+  return retval;
+}
+
+
+// ---------- the octave entry point to the 'ocl_chunked' function
+
+
+#if ! defined (OCL_OCTAVE_VERSION_4_4_0_AND_HIGHER) // for octave versions < 4.4.0
+#define ISCOMPLEX is_complex_type
+#else // for octave versions >= 4.4.0
+#define ISCOMPLEX iscomplex
+#endif
+
+
+// index of the elementwise operation fcn of two arrays, or -1
+static
+int
+ocl_chunked_binary_op (const std::string& fcn)
+{
+  if      (fcn == "plus")    return 0;
+  else if (fcn == "minus")   return 1;
+  else if (fcn == "times")   return 2;
+  else if (fcn == "rdivide") return 3;
+  return -1;
+}
+
+
+template <typename T, typename NDA>
+static
+octave_value
+ocl_chunked_apply (const NDA& x, const std::string& fcn, const NDA& y,
+                   octave_idx_type chunk_len)
+{
+  int op = ocl_chunked_binary_op (fcn);
+  if (op >= 0) {
+    if (y.dims () != x.dims ())
+      ocl_error ("ocl_chunked: X and Y must be of the same size");
+    return octave_value (NDA (OclArray<T>::stream_map2 (x, y, op, chunk_len)));
+  }
+
+  int red = -1;
+  if      (fcn == "sum")   red = 0;
+  else if (fcn == "sumsq") red = 1;
+  else if (fcn == "prod")  red = 2;
+  else if (fcn == "max")   red = 3;
+  else if (fcn == "min")   red = 4;
+
+  if (red >= 0) {
+    if (x.numel () == 0) // as for x(:) of an empty array
+      return (red >= 3) ? octave_value (NDA (dim_vector (0, 0)))
+                        : octave_value (NDA (dim_vector (1, 1), T ((red == 2) ? 1 : 0)));
+    return octave_value (NDA (dim_vector (1, 1), OclArray<T>::stream_reduce (x, red, chunk_len)));
+  }
+
+  for (int i = 0; i < octave_base_value::num_unary_mappers; i++) {
+    octave_base_value::unary_mapper_t umap = static_cast<octave_base_value::unary_mapper_t> (i);
+    if (fcn == octave_base_value::get_umap_name (umap))
+      return octave_value (NDA (OclArray<T>::stream_map (x, umap, chunk_len)));
+  }
+
+  ocl_error ("ocl_chunked: unknown reduction or mapping function '%s'", fcn.c_str ());
+}
+
+
+// The following two comment lines are needed verbatim for the Octave package manager:
+// PKG_ADD: autoload ("ocl_chunked", "ocl_bin.oct");
+// PKG_DEL: autoload ("ocl_chunked", "ocl_bin.oct", "remove");
+
+
+DEFUN_DLD (ocl_chunked, args, nargout,
+"-*- texinfo -*-\n\
+@deftypefn  {Loadable Function} {@var{y} =} ocl_chunked (@var{x}, @var{fcn}) \n\
+@deftypefnx {Loadable Function} {@var{y} =} ocl_chunked (@var{x}, @var{fcn}, @var{chunk_len}) \n\
+@deftypefnx {Loadable Function} {@var{z} =} ocl_chunked (@var{x}, @var{fcn}, @var{y}) \n\
+@deftypefnx {Loadable Function} {@var{z} =} ocl_chunked (@var{x}, @var{fcn}, @var{y}, @var{chunk_len}) \n\
+\n\
+Compute a reduction, a mapping function or an elementwise operation of \n\
+octave arrays on the OpenCL device, out of core.  \n\
+\n\
+The array @var{x} stays in host memory and may be larger than the largest \n\
+OpenCL buffer, or than the device memory.  It is streamed to the device \n\
+in chunks of @var{chunk_len} elements, by default sized from the memory \n\
+limits of the device (up to 64 MiB).  The chunks are uploaded alternately \n\
+into two device buffers, in a second command queue: the upload of a chunk \n\
+overlaps with the computation on the previous one, and the results are \n\
+read back without waiting for each chunk.  So streaming bounds the device \n\
+memory in use to about two chunks (per array), and hides the transfer \n\
+time as far as the device runs transfers and kernels concurrently.  \n\
+\n\
+If @var{fcn} is one of @qcode{\"sum\"}, @qcode{\"sumsq\"}, @qcode{\"prod\"}, \n\
+@qcode{\"max\"} or @qcode{\"min\"}, @var{y} is the reduction over all \n\
+elements of @var{x}, as for @code{@var{fcn} (@var{x}(:))}; the partial \n\
+results of the chunks stay on the device until the end.  Otherwise, \n\
+@var{fcn} names a mapping function (like @qcode{\"exp\"} or \n\
+@qcode{\"sqrt\"}) as applicable to OCL matrices of the class of @var{x}, \n\
+and @var{y} is the octave array of its results.  \n\
+\n\
+If @var{fcn} is one of @qcode{\"plus\"}, @qcode{\"minus\"}, \n\
+@qcode{\"times\"} or @qcode{\"rdivide\"}, @var{z} is the elementwise \n\
+operation of @var{x} and the second octave array @var{y}, which must be \n\
+of the same class and size as @var{x} (there is no broadcasting); the \n\
+chunks of both arrays are streamed together.  Reductions along single \n\
+dimensions and other operations are not supported.  \n\
+\n\
+@example \n\
+@group \n\
+x = rand (1e8, 1, \"single\"); \n\
+s = ocl_chunked (x, \"sum\"); \n\
+y = ocl_chunked (x, \"exp\", 2^22); \n\
+z = ocl_chunked (x, \"times\", y); \n\
+@end group \n\
+@end example \n\
+\n\
+@seealso{oclArray, ocl_context} \n\
+@end deftypefn")
+{
+  octave_value_list retval;
+  int nargin = args.length ();
+
+  if ((nargin < 2) || (nargin > 4))
+    ocl_error ("ocl_chunked: wrong number of arguments");
+  if (! args (1).is_string ())
+    ocl_error ("ocl_chunked: FCN must be a string");
+
+  octave_value x = args (0);
+  std::string fcn = args (1).string_value ();
+
+  // the second operand of an elementwise operation precedes chunk_len
+  octave_value y = x;
+  int chunk_arg = 2;
+  if (ocl_chunked_binary_op (fcn) >= 0) {
+    if (nargin < 3)
+      ocl_error ("ocl_chunked: elementwise operation '%s' needs a second array Y", fcn.c_str ());
+    y = args (2);
+    if (y.class_name () != x.class_name ())
+      ocl_error ("ocl_chunked: Y must be of the same class as X");
+    chunk_arg = 3;
+  } else if (nargin > 3)
+    ocl_error ("ocl_chunked: wrong number of arguments");
+
+  octave_idx_type chunk_len = 0;
+  if (nargin > chunk_arg) {
+    chunk_len = args (chunk_arg).idx_type_value ();
+    if (chunk_len < 1)
+      ocl_error ("ocl_chunked: CHUNK_LEN must be positive");
+  }
+
+  std::string cls = x.class_name ();
+
+#define OCL_CHUNKED_TYPE(C, T, NDA, ARRAY_FCN) \
+  if (cls == #C) \
+    retval (0) = ocl_chunked_apply<T, NDA> (x.ARRAY_FCN (), fcn, y.ARRAY_FCN (), chunk_len); \
+  else
+
+  if (x.ISCOMPLEX () || y.ISCOMPLEX ()) {
+    OCL_CHUNKED_TYPE( double, Complex,       ComplexNDArray,      complex_array_value       )
+    OCL_CHUNKED_TYPE( single, FloatComplex,  FloatComplexNDArray, float_complex_array_value )
+      ocl_error ("ocl_chunked: X must be a numeric array"); // default case after last "else"
+  } else {
+    OCL_CHUNKED_TYPE( double, double,        NDArray,             array_value               )
+    OCL_CHUNKED_TYPE( single, float,         FloatNDArray,        float_array_value         )
+    OCL_CHUNKED_TYPE( int8,   octave_int8,   int8NDArray,         int8_array_value          )
+    OCL_CHUNKED_TYPE( int16,  octave_int16,  int16NDArray,        int16_array_value         )
+    OCL_CHUNKED_TYPE( int32,  octave_int32,  int32NDArray,        int32_array_value         )
+    OCL_CHUNKED_TYPE( int64,  octave_int64,  int64NDArray,        int64_array_value         )
+    OCL_CHUNKED_TYPE( uint8,  octave_uint8,  uint8NDArray,        uint8_array_value         )
+    OCL_CHUNKED_TYPE( uint16, octave_uint16, uint16NDArray,       uint16_array_value        )
+    OCL_CHUNKED_TYPE( uint32, octave_uint32, uint32NDArray,       uint32_array_value        )
+    OCL_CHUNKED_TYPE( uint64, octave_uint64, uint64NDArray,       uint64_array_value        )
+      ocl_error ("ocl_chunked: X must be a numeric array"); // default case after last "else"
+  }
+
+#undef OCL_CHUNKED_TYPE
+
+  return retval;
+}
+
+
+// ---------- the octave entry points to the 'ocl_fread' and 'ocl_fwrite' functions
+
+
+// dimensions as with the size argument of fread (Inf, n, [m n] or [m Inf]),
+// for a file holding avail elements
+static
+dim_vector
+ocl_fread_dims (const Matrix& size, octave_idx_type avail)
+{
+  if ((size.numel () < 1) || (size.numel () > 2))
+    ocl_error ("ocl_fread: SIZE must be Inf, N, [M N] or [M Inf]");
+  for (octave_idx_type i = 0; i < size.numel (); i++)
+    if ((size (i) < 0) || ((! std::isinf (size (i))) && (size (i) != std::floor (size (i)))))
+      ocl_error ("ocl_fread: SIZE must be Inf, N, [M N] or [M Inf]");
+
+  octave_idx_type m, n;
+  if (size.numel () == 1) {
+    m = std::isinf (size (0)) ? avail : static_cast<octave_idx_type> (size (0));
+    n = 1;
+  } else {
+    if (std::isinf (size (0)))
+      ocl_error ("ocl_fread: SIZE must be Inf, N, [M N] or [M Inf]");
+    m = static_cast<octave_idx_type> (size (0));
+    n = std::isinf (size (1)) ? ((m > 0) ? avail / m : 0) : static_cast<octave_idx_type> (size (1));
+  }
+
+  if (m * n > avail)
+    ocl_error ("ocl_fread: file too short for the requested SIZE");
+
+  return dim_vector (m, n);
+}
+
+
+// the file is memory-mapped and uploaded from the mapping in chunks;
+// where mapping is not available, it is read in chunks into mapped
+// memory of the OpenCL buffer
+template <typename T>
+static
+OclArray<T>
+ocl_fread_array (const std::string& filename, const dim_vector& dv, uint64_t offset)
+{
+  size_t bytes = static_cast<size_t> (dv.safe_numel ()) * sizeof (T);
+  if (bytes == 0)
+    return OclArray<T> (dv);
+
+#if ! defined (_WIN32)
+  int fd = open (filename.c_str (), O_RDONLY);
+  if (fd >= 0) {
+    uint64_t page = sysconf (_SC_PAGESIZE);
+    uint64_t map_ofs = offset - offset % page;
+    size_t map_len = bytes + (offset - map_ofs);
+    void *p = mmap (0, map_len, PROT_READ, MAP_PRIVATE, fd, map_ofs);
+    close (fd); // the mapping remains valid
+    if (p != MAP_FAILED) {
+      madvise (p, map_len, MADV_SEQUENTIAL);
+      OclArray<T> result;
+      try {
+        result = OclArray<T>::upload_raw (static_cast<char *> (p) + (offset - map_ofs), dv);
+      } catch (...) {
+        munmap (p, map_len);
+        throw;
+      }
+      munmap (p, map_len);
+      return result;
+    }
+  }
+#endif
+
+  std::ifstream is (filename.c_str (), std::ios::in | std::ios::binary);
+  is.seekg (offset);
+  if (! is)
+    ocl_error ("ocl_fread: could not read file '%s'", filename.c_str ());
+  return OclArray<T>::read_raw (is, dv, false);
+}
+
+
+// The following two comment lines are needed verbatim for the Octave package manager:
+// PKG_ADD: autoload ("ocl_fread", "ocl_bin.oct");
+// PKG_DEL: autoload ("ocl_fread", "ocl_bin.oct", "remove");
+
+
+DEFUN_DLD (ocl_fread, args, nargout,
+"-*- texinfo -*-\n\
+@deftypefn  {Loadable Function} {@var{ocl_mat} =} ocl_fread (@var{filename}) \n\
+@deftypefnx {Loadable Function} {@var{ocl_mat} =} ocl_fread (@var{filename}, @var{size}) \n\
+@deftypefnx {Loadable Function} {@var{ocl_mat} =} ocl_fread (@var{filename}, @var{size}, @var{class}) \n\
+@deftypefnx {Loadable Function} {@var{ocl_mat} =} ocl_fread (@var{filename}, @var{size}, @var{class}, @var{offset}) \n\
+\n\
+Read raw binary data from a file directly into an OCL matrix.  \n\
+\n\
+The elements, of class @var{class} (@qcode{\"uint8\"} by default, or \n\
+@qcode{\"double\"}, @qcode{\"single\"} or any integer type), are read \n\
+in native byte order starting @var{offset} bytes (by default, 0) into \n\
+the file.  @var{size} is Inf (the default, all remaining elements), \n\
+@var{n} (a column of @var{n} elements), @code{[@var{m} @var{n}]} or \n\
+@code{[@var{m} Inf]} (as many full columns of @var{m} elements as the \n\
+file holds); unlike @code{fread}, requesting more elements than the \n\
+file holds is an error.  \n\
+\n\
+The file is memory-mapped, where available, and uploaded from the \n\
+mapping in chunks by non-blocking transfers, without a copy into an \n\
+octave matrix.  Otherwise, the chunks are read into mapped memory of \n\
+the OpenCL buffer.  \n\
+\n\
+@example \n\
+@group \n\
+ocl_fwrite (\"data.bin\", ocl_single (rand (1000, 50))); \n\
+x = ocl_fread (\"data.bin\", [1000 Inf], \"single\"); \n\
+@end group \n\
+@end example \n\
+\n\
+@seealso{ocl_fwrite, fread, oclArray} \n\
+@end deftypefn")
+{
+  octave_value_list retval;
+  int nargin = args.length ();
+
+  if ((nargin < 1) || (nargin > 4))
+    ocl_error ("ocl_fread: wrong number of arguments");
+  if (! args (0).is_string ())
+    ocl_error ("ocl_fread: FILENAME must be a string");
+
+  std::string filename = args (0).string_value ();
+  Matrix size (1, 1, std::numeric_limits<double>::infinity ());
+  if ((nargin > 1) && (args (1).numel () > 0))
+    size = args (1).matrix_value ();
+  std::string val_class = "uint8";
+  if (nargin > 2)
+    val_class = args (2).string_value ();
+  double offset = 0;
+  if (nargin > 3)
+    offset = args (3).double_value ();
+  if ((offset < 0) || (offset != std::floor (offset)))
+    ocl_error ("ocl_fread: OFFSET must be a non-negative integer");
+
+  std::ifstream is (filename.c_str (), std::ios::in | std::ios::binary | std::ios::ate);
+  if (! is)
+    ocl_error ("ocl_fread: could not open file '%s'", filename.c_str ());
+  double file_size = static_cast<double> (is.tellg ());
+  is.close ();
+  if (offset > file_size)
+    ocl_error ("ocl_fread: OFFSET beyond the end of the file");
+
+  assure_installed_ocl_types ();
+
+#define OCL_FREAD_TYPE(C, T) \
+  if (val_class == #C) { \
+    typedef T::array_type::element_type elem_type; \
+    octave_idx_type avail = static_cast<octave_idx_type> ((file_size - offset) / sizeof (elem_type)); \
+    dim_vector dv = ocl_fread_dims (size, avail); \
+    retval (0) = octave_value (new T (ocl_fread_array<elem_type> (filename, dv, static_cast<uint64_t> (offset)))); \
+  } else
+
+  OCL_FREAD_TYPE( double, octave_ocl_matrix )
+  OCL_FREAD_TYPE( single, octave_ocl_float_matrix )
+  OCL_FREAD_TYPE( int8,   octave_ocl_int8_matrix )
+  OCL_FREAD_TYPE( int16,  octave_ocl_int16_matrix )
+  OCL_FREAD_TYPE( int32,  octave_ocl_int32_matrix )
+  OCL_FREAD_TYPE( int64,  octave_ocl_int64_matrix )
+  OCL_FREAD_TYPE( uint8,  octave_ocl_uint8_matrix )
+  OCL_FREAD_TYPE( uint16, octave_ocl_uint16_matrix )
+  OCL_FREAD_TYPE( uint32, octave_ocl_uint32_matrix )
+  OCL_FREAD_TYPE( uint64, octave_ocl_uint64_matrix )
+    ocl_error ("ocl_fread: 'class' must be \"double\", \"single\" or an integer type"); // default case after last "else"
+
+#undef OCL_FREAD_TYPE
+
+  return retval;
+}
+
+
+// The following two comment lines are needed verbatim for the Octave package manager:
+// PKG_ADD: autoload ("ocl_fwrite", "ocl_bin.oct");
+// PKG_DEL: autoload ("ocl_fwrite", "ocl_bin.oct", "remove");
+
+
+DEFUN_DLD (ocl_fwrite, args, nargout,
+"-*- texinfo -*-\n\
+@deftypefn  {Loadable Function} {@var{count} =} ocl_fwrite (@var{filename}, @var{ocl_mat}) \n\
+@deftypefnx {Loadable Function} {@var{count} =} ocl_fwrite (@var{filename}, @var{ocl_mat}, \"append\") \n\
+\n\
+Write the elements of an OCL matrix as raw binary data to a file.  \n\
+\n\
+The elements are written in native byte order (complex elements as \n\
+pairs of real and imaginary part), replacing the file, or appended to \n\
+it with @qcode{\"append\"}.  They are streamed from mapped memory of the \n\
+OpenCL buffer in chunks, without a copy into an octave matrix.  The \n\
+number of elements written is returned.  \n\
+\n\
+@seealso{ocl_fread, fwrite, oclArray} \n\
+@end deftypefn")
+{
+  octave_value_list retval;
+  int nargin = args.length ();
+
+  if ((nargin < 2) || (nargin > 3))
+    ocl_error ("ocl_fwrite: wrong number of arguments");
+  if (! args (0).is_string ())
+    ocl_error ("ocl_fwrite: FILENAME must be a string");
+
+  std::string filename = args (0).string_value ();
+  std::ios::openmode mode = std::ios::out | std::ios::binary;
+  if (nargin > 2) {
+    if ((! args (2).is_string ()) || (args (2).string_value () != "append"))
+      ocl_error ("ocl_fwrite: third argument must be \"append\"");
+    mode |= std::ios::app;
+  } else
+    mode |= std::ios::trunc;
+
+  assure_installed_ocl_types ();
+
+  int type_id = args (1).type_id ();
+  std::ofstream os;
+  bool ok = false;
+
+  // the OCL matrix is checked before the file is opened (and truncated)
+#define OCL_FWRITE_TYPE(T) \
+  if (type_id == T::static_type_id ()) { \
+    T *mat = dynamic_cast<T *> (args (1).internal_rep ()); \
+    if (! mat) \
+      ocl_error ("ocl_fwrite: invalid argument"); \
+    const T::array_type& array = mat->ocl_array_value (); \
+    if ((array.numel () > 0) && (! array.is_valid ())) \
+      ocl_error ("ocl_fwrite: cannot write an inoperable ocl matrix"); \
+    os.open (filename.c_str (), mode); \
+    if (! os) \
+      ocl_error ("ocl_fwrite: could not open file '%s'", filename.c_str ()); \
+    ok = array.write_raw (os); \
+    retval (0) = octave_value (static_cast<double> (mat->numel ())); \
+  } else
+
+  OCL_FWRITE_TYPE( octave_ocl_matrix )
+  OCL_FWRITE_TYPE( octave_ocl_float_matrix )
+  OCL_FWRITE_TYPE( octave_ocl_complex_matrix )
+  OCL_FWRITE_TYPE( octave_ocl_float_complex_matrix )
+  OCL_FWRITE_TYPE( octave_ocl_int8_matrix )
+  OCL_FWRITE_TYPE( octave_ocl_int16_matrix )
+  OCL_FWRITE_TYPE( octave_ocl_int32_matrix )
+  OCL_FWRITE_TYPE( octave_ocl_int64_matrix )
+  OCL_FWRITE_TYPE( octave_ocl_uint8_matrix )
+  OCL_FWRITE_TYPE( octave_ocl_uint16_matrix )
+  OCL_FWRITE_TYPE( octave_ocl_uint32_matrix )
+  OCL_FWRITE_TYPE( octave_ocl_uint64_matrix )
+    ocl_error ("ocl_fwrite: second argument must be an ocl matrix"); // default case after last "else"
+
+#undef OCL_FWRITE_TYPE
+
+  os.close ();
+  if ((! ok) || (! os))
+    ocl_error ("ocl_fwrite: could not write file '%s'", filename.c_str ());
+
+  return retval;
+}
@@ -33,6 +33,7 @@
 
 #include "ocl_octave_versions.h"
 #include "ocl_ov_matrix.h"
+#include "ocl_ov_sparse.h"
 
 
 #if ! defined (OCL_OCTAVE_VERSION_4_4_0_AND_HIGHER) // for octave versions < 4.4.0
@@ -258,6 +259,33 @@ scalar_ov_cast (const octave_uint64_scalar& v)
     return new octave_value_type (v1array.method (v2.ocl_array_value ())); \
   }
 
+#define OCL_DEFNDBINOP_MTIMES_MM(name, trans1, trans2) \
+  template <typename octave_value_type, typename octave_value_type1, typename octave_value_type2> \
+  static octave_value \
+  name (const octave_base_value& a1, const octave_base_value& a2) \
+  { \
+    const octave_value_type1& v1 = dynamic_cast< const octave_value_type1& > (a1); \
+    const octave_value_type2& v2 = dynamic_cast< const octave_value_type2& > (a2); \
+    typename octave_value_type::array_type v1array = typename octave_value_type::array_type (v1.ocl_array_value ());\
+    return new octave_value_type (v1array.mtimes (v2.ocl_array_value (), trans1, trans2)); \
+  }
+
+#define OCL_DEFNDBINOP_MLDIVIDE_MM(name) \
+  template <typename octave_value_type, typename octave_value_type1, typename octave_value_type2> \
+  static octave_value \
+  name (const octave_base_value& a1, const octave_base_value& a2) \
+  { \
+    const octave_value_type1& v1 = dynamic_cast< const octave_value_type1& > (a1); \
+    const octave_value_type2& v2 = dynamic_cast< const octave_value_type2& > (a2); \
+    typename octave_value_type::array_type v1array = typename octave_value_type::array_type (v1.ocl_array_value ());\
+    typename octave_value_type::array_type v2array = typename octave_value_type::array_type (v2.ocl_array_value ());\
+    octave_idx_type info; \
+    typename octave_value_type::array_type result = v1array.mldivide (v2array, info); \
+    if (info > 0) \
+      warning_singular_oclmat (); \
+    return new octave_value_type (result); \
+  }
+
 #define OCL_DEFNDBINOPS_OP(name, op) \
   OCL_DEFNDBINOP_OP_MM (CONCAT2(name, _mm), op) \
   OCL_DEFNDBINOP_OP_MS (CONCAT2(name, _ms), op) \
@@ -378,6 +406,11 @@ OCL_DEFNDBINOPS2_OP (oclmat_el_div, /)
 OCL_DEFNDBINOP_FN_MM (oclmat_el_mul_mm, product)
 OCL_DEFNDBINOP_FN_MM (oclmat_el_div_mm, quotient)
 OCL_DEFNDBINOP_METHOD_MM (oclmat_mtimes, mtimes)
+OCL_DEFNDBINOP_MLDIVIDE_MM (oclmat_mldivide)
+OCL_DEFNDBINOP_MTIMES_MM (oclmat_trans_mul, 'T', 'N')
+OCL_DEFNDBINOP_MTIMES_MM (oclmat_mul_trans, 'N', 'T')
+OCL_DEFNDBINOP_MTIMES_MM (oclmat_herm_mul, 'C', 'N')
+OCL_DEFNDBINOP_MTIMES_MM (oclmat_mul_herm, 'N', 'C')
 OCL_DEFNDBINOPS_FN (oclmat_el_pow, pow)
 
 OCL_DEFNDASSIGNOP_FN_M (oclmat_assign_m, assign)
@@ -393,6 +426,78 @@ OCL_DEFNDASSIGNOP_OP_S (oclmat_assign_mul_s, *=)
 OCL_DEFNDASSIGNOP_OP_S (oclmat_assign_div_s, /=)
 
 
+// macros to manage operators for OCL sparse matrices
+
+
+#define OCL_DEFSPUNOP_METHOD(name, method) \
+  template <typename octave_value_type> \
+  static octave_value \
+  name (const octave_base_value& a) \
+  { \
+    const octave_value_type& v = dynamic_cast< const octave_value_type& > (a); \
+    return new octave_value_type (v.ocl_sparse_value ().method ()); \
+  }
+
+#define OCL_DEFSPBINOP_MTIMES_SM(name) \
+  template <typename octave_value_type, typename octave_value_type1, typename octave_value_type2> \
+  static octave_value \
+  name (const octave_base_value& a1, const octave_base_value& a2) \
+  { \
+    const octave_value_type1& v1 = dynamic_cast< const octave_value_type1& > (a1); \
+    const octave_value_type2& v2 = dynamic_cast< const octave_value_type2& > (a2); \
+    typename octave_value_type::array_type v2array = typename octave_value_type::array_type (v2.ocl_array_value ());\
+    return new octave_value_type (v1.ocl_sparse_value ().mtimes (v2array)); \
+  }
+
+#define OCL_DEFSPBINOP_MTIMES_MS(name) \
+  template <typename octave_value_type, typename octave_value_type1, typename octave_value_type2> \
+  static octave_value \
+  name (const octave_base_value& a1, const octave_base_value& a2) \
+  { \
+    const octave_value_type1& v1 = dynamic_cast< const octave_value_type1& > (a1); \
+    const octave_value_type2& v2 = dynamic_cast< const octave_value_type2& > (a2); \
+    typename octave_value_type::array_type v1array = typename octave_value_type::array_type (v1.ocl_array_value ());\
+    return new octave_value_type (v2.ocl_sparse_value ().mtimes_left (v1array)); \
+  }
+
+
+// real sparse with complex dense: the sparse matrix is promoted to complex
+
+#define OCL_DEFSPBINOP_MTIMES_SM_R(name) \
+  template <typename octave_value_type, typename octave_value_type1, typename octave_value_type2> \
+  static octave_value \
+  name (const octave_base_value& a1, const octave_base_value& a2) \
+  { \
+    typedef OclSparse< typename octave_value_type::array_type::element_type > sparse_type; \
+    const octave_value_type1& v1 = dynamic_cast< const octave_value_type1& > (a1); \
+    const octave_value_type2& v2 = dynamic_cast< const octave_value_type2& > (a2); \
+    return new octave_value_type (sparse_type (v1.ocl_sparse_value ()).mtimes (v2.ocl_array_value ())); \
+  }
+
+#define OCL_DEFSPBINOP_MTIMES_MS_R(name) \
+  template <typename octave_value_type, typename octave_value_type1, typename octave_value_type2> \
+  static octave_value \
+  name (const octave_base_value& a1, const octave_base_value& a2) \
+  { \
+    typedef OclSparse< typename octave_value_type::array_type::element_type > sparse_type; \
+    const octave_value_type1& v1 = dynamic_cast< const octave_value_type1& > (a1); \
+    const octave_value_type2& v2 = dynamic_cast< const octave_value_type2& > (a2); \
+    return new octave_value_type (sparse_type (v2.ocl_sparse_value ()).mtimes_left (v1.ocl_array_value ())); \
+  }
+
+
+// define operators for OCL sparse matrices
+
+
+OCL_DEFSPUNOP_METHOD (oclsparse_transpose, transpose)
+OCL_DEFSPUNOP_METHOD (oclsparse_hermitian, hermitian)
+
+OCL_DEFSPBINOP_MTIMES_SM (oclsparse_mtimes_sm)
+OCL_DEFSPBINOP_MTIMES_MS (oclsparse_mtimes_ms)
+OCL_DEFSPBINOP_MTIMES_SM_R (oclsparse_mtimes_sm_r)
+OCL_DEFSPBINOP_MTIMES_MS_R (oclsparse_mtimes_ms_r)
+
+
 // define installation procedure for operators for OCL matrices
 
 
@@ -426,7 +531,12 @@ oclmat_install (void)
   OCL_INSTALL_BINOPS(op_el_div, octave_value_ocl_matrix_type, octave_value_scalar_type, oclmat_el_div);
   OCL_INSTALL_BINOPS2(op_mul, octave_value_ocl_matrix_type, octave_value_scalar_type, oclmat_el_mul);
   OCL_INSTALL_BINOP (op_mul, octave_value_ocl_matrix_type, octave_value_ocl_matrix_type, octave_value_ocl_matrix_type, oclmat_mtimes);
+  OCL_INSTALL_BINOP (op_trans_mul, octave_value_ocl_matrix_type, octave_value_ocl_matrix_type, octave_value_ocl_matrix_type, oclmat_trans_mul);
+  OCL_INSTALL_BINOP (op_mul_trans, octave_value_ocl_matrix_type, octave_value_ocl_matrix_type, octave_value_ocl_matrix_type, oclmat_mul_trans);
+  OCL_INSTALL_BINOP (op_herm_mul, octave_value_ocl_matrix_type, octave_value_ocl_matrix_type, octave_value_ocl_matrix_type, oclmat_herm_mul);
+  OCL_INSTALL_BINOP (op_mul_herm, octave_value_ocl_matrix_type, octave_value_ocl_matrix_type, octave_value_ocl_matrix_type, oclmat_mul_herm);
   OCL_INSTALL_BINOP (op_div, octave_value_ocl_matrix_type, octave_value_ocl_matrix_type, octave_value_scalar_type, oclmat_el_div_ms);
+  OCL_INSTALL_BINOP (op_ldiv, octave_value_ocl_matrix_type, octave_value_ocl_matrix_type, octave_value_ocl_matrix_type, oclmat_mldivide);
   OCL_INSTALL_BINOPS(op_el_pow, octave_value_ocl_matrix_type, octave_value_scalar_type, oclmat_el_pow);
 
   OCL_INSTALL_ASSIGNOP (op_asn_eq, octave_value_ocl_matrix_type, octave_value_ocl_matrix_type, oclmat_assign_m);
@@ -519,11 +629,51 @@ oclmat_install_c (void)
   OCL_INSTALL_BINOPS2_C(op_mul, complex_ocl_matrix_type, real_ocl_matrix_type, complex_scalar_type, oclmat_el_mul);
   OCL_INSTALL_BINOP (op_mul, complex_ocl_matrix_type, complex_ocl_matrix_type, real_ocl_matrix_type, oclmat_mtimes);
   OCL_INSTALL_BINOP (op_mul, complex_ocl_matrix_type, real_ocl_matrix_type, complex_ocl_matrix_type, oclmat_mtimes);
+  OCL_INSTALL_BINOP (op_trans_mul, complex_ocl_matrix_type, complex_ocl_matrix_type, real_ocl_matrix_type, oclmat_trans_mul);
+  OCL_INSTALL_BINOP (op_trans_mul, complex_ocl_matrix_type, real_ocl_matrix_type, complex_ocl_matrix_type, oclmat_trans_mul);
+  OCL_INSTALL_BINOP (op_mul_trans, complex_ocl_matrix_type, complex_ocl_matrix_type, real_ocl_matrix_type, oclmat_mul_trans);
+  OCL_INSTALL_BINOP (op_mul_trans, complex_ocl_matrix_type, real_ocl_matrix_type, complex_ocl_matrix_type, oclmat_mul_trans);
+  OCL_INSTALL_BINOP (op_herm_mul, complex_ocl_matrix_type, complex_ocl_matrix_type, real_ocl_matrix_type, oclmat_herm_mul);
+  OCL_INSTALL_BINOP (op_herm_mul, complex_ocl_matrix_type, real_ocl_matrix_type, complex_ocl_matrix_type, oclmat_herm_mul);
+  OCL_INSTALL_BINOP (op_mul_herm, complex_ocl_matrix_type, complex_ocl_matrix_type, real_ocl_matrix_type, oclmat_mul_herm);
+  OCL_INSTALL_BINOP (op_mul_herm, complex_ocl_matrix_type, real_ocl_matrix_type, complex_ocl_matrix_type, oclmat_mul_herm);
   OCL_INSTALL_BINOP (op_div, complex_ocl_matrix_type, real_ocl_matrix_type, complex_scalar_type, oclmat_el_div_ms);
+  OCL_INSTALL_BINOP (op_ldiv, complex_ocl_matrix_type, complex_ocl_matrix_type, real_ocl_matrix_type, oclmat_mldivide);
+  OCL_INSTALL_BINOP (op_ldiv, complex_ocl_matrix_type, real_ocl_matrix_type, complex_ocl_matrix_type, oclmat_mldivide);
   OCL_INSTALL_BINOPS_C(op_el_pow, complex_ocl_matrix_type, real_ocl_matrix_type, complex_scalar_type, oclmat_el_pow);
 }
 
 
+// define installation procedure for operators for OCL sparse matrices;
+// op_trans_mul etc. are decomposed by octave into transposition and op_mul
+
+
+template < typename octave_value_ocl_sparse_type, typename octave_value_ocl_matrix_type >
+static void
+oclsparse_install (void)
+{
+  octave_value_ocl_sparse_type::register_type ();
+
+  OCL_INSTALL_UNOP (op_transpose, octave_value_ocl_sparse_type, oclsparse_transpose);
+  OCL_INSTALL_UNOP (op_hermitian, octave_value_ocl_sparse_type, oclsparse_hermitian);
+
+  OCL_INSTALL_BINOP (op_mul, octave_value_ocl_matrix_type, octave_value_ocl_sparse_type, octave_value_ocl_matrix_type, oclsparse_mtimes_sm);
+  OCL_INSTALL_BINOP (op_mul, octave_value_ocl_matrix_type, octave_value_ocl_matrix_type, octave_value_ocl_sparse_type, oclsparse_mtimes_ms);
+}
+
+
+template < typename complex_ocl_sparse_type, typename complex_ocl_matrix_type,
+           typename real_ocl_sparse_type, typename real_ocl_matrix_type >
+static void
+oclsparse_install_c (void)
+{
+  OCL_INSTALL_BINOP (op_mul, complex_ocl_matrix_type, complex_ocl_sparse_type, real_ocl_matrix_type, oclsparse_mtimes_sm);
+  OCL_INSTALL_BINOP (op_mul, complex_ocl_matrix_type, real_ocl_matrix_type, complex_ocl_sparse_type, oclsparse_mtimes_ms);
+  OCL_INSTALL_BINOP (op_mul, complex_ocl_matrix_type, real_ocl_sparse_type, complex_ocl_matrix_type, oclsparse_mtimes_sm_r);
+  OCL_INSTALL_BINOP (op_mul, complex_ocl_matrix_type, complex_ocl_matrix_type, real_ocl_sparse_type, oclsparse_mtimes_ms_r);
+}
+
+
 // ---------- public functions
 
 
@@ -546,3 +696,18 @@ install_ocl_matrix_types (void)
   oclmat_install_c < octave_ocl_complex_matrix, octave_ocl_matrix, octave_complex > ();
   oclmat_install_c < octave_ocl_float_complex_matrix, octave_ocl_float_matrix, octave_float_complex > ();
 }
+
+
+void
+install_ocl_sparse_types (void)
+{
+  oclsparse_install < octave_ocl_sparse_matrix, octave_ocl_matrix > ();
+  oclsparse_install < octave_ocl_float_sparse_matrix, octave_ocl_float_matrix > ();
+  oclsparse_install < octave_ocl_complex_sparse_matrix, octave_ocl_complex_matrix > ();
+  oclsparse_install < octave_ocl_float_complex_sparse_matrix, octave_ocl_float_complex_matrix > ();
+
+  oclsparse_install_c < octave_ocl_complex_sparse_matrix, octave_ocl_complex_matrix,
+                         octave_ocl_sparse_matrix, octave_ocl_matrix > ();
+  oclsparse_install_c < octave_ocl_float_complex_sparse_matrix, octave_ocl_float_complex_matrix,
+                         octave_ocl_float_sparse_matrix, octave_ocl_float_matrix > ();
+}
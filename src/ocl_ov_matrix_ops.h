@@ -24,4 +24,7 @@
 extern void
 install_ocl_matrix_types (void);
 
+extern void
+install_ocl_sparse_types (void);
+
 #endif  /* __OCL_OV_MATRIX_OPS_H */
@@ -0,0 +1,212 @@
+/*
+ * Copyright (C) 2019-2023 Matthias W. Klein
+ *
+ * This file is part of OCL - a GNU Octave package providing OpenCL support.
+ *
+ * OCL is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OCL is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OCL.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <octave/oct.h>
+
+#include "ocl_octave_versions.h"
+#include "ocl_lib.h"
+#include "ocl_ov_types.h"
+#include "ocl_ov_sparse.h"
+
+
+#if ! defined (OCL_OCTAVE_VERSION_4_4_0_AND_HIGHER) // for octave versions < 4.4.0
+#define ISSPARSE is_sparse_type
+#define ISCOMPLEX is_complex_type
+#else // for octave versions >= 4.4.0
+#define ISSPARSE issparse
+#define ISCOMPLEX iscomplex
+#endif
+
+
+// ---------- static helper functions
+
+
+// the CSR arrays of an octave sparse matrix are the compressed column
+// storage of its transpose
+template <typename T, typename SM>
+static OclSparse<T>
+ocl_sparse_from_octave (const SM& s)
+{
+  SM t = s.transpose ();
+  octave_idx_type nr = s.rows ();
+  octave_idx_type n = t.nnz ();
+
+  Array<ocl_idx_type> ptr (dim_vector (nr + 1, 1));
+  Array<ocl_idx_type> idx (dim_vector (n, 1));
+  Array<T> val (dim_vector (n, 1));
+
+  for (octave_idx_type r = 0; r <= nr; r++)
+    ptr (r) = ocl_idx_type (t.cidx (r));
+  for (octave_idx_type k = 0; k < n; k++) {
+    idx (k) = ocl_idx_type (t.ridx (k));
+    val (k) = T (t.data (k));
+  }
+
+  return OclSparse<T> (nr, s.cols (), ptr, idx, val);
+}
+
+
+template <typename SM, typename T>
+static SM
+ocl_sparse_to_octave (const OclSparse<T>& a)
+{
+  Array<ocl_idx_type> ptr, idx;
+  Array<T> val;
+  a.as_csr (ptr, idx, val);
+
+  octave_idx_type n = a.nnz ();
+  SM t (a.cols (), a.rows (), n);
+
+  for (octave_idx_type r = 0; r <= a.rows (); r++)
+    t.xcidx (r) = ptr (r).value ();
+  for (octave_idx_type k = 0; k < n; k++) {
+    t.xridx (k) = idx (k).value ();
+    t.xdata (k) = typename SM::element_type (val (k));
+  }
+
+  return t.transpose ();
+}
+
+
+// ---------- definition of octave_base_ocl_sparse<ST> class members
+
+
+template <typename ST>
+SparseMatrix
+octave_base_ocl_sparse<ST>::sparse_matrix_value (bool) const
+{ return ocl_sparse_to_octave<SparseMatrix> (sparse); }
+
+
+template <typename ST>
+SparseComplexMatrix
+octave_base_ocl_sparse<ST>::sparse_complex_matrix_value (bool) const
+{ return ocl_sparse_to_octave<SparseComplexMatrix> (sparse); }
+
+
+template <>
+SparseMatrix
+octave_base_ocl_sparse< OclSparse< Complex > >::sparse_matrix_value (bool) const
+{ ocl_error ("invalid conversion"); return SparseMatrix (); }
+
+
+template <>
+SparseMatrix
+octave_base_ocl_sparse< OclSparse< FloatComplex > >::sparse_matrix_value (bool) const
+{ ocl_error ("invalid conversion"); return SparseMatrix (); }
+
+
+#ifdef DEFINE_OCTAVE_ALLOCATOR
+DEFINE_OCTAVE_ALLOCATOR (octave_base_ocl_sparse< OclSparse< double > >);
+DEFINE_OCTAVE_ALLOCATOR (octave_base_ocl_sparse< OclSparse< float > >);
+DEFINE_OCTAVE_ALLOCATOR (octave_base_ocl_sparse< OclSparse< Complex > >);
+DEFINE_OCTAVE_ALLOCATOR (octave_base_ocl_sparse< OclSparse< FloatComplex > >);
+#endif
+
+
+DEFINE_OV_TYPEID_FUNCTIONS_AND_DATA_TC (octave_base_ocl_sparse< OclSparse< double > >, "ocl sparse matrix", "ocl_sparse");
+DEFINE_OV_TYPEID_FUNCTIONS_AND_DATA_TC (octave_base_ocl_sparse< OclSparse< float > >, "ocl float sparse matrix", "ocl_sparse");
+DEFINE_OV_TYPEID_FUNCTIONS_AND_DATA_TC (octave_base_ocl_sparse< OclSparse< Complex > >, "ocl complex sparse matrix", "ocl_sparse");
+DEFINE_OV_TYPEID_FUNCTIONS_AND_DATA_TC (octave_base_ocl_sparse< OclSparse< FloatComplex > >, "ocl float complex sparse matrix", "ocl_sparse");
+
+
+template class octave_base_ocl_sparse< OclSparse< double > >;
+template class octave_base_ocl_sparse< OclSparse< float > >;
+template class octave_base_ocl_sparse< OclSparse< Complex > >;
+template class octave_base_ocl_sparse< OclSparse< FloatComplex > >;
+
+
+// ---------- the octave entry point to the 'ocl_sparse' function
+
+
+// The following two comment lines are needed verbatim for the Octave package manager:
+// PKG_ADD: autoload ("ocl_sparse", "ocl_bin.oct");
+// PKG_DEL: autoload ("ocl_sparse", "ocl_bin.oct", "remove");
+
+
+DEFUN_DLD (ocl_sparse, args, nargout,
+"-*- texinfo -*-\n\
+@deftypefn  {Loadable Function} {@var{ocl_s} =} ocl_sparse (@var{s}) \n\
+@deftypefnx {Loadable Function} {@var{ocl_s} =} ocl_sparse (@var{s}, @var{class}) \n\
+\n\
+Transfer an octave sparse matrix into an OCL sparse matrix.  \n\
+\n\
+@code{ocl_sparse} copies the nonzeros of the (real or complex) octave sparse \n\
+matrix @var{s} to the OpenCL device, where they are stored in compressed \n\
+sparse row (CSR) format.  The class of the elements is @qcode{\"double\"} \n\
+(the default) or @qcode{\"single\"}, as selected by the string @var{class}.  \n\
+\n\
+OCL sparse matrices can be multiplied, on the OpenCL device, with OCL \n\
+matrices of the same class, from either side, and also after (conjugate) \n\
+transposition; the result is an OCL matrix:  \n\
+\n\
+@example \n\
+@group \n\
+ocl_s = ocl_sparse (sprandn (1000, 1000, 0.01)); \n\
+x = ocl_double (rand (1000, 4)); \n\
+y = ocl_s * x; \n\
+z = ocl_s' * x; \n\
+w = x' * ocl_s; \n\
+@end group \n\
+@end example \n\
+\n\
+@noindent \n\
+Transposed products use the CSR arrays of the transpose, which are \n\
+assembled once, on first use, and then kept with the OCL sparse matrix.  \n\
+\n\
+The functions @code{size} and @code{nnz} apply to OCL sparse matrices as \n\
+usual, and @code{sparse (@var{ocl_s})} transfers the data back into an \n\
+octave sparse matrix.  \n\
+\n\
+@seealso{sparse, ocl_double, ocl_single, oclArray} \n\
+@end deftypefn")
+{
+  octave_value_list retval;
+  int nargin = args.length ();
+  std::string val_class = "double";
+
+  if ((nargin > 0) && (args (nargin-1).is_string ())) {
+    val_class = args (nargin-1).string_value ();
+    nargin--;
+  }
+  if (nargin != 1)
+    ocl_error ("ocl_sparse: wrong number of arguments");
+  if (! args (0).ISSPARSE ())
+    ocl_error ("ocl_sparse: argument must be a sparse matrix");
+
+  assure_installed_ocl_types ();
+
+  bool is_complex = args (0).ISCOMPLEX ();
+
+#define OCL_SPARSE_TYPE(C, TR, TC) \
+  if (val_class == #C) { \
+    if (is_complex) \
+      retval (0) = octave_value (new TC (ocl_sparse_from_octave<TC::element_type> (args (0).sparse_complex_matrix_value ()))); \
+    else \
+      retval (0) = octave_value (new TR (ocl_sparse_from_octave<TR::element_type> (args (0).sparse_matrix_value ()))); \
+  } else
+
+  OCL_SPARSE_TYPE( double, octave_ocl_sparse_matrix, octave_ocl_complex_sparse_matrix )
+  OCL_SPARSE_TYPE( single, octave_ocl_float_sparse_matrix, octave_ocl_float_complex_sparse_matrix )
+    ocl_error ("ocl_sparse: 'class' must be \"double\" or \"single\""); // default case after last "else"
+
+#undef OCL_SPARSE_TYPE
+
+  return retval;
+}
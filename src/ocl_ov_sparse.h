@@ -0,0 +1,147 @@
+/*
+ * Copyright (C) 2019-2023 Matthias W. Klein
+ *
+ * This file is part of OCL - a GNU Octave package providing OpenCL support.
+ *
+ * OCL is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OCL is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OCL.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef __OCL_OV_SPARSE_H
+#define __OCL_OV_SPARSE_H
+
+#include "ocl_octave_versions.h"
+#include "ocl_ov_matrix.h"
+#include "ocl_sparse.h"
+
+#include <dSparse.h>
+#include <CSparse.h>
+
+template <typename ST>
+class
+octave_base_ocl_sparse : public octave_base_value
+{
+public:
+
+  typedef typename ST::element_type element_type;
+  typedef ST sparse_type;
+
+  octave_base_ocl_sparse (void)
+    : octave_base_value (), sparse () { }
+
+  octave_base_ocl_sparse (const octave_base_ocl_sparse& s)
+    : octave_base_value (), sparse (s.sparse) { }
+
+  octave_base_ocl_sparse (const ST& s)
+    : octave_base_value (), sparse (s) { }
+
+  ~octave_base_ocl_sparse (void) { }
+
+  octave_base_value *clone (void) const { return new octave_base_ocl_sparse<ST> (*this); }
+  octave_base_value *empty_clone (void) const { return new octave_base_ocl_sparse<ST> (); }
+
+  const ST& ocl_sparse_value (void) const { return sparse; }
+
+  dim_vector dims (void) const { return sparse.dims (); }
+
+  octave_idx_type nnz (void) const { return sparse.nnz (); }
+
+  bool is_defined (void) const { return true; }
+
+  bool is_constant (void) const { return true; }
+
+#if ! defined (OCL_OCTAVE_VERSION_4_4_0_AND_HIGHER) // for octave versions < 4.4.0
+  bool is_numeric_type (void) const
+#else // for octave versions >= 4.4.0
+  bool isnumeric (void) const
+#endif
+  { return true; }
+
+#if ! defined (OCL_OCTAVE_VERSION_4_4_0_AND_HIGHER) // for octave versions < 4.4.0
+  bool is_complex_type (void) const
+#else // for octave versions >= 4.4.0
+  bool iscomplex (void) const
+#endif
+  { return OclArray<element_type>::is_complex_type (); }
+
+  // transfer to octave sparse matrices, e.g. by 'sparse (ocl_sparse_mat)'
+
+  SparseMatrix
+  sparse_matrix_value (bool = false) const;
+
+  SparseComplexMatrix
+  sparse_complex_matrix_value (bool = false) const;
+
+  bool print_as_scalar (void) const { return true; }
+
+  void print (std::ostream& os, bool pr_as_read_syntax = false)
+  { print_raw (os, pr_as_read_syntax); }
+
+  void print_raw (std::ostream& os, bool pr_as_read_syntax = false) const
+  { os << sparse; }
+
+// saving or loading ocl sparse matrices is not supported (unlike ocl matrices,
+// see the comments in ocl_ov_matrix.cc);
+// the stub functions only exist to avoid errors when also saving/loading other variables
+
+  bool save_ascii (std::ostream& os)
+  { return true; }
+
+  bool load_ascii (std::istream& is)
+  { return true; }
+
+#if ! defined (OCL_OCTAVE_VERSION_6_1_0_AND_HIGHER) // for octave versions < 6.1.0
+  bool save_binary (std::ostream& os, bool& save_as_floats)
+#else // for octave versions >= 6.1.0
+  bool save_binary (std::ostream& os, bool save_as_floats)
+#endif
+  { return true; }
+
+  bool load_binary (std::istream& is, bool swap, octave::mach_info::float_format fmt)
+  { return true; }
+
+  bool save_hdf5 (octave_hdf5_id loc_id, const char *name, bool save_as_floats)
+  { return true; }
+
+  bool load_hdf5 (octave_hdf5_id loc_id, const char *name)
+  { return true; }
+
+protected:
+
+  ST sparse;
+
+private:
+
+  octave_base_ocl_sparse& operator = (const octave_base_ocl_sparse&); // No assignment.
+
+#ifdef DECLARE_OCTAVE_ALLOCATOR
+  DECLARE_OCTAVE_ALLOCATOR
+#endif
+
+  DECLARE_OV_TYPEID_FUNCTIONS_AND_DATA
+};
+
+#if defined (DEFINE_TEMPLATE_OV_TYPEID_FUNCTIONS_AND_DATA)
+DECLARE_TEMPLATE_OV_TYPEID_SPECIALIZATIONS (octave_base_ocl_sparse, OclSparse< double        >)
+DECLARE_TEMPLATE_OV_TYPEID_SPECIALIZATIONS (octave_base_ocl_sparse, OclSparse< float         >)
+DECLARE_TEMPLATE_OV_TYPEID_SPECIALIZATIONS (octave_base_ocl_sparse, OclSparse< Complex       >)
+DECLARE_TEMPLATE_OV_TYPEID_SPECIALIZATIONS (octave_base_ocl_sparse, OclSparse< FloatComplex  >)
+#endif
+
+typedef octave_base_ocl_sparse< OclSparse< double        > > octave_ocl_sparse_matrix;
+typedef octave_base_ocl_sparse< OclSparse< float         > > octave_ocl_float_sparse_matrix;
+typedef octave_base_ocl_sparse< OclSparse< Complex       > > octave_ocl_complex_sparse_matrix;
+typedef octave_base_ocl_sparse< OclSparse< FloatComplex  > > octave_ocl_float_complex_sparse_matrix;
+
+#endif  /* __OCL_OV_SPARSE_H */
@@ -48,6 +48,7 @@ assure_installed_ocl_types (void)
   ocl_types_loaded = true;
 
   install_ocl_matrix_types ();
+  install_ocl_sparse_types ();
   install_ocl_program_type ();
 }
 
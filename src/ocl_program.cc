@@ -21,12 +21,20 @@
 #include "ocl_program.h"
 #include "ocl_array.h"
 #include "ocl_lib.h"
+#include "ocl_memobj.h"
 #include <octave/oct.h>
+#include <algorithm>
 
 
 // ---------- static helper functions
 
 
+// limits for the work sizes chosen by enqueue_kernel_grid () and the
+// reduction helpers: work-group size, and work-groups per compute unit
+static const size_t max_local_size = 256;
+static const size_t groups_per_compute_unit = 8;
+
+
 static
 void
 ocl_program_inop_error (void)
@@ -99,10 +107,25 @@ OclProgram::OclProgramRep::compile (const std::string& source, const std::string
 
   ocl_kernels.resize (num_kernels);
   kernel_names.resize (num_kernels);
+  kernel_work_group_sizes.resize (num_kernels);
+
+  cl_uint units = 1;
+  size_t max_work_group_size = 1;
+  if (clGetDeviceInfo (device_id, CL_DEVICE_MAX_COMPUTE_UNITS, sizeof (cl_uint), & units, 0) != CL_SUCCESS)
+    units = 1;
+  if (clGetDeviceInfo (device_id, CL_DEVICE_MAX_WORK_GROUP_SIZE, sizeof (size_t), & max_work_group_size, 0) != CL_SUCCESS)
+    max_work_group_size = 1;
+  compute_units = std::max (units, (cl_uint) 1);
 
   for (unsigned int i = 0; i < num_kernels; i++) {
     ocl_kernels [i] = (void*) kernel_objs [i];
 
+    size_t wg_size = 0;
+    if (clGetKernelWorkGroupInfo (kernel_objs [i], device_id, CL_KERNEL_WORK_GROUP_SIZE,
+                                  sizeof (size_t), & wg_size, 0) != CL_SUCCESS)
+      wg_size = max_work_group_size;
+    kernel_work_group_sizes [i] = std::max (std::min (wg_size, max_work_group_size), (size_t) 1);
+
     size_t name_length = 0;
     last_error = clGetKernelInfo (kernel_objs [i], CL_KERNEL_FUNCTION_NAME, 0, 0, & name_length);
     if ((last_error != CL_SUCCESS) || (name_length == 0))
@@ -162,6 +185,9 @@ OclProgram::OclProgramRep::set_kernel_arg
   if ((kernel_index < 0) || (kernel_index >= (int) num_kernels ()))
     ocl_error ("OclProgram::set_kernel_arg(): kernel index not found");
 
+  // the memory objects bound so far stay pinned until the kernel is enqueued
+  ocl_memobj_hold_pins (ocl_kernels [kernel_index]);
+
   last_error = clSetKernelArg ((cl_kernel) ocl_kernels [kernel_index],
                                arg_index,
                                byte_size,
@@ -233,10 +259,90 @@ OclProgram::OclProgramRep::enqueue_kernel
                                        global_work_size,
                                        local_work_size_pointer,
                                        0, 0, 0);
+  ocl_memobj_release_pins (ocl_kernels [kernel_index]);
   ocl_check_error ("clEnqueueNDRangeKernel");
 }
 
 
+void
+OclProgram::OclProgramRep::enqueue_kernel_grid
+  (int kernel_index,
+   size_t n)
+{
+  assure_valid ();
+  if ((kernel_index < 0) || (kernel_index >= (int) num_kernels ()))
+    ocl_error ("OclProgram::enqueue_kernel_grid(): kernel index not found");
+
+  if (n == 0)
+    return;
+
+  // work-groups as large as the kernel allows on this device (up to a limit),
+  // but only as many of them as keep all compute units busy; the kernel then
+  // loops over the remaining items with a stride of the global work size
+  size_t local_size = std::min (kernel_work_group_sizes [kernel_index], max_local_size);
+  size_t num_groups = std::min ((n + local_size - 1) / local_size,
+                                compute_units * groups_per_compute_unit);
+
+  Matrix work_size (3,1);
+  work_size (0,0) = num_groups * local_size;
+  work_size (1,0) = 0;
+  work_size (2,0) = local_size;
+
+  enqueue_kernel (kernel_index, work_size);
+}
+
+
+size_t
+OclProgram::OclProgramRep::get_kernel_work_group_size
+  (int kernel_index) const
+{
+  assure_valid ();
+  if ((kernel_index < 0) || (kernel_index >= (int) num_kernels ()))
+    ocl_error ("OclProgram::get_kernel_work_group_size(): kernel index not found");
+
+  return kernel_work_group_sizes [kernel_index];
+}
+
+
+size_t
+OclProgram::OclProgramRep::reduction_group_size
+  (int kernel_index,
+   size_t len) const
+{
+  assure_valid ();
+  if ((kernel_index < 0) || (kernel_index >= (int) num_kernels ()))
+    ocl_error ("OclProgram::reduction_group_size(): kernel index not found");
+
+  size_t max_size = std::min (kernel_work_group_sizes [kernel_index], max_local_size);
+  size_t local_size = 1;
+  while ((2 * local_size <= max_size) && (local_size < len))
+    local_size *= 2;
+
+  return local_size;
+}
+
+
+size_t
+OclProgram::OclProgramRep::reduction_groups_per_slice
+  (size_t num_slices,
+   size_t len,
+   size_t local_size) const
+{
+  // at least a few elements per work-item, and only as many work-groups
+  // in total as keep all compute units busy
+  const size_t min_items_per_work_item = 4;
+
+  size_t max_groups = compute_units * groups_per_compute_unit;
+  if (num_slices >= max_groups)
+    return 1;
+
+  size_t groups = (len + local_size * min_items_per_work_item - 1) / (local_size * min_items_per_work_item);
+  groups = std::min (groups, (max_groups + num_slices - 1) / num_slices);
+
+  return std::max (groups, (size_t) 1);
+}
+
+
 // ---------- OclProgram members
 
 
@@ -45,11 +45,11 @@ protected:
 
     // empty, inoperable program
     OclProgramRep ()
-      : OclContextObject (false), ocl_program (0), count (1) {}
+      : OclContextObject (false), ocl_program (0), compute_units (1), count (1) {}
 
     // program with source code, for immediate compilation; needs/activates an OpenCL context
     OclProgramRep (const std::string& source, const std::string& build_options = "")
-      : OclContextObject (true), ocl_program (0), count (1)
+      : OclContextObject (true), ocl_program (0), compute_units (1), count (1)
     {
       compile (source, build_options);
     }
@@ -86,11 +86,21 @@ protected:
 
     void enqueue_kernel (int kernel_index, const Matrix& work_size);
 
+    void enqueue_kernel_grid (int kernel_index, size_t n);
+
+    size_t get_kernel_work_group_size (int kernel_index) const;
+
+    size_t reduction_group_size (int kernel_index, size_t len) const;
+
+    size_t reduction_groups_per_slice (size_t num_slices, size_t len, size_t local_size) const;
+
     void *ocl_program;
     std::string build_log;
     std::vector<void *> ocl_kernels;
     std::vector<std::string> kernel_names;
     std::map<std::string, int> kernel_dictionary;
+    std::vector<size_t> kernel_work_group_sizes;
+    size_t compute_units;
     int count;
 
   private:
@@ -186,6 +196,10 @@ public:
     }
   }
 
+  // for __local kernel arguments (only the size is given, no data)
+  void set_kernel_arg_local (int kernel_index, unsigned int arg_index, size_t byte_size)
+    { rep->set_kernel_arg (kernel_index, arg_index, 0, byte_size); }
+
   // for OclArray type kernel arguments
   template <typename T>
   void set_kernel_arg (int kernel_index, unsigned int arg_index, const OclArray<T>& arg);
@@ -279,6 +293,51 @@ public:
     rep->enqueue_kernel (kernel_index, work_size);
   }
 
+  // enqueue kernel with a grid-stride loop over (at most) n work-items;
+  // global and local work size are derived from the device's resources
+  void enqueue_kernel_grid (int kernel_index, size_t n)
+  {
+    rep->enqueue_kernel_grid (kernel_index, n);
+  }
+
+  // maximum work-group size of the kernel on the current device
+  size_t get_kernel_work_group_size (int kernel_index) const
+  {
+    return rep->get_kernel_work_group_size (kernel_index);
+  }
+
+  // power-of-two work-group size for a work-group tree reduction
+  // over len elements, as large as the kernel allows on this device
+  size_t reduction_group_size (int kernel_index, size_t len) const
+  {
+    return rep->reduction_group_size (kernel_index, len);
+  }
+
+  // number of work-groups per slice for a two-stage reduction of
+  // num_slices slices of len elements each, enough to keep the device busy
+  size_t reduction_groups_per_slice (size_t num_slices, size_t len, size_t local_size) const
+  {
+    return rep->reduction_groups_per_slice (num_slices, len, local_size);
+  }
+
+  // enqueue kernel as num_slices x groups_per_slice work-groups of
+  // local_size work-items each; the work-groups of slice i are the ones
+  // with get_group_id (1) == i, numbered by get_group_id (0)
+  void enqueue_kernel_groups (int kernel_index, size_t num_slices, size_t local_size,
+                              size_t groups_per_slice = 1)
+  {
+    if (num_slices == 0)
+      return;
+    Matrix work_size (3,2);
+    work_size (0,0) = local_size * groups_per_slice;
+    work_size (0,1) = num_slices;
+    work_size (1,0) = 0;
+    work_size (1,1) = 0;
+    work_size (2,0) = local_size;
+    work_size (2,1) = 1;
+    rep->enqueue_kernel (kernel_index, work_size);
+  }
+
   // for convenience
   static void clEnqueueBarrier (void);
 
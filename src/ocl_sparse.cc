@@ -0,0 +1,196 @@
+/*
+ * Copyright (C) 2019-2023 Matthias W. Klein
+ *
+ * This file is part of OCL - a GNU Octave package providing OpenCL support.
+ *
+ * OCL is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OCL is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OCL.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "ocl_sparse.h"
+#include "ocl_lib.h"
+
+
+// ---------- OclSparse<T> members
+
+
+template <typename T>
+OclSparse<T>::OclSparse (octave_idx_type r, octave_idx_type c,
+                         const Array<ocl_idx_type>& ptr,
+                         const Array<ocl_idx_type>& idx,
+                         const Array<T>& val)
+  : nr (r), nc (c), row_ptr (ptr), col_idx (idx), values (val), conj_values (false),
+    has_trans (false), trans_row_ptr (), trans_col_idx (), trans_values ()
+{
+  if ((ptr.numel () != r + 1) ||
+      (idx.numel () != val.numel ()) ||
+      (ptr (r).value () != val.numel ()))
+    ocl_error ("OclSparse: invalid compressed sparse row arrays");
+}
+
+
+// the transpose of the converted matrix is built anew on first use
+template <typename T> template <typename U>
+OclSparse<T>::OclSparse (const OclSparse<U>& a)
+  : nr (a.nr), nc (a.nc), row_ptr (a.row_ptr), col_idx (a.col_idx),
+    values ((a.nnz () > 0) ? OclArray<T> (a.values) : OclArray<T> (dim_vector (0, 1))),
+    conj_values (false),
+    has_trans (false), trans_row_ptr (), trans_col_idx (), trans_values ()
+{
+}
+
+
+template <typename T>
+void
+OclSparse<T>::as_csr (Array<ocl_idx_type>& ptr, Array<ocl_idx_type>& idx, Array<T>& val) const
+{
+  ptr = row_ptr.as_array ();
+  if (nnz () == 0) {
+    idx = Array<ocl_idx_type> (dim_vector (0, 1));
+    val = Array<T> (dim_vector (0, 1));
+    return;
+  }
+  idx = col_idx.as_array ();
+  if (conj_values)
+    val = values.map (octave_base_value::umap_conj).as_array ();
+  else
+    val = values.as_array ();
+}
+
+
+// build the CSR arrays of the transpose (a bucket sort by column) on the host
+template <typename T>
+void
+OclSparse<T>::assure_trans (void) const
+{
+  if (has_trans)
+    return;
+
+  octave_idx_type n = nnz ();
+
+  Array<ocl_idx_type> ptr = row_ptr.as_array ();
+  Array<ocl_idx_type> t_ptr (dim_vector (nc + 1, 1), ocl_idx_type (0));
+  Array<ocl_idx_type> t_idx (dim_vector (n, 1));
+  Array<T> t_val (dim_vector (n, 1));
+
+  if (n > 0) {
+    Array<ocl_idx_type> idx = col_idx.as_array ();
+    Array<T> val = values.as_array ();
+
+    for (octave_idx_type k = 0; k < n; k++)
+      t_ptr (idx (k).value () + 1) += ocl_idx_type (1);
+    for (octave_idx_type j = 0; j < nc; j++)
+      t_ptr (j+1) += t_ptr (j);
+
+    Array<ocl_idx_type> pos (t_ptr);
+    for (octave_idx_type r = 0; r < nr; r++)
+      for (octave_idx_type k = ptr (r).value (); k < ptr (r+1).value (); k++) {
+        octave_idx_type j = idx (k).value ();
+        octave_idx_type p = pos (j).value ();
+        t_idx (p) = ocl_idx_type (r);
+        t_val (p) = val (k);
+        pos (j) = ocl_idx_type (p + 1);
+      }
+  }
+
+  trans_row_ptr = OclArray<ocl_idx_type> (t_ptr);
+  trans_col_idx = OclArray<ocl_idx_type> (t_idx);
+  trans_values = OclArray<T> (t_val);
+  has_trans = true;
+}
+
+
+template <typename T>
+OclSparse<T>
+OclSparse<T>::transpose (void) const
+{
+  assure_trans ();
+
+  OclSparse<T> result (*this);
+  result.nr = nc;
+  result.nc = nr;
+  result.row_ptr = trans_row_ptr;
+  result.col_idx = trans_col_idx;
+  result.values = trans_values;
+  result.trans_row_ptr = row_ptr;
+  result.trans_col_idx = col_idx;
+  result.trans_values = values;
+  return result;
+}
+
+
+template <typename T>
+OclSparse<T>
+OclSparse<T>::hermitian (void) const
+{
+  OclSparse<T> result = transpose ();
+  if (OclArray<T>::is_complex_type ())
+    result.conj_values = ! conj_values;
+  return result;
+}
+
+
+template <typename T>
+OclArray<T>
+OclSparse<T>::mtimes (const OclArray<T>& x) const
+{
+  if ((x.ndims () != 2) || (x.dim1 () != nc))
+    ocl_error ("OclSparse: mismatch in operands' sizes for matrix multiplication");
+
+  return OclArray<T>::csr_mtimes (nr, row_ptr, col_idx, values, x, conj_values);
+}
+
+
+template <typename T>
+OclArray<T>
+OclSparse<T>::mtimes_left (const OclArray<T>& x) const
+{
+  if ((x.ndims () != 2) || (x.dim2 () != nr))
+    ocl_error ("OclSparse: mismatch in operands' sizes for matrix multiplication");
+
+  // x * A = (A.' * x.').'
+  return transpose ().mtimes (x.transpose ()).transpose ();
+}
+
+
+// ---------- public functions
+
+
+template <typename T>
+std::ostream&
+operator << (std::ostream& os, const OclSparse<T>& a)
+{
+  os << "  OCL sparse matrix (" << a.dims ().str () << ", " << a.nnz () << " nonzeros)"
+     << " of class " << OclArray<T>::get_type_str_oct ()
+     << " (" << OclArray<T>::get_type_str_oclc () << ")\n";
+
+  return os;
+}
+
+
+// ---------- OclSparse<T> instantiations
+
+
+#define INSTANTIATE_OCLSPARSE( T ) \
+  template std::ostream& operator << (std::ostream& os, const OclSparse<T>& a); \
+  template class OclSparse<T>;
+
+
+INSTANTIATE_OCLSPARSE (float        );
+INSTANTIATE_OCLSPARSE (double       );
+INSTANTIATE_OCLSPARSE (FloatComplex );
+INSTANTIATE_OCLSPARSE (Complex      );
+
+template OclSparse<FloatComplex>::OclSparse (const OclSparse<float>& a);
+template OclSparse<Complex>::OclSparse (const OclSparse<double>& a);
@@ -0,0 +1,104 @@
+/*
+ * Copyright (C) 2019-2023 Matthias W. Klein
+ *
+ * This file is part of OCL - a GNU Octave package providing OpenCL support.
+ *
+ * OCL is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OCL is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OCL.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef __OCL_SPARSE_H
+#define __OCL_SPARSE_H
+
+#include "ocl_array.h"
+
+
+// OCL sparse matrix class allowing shallow copies; a 2-dim matrix in
+// compressed sparse row (CSR) format: the nonzeros of row r are
+// values (k) in columns col_idx (k), for row_ptr (r) <= k < row_ptr (r+1).
+// The CSR arrays of the transpose, needed for transposed products, are
+// created on first use and then kept with the matrix.
+template <typename T>
+class
+OclSparse
+{
+public:
+
+  typedef T element_type;
+
+  // Empty constructor (0x0).
+  OclSparse (void)
+    : nr (0), nc (0), row_ptr (), col_idx (), values (), conj_values (false),
+      has_trans (false), trans_row_ptr (), trans_col_idx (), trans_values () {}
+
+  // Copy from host memory constructor, with CSR arrays.
+  OclSparse (octave_idx_type r, octave_idx_type c,
+             const Array<ocl_idx_type>& ptr,
+             const Array<ocl_idx_type>& idx,
+             const Array<T>& val);
+
+  // Type conversion constructor. OclSparse: only for real->complex conversion.
+  template <typename U>
+  explicit OclSparse (const OclSparse<U>& a);
+
+  octave_idx_type rows (void) const { return nr; }
+  octave_idx_type cols (void) const { return nc; }
+  octave_idx_type nnz (void) const { return values.numel (); }
+
+  dim_vector dims (void) const { return dim_vector (nr, nc); }
+
+  size_t byte_size (void) const
+  { return row_ptr.byte_size () + col_idx.byte_size () + values.byte_size (); }
+
+  // CSR arrays on the host
+  void as_csr (Array<ocl_idx_type>& ptr, Array<ocl_idx_type>& idx, Array<T>& val) const;
+
+  OclSparse<T> transpose (void) const;
+  OclSparse<T> hermitian (void) const;
+
+  // Sparse times dense: (*this) * x, and x * (*this).
+  OclArray<T> mtimes (const OclArray<T>& x) const;
+  OclArray<T> mtimes_left (const OclArray<T>& x) const;
+
+protected:
+
+  octave_idx_type nr, nc;
+
+  OclArray<ocl_idx_type> row_ptr;
+  OclArray<ocl_idx_type> col_idx;
+  OclArray<T> values;
+  bool conj_values;
+
+  mutable bool has_trans;
+  mutable OclArray<ocl_idx_type> trans_row_ptr;
+  mutable OclArray<ocl_idx_type> trans_col_idx;
+  mutable OclArray<T> trans_values;
+
+  void assure_trans (void) const;
+
+  template <class U> friend class OclSparse;
+};
+
+
+template <typename T>
+std::ostream&
+operator << (std::ostream& os, const OclSparse<T>& a);
+
+
+typedef OclSparse<float        > OclFloatSparse;
+typedef OclSparse<double       > OclSparseMatrix;
+typedef OclSparse<FloatComplex > OclFloatComplexSparse;
+typedef OclSparse<Complex      > OclComplexSparse;
+
+#endif  /* __OCL_SPARSE_H */